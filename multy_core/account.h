@@ -55,6 +55,33 @@ MULTY_CORE_API struct Error* make_hd_account(
         uint32_t index,
         struct HDAccount** new_account);
 
+/** Make a watch-only HD account from the public key of the account.
+ *
+ * Watch-only account derives leaves from the public key only, leaves have
+ * same addresses as leaves of the HD account made from the master key,
+ * but have no private keys.
+ * @param serialized_account_public_key - base58 encoded BIP32 public key (xpub)
+ *        of the account, as given by hd_account_get_public_key_string().
+ * @param blockchain_type - type of the blockchain.
+ * @param account_type - ACCOUNT_TYPE_DEFAULT or blockchain-specific account type.
+ * @param new_account - newly created account, must be freed by caller with
+ * free_hd_account().
+ */
+MULTY_CORE_API struct Error* make_watch_only_hd_account(
+        const char* serialized_account_public_key,
+        struct BlockchainType blockchain_type,
+        uint32_t account_type,
+        struct HDAccount** new_account);
+
+/** Get public key of the HD account serialized as BIP32 xpub string.
+ * @param base_account - HD account, regular or watch-only.
+ * @param out_serialized_public_key - resulting string, must be freed by caller
+ * with free_string().
+ */
+MULTY_CORE_API struct Error* hd_account_get_public_key_string(
+        const struct HDAccount* base_account,
+        const char** out_serialized_public_key);
+
 /** Make a leaf HD account - the one that has an address and can be paid from/to.
  * @param base_account - base account, for which leaf is generated.
  * @param address_type - type of address for account: internal or external.
@@ -68,6 +95,24 @@ MULTY_CORE_API struct Error* make_hd_leaf_account(
         uint32_t index,
         struct Account** new_account);
 
+/** Derive addresses of a range of leaf HD accounts, without making accounts.
+ * Same as calling make_hd_leaf_account() and account_get_address_string()
+ * for each index in [first_index, first_index + count), but much faster.
+ * Large ranges are processed in parallel.
+ * @param base_account - base account, for which leaves are derived.
+ * @param address_type - type of address: internal or external.
+ * @param first_index - index of the first leaf, not hardened.
+ * @param count - number of addresses, all indices must be not hardened.
+ * @param out_addresses - array of count items, each must be freed by caller
+ * with free_string(). Nothing is set on error.
+ */
+MULTY_CORE_API struct Error* hd_account_derive_addresses(
+        const struct HDAccount* base_account,
+        enum AddressType address_type,
+        uint32_t first_index,
+        size_t count,
+        const char** out_addresses);
+
 /** Make regular account from private key and Blockchain.
  * @param Blockchain - Blockchain to use account for.
  * @param account_type - ACCOUNT_TYPE_DEFAULT or blockchain-specific account type.
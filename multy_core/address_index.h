@@ -0,0 +1,115 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_ADDRESS_INDEX_H
+#define MULTY_CORE_ADDRESS_INDEX_H
+
+#include "multy_core/api.h"
+#include "multy_core/account.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct AddressIndex;
+struct BinaryData;
+struct Error;
+struct HDAccount;
+
+/** AddressIndex maps address hashes back to HD leaves that own those.
+ *
+ * Address hash is a 20-byte value encoded in the address and in the output
+ * script: HASH160 of the public key (P2PKH) or of the script (P2SH) for
+ * Bitcoin, and the address itself for Ethereum. That is exactly what
+ * bitcoin_parse_address() or ethereum_parse_address() return.
+ *
+ * Leaf is identified by caller-provided account id, address type and index.
+ * Index can be saved to a file and loaded back with memory mapping, without
+ * deriving addresses again.
+ */
+
+/// Leaf that owns an address.
+struct AddressIndexLeaf
+{
+    /// Id of the HD account, as given to address_index_add_hd_account_addresses().
+    uint32_t account_id;
+    enum AddressType address_type;
+    uint32_t index;
+};
+
+/** Make a new empty index.
+ * @param new_index - new index, must be freed with free_address_index().
+ */
+MULTY_CORE_API struct Error* make_address_index(struct AddressIndex** new_index);
+
+/** Load index saved with address_index_save().
+ * File is memory-mapped, and only copied to memory when more addresses are added.
+ * @param file_path - path of the file to load index from.
+ * @param new_index - loaded index, must be freed with free_address_index().
+ */
+MULTY_CORE_API struct Error* make_address_index_from_file(
+        const char* file_path, struct AddressIndex** new_index);
+
+/** Add addresses of leaves [first_index, first_index + count) of the HD account.
+ *
+ * Adding same leaves again is allowed, so index can be extended as the gap limit
+ * advances, e.g. by adding next 20 addresses of the chain.
+ * @param index - index to add addresses to.
+ * @param account_id - any value except UINT32_MAX, that identifies hd_account.
+ * @param hd_account - Bitcoin or Ethereum HD account, regular or watch-only.
+ * @param address_type - chain of the leaves.
+ * @param first_index - index of the first leaf.
+ * @param count - number of leaves.
+ */
+MULTY_CORE_API struct Error* address_index_add_hd_account_addresses(
+        struct AddressIndex* index,
+        uint32_t account_id,
+        const struct HDAccount* hd_account,
+        enum AddressType address_type,
+        uint32_t first_index,
+        size_t count);
+
+/** Find a leaf that owns the address hash.
+ * @param index - index to search.
+ * @param address_hash - 20-byte address hash.
+ * @param out_found - set to true if leaf is found, false otherwise.
+ * @param out_leaf - set to the leaf if one is found, not changed otherwise.
+ */
+MULTY_CORE_API struct Error* address_index_find(
+        const struct AddressIndex* index,
+        const struct BinaryData* address_hash,
+        bool* out_found,
+        struct AddressIndexLeaf* out_leaf);
+
+/** Get number of addresses in the index.
+ * @param index - index.
+ * @param out_size - number of distinct addresses.
+ */
+MULTY_CORE_API struct Error* address_index_get_size(
+        const struct AddressIndex* index, size_t* out_size);
+
+/** Save index to the file, to be loaded with make_address_index_from_file().
+ *
+ * File layout depends on the byte order of the machine, and can be loaded
+ * only on machines with same byte order.
+ * @param index - index to save.
+ * @param file_path - path of the file, overwritten if exists.
+ */
+MULTY_CORE_API struct Error* address_index_save(
+        const struct AddressIndex* index, const char* file_path);
+
+/** Frees AddressIndex instance, can accept nullptr. **/
+MULTY_CORE_API void free_address_index(struct AddressIndex* index);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // MULTY_CORE_ADDRESS_INDEX_H
@@ -0,0 +1,61 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_BITCOIN_BULK_PAYOUT_H
+#define MULTY_CORE_BITCOIN_BULK_PAYOUT_H
+
+#include "multy_core/api.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct BinaryData;
+struct Error;
+struct Transaction;
+
+/** Destination of the bulk payout.
+ *
+ * Exactly one of address or script_pubkey must be set, the other one must be null.
+ * Passing script_pubkey skips parsing of the address, only P2PKH and P2SH
+ * scripts are accepted.
+ */
+struct BitcoinBulkDestination
+{
+    const char* address;
+    const struct BinaryData* script_pubkey;
+    uint64_t amount; // in satoshi
+};
+
+/** Add many destinations to the Bitcoin transaction at once.
+ *
+ * Unlike transaction_add_destination(), destinations are not represented as
+ * Properties and can't be altered or removed after being added. Those are
+ * serialized in order they were added, after all destinations added with
+ * transaction_add_destination(). Suitable for payouts of thousands of outputs.
+ *
+ * Either all destinations are added or none is, if any of them is invalid.
+ *
+ * @param transaction - Bitcoin transaction;
+ * @param destinations - destinations_count items;
+ * @param destinations_count - number of destinations.
+ * @return Error with ERROR_INVALID_ADDRESS if address or script_pubkey is invalid,
+ *      ERROR_TRANSACTION_TRANSFER_AMOUNT_TOO_SMALL if amount is zero or,
+ *      on mainnet, is dust.
+ */
+MULTY_CORE_API struct Error* transaction_add_bitcoin_destinations(
+        struct Transaction* transaction,
+        const struct BitcoinBulkDestination* destinations,
+        size_t destinations_count);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // MULTY_CORE_BITCOIN_BULK_PAYOUT_H
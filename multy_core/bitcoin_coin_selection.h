@@ -0,0 +1,87 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_BITCOIN_COIN_SELECTION_H
+#define MULTY_CORE_BITCOIN_COIN_SELECTION_H
+
+#include "multy_core/api.h"
+#include "multy_core/bitcoin.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Error;
+
+enum BitcoinCoinSelectionStrategy
+{
+    /// Look for a set of outputs that needs no change, fall back to KNAPSACK.
+    BITCOIN_COIN_SELECTION_BRANCH_AND_BOUND = 0,
+    /// Randomized (with fixed seed) approximation of the smallest sufficient set.
+    BITCOIN_COIN_SELECTION_KNAPSACK = 1,
+    /// Spend the biggest outputs first, produces fewest inputs.
+    BITCOIN_COIN_SELECTION_LARGEST_FIRST = 2,
+};
+
+/** Candidate output to spend.
+ *
+ * Outputs are referred to by their index in the pool, so the outpoint
+ * (previous transaction hash and output index) is not needed here.
+ */
+struct BitcoinUnspentOutput
+{
+    uint64_t amount; // in satoshi
+    /// Type of the address output belongs to, either
+    /// BITCOIN_ADDRESS_P2PKH or BITCOIN_ADDRESS_P2SH_P2WPKH.
+    enum BitcoinAddressType address_type;
+};
+
+struct BitcoinCoinSelectionTarget
+{
+    uint64_t amount; // in satoshi
+    enum BitcoinAddressType address_type;
+};
+
+/** Select outputs from the pool to pay given targets and a transaction fee.
+ *
+ * Fee is estimated with the worst-case signature size of each input, so it is
+ * never less than the fee of signed transaction. Change that is too small to be
+ * spent economically (dust) is added to the fee.
+ *
+ * @param pool - candidate outputs, pool_size items;
+ * @param targets - transaction destinations (except change), targets_count items;
+ * @param fee_per_byte - fee rate in satoshi per (virtual) byte;
+ * @param change_address_type - type of the address for the change output;
+ * @param strategy - how outputs are selected;
+ * @param out_selected - indices of selected outputs in the pool, in ascending order,
+ *      must have room for pool_size items;
+ * @param out_selected_count - number of items written to out_selected;
+ * @param out_change_amount - change in satoshi, 0 if no change output is needed;
+ * @param out_fee - estimated fee of the transaction in satoshi.
+ * @return Error with ERROR_TRANSACTION_INSUFFICIENT_FUNDS if pool can't
+ *      cover all targets and a fee.
+ */
+MULTY_CORE_API struct Error* bitcoin_select_coins(
+        const struct BitcoinUnspentOutput* pool,
+        size_t pool_size,
+        const struct BitcoinCoinSelectionTarget* targets,
+        size_t targets_count,
+        uint64_t fee_per_byte,
+        enum BitcoinAddressType change_address_type,
+        enum BitcoinCoinSelectionStrategy strategy,
+        size_t* out_selected,
+        size_t* out_selected_count,
+        uint64_t* out_change_amount,
+        uint64_t* out_fee);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // MULTY_CORE_BITCOIN_COIN_SELECTION_H
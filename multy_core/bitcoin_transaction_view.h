@@ -0,0 +1,70 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_BITCOIN_TRANSACTION_VIEW_H
+#define MULTY_CORE_BITCOIN_TRANSACTION_VIEW_H
+
+#include "multy_core/api.h"
+#include "multy_core/binary_data.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Error;
+
+#define BITCOIN_TRANSACTION_ID_SIZE 32
+
+/// Summary of the serialized transaction.
+struct BitcoinTransactionInfo
+{
+    int32_t version;
+    uint32_t lock_time;
+    bool is_segwit;
+    size_t inputs_count;
+    size_t outputs_count;
+    size_t size; // in bytes
+    size_t virtual_size; // BIP141 virtual size, rounded up.
+    /// As serialized, i.e. in reverse order to the txid as it is displayed.
+    unsigned char txid[BITCOIN_TRANSACTION_ID_SIZE];
+    /// Same as txid for non-segwit transactions.
+    unsigned char wtxid[BITCOIN_TRANSACTION_ID_SIZE];
+};
+
+struct BitcoinTransactionOutputInfo
+{
+    uint64_t amount; // in satoshi
+    /// Points into the serialized transaction, nothing is copied.
+    struct BinaryData script_pubkey;
+};
+
+/** Parse serialized Bitcoin transaction (with or without BIP144 witness data).
+ *
+ * Call with out_outputs set to null to get the number of outputs first.
+ * @param serialized_transaction - transaction to parse;
+ * @param out_info - transaction summary;
+ * @param out_outputs - can be null, otherwise must have room for
+ *      outputs_capacity items, first min(outputs_count, outputs_capacity)
+ *      outputs are written;
+ * @param outputs_capacity - number of items in out_outputs.
+ * @return Error with ERROR_INVALID_ARGUMENT if data is not a valid
+ *      serialized transaction.
+ */
+MULTY_CORE_API struct Error* bitcoin_parse_transaction(
+        const struct BinaryData* serialized_transaction,
+        struct BitcoinTransactionInfo* out_info,
+        struct BitcoinTransactionOutputInfo* out_outputs,
+        size_t outputs_capacity);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // MULTY_CORE_BITCOIN_TRANSACTION_VIEW_H
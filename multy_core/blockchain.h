@@ -9,6 +9,7 @@
 
 #include "multy_core/api.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -42,6 +43,22 @@ MULTY_CORE_API struct Error* validate_address(
         struct BlockchainType blockchain,
         const char* address);
 
+/** Validate many addresses for given blockchain at once.
+ *  Faster than calling validate_address() for each address,
+ *  but does not tell why address is invalid.
+ *  @param blockchain_type - Blockchain to use addresses for.
+ *  @param addresses - addresses_count addresses, null ones are considered invalid.
+ *  @param addresses_count - number of addresses.
+ *  @param out_is_valid - addresses_count items, each one is set to true
+ *      if corresponding address is valid, and to false otherwise.
+ *  @return null ptr on success, Error if arguments are invalid.
+ */
+MULTY_CORE_API struct Error* validate_addresses(
+        struct BlockchainType blockchain,
+        const char* const* addresses,
+        size_t addresses_count,
+        bool* out_is_valid);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -47,6 +47,17 @@ MULTY_CORE_API struct Error* get_version(struct Version* version);
  */
 MULTY_CORE_API struct Error* make_version_string(const char** out_version_string);
 
+/** Initializes the library ahead of time, optional.
+ *
+ * Builds the secp256k1 context (signing and verification tables), which is
+ * otherwise built on the first operation with keys, so that the first
+ * signature or key derivation is as fast as the following ones.
+ * Building the context is not thread-safe, so call this before using keys
+ * from several threads. Can be called more than once.
+ * @return Error on error, nullptr otherwise.
+ */
+MULTY_CORE_API struct Error* multy_core_init(void);
+
 /** Frees a string, can take null. **/
 MULTY_CORE_API void free_string(const char* str);
 
@@ -7,10 +7,19 @@
 #ifndef MULTY_CORE_ETHEREUM_H
 #define MULTY_CORE_ETHEREUM_H
 
+#include "multy_core/api.h"
+#include "multy_core/binary_data.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct BigInt;
+struct Error;
+
 enum EthereumChainId
 {
     // Default chain id value from Ethereum sources.
@@ -28,6 +37,62 @@ enum EthereumChainId
     ETHEREUM_CHAIN_ID_ETC_TESTNET = 62, //	Ethereum Classic testnet
 };
 
+#define ETHEREUM_ADDRESS_BINARY_SIZE 20
+#define ETHEREUM_TRANSACTION_HASH_SIZE 32
+
+/// Fields of the signed transaction.
+struct EthereumTransactionInfo
+{
+    /// Must be created by the caller (see make_big_int()),
+    /// values are set on success. Any of those can be null to skip the value.
+    struct BigInt* nonce;
+    struct BigInt* gas_price;
+    struct BigInt* gas_limit;
+    struct BigInt* value;
+    /// Point into the serialized transaction, nothing is copied.
+    /// destination is empty for contract creation transaction.
+    struct BinaryData destination;
+    struct BinaryData data;
+    /// 0 for pre-EIP-155 signature.
+    uint64_t chain_id;
+    /// Binary address of the sender, recovered from the signature.
+    unsigned char sender[ETHEREUM_ADDRESS_BINARY_SIZE];
+    /// Transaction hash, as used by the block explorers.
+    unsigned char hash[ETHEREUM_TRANSACTION_HASH_SIZE];
+};
+
+/** Parse serialized signed Ethereum transaction and recover the sender.
+ *
+ * Both pre-EIP-155 and EIP-155 signatures are supported, signatures with high
+ * s value are rejected (EIP-2).
+ * @param serialized_transaction - RLP-encoded signed transaction;
+ * @param info - transaction fields, see EthereumTransactionInfo.
+ * @return Error with ERROR_INVALID_ARGUMENT if data is not a valid signed
+ *      transaction or sender can't be recovered from the signature.
+ */
+MULTY_CORE_API struct Error* ethereum_parse_signed_transaction(
+        const struct BinaryData* serialized_transaction,
+        struct EthereumTransactionInfo* info);
+
+/** Encode contract function call with Solidity ABI, i.e. data of a transaction.
+ *
+ * @param signature - function name and argument types, like
+ *      "transfer(address,uint256)", "uint" and "int" aliases are allowed;
+ * @param arguments - arguments_count values as text, see
+ *      EthereumAbiFunction::encode_call_from_text() for format of each type:
+ *      integers in decimal, addresses and bytes as hex, arrays as "[a,b]",
+ *      tuples as "(a,b)";
+ * @param arguments_count - number of arguments;
+ * @param out_call - selector and encoded arguments.
+ * @return Error with ERROR_INVALID_ARGUMENT if signature is invalid or
+ *      arguments don't match it.
+ */
+MULTY_CORE_API struct Error* ethereum_encode_contract_call(
+        const char* signature,
+        const char* const* arguments,
+        size_t arguments_count,
+        struct BinaryData** out_call);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
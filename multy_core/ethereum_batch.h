@@ -0,0 +1,73 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_ETHEREUM_BATCH_H
+#define MULTY_CORE_ETHEREUM_BATCH_H
+
+#include "multy_core/api.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Account;
+struct BigInt;
+struct BinaryData;
+struct Error;
+
+/// Single transfer of the batch, becomes a separate transaction.
+struct EthereumTransfer
+{
+    /// Receiver of Ether or tokens.
+    const char* address;
+    /// Amount in wei, or amount of tokens if token_transfer is set.
+    const struct BigInt* amount;
+    /// Optional, same format as "token_transfer" transaction property,
+    /// e.g. "ERC20:<contract address>:transfer". Null for Ether transfer.
+    const char* token_transfer;
+};
+
+/** Make signed transactions for many transfers from the same account at once.
+ *
+ * Transactions get consecutive nonces, starting with first_nonce, and all share
+ * the same gas price and gas limit. Private key is obtained and every distinct
+ * token_transfer is parsed only once per call.
+ *
+ * Unlike regular transactions, balance of the account is not checked, it is up
+ * to the caller to make sure there are enough funds.
+ *
+ * Either all transactions are made or none is, if any of transfers is invalid.
+ *
+ * @param account - Ethereum account to sign transactions with;
+ * @param first_nonce - nonce of the first transaction;
+ * @param gas_price - gas price of each transaction, in wei;
+ * @param gas_limit - gas limit of each transaction;
+ * @param transfers - transfers_count items;
+ * @param transfers_count - number of transfers;
+ * @param threads_count - number of threads to sign transactions with,
+ *      0 to use all available cores, 1 to sign only on the calling thread;
+ * @param out_transactions - serialized signed transactions, in same order as
+ *      transfers, must have room for transfers_count items,
+ *      each one has to be freed with free_binarydata().
+ * @return Error with ERROR_INVALID_ADDRESS if any address is invalid.
+ */
+MULTY_CORE_API struct Error* ethereum_make_signed_transactions(
+        const struct Account* account,
+        const struct BigInt* first_nonce,
+        const struct BigInt* gas_price,
+        const struct BigInt* gas_limit,
+        const struct EthereumTransfer* transfers,
+        size_t transfers_count,
+        size_t threads_count,
+        struct BinaryData** out_transactions);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif // MULTY_CORE_ETHEREUM_BATCH_H
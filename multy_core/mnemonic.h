@@ -38,6 +38,21 @@ MULTY_CORE_API struct Error* make_mnemonic(
 MULTY_CORE_API struct Error* make_seed(
         const char* mnemonic, const char* password, struct BinaryData** seed);
 
+/** Generates seeds for many mnemonics at once, same as calling make_seed()
+ * for each of them, but seeds are computed on several threads.
+ * @param mnemonics - array of count mnemonics.
+ * @param passwords - array of count passwords, any of those can be null;
+ *      can be null if none of mnemonics has a password.
+ * @param count - number of mnemonics.
+ * @param [out]seeds - array of count seeds, each must be freed with
+ *      free_binarydata(). Either all seeds are set, or none if error occurs.
+ */
+MULTY_CORE_API struct Error* make_seeds(
+        const char* const* mnemonics,
+        const char* const* passwords,
+        size_t count,
+        struct BinaryData** seeds);
+
 MULTY_CORE_API struct Error* seed_to_string(
         const struct BinaryData* seed, const char** str);
 
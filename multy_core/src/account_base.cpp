@@ -7,9 +7,15 @@
 #include "multy_core/src/account_base.h"
 
 #include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
 #include "multy_core/src/api/key_impl.h"
 #include "multy_core/src/utility.h"
 
+#include "wally_crypto.h"
+
+#include <algorithm>
+#include <functional>
+
 namespace
 {
 using namespace multy_core::internal;
@@ -32,6 +38,66 @@ static_assert(
         BIP44_TESTNET_CHAIN_CODE == 0x80000001,
         "invalid hardened index derivation function implementation");
 
+// Addresses are derived in batches, so that hashing can be done in parallel
+// and memory for public keys is bounded.
+const size_t DERIVE_ADDRESSES_BATCH_SIZE = 256;
+// Ranges smaller than that are not worth starting a thread.
+const size_t MIN_ADDRESSES_PER_THREAD = 4 * DERIVE_ADDRESSES_BATCH_SIZE;
+
+size_t get_address_public_key_size(PublicKeyFormat format)
+{
+    return format == EC_PUBLIC_KEY_COMPRESSED
+            ? EC_PUBLIC_KEY_LEN : EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+}
+
+// Leaf of the watch-only HD account, there is no private key.
+class WatchOnlyAccount : public Account
+{
+public:
+    WatchOnlyAccount(BlockchainType blockchain_type,
+            HDPath path,
+            std::string address,
+            PublicKeyPtr public_key)
+        : m_blockchain_type(blockchain_type),
+          m_path(std::move(path)),
+          m_address(std::move(address)),
+          m_public_key(std::move(public_key))
+    {
+    }
+
+    HDPath get_path() const override
+    {
+        return m_path;
+    }
+
+    BlockchainType get_blockchain_type() const override
+    {
+        return m_blockchain_type;
+    }
+
+    std::string get_address() const override
+    {
+        return m_address;
+    }
+
+    PrivateKeyPtr get_private_key() const override
+    {
+        THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+                "Watch-only account has no private key.");
+    }
+
+    PublicKeyPtr get_public_key() const override
+    {
+        return m_public_key->clone();
+    }
+
+private:
+    const BlockchainType m_blockchain_type;
+    const HDPath m_path;
+    const std::string m_address;
+    const PublicKeyPtr m_public_key;
+};
+
 } // namepace
 
 namespace multy_core
@@ -79,7 +145,8 @@ HDAccountBase::HDAccountBase(
         uint32_t index)
     : m_blockchain_type(blockchain_type),
       m_account_key(),
-      m_bip44_path(BIP44_ACCOUNT_PATH_DEPTH)
+      m_bip44_path(BIP44_ACCOUNT_PATH_DEPTH),
+      m_chain_keys()
 {
     // BIP44 derive account key:
     // master key -> blockchain key -> account key.
@@ -105,10 +172,43 @@ HDAccountBase::HDAccountBase(
     m_bip44_path[BIP44_ACCOUNT] = account_index;
 }
 
+HDAccountBase::HDAccountBase(
+        BlockchainType blockchain_type,
+        uint32_t chain_index,
+        const ExtendedKey& account_public_key)
+    : m_blockchain_type(blockchain_type),
+      m_account_key(make_clone(account_public_key)),
+      m_bip44_path(BIP44_ACCOUNT_PATH_DEPTH),
+      m_chain_keys()
+{
+    if (account_public_key.is_private())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Watch-only HD account must be made from a public key.");
+    }
+    if (account_public_key.key.depth != BIP44_ACCOUNT_PATH_DEPTH
+            || account_public_key.key.child_num < HARDENED_INDEX_BASE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Key is not a BIP44 account key.")
+                << " Depth: " << static_cast<uint32_t>(account_public_key.key.depth)
+                << ", child number: " << account_public_key.key.child_num;
+    }
+
+    m_bip44_path[BIP44_PURPOSE] = BIP44_PURPOSE_CHAIN_CODE;
+    m_bip44_path[BIP44_COIN_TYPE] = hardened_index(chain_index);
+    m_bip44_path[BIP44_ACCOUNT] = account_public_key.key.child_num;
+}
+
 HDAccountBase::~HDAccountBase()
 {
 }
 
+bool HDAccountBase::is_watch_only() const
+{
+    return !m_account_key->is_private();
+}
+
 HDPath HDAccountBase::get_path() const
 {
     return m_bip44_path;
@@ -124,16 +224,138 @@ ExtendedKeyPtr HDAccountBase::get_account_key() const
     return make_clone(*m_account_key);
 }
 
+const ExtendedKey& HDAccountBase::get_chain_key(AddressType type) const
+{
+    INVARIANT(static_cast<size_t>(type) < m_chain_keys.size());
+
+    return m_chain_keys[type].get([this, type]()
+    {
+        return *make_child_key(*m_account_key, static_cast<uint32_t>(type));
+    });
+}
+
+HDPath HDAccountBase::make_leaf_path(AddressType type, uint32_t index) const
+{
+    HDPath result;
+    result.reserve(m_bip44_path.size() + 2);
+    result.assign(m_bip44_path.begin(), m_bip44_path.end());
+    result.push_back(static_cast<uint32_t>(type));
+    result.push_back(index);
+
+    return result;
+}
+
 AccountPtr HDAccountBase::make_leaf_account(
         AddressType type, uint32_t index) const
 {
-    ExtendedKeyPtr key_ptr;
-    throw_if_error(
-            make_child_key(
-                    m_account_key.get(), static_cast<uint32_t>(type),
-                    reset_sp(key_ptr)));
+    if (!is_watch_only())
+    {
+        return make_account(get_chain_key(type), type, index);
+    }
+
+    unsigned char public_key[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    const PublicKeyFormat format = get_address_public_key_format();
+    derive_child_public_keys(get_chain_key(type), index, 1, format, public_key);
+
+    std::string address;
+    make_addresses(public_key, 1, &address);
+
+    return AccountPtr(new WatchOnlyAccount(
+            get_blockchain_type(),
+            make_leaf_path(type, index),
+            std::move(address),
+            make_leaf_public_key(public_key)));
+}
+
+std::vector<std::string> HDAccountBase::derive_addresses(
+        AddressType type, uint32_t first_index, size_t count) const
+{
+    std::vector<std::string> result(count);
+    derive_leaves(type, first_index, count,
+            [this, &result](const unsigned char* public_keys,
+                    size_t offset, size_t batch_size)
+            {
+                make_addresses(public_keys, batch_size, &result[offset]);
+            });
+
+    return result;
+}
+
+void HDAccountBase::derive_address_hashes(AddressType type,
+        uint32_t first_index, size_t count, unsigned char* out_hashes) const
+{
+    INVARIANT(out_hashes != nullptr || count == 0);
+
+    derive_leaves(type, first_index, count,
+            [this, out_hashes](const unsigned char* public_keys,
+                    size_t offset, size_t batch_size)
+            {
+                make_address_hashes(public_keys, batch_size,
+                        out_hashes + offset * ADDRESS_HASH_SIZE);
+            });
+}
 
-    return  make_account(*key_ptr, type, index);
+void HDAccountBase::derive_leaves(AddressType type,
+        uint32_t first_index, size_t count,
+        const std::function<void(const unsigned char*, size_t, size_t)>& process_keys) const
+{
+    if (first_index >= HARDENED_INDEX_BASE
+            || count > HARDENED_INDEX_BASE - first_index)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Leaf index is out of range.")
+                << " First index: " << first_index << ", count: " << count;
+    }
+
+    // Deriving chain key also creates secp256k1 context (if it wasn't yet),
+    // which is not thread-safe, but must be done before starting any threads.
+    const ExtendedKey& chain_key = get_chain_key(type);
+    const PublicKeyFormat format = get_address_public_key_format();
+    const size_t key_size = get_address_public_key_size(format);
+
+    auto derive_range = [&](size_t begin, size_t end)
+    {
+        std::vector<unsigned char> public_keys(DERIVE_ADDRESSES_BATCH_SIZE * key_size);
+        for (size_t i = begin; i < end; i += DERIVE_ADDRESSES_BATCH_SIZE)
+        {
+            const size_t batch_size = std::min(DERIVE_ADDRESSES_BATCH_SIZE, end - i);
+            derive_child_public_keys(chain_key,
+                    first_index + static_cast<uint32_t>(i), batch_size,
+                    format, public_keys.data());
+            process_keys(public_keys.data(), i, batch_size);
+        }
+    };
+
+    parallel_for(count, MIN_ADDRESSES_PER_THREAD, derive_range);
+}
+
+PublicKeyPtr HDAccountBase::make_leaf_public_key(
+        const unsigned char* /*public_key*/) const
+{
+    THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+            "Watch-only accounts are not supported for this blockchain.")
+            << " Blockchain: " << to_string(get_blockchain_type());
+}
+
+PublicKeyFormat HDAccountBase::get_address_public_key_format() const
+{
+    return EC_PUBLIC_KEY_COMPRESSED;
+}
+
+void HDAccountBase::make_addresses(const unsigned char* /*public_keys*/,
+        size_t /*count*/, std::string* /*out_addresses*/) const
+{
+    THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+            "Can't make addresses from public keys for this blockchain.")
+            << " Blockchain: " << to_string(get_blockchain_type());
+}
+
+void HDAccountBase::make_address_hashes(const unsigned char* /*public_keys*/,
+        size_t /*count*/, unsigned char* /*out_hashes*/) const
+{
+    THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+            "Can't make address hashes from public keys for this blockchain.")
+            << " Blockchain: " << to_string(get_blockchain_type());
 }
 
 } // namespace multy_core
@@ -12,12 +12,17 @@
 #include "multy_core/key.h"
 
 #include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/cached_value.h"
+#include "multy_core/src/ec_key_utils.h"
 #include "multy_core/src/u_ptr.h"
 #include "multy_core/src/hd_path.h"
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <stddef.h>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -52,7 +57,12 @@ private:
     const PrivateKey& m_private_key_ref;
 };
 
-// Base class for coin-specific HD accounts.
+/** Base class for coin-specific HD accounts.
+ *
+ * Watch-only HD account is made from the public account key, it derives
+ * leaves with public derivation only. Leaf accounts of watch-only HD account
+ * have addresses and public keys, but no private keys.
+ */
 struct HDAccountBase : public HDAccount
 {
 public:
@@ -60,8 +70,18 @@ public:
 
     virtual ~HDAccountBase();
 
+    bool is_watch_only() const;
+
     AccountPtr make_leaf_account(AddressType type, uint32_t index) const override;
 
+    /** Derives public keys of leaves from the chain key, and makes addresses
+     * from those with make_addresses(). Large ranges are split between threads.
+     */
+    std::vector<std::string> derive_addresses(
+            AddressType type, uint32_t first_index, size_t count) const override;
+    void derive_address_hashes(AddressType type, uint32_t first_index,
+            size_t count, unsigned char* out_hashes) const override;
+
 protected:
     HDAccountBase(
             BlockchainType blockchain_type,
@@ -69,19 +89,76 @@ protected:
             const ExtendedKey& bip44_master_key,
             uint32_t index);
 
+    /** Makes watch-only account.
+     * @param account_public_key - public key of the BIP44 account:
+     *        m/44'/coin'/account', as given by get_account_key().
+     * @throw Exception if key is private or is not an account key.
+     */
+    HDAccountBase(
+            BlockchainType blockchain_type,
+            uint32_t chain_index,
+            const ExtendedKey& account_public_key);
+
     HDPath get_path() const override;
     BlockchainType get_blockchain_type() const override;
     ExtendedKeyPtr get_account_key() const override;
 
+    /** Makes leaf account.
+     * @param parent_key - key of the chain, see get_chain_key().
+     */
     virtual AccountPtr make_account(
             const ExtendedKey& parent_key,
             AddressType type,
             uint32_t index) const = 0;
 
+    /// Format of public keys passed to make_addresses().
+    virtual PublicKeyFormat get_address_public_key_format() const;
+
+    /** Makes addresses of leaves from their public keys, used by derive_addresses().
+     *
+     * Must be safe to call concurrently.
+     * Default implementation throws ERROR_FEATURE_NOT_SUPPORTED.
+     * @param public_keys - count keys, one after another, in
+     *        get_address_public_key_format() format.
+     * @param out_addresses - count addresses.
+     */
+    virtual void make_addresses(const unsigned char* public_keys, size_t count,
+            std::string* out_addresses) const;
+
+    /** Same as make_addresses(), but makes ADDRESS_HASH_SIZE-byte address hashes.
+     *  Default implementation throws ERROR_FEATURE_NOT_SUPPORTED.
+     */
+    virtual void make_address_hashes(const unsigned char* public_keys, size_t count,
+            unsigned char* out_hashes) const;
+
+    /** Makes public key of the leaf of watch-only account.
+     *
+     * Default implementation throws ERROR_FEATURE_NOT_SUPPORTED.
+     * @param public_key - key in get_address_public_key_format() format.
+     */
+    virtual PublicKeyPtr make_leaf_public_key(const unsigned char* public_key) const;
+
+    /// Key of the external or internal chain: m/44'/coin'/account'/type.
+    const ExtendedKey& get_chain_key(AddressType type) const;
+    /// Path of the leaf: m/44'/coin'/account'/type/index.
+    HDPath make_leaf_path(AddressType type, uint32_t index) const;
+
+private:
+    /** Derives public keys of leaves in batches, possibly on several threads.
+     * @param process_keys - called with public keys of each batch,
+     *        index of the first key of the batch relative to first_index
+     *        and number of keys in the batch, must be safe to call concurrently.
+     */
+    void derive_leaves(AddressType type, uint32_t first_index, size_t count,
+            const std::function<void(const unsigned char*, size_t, size_t)>& process_keys) const;
+
 private:
     const BlockchainType m_blockchain_type;
     ExtendedKeyPtr m_account_key;
     HDPath m_bip44_path;
+    // Chain keys are derived on first use, indexed by AddressType,
+    // so each leaf takes a single derivation step.
+    std::array<CachedValue<ExtendedKey>, ADDRESS_INTERNAL + 1> m_chain_keys;
 };
 
 } // namespace multy_core
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -47,6 +48,50 @@ Error* make_hd_account(
     return nullptr;
 }
 
+Error* make_watch_only_hd_account(
+        const char* serialized_account_public_key,
+        BlockchainType blockchain_type,
+        uint32_t account_type,
+        HDAccount** new_account)
+{
+    ARG_CHECK(serialized_account_public_key != nullptr);
+    ARG_CHECK(new_account != nullptr);
+
+    try
+    {
+        const ExtendedKeyPtr account_key = make_extended_key(
+                serialized_account_public_key);
+        *new_account = get_blockchain(blockchain_type.blockchain)
+                .make_watch_only_hd_account(blockchain_type, account_type,
+                        *account_key).release();
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    OUT_CHECK_OBJECT(*new_account);
+
+    return nullptr;
+}
+
+Error* hd_account_get_public_key_string(
+        const HDAccount* base_account,
+        const char** out_serialized_public_key)
+{
+    ARG_CHECK_OBJECT(base_account);
+    ARG_CHECK(out_serialized_public_key != nullptr);
+
+    try
+    {
+        const ExtendedKeyPtr account_key = base_account->get_account_key();
+        *out_serialized_public_key = copy_string(
+                make_public_extended_key(*account_key)->to_string());
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    OUT_CHECK(*out_serialized_public_key);
+
+    return nullptr;
+}
+
 Error* make_hd_leaf_account(
         const HDAccount* base_account,
         AddressType address_type,
@@ -71,6 +116,43 @@ Error* make_hd_leaf_account(
     return nullptr;
 }
 
+Error* hd_account_derive_addresses(
+        const HDAccount* base_account,
+        AddressType address_type,
+        uint32_t first_index,
+        size_t count,
+        const char** out_addresses)
+{
+    ARG_CHECK_OBJECT(base_account);
+    ARG_CHECK(address_type == ADDRESS_INTERNAL
+            || address_type == ADDRESS_EXTERNAL);
+    ARG_CHECK(first_index < HARDENED_INDEX_BASE);
+    ARG_CHECK(count <= HARDENED_INDEX_BASE - first_index);
+    ARG_CHECK(out_addresses || count == 0);
+
+    try
+    {
+        const std::vector<std::string> addresses
+                = base_account->derive_addresses(address_type, first_index, count);
+        INVARIANT(addresses.size() == count);
+
+        // Either all addresses are passed to the caller, or none.
+        std::vector<ConstCharPtr> result;
+        result.reserve(count);
+        for (const std::string& address : addresses)
+        {
+            result.emplace_back(copy_string(address));
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            out_addresses[i] = result[i].release();
+        }
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    return nullptr;
+}
+
 Error* make_account(
         BlockchainType blockchain,
         uint32_t account_type,
@@ -27,3 +27,17 @@ const void* HDAccount::get_object_magic()
 {
     RETURN_MAGIC();
 }
+
+std::vector<std::string> HDAccount::derive_addresses(
+        AddressType type, uint32_t first_index, size_t count) const
+{
+    std::vector<std::string> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.push_back(make_leaf_account(
+                type, first_index + static_cast<uint32_t>(i))->get_address());
+    }
+
+    return result;
+}
@@ -15,6 +15,18 @@
 #include "multy_core/src/hd_path.h"
 #include "multy_core/src/u_ptr.h"
 
+#include <string>
+#include <vector>
+
+namespace multy_core
+{
+namespace internal
+{
+// Size of the hash encoded in the address, see HDAccount::derive_address_hashes().
+const size_t ADDRESS_HASH_SIZE = 20;
+} // namespace internal
+} // namespace multy_core
+
 // Declared a struct (and out of multy_core::internal namespace)
 // for consitency with a C-like interface.
 // Exported only to make testing easier.
@@ -55,6 +67,25 @@ public:
     virtual AccountPtr make_leaf_account(AddressType type, uint32_t index) const = 0;
     virtual ExtendedKeyPtr get_account_key() const = 0;
 
+    /** Addresses of leaf accounts with indices [first_index, first_index + count).
+     *
+     * Same as make_leaf_account(type, index)->get_address() for each index,
+     * which is what default implementation does, but may be much faster.
+     */
+    virtual std::vector<std::string> derive_addresses(
+            AddressType type, uint32_t first_index, size_t count) const;
+
+    /** Hashes encoded in addresses of leaf accounts, ADDRESS_HASH_SIZE bytes each:
+     * HASH160 of the public key (P2PKH) or of the script (P2SH) for Bitcoin,
+     * address itself for Ethereum.
+     *
+     * @param out_hashes - count hashes, one after another.
+     * @throw Exception with ERROR_FEATURE_NOT_SUPPORTED if blockchain has no
+     *      address hashes.
+     */
+    virtual void derive_address_hashes(AddressType type, uint32_t first_index,
+            size_t count, unsigned char* out_hashes) const = 0;
+
     static const void* get_object_magic();
 };
 
@@ -0,0 +1,133 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/address_index.h"
+
+#include "multy_core/binary_data.h"
+#include "multy_core/error.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/address_index_impl.h"
+#include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/utility.h"
+
+namespace
+{
+using namespace multy_core::internal;
+} // namespace
+
+Error* make_address_index(AddressIndex** new_index)
+{
+    ARG_CHECK(new_index != nullptr);
+
+    try
+    {
+        *new_index = new AddressIndex();
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    OUT_CHECK_OBJECT(*new_index);
+
+    return nullptr;
+}
+
+Error* make_address_index_from_file(const char* file_path, AddressIndex** new_index)
+{
+    ARG_CHECK(file_path != nullptr);
+    ARG_CHECK(new_index != nullptr);
+
+    try
+    {
+        *new_index = new AddressIndex(file_path);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    OUT_CHECK_OBJECT(*new_index);
+
+    return nullptr;
+}
+
+Error* address_index_add_hd_account_addresses(
+        AddressIndex* index,
+        uint32_t account_id,
+        const HDAccount* hd_account,
+        AddressType address_type,
+        uint32_t first_index,
+        size_t count)
+{
+    ARG_CHECK_OBJECT(index);
+    ARG_CHECK(account_id != AddressIndex::EMPTY_ACCOUNT_ID);
+    ARG_CHECK_OBJECT(hd_account);
+    ARG_CHECK(address_type == ADDRESS_INTERNAL
+            || address_type == ADDRESS_EXTERNAL);
+    ARG_CHECK(first_index < HARDENED_INDEX_BASE);
+    ARG_CHECK(count <= HARDENED_INDEX_BASE - first_index);
+
+    try
+    {
+        index->add_hd_account_addresses(account_id, *hd_account, address_type,
+                first_index, count);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    return nullptr;
+}
+
+Error* address_index_find(
+        const AddressIndex* index,
+        const BinaryData* address_hash,
+        bool* out_found,
+        AddressIndexLeaf* out_leaf)
+{
+    ARG_CHECK_OBJECT(index);
+    ARG_CHECK(address_hash != nullptr);
+    ARG_CHECK(address_hash->data != nullptr);
+    ARG_CHECK(address_hash->len == ADDRESS_HASH_SIZE);
+    ARG_CHECK(out_found != nullptr);
+    ARG_CHECK(out_leaf != nullptr);
+
+    try
+    {
+        *out_found = index->find(address_hash->data, out_leaf);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    return nullptr;
+}
+
+Error* address_index_get_size(const AddressIndex* index, size_t* out_size)
+{
+    ARG_CHECK_OBJECT(index);
+    ARG_CHECK(out_size != nullptr);
+
+    try
+    {
+        *out_size = index->size();
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    return nullptr;
+}
+
+Error* address_index_save(const AddressIndex* index, const char* file_path)
+{
+    ARG_CHECK_OBJECT(index);
+    ARG_CHECK(file_path != nullptr);
+
+    try
+    {
+        index->save(file_path);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_ACCOUNT);
+
+    return nullptr;
+}
+
+void free_address_index(AddressIndex* index)
+{
+    CHECK_OBJECT_BEFORE_FREE(index);
+    delete index;
+}
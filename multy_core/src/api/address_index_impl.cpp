@@ -0,0 +1,448 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/api/address_index_impl.h"
+
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+using namespace multy_core::internal;
+
+const uint32_t LEAF_ADDRESS_TYPE_BIT = 0x80000000;
+const size_t MIN_CAPACITY = 64;
+
+const char FILE_MAGIC[8] = {'M', 'L', 'T', 'Y', 'A', 'I', 'D', 'X'};
+// Written as is, so reads as a different value on a machine with other byte order.
+const uint32_t FILE_BYTE_ORDER_MARK = 0x01020304;
+const uint32_t FILE_VERSION = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t byte_order_mark;
+    uint32_t version;
+    uint32_t entry_size;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t size;
+};
+static_assert(sizeof(FileHeader) == 40, "FileHeader must have no padding.");
+
+size_t get_slot(const unsigned char* address_hash, size_t mask)
+{
+    // Address hashes are uniformly distributed, no need to hash those again.
+    uint64_t value;
+    memcpy(&value, address_hash, sizeof(value));
+
+    return static_cast<size_t>(value) & mask;
+}
+
+void validate_leaf(const AddressIndexLeaf& leaf)
+{
+    if (leaf.account_id == AddressIndex::EMPTY_ACCOUNT_ID
+            || (leaf.address_type != ADDRESS_EXTERNAL
+                    && leaf.address_type != ADDRESS_INTERNAL)
+            || (leaf.index & LEAF_ADDRESS_TYPE_BIT) != 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid address index leaf.")
+                << " Account id: " << leaf.account_id
+                << ", address type: " << leaf.address_type
+                << ", index: " << leaf.index;
+    }
+}
+
+[[noreturn]] void throw_file_error(const char* message, const char* file_path)
+{
+    const int error = errno;
+    THROW_EXCEPTION2(ERROR_GENERAL_ERROR, message)
+            << " Path: \"" << file_path << "\", error: " << strerror(error);
+}
+
+} // namespace
+
+#if !defined(_WIN32)
+
+class AddressIndex::MappedFile
+{
+public:
+    explicit MappedFile(const char* file_path)
+        : m_data(nullptr),
+          m_size(0)
+    {
+        const int fd = open(file_path, O_RDONLY);
+        if (fd < 0)
+        {
+            throw_file_error("Failed to open address index file.", file_path);
+        }
+
+        struct stat file_stat;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            m_size = static_cast<size_t>(file_stat.st_size);
+            data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        // Mapping stays valid after file is closed.
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            throw_file_error("Failed to map address index file.", file_path);
+        }
+        m_data = static_cast<const unsigned char*>(data);
+    }
+
+    ~MappedFile()
+    {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+
+    const unsigned char* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+};
+
+#else
+
+// No mmap(), whole file is read into memory instead.
+class AddressIndex::MappedFile
+{
+public:
+    explicit MappedFile(const char* file_path)
+        : m_data()
+    {
+        std::unique_ptr<FILE, int (*)(FILE*)> file(
+                fopen(file_path, "rb"), &fclose);
+        if (!file)
+        {
+            throw_file_error("Failed to open address index file.", file_path);
+        }
+
+        unsigned char buffer[64 * 1024];
+        size_t read_size = 0;
+        while ((read_size = fread(buffer, 1, sizeof(buffer), file.get())) > 0)
+        {
+            m_data.insert(m_data.end(), buffer, buffer + read_size);
+        }
+        if (ferror(file.get()))
+        {
+            throw_file_error("Failed to read address index file.", file_path);
+        }
+    }
+
+    const unsigned char* data() const
+    {
+        return m_data.data();
+    }
+
+    size_t size() const
+    {
+        return m_data.size();
+    }
+
+private:
+    // Allocated memory is aligned for any type, just like the mapping.
+    std::vector<unsigned char> m_data;
+};
+
+#endif
+
+const uint32_t AddressIndex::EMPTY_ACCOUNT_ID;
+
+AddressIndex::AddressIndex()
+    : m_entries(),
+      m_file(),
+      m_table(nullptr),
+      m_capacity(0),
+      m_size(0)
+{
+}
+
+AddressIndex::AddressIndex(const char* file_path)
+    : AddressIndex()
+{
+    INVARIANT(file_path != nullptr);
+
+    m_file.reset(new MappedFile(file_path));
+    const unsigned char* data = m_file->data();
+    const size_t data_size = m_file->size();
+
+    FileHeader header;
+    bool is_valid = data_size >= sizeof(header);
+    if (is_valid)
+    {
+        memcpy(&header, data, sizeof(header));
+        const uint64_t max_capacity = (data_size - sizeof(header)) / sizeof(Entry);
+        is_valid = memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+                && header.byte_order_mark == FILE_BYTE_ORDER_MARK
+                && header.version == FILE_VERSION
+                && header.entry_size == sizeof(Entry)
+                && header.capacity <= max_capacity
+                && data_size == sizeof(header) + header.capacity * sizeof(Entry)
+                && (header.capacity & (header.capacity - 1)) == 0
+                && header.size * 2 <= header.capacity;
+    }
+    if (!is_valid)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid address index file.")
+                << " Path: \"" << file_path << "\".";
+    }
+
+    // Table is aligned, since header size is a multiple of Entry alignment
+    // and mapping (or buffer) starts at page (or max alignment) boundary.
+    static_assert(sizeof(FileHeader) % alignof(Entry) == 0,
+            "Entries in the file are not aligned.");
+    m_table = reinterpret_cast<const Entry*>(data + sizeof(header));
+    m_capacity = static_cast<size_t>(header.capacity);
+
+    // Probing relies on empty slots, so make sure those are there.
+    size_t actual_size = 0;
+    for (size_t i = 0; i < m_capacity; ++i)
+    {
+        actual_size += m_table[i].account_id != EMPTY_ACCOUNT_ID ? 1 : 0;
+    }
+    if (actual_size != header.size)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Address index file is corrupt.")
+                << " Path: \"" << file_path << "\", expected size: "
+                << header.size << ", actual size: " << actual_size;
+    }
+    m_size = actual_size;
+}
+
+AddressIndex::~AddressIndex()
+{
+}
+
+void AddressIndex::add_hd_account_addresses(uint32_t account_id,
+        const HDAccount& hd_account,
+        AddressType address_type,
+        uint32_t first_index,
+        size_t count)
+{
+    validate_leaf(AddressIndexLeaf{account_id, address_type, first_index});
+
+    std::vector<unsigned char> hashes(count * ADDRESS_HASH_SIZE);
+    hd_account.derive_address_hashes(address_type, first_index, count, hashes.data());
+
+    reserve(m_size + count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        add(hashes.data() + i * ADDRESS_HASH_SIZE, AddressIndexLeaf{
+                account_id, address_type, first_index + static_cast<uint32_t>(i)});
+    }
+}
+
+void AddressIndex::add(const unsigned char* address_hash, const AddressIndexLeaf& leaf)
+{
+    INVARIANT(address_hash != nullptr);
+    validate_leaf(leaf);
+
+    reserve(m_size + 1);
+    Entry& entry = find_slot(address_hash);
+    if (entry.account_id == EMPTY_ACCOUNT_ID)
+    {
+        memcpy(entry.address_hash, address_hash, sizeof(entry.address_hash));
+        ++m_size;
+    }
+    entry.account_id = leaf.account_id;
+    entry.leaf = (leaf.address_type == ADDRESS_INTERNAL ? LEAF_ADDRESS_TYPE_BIT : 0)
+            | leaf.index;
+}
+
+bool AddressIndex::find(const unsigned char* address_hash,
+        AddressIndexLeaf* out_leaf) const
+{
+    INVARIANT(address_hash != nullptr);
+    INVARIANT(out_leaf != nullptr);
+
+    if (m_size == 0)
+    {
+        return false;
+    }
+
+    const size_t mask = m_capacity - 1;
+    for (size_t slot = get_slot(address_hash, mask); ; slot = (slot + 1) & mask)
+    {
+        const Entry& entry = m_table[slot];
+        if (entry.account_id == EMPTY_ACCOUNT_ID)
+        {
+            return false;
+        }
+        if (memcmp(entry.address_hash, address_hash, sizeof(entry.address_hash)) == 0)
+        {
+            out_leaf->account_id = entry.account_id;
+            out_leaf->address_type = (entry.leaf & LEAF_ADDRESS_TYPE_BIT)
+                    ? ADDRESS_INTERNAL : ADDRESS_EXTERNAL;
+            out_leaf->index = entry.leaf & ~LEAF_ADDRESS_TYPE_BIT;
+            return true;
+        }
+    }
+}
+
+size_t AddressIndex::size() const
+{
+    return m_size;
+}
+
+void AddressIndex::reserve(size_t count)
+{
+    if (count > std::numeric_limits<size_t>::max() / 4 / sizeof(Entry))
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Too many addresses for the index.")
+                << " Count: " << count;
+    }
+
+    make_writable();
+
+    // Keeping the table at most half full, so probe sequences are short.
+    if (count * 2 <= m_capacity)
+    {
+        return;
+    }
+    size_t new_capacity = std::max(MIN_CAPACITY, m_capacity);
+    while (new_capacity < count * 2)
+    {
+        new_capacity *= 2;
+    }
+    rehash(new_capacity);
+}
+
+void AddressIndex::save(const char* file_path) const
+{
+    INVARIANT(file_path != nullptr);
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.byte_order_mark = FILE_BYTE_ORDER_MARK;
+    header.version = FILE_VERSION;
+    header.entry_size = sizeof(Entry);
+    header.capacity = m_capacity;
+    header.size = m_size;
+
+    // Written to a temporary file which then replaces the target, so the file
+    // this index is mapped from (if any) is never truncated while in use.
+    const std::string temp_file_path = std::string(file_path) + ".tmp";
+    std::unique_ptr<FILE, int (*)(FILE*)> file(
+            fopen(temp_file_path.c_str(), "wb"), &fclose);
+    if (!file)
+    {
+        throw_file_error("Failed to create address index file.", temp_file_path.c_str());
+    }
+
+    const bool is_written = fwrite(&header, sizeof(header), 1, file.get()) == 1
+            && (m_capacity == 0
+                    || fwrite(m_table, sizeof(Entry), m_capacity, file.get()) == m_capacity);
+    if (!is_written || fclose(file.release()) != 0)
+    {
+        remove(temp_file_path.c_str());
+        throw_file_error("Failed to write address index file.", temp_file_path.c_str());
+    }
+
+#if defined(_WIN32)
+    // rename() doesn't replace existing file, and it is not mapped anyway.
+    remove(file_path);
+#endif
+    if (rename(temp_file_path.c_str(), file_path) != 0)
+    {
+        remove(temp_file_path.c_str());
+        throw_file_error("Failed to replace address index file.", file_path);
+    }
+}
+
+const void* AddressIndex::get_object_magic()
+{
+    RETURN_MAGIC();
+}
+
+void AddressIndex::rehash(size_t new_capacity)
+{
+    INVARIANT((new_capacity & (new_capacity - 1)) == 0);
+    INVARIANT(new_capacity > m_size * 2);
+
+    Entry empty_entry;
+    memset(&empty_entry, 0, sizeof(empty_entry));
+    empty_entry.account_id = EMPTY_ACCOUNT_ID;
+
+    std::vector<Entry> new_entries(new_capacity, empty_entry);
+    const size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < m_capacity; ++i)
+    {
+        const Entry& entry = m_table[i];
+        if (entry.account_id == EMPTY_ACCOUNT_ID)
+        {
+            continue;
+        }
+
+        size_t slot = get_slot(entry.address_hash, mask);
+        while (new_entries[slot].account_id != EMPTY_ACCOUNT_ID)
+        {
+            slot = (slot + 1) & mask;
+        }
+        new_entries[slot] = entry;
+    }
+
+    m_entries.swap(new_entries);
+    m_table = m_entries.data();
+    m_capacity = new_capacity;
+}
+
+void AddressIndex::make_writable()
+{
+    if (!m_file)
+    {
+        return;
+    }
+
+    m_entries.assign(m_table, m_table + m_capacity);
+    m_table = m_entries.data();
+    m_file.reset();
+}
+
+AddressIndex::Entry& AddressIndex::find_slot(const unsigned char* address_hash)
+{
+    INVARIANT(!m_file);
+    INVARIANT(m_size < m_capacity);
+
+    const size_t mask = m_capacity - 1;
+    for (size_t slot = get_slot(address_hash, mask); ; slot = (slot + 1) & mask)
+    {
+        Entry& entry = m_entries[slot];
+        if (entry.account_id == EMPTY_ACCOUNT_ID
+                || memcmp(entry.address_hash, address_hash, sizeof(entry.address_hash)) == 0)
+        {
+            return entry;
+        }
+    }
+}
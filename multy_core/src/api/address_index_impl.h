@@ -0,0 +1,94 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_API_ADDRESS_INDEX_IMPL_H
+#define MULTY_CORE_SRC_API_ADDRESS_INDEX_IMPL_H
+
+#include "multy_core/address_index.h"
+#include "multy_core/api.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/object.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+/** Open-addressing hash table of address hashes, see address_index.h.
+ *
+ * Table is a power-of-two array of fixed-size entries with linear probing,
+ * at most half full, address hashes are uniformly distributed,
+ * hence first bytes of the hash are used as a slot number.
+ *
+ * Saved file is a header followed by the table as is, so loaded table is used
+ * directly from the memory-mapped file, until anything is added to it.
+ */
+struct MULTY_CORE_API AddressIndex : public ::multy_core::internal::ObjectBase<AddressIndex>
+{
+public:
+    // Account id that marks empty slot, hence is not allowed for accounts.
+    static const uint32_t EMPTY_ACCOUNT_ID = UINT32_MAX;
+
+    AddressIndex();
+    // Loads index from file.
+    explicit AddressIndex(const char* file_path);
+    ~AddressIndex();
+
+    AddressIndex(const AddressIndex&) = delete;
+    AddressIndex& operator=(const AddressIndex&) = delete;
+
+    void add_hd_account_addresses(uint32_t account_id,
+            const HDAccount& hd_account,
+            AddressType address_type,
+            uint32_t first_index,
+            size_t count);
+
+    /** Adds single address hash, replaces the leaf if hash is already there.
+     * @param address_hash - ADDRESS_HASH_SIZE bytes.
+     */
+    void add(const unsigned char* address_hash, const AddressIndexLeaf& leaf);
+
+    /** Finds the leaf of the address hash.
+     * @param address_hash - ADDRESS_HASH_SIZE bytes.
+     * @return false if hash is not in the index.
+     */
+    bool find(const unsigned char* address_hash, AddressIndexLeaf* out_leaf) const;
+
+    size_t size() const;
+
+    // Makes sure that count addresses in total can be added without rehashing.
+    void reserve(size_t count);
+
+    void save(const char* file_path) const;
+
+    static const void* get_object_magic();
+
+private:
+    struct Entry
+    {
+        unsigned char address_hash[multy_core::internal::ADDRESS_HASH_SIZE];
+        uint32_t account_id;
+        // AddressType in the highest bit, and index of the leaf in the rest.
+        uint32_t leaf;
+    };
+    class MappedFile;
+
+    void rehash(size_t new_capacity);
+    // Copies table from the mapped file to memory, if it is not there yet.
+    void make_writable();
+    Entry& find_slot(const unsigned char* address_hash);
+
+private:
+    std::vector<Entry> m_entries;
+    std::unique_ptr<MappedFile> m_file;
+    // Either m_entries.data() or table from m_file.
+    const Entry* m_table;
+    size_t m_capacity;
+    size_t m_size;
+};
+
+#endif // MULTY_CORE_SRC_API_ADDRESS_INDEX_IMPL_H
@@ -7,6 +7,7 @@
 #include "multy_core/src/api/big_int_impl.h"
 
 #include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
 #include "multy_core/src/utility.h"
 
 #include "multy_test/value_printers.h"
@@ -192,16 +193,51 @@ int64_t BigInt::get_value_as_int64() const
 
 size_t BigInt::get_exported_size_in_bytes() const
 {
-    const size_t limbs_count = mpz_size(m_value);
-    const mp_limb_t* limbs = mpz_limbs_read(m_value);
+    // Inner limbs may have leading zero bytes, so those can't be counted
+    // limb-by-limb. mpz_sizeinbase() gives 1 for zero.
+    if (mpz_sgn(m_value) == 0)
+    {
+        return 0;
+    }
+    return (mpz_sizeinbase(m_value, 2) + 7) / 8;
+}
+
+size_t BigInt::export_to_buffer(ExportFormat format,
+        unsigned char* buffer, size_t buffer_size) const
+{
+    const size_t size = get_exported_size_in_bytes();
+    if (size > buffer_size)
+    {
+        THROW_EXCEPTION("Buffer is too small to export BigInt value.")
+                << " Required: " << size << ", available: " << buffer_size;
+    }
 
-    size_t result = 0;
-    for (size_t i = 0; i < limbs_count; ++i)
+    if (size != 0)
     {
-        result += get_bytes_len(limbs[i]);
+        INVARIANT(buffer != nullptr);
+
+        const int word_order = (format == EXPORT_BIG_ENDIAN) ? 1 : -1;
+        const int byte_order = word_order;
+        size_t words_count = 0;
+        mpz_export(buffer, &words_count, word_order, size, byte_order, 0, m_value);
+        INVARIANT(words_count == 1);
     }
 
-    return result;
+    return size;
+}
+
+void BigInt::import_from_binary_data(const BinaryData& data, ExportFormat format)
+{
+    INVARIANT(data.data != nullptr || data.len == 0);
+
+    if (data.len == 0)
+    {
+        mpz_set_ui(m_value, 0);
+        return;
+    }
+
+    const int word_order = (format == EXPORT_BIG_ENDIAN) ? 1 : -1;
+    mpz_import(m_value, data.len, word_order, 1, 0, 0, data.data);
 }
 
 BinaryDataPtr BigInt::export_as_binary_data(BigInt::ExportFormat format) const
@@ -210,12 +246,7 @@ BinaryDataPtr BigInt::export_as_binary_data(BigInt::ExportFormat format) const
 
     BinaryDataPtr result;
     throw_if_error(make_binary_data(size, reset_sp(result)));
-
-    const int word_order = (format == EXPORT_BIG_ENDIAN) ? 1 : -1;
-    const int byte_order = word_order;
-    size_t result_size = 0;
-    mpz_export(const_cast<uint8_t*>(result->data), &result_size, word_order,
-            result->len, byte_order, 0, m_value);
+    export_to_buffer(format, const_cast<uint8_t*>(result->data), result->len);
 
     return result;
 }
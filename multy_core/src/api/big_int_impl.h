@@ -66,6 +66,12 @@ struct MULTY_CORE_API BigInt : public ::multy_core::internal::ObjectBase<BigInt>
     typedef multy_core::internal::BinaryDataPtr BinaryDataPtr;
     enum ExportFormat {EXPORT_BIG_ENDIAN, EXPORT_LITTLE_ENDIAN};
     BinaryDataPtr export_as_binary_data(ExportFormat format) const;
+    // Reverse of export_as_binary_data(), value is always non-negative.
+    void import_from_binary_data(const BinaryData& data, ExportFormat format);
+    // Writes get_exported_size_in_bytes() bytes and returns that number,
+    // throws exception if buffer is too small.
+    size_t export_to_buffer(ExportFormat format,
+            unsigned char* buffer, size_t buffer_size) const;
 
     BigInt& operator+=(const BigInt& other);
     BigInt& operator-=(const BigInt& other);
@@ -0,0 +1,37 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/bitcoin_bulk_payout.h"
+
+#include "multy_core/src/api/transaction_impl.h"
+#include "multy_core/src/bitcoin/bitcoin_transaction.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+Error* transaction_add_bitcoin_destinations(
+        Transaction* transaction,
+        const BitcoinBulkDestination* destinations,
+        size_t destinations_count)
+{
+    ARG_CHECK_OBJECT(transaction);
+    ARG_CHECK(destinations != nullptr || destinations_count == 0);
+
+    try
+    {
+        multy_core::internal::BitcoinTransaction* bitcoin_transaction
+                = dynamic_cast<multy_core::internal::BitcoinTransaction*>(transaction);
+        if (!bitcoin_transaction)
+        {
+            THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+                    "Bulk destinations are supported only by Bitcoin transactions.");
+        }
+        bitcoin_transaction->add_destinations(destinations, destinations_count);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    return nullptr;
+}
@@ -0,0 +1,49 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/bitcoin_coin_selection.h"
+
+#include "multy_core/src/bitcoin/bitcoin_coin_selection.h"
+#include "multy_core/src/utility.h"
+
+#include <algorithm>
+
+Error* bitcoin_select_coins(
+        const BitcoinUnspentOutput* pool,
+        size_t pool_size,
+        const BitcoinCoinSelectionTarget* targets,
+        size_t targets_count,
+        uint64_t fee_per_byte,
+        BitcoinAddressType change_address_type,
+        BitcoinCoinSelectionStrategy strategy,
+        size_t* out_selected,
+        size_t* out_selected_count,
+        uint64_t* out_change_amount,
+        uint64_t* out_fee)
+{
+    ARG_CHECK(pool != nullptr || pool_size == 0);
+    ARG_CHECK(targets != nullptr || targets_count == 0);
+    ARG_CHECK(out_selected != nullptr || pool_size == 0);
+    ARG_CHECK(out_selected_count);
+    ARG_CHECK(out_change_amount);
+    ARG_CHECK(out_fee);
+
+    try
+    {
+        const multy_core::internal::CoinSelectionResult result
+                = multy_core::internal::select_bitcoin_coins(
+                        pool, pool_size, targets, targets_count, fee_per_byte,
+                        change_address_type, strategy);
+
+        std::copy(result.selected.begin(), result.selected.end(), out_selected);
+        *out_selected_count = result.selected.size();
+        *out_change_amount = result.change_amount;
+        *out_fee = result.fee;
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    return nullptr;
+}
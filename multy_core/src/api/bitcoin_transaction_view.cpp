@@ -0,0 +1,60 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/bitcoin_transaction_view.h"
+
+#include "multy_core/src/bitcoin/bitcoin_transaction_view.h"
+#include "multy_core/src/utility.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+Error* bitcoin_parse_transaction(
+        const BinaryData* serialized_transaction,
+        BitcoinTransactionInfo* out_info,
+        BitcoinTransactionOutputInfo* out_outputs,
+        size_t outputs_capacity)
+{
+    ARG_CHECK(serialized_transaction);
+    ARG_CHECK(serialized_transaction->data != nullptr || serialized_transaction->len == 0);
+    ARG_CHECK(out_info);
+    ARG_CHECK(out_outputs != nullptr || outputs_capacity == 0);
+
+    try
+    {
+        using multy_core::internal::BitcoinTransactionView;
+        using multy_core::internal::hash;
+
+        const BitcoinTransactionView view(*serialized_transaction);
+
+        out_info->version = view.get_version();
+        out_info->lock_time = view.get_lock_time();
+        out_info->is_segwit = view.is_segwit();
+        out_info->inputs_count = view.get_inputs().size();
+        out_info->outputs_count = view.get_outputs().size();
+        out_info->size = view.get_size();
+        out_info->virtual_size = view.get_virtual_size();
+
+        const hash<256> txid = view.get_txid();
+        const hash<256> wtxid = view.get_wtxid();
+        static_assert(sizeof(out_info->txid) == sizeof(txid), "Hash size mismatch.");
+        memcpy(out_info->txid, txid.data(), txid.size());
+        memcpy(out_info->wtxid, wtxid.data(), wtxid.size());
+
+        const size_t outputs_count = std::min(
+                view.get_outputs().size(), outputs_capacity);
+        for (size_t i = 0; i < outputs_count; ++i)
+        {
+            const BitcoinTransactionView::Output& output = view.get_outputs()[i];
+            out_outputs[i].amount = output.amount;
+            out_outputs[i].script_pubkey = output.script_pubkey;
+        }
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    return nullptr;
+}
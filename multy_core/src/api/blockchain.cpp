@@ -36,3 +36,28 @@ Error* validate_address(BlockchainType blockchain_type, const char* address)
 
     return nullptr;
 }
+
+Error* validate_addresses(BlockchainType blockchain_type,
+        const char* const* addresses,
+        size_t addresses_count,
+        bool* out_is_valid)
+{
+    ARG_CHECK(addresses != nullptr || addresses_count == 0);
+    ARG_CHECK(out_is_valid != nullptr || addresses_count == 0);
+
+    BlockchainFacadeBase* blockchain = nullptr;
+    try
+    {
+        blockchain = &get_blockchain(blockchain_type.blockchain);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_API);
+
+    try
+    {
+        blockchain->validate_addresses(blockchain_type,
+                addresses, addresses_count, out_is_valid);
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_GENERIC);
+
+    return nullptr;
+}
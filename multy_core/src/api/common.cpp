@@ -6,6 +6,9 @@
 
 #include "multy_core/common.h"
 
+#include "multy_core/error.h"
+
+#include "multy_core/src/exception.h"
 #include "multy_core/src/u_ptr.h"
 #include "multy_core/src/utility.h"
 
@@ -13,6 +16,10 @@
 
 #include "wally_core.h"
 
+extern "C" {
+#include "libwally-core/src/internal.h"
+} // extern "C"
+
 #include <string.h>
 #include <sstream>
 
@@ -85,6 +92,20 @@ Error* make_version_string(const char** out_version_string)
     return nullptr;
 }
 
+Error* multy_core_init()
+{
+    try
+    {
+        if (!secp_ctx())
+        {
+            THROW_EXCEPTION2(ERROR_OUT_OF_MEMORY, "Failed to create secp256k1 context.");
+        }
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_GENERIC);
+
+    return nullptr;
+}
+
 void free_string(const char* str)
 {
     if (!str)
@@ -0,0 +1,103 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/ethereum.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/ethereum/ethereum_abi.h"
+#include "multy_core/src/ethereum/ethereum_transaction_view.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+#include <string>
+#include <vector>
+
+#include <string.h>
+
+Error* ethereum_parse_signed_transaction(
+        const BinaryData* serialized_transaction,
+        EthereumTransactionInfo* info)
+{
+    ARG_CHECK(serialized_transaction);
+    ARG_CHECK(serialized_transaction->data);
+    ARG_CHECK(info);
+    ARG_CHECK(info->nonce == nullptr || info->nonce->is_valid());
+    ARG_CHECK(info->gas_price == nullptr || info->gas_price->is_valid());
+    ARG_CHECK(info->gas_limit == nullptr || info->gas_limit->is_valid());
+    ARG_CHECK(info->value == nullptr || info->value->is_valid());
+
+    try
+    {
+        using namespace multy_core::internal;
+
+        const EthereumTransactionView view(*serialized_transaction);
+        const BinaryDataPtr sender = view.recover_sender_address();
+        const hash<256> transaction_hash = view.get_hash();
+        INVARIANT(sender->len == sizeof(info->sender));
+        static_assert(sizeof(info->hash) == sizeof(transaction_hash),
+                "Hash size mismatch.");
+
+        if (info->nonce)
+        {
+            *info->nonce = view.get_nonce();
+        }
+        if (info->gas_price)
+        {
+            *info->gas_price = view.get_gas_price();
+        }
+        if (info->gas_limit)
+        {
+            *info->gas_limit = view.get_gas_limit();
+        }
+        if (info->value)
+        {
+            *info->value = view.get_value();
+        }
+        info->destination = view.get_destination();
+        info->data = view.get_data();
+        info->chain_id = view.get_chain_id();
+        memcpy(info->sender, sender->data, sender->len);
+        memcpy(info->hash, transaction_hash.data(), transaction_hash.size());
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    return nullptr;
+}
+
+Error* ethereum_encode_contract_call(
+        const char* signature,
+        const char* const* arguments,
+        size_t arguments_count,
+        BinaryData** out_call)
+{
+    ARG_CHECK(signature);
+    ARG_CHECK(arguments != nullptr || arguments_count == 0);
+    ARG_CHECK(out_call);
+
+    try
+    {
+        std::vector<std::string> text_arguments;
+        text_arguments.reserve(arguments_count);
+        for (size_t i = 0; i < arguments_count; ++i)
+        {
+            if (arguments[i] == nullptr)
+            {
+                THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Argument is null.")
+                        << " Index: " << i;
+            }
+            text_arguments.push_back(arguments[i]);
+        }
+
+        const multy_core::internal::EthereumAbiFunction function(signature);
+        *out_call = function.encode_call_from_text(text_arguments).release();
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    OUT_CHECK(*out_call);
+
+    return nullptr;
+}
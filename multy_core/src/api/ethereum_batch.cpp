@@ -0,0 +1,49 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/ethereum_batch.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/ethereum/ethereum_batch.h"
+#include "multy_core/src/utility.h"
+
+#include <algorithm>
+
+Error* ethereum_make_signed_transactions(
+        const Account* account,
+        const BigInt* first_nonce,
+        const BigInt* gas_price,
+        const BigInt* gas_limit,
+        const EthereumTransfer* transfers,
+        size_t transfers_count,
+        size_t threads_count,
+        BinaryData** out_transactions)
+{
+    ARG_CHECK_OBJECT(account);
+    ARG_CHECK_OBJECT(first_nonce);
+    ARG_CHECK_OBJECT(gas_price);
+    ARG_CHECK_OBJECT(gas_limit);
+    ARG_CHECK(transfers != nullptr || transfers_count == 0);
+    ARG_CHECK(out_transactions != nullptr || transfers_count == 0);
+
+    try
+    {
+        std::vector<multy_core::internal::BinaryDataPtr> transactions
+                = multy_core::internal::make_signed_ethereum_transactions(
+                        *account, *first_nonce, *gas_price, *gas_limit,
+                        transfers, transfers_count, threads_count);
+
+        std::transform(transactions.begin(), transactions.end(), out_transactions,
+                [](multy_core::internal::BinaryDataPtr& transaction)
+                {
+                    return transaction.release();
+                });
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_TRANSACTION);
+
+    return nullptr;
+}
@@ -7,12 +7,19 @@
 #include "multy_core/src/api/key_impl.h"
 
 #include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
 #include "multy_core/src/hash.h"
 #include "multy_core/src/u_ptr.h"
 #include "multy_core/src/utility.h"
 
 #include "wally_bip32.h"
 #include "wally_core.h"
+#include "wally_crypto.h"
+
+extern "C" {
+#include "libwally-core/src/internal.h"
+} // extern "C"
+#include "libwally-core/src/secp256k1/include/secp256k1.h"
 
 #include <cstring>
 
@@ -37,7 +44,8 @@ std::string ExtendedKey::to_string() const
     unsigned char serialized_key[BIP32_SERIALIZED_LEN] = {'\0'};
     THROW_IF_WALLY_ERROR2(
             bip32_key_serialize(
-                    &key, 0, serialized_key, sizeof(serialized_key)),
+                    &key, is_private() ? 0 : BIP32_FLAG_KEY_PUBLIC,
+                    serialized_key, sizeof(serialized_key)),
             ERROR_KEY_CANT_SERIALIZE,
             "Failed to searialize ExtendedKey.");
 
@@ -51,6 +59,12 @@ std::string ExtendedKey::to_string() const
     return std::string(out_str.get());
 }
 
+bool ExtendedKey::is_private() const
+{
+    // That is how libwally marks keys with private part.
+    return key.priv_key[0] == BIP32_FLAG_KEY_PRIVATE;
+}
+
 const void* ExtendedKey::get_object_magic()
 {
     RETURN_MAGIC();
@@ -105,7 +119,9 @@ ExtendedKeyPtr make_child_key(
     ExtendedKeyPtr child_key(new ExtendedKey);
     THROW_IF_WALLY_ERROR2(
             bip32_key_from_parent(
-                    &parent_key.key, chain_code, BIP32_FLAG_KEY_PRIVATE,
+                    &parent_key.key, chain_code,
+                    parent_key.is_private()
+                            ? BIP32_FLAG_KEY_PRIVATE : BIP32_FLAG_KEY_PUBLIC,
                     &child_key->key),
             ERROR_KEY_CANT_DERIVE_CHILD_KEY,
             "Failed to make child key.");
@@ -113,6 +129,127 @@ ExtendedKeyPtr make_child_key(
     return child_key;
 }
 
+ExtendedKeyPtr make_extended_key(const char* serialized_key)
+{
+    INVARIANT(serialized_key != nullptr);
+
+    unsigned char decoded[BIP32_SERIALIZED_LEN + BASE58_CHECKSUM_LEN];
+    size_t decoded_size = 0;
+    THROW_IF_WALLY_ERROR2(
+            wally_base58_to_bytes(serialized_key, BASE58_FLAG_CHECKSUM,
+                    decoded, sizeof(decoded), &decoded_size),
+            ERROR_KEY_INVALID_SERIALIZED_STRING,
+            "Failed to decode base58 serialized ExtendedKey.");
+    if (decoded_size != BIP32_SERIALIZED_LEN)
+    {
+        THROW_EXCEPTION2(ERROR_KEY_INVALID_SERIALIZED_STRING,
+                "Serialized ExtendedKey has invalid size.")
+                << " Expected: " << BIP32_SERIALIZED_LEN
+                << ", actual: " << decoded_size;
+    }
+
+    ExtendedKeyPtr result(new ExtendedKey);
+    THROW_IF_WALLY_ERROR2(
+            bip32_key_unserialize(decoded, decoded_size, &result->key),
+            ERROR_KEY_INVALID_SERIALIZED_STRING,
+            "Failed to deserialize ExtendedKey.");
+
+    return result;
+}
+
+ExtendedKeyPtr make_public_extended_key(const ExtendedKey& key)
+{
+    ExtendedKeyPtr result = make_clone(key);
+    ext_key& public_key = result->key;
+
+    public_key.priv_key[0] = BIP32_FLAG_KEY_PUBLIC;
+    memset(public_key.priv_key + 1, 0, sizeof(public_key.priv_key) - 1);
+    if (public_key.version == BIP32_VER_MAIN_PRIVATE)
+    {
+        public_key.version = BIP32_VER_MAIN_PUBLIC;
+    }
+    else if (public_key.version == BIP32_VER_TEST_PRIVATE)
+    {
+        public_key.version = BIP32_VER_TEST_PUBLIC;
+    }
+
+    return result;
+}
+
+void derive_child_public_keys(const ExtendedKey& parent_key,
+        uint32_t first_index, size_t count,
+        PublicKeyFormat format, unsigned char* out_keys)
+{
+    INVARIANT(out_keys != nullptr || count == 0);
+    if (first_index >= HARDENED_INDEX_BASE
+            || count > HARDENED_INDEX_BASE - first_index)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Can't derive public keys of hardened children.")
+                << " First index: " << first_index << ", count: " << count;
+    }
+
+    const secp256k1_context* ctx = secp_ctx();
+    if (!ctx)
+    {
+        THROW_EXCEPTION2(ERROR_OUT_OF_MEMORY, "Failed to create secp256k1 context.");
+    }
+
+    secp256k1_pubkey parent_public_key;
+    if (!secp256k1_ec_pubkey_parse(ctx, &parent_public_key,
+            parent_key.key.pub_key, sizeof(parent_key.key.pub_key)))
+    {
+        THROW_EXCEPTION2(ERROR_KEY_CANT_DERIVE_CHILD_KEY,
+                "Invalid public key of the parent key.");
+    }
+
+    const size_t key_size = format == EC_PUBLIC_KEY_COMPRESSED
+            ? EC_PUBLIC_KEY_LEN : EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+    const unsigned int serialize_flags = format == EC_PUBLIC_KEY_COMPRESSED
+            ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
+
+    // BIP32 CKDpub: I = HMAC-SHA512(chain code, parent public key || index),
+    // child public key is parent public key + IL * G.
+    unsigned char data[EC_PUBLIC_KEY_LEN + sizeof(uint32_t)];
+    memcpy(data, parent_key.key.pub_key, EC_PUBLIC_KEY_LEN);
+    unsigned char hmac[HMAC_SHA512_LEN];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t index = first_index + static_cast<uint32_t>(i);
+        data[EC_PUBLIC_KEY_LEN] = static_cast<unsigned char>(index >> 24);
+        data[EC_PUBLIC_KEY_LEN + 1] = static_cast<unsigned char>(index >> 16);
+        data[EC_PUBLIC_KEY_LEN + 2] = static_cast<unsigned char>(index >> 8);
+        data[EC_PUBLIC_KEY_LEN + 3] = static_cast<unsigned char>(index);
+
+        THROW_IF_WALLY_ERROR2(
+                wally_hmac_sha512(
+                        parent_key.key.chain_code, sizeof(parent_key.key.chain_code),
+                        data, sizeof(data), hmac, sizeof(hmac)),
+                ERROR_KEY_CANT_DERIVE_CHILD_KEY,
+                "Failed to derive child key.");
+
+        // IL * G uses precomputed generator tables, adding it to the parent
+        // key avoids the private key derivation done by bip32_key_from_parent().
+        secp256k1_pubkey tweak_point;
+        secp256k1_pubkey child_public_key;
+        const secp256k1_pubkey* points[] = {&parent_public_key, &tweak_point};
+        // Fails if IL >= n or result is a point at infinity, which is
+        // astronomically improbable, BIP32 suggests to skip such index.
+        if (!secp256k1_ec_pubkey_create(ctx, &tweak_point, hmac)
+                || !secp256k1_ec_pubkey_combine(ctx, &child_public_key, points, 2))
+        {
+            THROW_EXCEPTION2(ERROR_KEY_CANT_DERIVE_CHILD_KEY,
+                    "Failed to derive child key.")
+                    << " Index: " << index;
+        }
+
+        size_t out_size = key_size;
+        secp256k1_ec_pubkey_serialize(ctx, out_keys + i * key_size, &out_size,
+                &child_public_key, serialize_flags);
+    }
+}
+
 CharPtr make_user_id_from_master_key(const ExtendedKey& master_key)
 {
     if (!(master_key.key.depth == 0 && master_key.key.child_num == 0))
@@ -8,6 +8,7 @@
 #define MULTY_CORE_INTERNAL_KEY_IMPL_H
 
 #include "multy_core/api.h"
+#include "multy_core/src/ec_key_utils.h"
 #include "multy_core/src/u_ptr.h"
 #include "multy_core/src/object.h"
 
@@ -34,7 +35,9 @@ struct MULTY_CORE_API ExtendedKey : public ::multy_core::internal::ObjectBase<Ex
 {
     ExtendedKey();
 
+    // Serialized as xprv if key is private, as xpub otherwise.
     std::string to_string() const;
+    bool is_private() const;
 
     static const void* get_object_magic();
 
@@ -83,6 +86,34 @@ ExtendedKeyPtr make_master_key(const BinaryData& seed);
 ExtendedKeyPtr make_child_key(const ExtendedKey& parent_key,
         uint32_t chain_code);
 
+/** Makes extended key from base58-encoded BIP32 serialized key (xprv or xpub).
+ * @throw Exception with ERROR_KEY_INVALID_SERIALIZED_STRING if string is invalid.
+ */
+ExtendedKeyPtr make_extended_key(const char* serialized_key);
+
+/// Makes a copy of the key without the private part, serialized as xpub.
+ExtendedKeyPtr make_public_extended_key(const ExtendedKey& key);
+
+/** Derives public keys of non-hardened children of the key.
+ *
+ * Only public key and chain code of the parent are used, so that works
+ * for both private and public parent keys, and is faster than deriving
+ * private children and then computing their public keys.
+ * Safe to call concurrently, once secp256k1 context has been created.
+ *
+ * @param parent_key - parent key, private or public.
+ * @param first_index - index of the first child, first_index + count
+ *        must not exceed HARDENED_INDEX_BASE.
+ * @param count - number of children to derive.
+ * @param format - format of the resulting public keys.
+ * @param out_keys - count keys, one after another, each is
+ *        EC_PUBLIC_KEY_LEN or EC_PUBLIC_KEY_UNCOMPRESSED_LEN bytes, depending on format.
+ * @throw Exception if any of the children can't be derived.
+ */
+void derive_child_public_keys(const ExtendedKey& parent_key,
+        uint32_t first_index, size_t count,
+        PublicKeyFormat format, unsigned char* out_keys);
+
 /** Makes a user id string from master key.
  *
  * User id is a string that uniquely identifies user without giving away
@@ -9,6 +9,8 @@
 #include "multy_core/common.h"
 #include "multy_core/error.h"
 #include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/hash.h"
 #include "multy_core/src/utility.h"
 
 #include "wally_bip39.h"
@@ -17,6 +19,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include <stdlib.h>
 
 namespace
@@ -34,6 +37,39 @@ size_t max_supported_entropy_size(size_t entropy_size)
 
     return find_max_value(supported_entropy_sizes, default_value, entropy_size);
 }
+
+// Number of PBKDF2 iterations as required by BIP39.
+const uint32_t BIP39_PBKDF2_ITERATIONS = 2048;
+
+void validate_mnemonic(const char* mnemonic)
+{
+    THROW_IF_WALLY_ERROR2(
+            bip39_mnemonic_validate(nullptr, mnemonic),
+            ERROR_MNEMONIC_INVALID,
+            "Invalid mnemonic value.");
+}
+
+// Mnemonic must be validated beforehand.
+BinaryDataPtr make_seed_data(const char* mnemonic, const char* password)
+{
+    std::string salt("mnemonic");
+    if (password)
+    {
+        salt += password;
+    }
+
+    BinaryDataPtr seed(new BinaryData{nullptr, 0});
+    std::unique_ptr<unsigned char[]> data(new unsigned char[BIP39_SEED_LEN_512]);
+    pbkdf2_hmac_sha512(as_binary_data(mnemonic), as_binary_data(salt),
+            BIP39_PBKDF2_ITERATIONS, data.get(), BIP39_SEED_LEN_512);
+    wally_bzero(&salt[0], salt.size());
+
+    seed->data = data.release();
+    seed->len = BIP39_SEED_LEN_512;
+
+    return seed;
+}
+
 } // namespace
 
 Error* make_mnemonic(EntropySource entropy_source, const char** mnemonic)
@@ -70,30 +106,13 @@ Error* make_mnemonic(EntropySource entropy_source, const char** mnemonic)
 
 Error* make_seed(const char* mnemonic, const char* password, BinaryData** seed)
 {
-    static const size_t max_seed_size = BIP39_SEED_LEN_512;
-
     ARG_CHECK(mnemonic);
     ARG_CHECK(seed);
 
     try
     {
-        size_t written = 0;
-        THROW_IF_WALLY_ERROR2(
-                bip39_mnemonic_validate(nullptr, mnemonic),
-                ERROR_MNEMONIC_INVALID,
-                "Invalid mnemonic value.");
-
-        std::unique_ptr<unsigned char[]> data(new unsigned char[max_seed_size]);
-        THROW_IF_WALLY_ERROR(
-                bip39_mnemonic_to_seed(
-                        mnemonic, password, data.get(), max_seed_size,
-                        &written),
-                "Faield to generate seed from mnemonic.");
-
-        BinaryData* out = new BinaryData;
-        out->data = data.release();
-        out->len = written;
-        *seed = out;
+        validate_mnemonic(mnemonic);
+        *seed = make_seed_data(mnemonic, password).release();
     }
     CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_MNEMONIC);
 
@@ -102,6 +121,48 @@ Error* make_seed(const char* mnemonic, const char* password, BinaryData** seed)
     return nullptr;
 }
 
+Error* make_seeds(
+        const char* const* mnemonics,
+        const char* const* passwords,
+        size_t count,
+        BinaryData** seeds)
+{
+    ARG_CHECK(mnemonics || count == 0);
+    ARG_CHECK(seeds || count == 0);
+
+    try
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mnemonics[i] == nullptr)
+            {
+                THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Mnemonic is null.")
+                        << " Index: " << i;
+            }
+            validate_mnemonic(mnemonics[i]);
+        }
+
+        // Either all seeds are passed to the caller, or none.
+        std::vector<BinaryDataPtr> result(count);
+        parallel_for(count, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                result[i] = make_seed_data(mnemonics[i],
+                        passwords ? passwords[i] : nullptr);
+            }
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            seeds[i] = result[i].release();
+        }
+    }
+    CATCH_EXCEPTION_RETURN_ERROR(ERROR_SCOPE_MNEMONIC);
+
+    return nullptr;
+}
+
 Error* seed_to_string(const BinaryData* seed, const char** str)
 {
     ARG_CHECK(seed);
@@ -11,12 +11,9 @@
 
 #include "multy_core/src/exception.h"
 #include "multy_core/src/exception_stream.h"
+#include "multy_core/src/hash.h"
 #include "multy_core/src/utility.h"
 
-extern "C" {
-#include "keccak-tiny/keccak-tiny.h"
-} // extern "C"
-
 #include <algorithm>
 #include <iterator>
 #include <sstream>
@@ -30,12 +27,12 @@ static const size_t HASH_SIZES[] = {
     SHA3_224, SHA3_256, SHA3_384, SHA3_512
 };
 
-#define DO_SHA3(size, in, out)                                                 \
-    THROW_IF_WALLY_ERROR(                                                      \
-            ::sha3_##size(                                                     \
-                    const_cast<uint8_t*>(output->data), output->len,           \
-                    input.data, input.len),                                    \
-            "Failed to SHA3-" #size " input data.");
+template <HasherType HasherT, size_t N>
+void do_hash_to(const BinaryData& input, BinaryData* output)
+{
+    const hash<N> result = do_hash<HasherT, N>(input);
+    memcpy(const_cast<unsigned char*>(output->data), result.data(), result.size());
+}
 
 void do_sha3(const BinaryData& input, BinaryData* output)
 {
@@ -43,22 +40,22 @@ void do_sha3(const BinaryData& input, BinaryData* output)
     {
         case 224:
         {
-            DO_SHA3(224, input, output);
+            do_hash_to<SHA3, 224>(input, output);
             break;
         }
         case 256:
         {
-            DO_SHA3(256, input, output);
+            do_hash_to<SHA3, 256>(input, output);
             break;
         }
         case 384:
         {
-            DO_SHA3(384, input, output);
+            do_hash_to<SHA3, 384>(input, output);
             break;
         }
         case 512:
         {
-            DO_SHA3(512, input, output);
+            do_hash_to<SHA3, 512>(input, output);
             break;
         }
         default:
@@ -137,10 +134,7 @@ void keccak_256(const BinaryData& input, BinaryData* output)
     const size_t HASH_SIZES[] = {256 / 8};
     const size_t hash_size = get_biggest_of_supported_sizes(output->len, HASH_SIZES);
 
-    THROW_IF_WALLY_ERROR(
-            ::keccak_256(const_cast<unsigned char*>(output->data), hash_size,
-                    input.data, input.len),
-            "Failed to hash input with keccack_256.");
+    do_hash_to<KECCAK, 256>(input, output);
 
     output->len = hash_size;
 }
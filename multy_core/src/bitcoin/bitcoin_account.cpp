@@ -68,52 +68,67 @@ uint32_t get_chain_index(BlockchainType blockchain_type)
     return blockchain_type.blockchain;
 }
 
-class BitcoinP2PKHAccount : public BitcoinAccount
+// P2PKH address generated from hash160 of public key.
+// https://en.bitcoin.it/wiki/Technical_background_of_version_1_Bitcoin_addresses
+//
+// P2SH-P2WPKH address is generated same way from hash160 of a segwit script.
+std::string make_base58_address(BitcoinNetType net_type,
+        BitcoinAddressType address_type,
+        const unsigned char* hash)
 {
-public:
-    using BitcoinAccount::BitcoinAccount;
+    unsigned char pub_hash[HASH160_LEN + 1] = {'\0'};
 
-    std::string get_address() const override
-    {
-        // P2PKH address generated from public key.
-        // https://en.bitcoin.it/wiki/Technical_background_of_version_1_Bitcoin_addresses
+    // Leave the first byte intact for prefix.
+    memcpy(pub_hash + 1, hash, HASH160_LEN);
 
-        unsigned char pub_hash[HASH160_LEN + 1] = {'\0'};
+    // Add version byte in front of RIPEMD-160 hash
+    //      (0x00 for P2PKH or 0x05 for P2SH on Main Network)
+    pub_hash[0] = get_address_prefix(net_type, address_type);
 
-        // 1 - Take the corresponding public key generated with it (33 or 65
-        // bytes)
-        PublicKeyPtr public_key(m_private_key->make_public_key());
-        BinaryData key_data = public_key->get_content();
+    // - Perform SHA-256 hash on the extended RIPEMD-160 result
+    // - Perform SHA-256 hash on the result of the previous SHA-256 hash
+    // - Add the 4 checksum bytes at the end of extended RIPEMD-160 hash.
+    // - Convert the result from a byte string into a base58 string
+    //      using Base58Check encoding.
+    CharPtr base58_string_ptr;
+    THROW_IF_WALLY_ERROR(
+            wally_base58_from_bytes(
+                    pub_hash, sizeof(pub_hash), BASE58_FLAG_CHECKSUM,
+                    reset_sp(base58_string_ptr)),
+            "Converting to base58 failed.");
 
-        // 2 - Perform SHA-256 hashing on the public key
-        // 3 - Perform RIPEMD-160 hashing on the result of SHA-256
-        {
-            // Leave the first byte intact for prefix.
-            BinaryData hash_data = power_slice(as_binary_data(pub_hash), 1, -1);
-            bitcoin_hash_160(key_data, &hash_data);
-        }
+    return std::string(base58_string_ptr.get());
+}
 
-        // 4 - Add version byte in front of RIPEMD-160 hash
-        //      (0x00 for Main Network)
-        pub_hash[0] = get_address_prefix(
-                static_cast<BitcoinNetType>(m_blockchain_type.net_type),
-                BITCOIN_ADDRESS_P2PKH);
-
-        // 5 - Perform SHA-256 hash on the extended RIPEMD-160 result
-        // 6 - Perform SHA-256 hash on the result of the previous SHA-256 hash
-        // 8 - Add the 4 checksum bytes from stage 7 at the end of extended
-        //      RIPEMD-160 hash from stage 4.
-        // 9 - Convert the result from a byte string into a base58 string
-        //      using Base58Check encoding.
-        CharPtr base58_string_ptr;
-        THROW_IF_WALLY_ERROR(
-                wally_base58_from_bytes(
-                        pub_hash, sizeof(pub_hash), BASE58_FLAG_CHECKSUM,
-                        reset_sp(base58_string_ptr)),
-                "Converting to base58 failed.");
-        std::string result(base58_string_ptr.get());
+// Hash of the P2SH-P2WPKH redeem script, from hash160 of public key.
+void make_p2sh_p2wpkh_script_hash(const unsigned char* public_key_hash,
+        unsigned char* out_script_hash)
+{
+    unsigned char segwit_script[HASH160_LEN + 2] = {'\0'};
+    // Leave the first two bytes intact for script opcode
+    memcpy(segwit_script + 2, public_key_hash, HASH160_LEN);
+    // Perform make script segWit for lock bitcoins
+    segwit_script[0] = 0x00; // Version byte witness
+    segwit_script[1] = HASH160_LEN; // Witness program is 20 bytes
+
+    // Perform SHA-256 hashing on the segWit script
+    // Perform RIPEMD-160 hashing on the result of SHA-256
+    BinaryData hash_data{out_script_hash, HASH160_LEN};
+    bitcoin_hash_160(as_binary_data(segwit_script), &hash_data);
+}
 
-        return result;
+class BitcoinP2PKHAccount : public BitcoinAccount
+{
+public:
+    using BitcoinAccount::BitcoinAccount;
+
+protected:
+    std::string make_address() const override
+    {
+        return make_base58_address(
+                static_cast<BitcoinNetType>(m_blockchain_type.net_type),
+                BITCOIN_ADDRESS_P2PKH,
+                m_private_key->get_public_key_hash().data());
     }
 };
 
@@ -122,54 +137,17 @@ class BitcoinP2SHWPKHAccount : public BitcoinAccount
 public:
     using BitcoinAccount::BitcoinAccount;
 
-    std::string get_address() const override
+protected:
+    std::string make_address() const override
     {
-        unsigned char pub_hash[HASH160_LEN + 1] = {'\0'};
-
-        // 1 - Take the corresponding public key generated with it (33 or 65
-        // bytes)
-        {
-            unsigned char segwit_script[HASH160_LEN + 2] = {'\0'};
-           // Leave the first two bytes intact for script opcode
-            BinaryData hash_pub_key = power_slice(as_binary_data(segwit_script), 2, -2);
-
-            PublicKeyPtr public_key(m_private_key->make_public_key());
-            BinaryData key_data = public_key->get_content();
-            // 2 - Perform SHA-256 hashing on the public key
-            // 3 - Perform RIPEMD-160 hashing on the result of SHA-256
-            bitcoin_hash_160(key_data, &hash_pub_key);
-            // 4 - Perform make script segWit for lock bitcoins
-            segwit_script[0] = 0x00; // Version byte witness
-            segwit_script[1] = HASH160_LEN; // Witness program is 20 bytes
-
-            // Leave the first byte intact for prefix.
-            BinaryData hash_data = power_slice(as_binary_data(pub_hash), 1, -1);
-            // 5 - Perform SHA-256 hashing on the segWit script
-            // 6 - Perform RIPEMD-160 hashing on the result of SHA-256
-            bitcoin_hash_160(as_binary_data(segwit_script), &hash_data);
-        }
+        unsigned char script_hash[HASH160_LEN];
+        make_p2sh_p2wpkh_script_hash(
+                m_private_key->get_public_key_hash().data(), script_hash);
 
-        // 7 - Add version byte in front of RIPEMD-160 hash
-        //      (0x05 for Main Network)
-        pub_hash[0] = get_address_prefix(
+        return make_base58_address(
                 static_cast<BitcoinNetType>(m_blockchain_type.net_type),
-                BITCOIN_ADDRESS_P2SH);
-
-        // 8 - Perform SHA-256 hash on the extended RIPEMD-160 result
-        // 9 - Perform SHA-256 hash on the result of the previous SHA-256 hash
-        // 10 - Add the 4 checksum bytes from stage 7 at the end of extended
-        //      RIPEMD-160 hash from stage 4.
-        // 11 - Convert the result from a byte string into a base58 string
-        //      using Base58Check encoding.
-        CharPtr base58_string_ptr;
-        THROW_IF_WALLY_ERROR(
-                wally_base58_from_bytes(
-                        pub_hash, sizeof(pub_hash), BASE58_FLAG_CHECKSUM,
-                        reset_sp(base58_string_ptr)),
-                "Converting to base58 failed.");
-        std::string result(base58_string_ptr.get());
-
-        return result;
+                BITCOIN_ADDRESS_P2SH,
+                script_hash);
     }
 };
 
@@ -211,7 +189,8 @@ BitcoinAccount::BitcoinAccount(BlockchainType blockchain_type,
         BitcoinPrivateKeyPtr key,
         HDPath path)
     : AccountBase(blockchain_type, *key, path),
-      m_private_key(std::move(key))
+      m_private_key(std::move(key)),
+      m_address()
 {
 }
 
@@ -219,6 +198,14 @@ BitcoinAccount::~BitcoinAccount()
 {
 }
 
+std::string BitcoinAccount::get_address() const
+{
+    return m_address.get([this]()
+    {
+        return make_address();
+    });
+}
+
 void bitcoin_hash_160(const BinaryData& input, BinaryData* output)
 {
     INVARIANT(output != nullptr);
@@ -241,6 +228,16 @@ BitcoinHDAccount::BitcoinHDAccount(
 {
 }
 
+BitcoinHDAccount::BitcoinHDAccount(
+        BlockchainType blockchain_type,
+        BitcoinAccountType account_type,
+        const ExtendedKey& account_public_key)
+    : HDAccountBase(blockchain_type,
+            get_chain_index(blockchain_type), account_public_key),
+      m_account_type(account_type)
+{
+}
+
 BitcoinHDAccount::~BitcoinHDAccount()
 {
 }
@@ -263,7 +260,62 @@ AccountPtr BitcoinHDAccount::make_account(
             get_blockchain_type(),
             m_account_type,
             std::move(private_key),
-            make_child_path(make_child_path(get_path(), type), index));
+            make_leaf_path(type, index));
+}
+
+void BitcoinHDAccount::make_addresses(const unsigned char* public_keys,
+        size_t count, std::string* out_addresses) const
+{
+    std::vector<unsigned char> hashes(count * HASH160_LEN);
+    make_address_hashes(public_keys, count, hashes.data());
+
+    const BitcoinNetType net_type
+            = static_cast<BitcoinNetType>(get_blockchain_type().net_type);
+    const BitcoinAddressType address_type = m_account_type == BITCOIN_ACCOUNT_SEGWIT
+            ? BITCOIN_ADDRESS_P2SH : BITCOIN_ADDRESS_P2PKH;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_addresses[i] = make_base58_address(
+                net_type, address_type, hashes.data() + i * HASH160_LEN);
+    }
+}
+
+void BitcoinHDAccount::make_address_hashes(const unsigned char* public_keys,
+        size_t count, unsigned char* out_hashes) const
+{
+    if (m_account_type != BITCOIN_ACCOUNT_P2PKH
+            && m_account_type != BITCOIN_ACCOUNT_SEGWIT)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Unknown BitcoinAccountType.")
+                << " Value: " << m_account_type << ".";
+    }
+
+    unsigned char public_key_hash[HASH160_LEN];
+    for (size_t i = 0; i < count; ++i)
+    {
+        unsigned char* const hash = out_hashes + i * HASH160_LEN;
+        THROW_IF_WALLY_ERROR(
+                wally_hash160(public_keys + i * EC_PUBLIC_KEY_LEN,
+                        EC_PUBLIC_KEY_LEN,
+                        public_key_hash, sizeof(public_key_hash)),
+                "hash160 failed.");
+
+        if (m_account_type == BITCOIN_ACCOUNT_SEGWIT)
+        {
+            make_p2sh_p2wpkh_script_hash(public_key_hash, hash);
+        }
+        else
+        {
+            memcpy(hash, public_key_hash, HASH160_LEN);
+        }
+    }
+}
+
+PublicKeyPtr BitcoinHDAccount::make_leaf_public_key(
+        const unsigned char* public_key) const
+{
+    return PublicKeyPtr(new BitcoinPublicKey(BitcoinPublicKey::KeyData(
+            public_key, public_key + EC_PUBLIC_KEY_LEN)));
 }
 
 AccountPtr make_bitcoin_account(
@@ -11,6 +11,7 @@
 #include "multy_core/bitcoin.h"
 
 #include "multy_core/src/account_base.h"
+#include "multy_core/src/cached_value.h"
 #include "multy_core/src/u_ptr.h"
 
 namespace multy_core
@@ -54,6 +55,12 @@ public:
             const ExtendedKey& bip44_master_key,
             uint32_t index);
 
+    // Watch-only account, see HDAccountBase.
+    BitcoinHDAccount(
+            BlockchainType blockchain_type,
+            BitcoinAccountType account_type,
+            const ExtendedKey& account_public_key);
+
     ~BitcoinHDAccount();
 
     AccountPtr make_account(
@@ -61,6 +68,13 @@ public:
             AddressType type,
             uint32_t index) const override;
 
+protected:
+    void make_addresses(const unsigned char* public_keys, size_t count,
+            std::string* out_addresses) const override;
+    void make_address_hashes(const unsigned char* public_keys, size_t count,
+            unsigned char* out_hashes) const override;
+    PublicKeyPtr make_leaf_public_key(const unsigned char* public_key) const override;
+
 private:
     const BitcoinAccountType m_account_type;
 };
@@ -75,13 +89,20 @@ public:
 
     ~BitcoinAccount();
 
-    virtual std::string get_address() const = 0;
+    // Address is computed on first use and then cached.
+    std::string get_address() const override;
 
     static std::string get_address_from_private_key(const PrivateKey& key);
     BitcoinAccountType get_account_type() const;
 
+protected:
+    virtual std::string make_address() const = 0;
+
 protected:
     const BitcoinPrivateKeyPtr m_private_key;
+
+private:
+    CachedValue<std::string> m_address;
 };
 
 } // namespace internal
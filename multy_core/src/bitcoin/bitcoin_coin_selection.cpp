@@ -0,0 +1,563 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/bitcoin/bitcoin_coin_selection.h"
+
+#include "multy_core/error.h"
+
+#include "multy_core/src/bitcoin/bitcoin_transaction.h"
+#include "multy_core/src/error_utility.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace
+{
+using namespace multy_core::internal;
+
+// Sizes are given in weight units (WU) as defined by BIP141:
+// 4 WU per byte of non-witness data and 1 WU per byte of witness data,
+// see WITNESS_SCALE_FACTOR.
+
+// version and lock time.
+const uint64_t BITCOIN_TRANSACTION_HEADER_SIZE = 4 + 4;
+// segwit marker and flag.
+const uint64_t BITCOIN_SEGWIT_HEADER_WEIGHT = 1 + 1;
+
+// prev tx hash, prev tx out index, script length, script, sequence.
+// Signature is assumed to be of the max DER-encoded size + SIGHASH byte,
+// public key is compressed.
+const uint64_t BITCOIN_P2PKH_INPUT_SIZE = 32 + 4 + 1 + (1 + 73 + 1 + 33) + 4;
+// Non-segwit input of the segwit transaction has an empty witness.
+const uint64_t BITCOIN_P2PKH_INPUT_WITNESS_SIZE = 1;
+// Script is a push of the P2WPKH witness program.
+const uint64_t BITCOIN_P2SH_P2WPKH_INPUT_SIZE = 32 + 4 + 1 + (1 + 22) + 4;
+const uint64_t BITCOIN_P2SH_P2WPKH_INPUT_WITNESS_SIZE = 1 + (1 + 73 + 1 + 33);
+
+// amount, script length, script.
+const uint64_t BITCOIN_P2PKH_OUTPUT_SIZE = 8 + 1 + 25;
+const uint64_t BITCOIN_P2SH_OUTPUT_SIZE = 8 + 1 + 23;
+
+// Bounds on amount of work done by search strategies, selected to keep
+// selection time in milliseconds range for pool of 100000 outputs.
+const size_t BRANCH_AND_BOUND_MAX_TRIES = 100000;
+const size_t KNAPSACK_MAX_ITERATIONS = 1000;
+const size_t KNAPSACK_MAX_TOTAL_STEPS = 10000000;
+const uint32_t KNAPSACK_RANDOM_SEED = 0x6d756c74;
+
+struct Candidate
+{
+    // amount minus fee for spending the output.
+    uint64_t effective_value;
+    size_t index;
+};
+
+typedef std::vector<Candidate> Candidates;
+typedef std::vector<size_t> Selection; // positions in Candidates.
+
+bool is_segwit(BitcoinAddressType address_type)
+{
+    return address_type == BITCOIN_ADDRESS_P2SH_P2WPKH;
+}
+
+uint64_t checked_add(uint64_t left, uint64_t right)
+{
+    if (left > std::numeric_limits<uint64_t>::max() - right)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Amount overflow.");
+    }
+    return left + right;
+}
+
+uint64_t checked_mul(uint64_t left, uint64_t right)
+{
+    if (right != 0 && left > std::numeric_limits<uint64_t>::max() / right)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Amount overflow.");
+    }
+    return left * right;
+}
+
+uint64_t get_input_weight(BitcoinAddressType address_type, bool is_segwit_transaction)
+{
+    switch (address_type)
+    {
+        case BITCOIN_ADDRESS_P2PKH:
+            return BITCOIN_P2PKH_INPUT_SIZE * WITNESS_SCALE_FACTOR
+                    + (is_segwit_transaction ? BITCOIN_P2PKH_INPUT_WITNESS_SIZE : 0);
+        case BITCOIN_ADDRESS_P2SH_P2WPKH:
+            return BITCOIN_P2SH_P2WPKH_INPUT_SIZE * WITNESS_SCALE_FACTOR
+                    + BITCOIN_P2SH_P2WPKH_INPUT_WITNESS_SIZE;
+        default:
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Spending output of this address type is not supported.")
+                    << " Address type: " << address_type;
+    }
+}
+
+uint64_t get_output_size(BitcoinAddressType address_type)
+{
+    switch (address_type)
+    {
+        case BITCOIN_ADDRESS_P2PKH:
+            return BITCOIN_P2PKH_OUTPUT_SIZE;
+        case BITCOIN_ADDRESS_P2SH:
+        case BITCOIN_ADDRESS_P2SH_P2WPKH:
+            return BITCOIN_P2SH_OUTPUT_SIZE;
+        default:
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid address type.")
+                    << " Address type: " << address_type;
+    }
+}
+
+// Same rule as is_dust_amount() in bitcoin_transaction.cpp.
+uint64_t get_dust_threshold(BitcoinAddressType address_type)
+{
+    return BITCOIN_DUST_RELAY_FEE_PER_BYTE * (is_segwit(address_type)
+            ? BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_SEGWIT
+            : BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_NON_SEGWIT);
+}
+
+// Fee for given weight, rounded up to the whole virtual byte.
+uint64_t get_fee_for_weight(uint64_t weight, uint64_t fee_per_byte)
+{
+    return checked_mul(
+            (weight + WITNESS_SCALE_FACTOR - 1) / WITNESS_SCALE_FACTOR,
+            fee_per_byte);
+}
+
+uint64_t sum_effective_values(const Candidates& candidates, const Selection& selection)
+{
+    uint64_t result = 0;
+    for (const size_t i : selection)
+    {
+        result += candidates[i].effective_value;
+    }
+    return result;
+}
+
+/** Depth-first search for a set of candidates with total effective value in
+ * range [target, max_target], i.e. a set that needs no change.
+ * Of all found sets, the one with least excess is chosen.
+ *
+ * Candidates must be sorted by effective value in descending order.
+ * Returns empty selection if nothing was found in BRANCH_AND_BOUND_MAX_TRIES.
+ */
+Selection select_branch_and_bound(
+        const Candidates& candidates,
+        uint64_t available,
+        uint64_t target,
+        uint64_t max_target)
+{
+    Selection current;
+    Selection best;
+    uint64_t best_excess = std::numeric_limits<uint64_t>::max();
+    uint64_t current_value = 0;
+
+    for (size_t tries = 0, i = 0; tries < BRANCH_AND_BOUND_MAX_TRIES; ++tries, ++i)
+    {
+        bool backtrack = false;
+        if (current_value + available < target
+                || current_value > max_target)
+        {
+            // Can't reach the target or already overshot it.
+            backtrack = true;
+        }
+        else if (current_value >= target)
+        {
+            const uint64_t excess = current_value - target;
+            if (excess <= best_excess)
+            {
+                best = current;
+                best_excess = excess;
+                if (best_excess == 0)
+                {
+                    break;
+                }
+            }
+            backtrack = true;
+        }
+
+        if (backtrack)
+        {
+            if (current.empty())
+            {
+                // Whole tree was walked.
+                break;
+            }
+            // Return omitted candidates back to available before trying
+            // the branch where last included candidate is omitted.
+            for (--i; i > current.back(); --i)
+            {
+                available += candidates[i].effective_value;
+            }
+            current_value -= candidates[i].effective_value;
+            current.pop_back();
+        }
+        else
+        {
+            const Candidate& candidate = candidates[i];
+            available -= candidate.effective_value;
+
+            // Omitting a candidate and then including an equal one yields
+            // the very same set of values as was already evaluated.
+            if (current.empty()
+                    || current.back() == i - 1
+                    || candidate.effective_value != candidates[i - 1].effective_value)
+            {
+                current.push_back(i);
+                current_value += candidate.effective_value;
+            }
+        }
+    }
+
+    return best;
+}
+
+/** Randomized search for a subset with least total effective value not less
+ * than target, as done by Bitcoin Core wallet prior to branch and bound.
+ *
+ * Values must be sorted in descending order, and total must be >= target.
+ */
+std::vector<bool> approximate_best_subset(
+        const Candidates& values,
+        uint64_t total,
+        uint64_t target,
+        std::mt19937* random)
+{
+    std::vector<bool> best(values.size(), true);
+    uint64_t best_total = total;
+
+    const size_t iterations = std::max<size_t>(1, std::min(
+            KNAPSACK_MAX_ITERATIONS,
+            KNAPSACK_MAX_TOTAL_STEPS / std::max<size_t>(1, 2 * values.size())));
+
+    std::vector<bool> included(values.size());
+    for (size_t iteration = 0; iteration < iterations && best_total != target; ++iteration)
+    {
+        std::fill(included.begin(), included.end(), false);
+        uint64_t current_total = 0;
+        bool reached_target = false;
+        uint32_t random_bits = 0;
+        size_t random_bits_left = 0;
+
+        // First pass picks candidates randomly, second one adds all the rest.
+        for (int pass = 0; pass < 2 && !reached_target; ++pass)
+        {
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                if (included[i])
+                {
+                    continue;
+                }
+                if (pass == 0)
+                {
+                    if (random_bits_left == 0)
+                    {
+                        random_bits = (*random)();
+                        random_bits_left = 32;
+                    }
+                    const bool pick = random_bits & 1;
+                    random_bits >>= 1;
+                    --random_bits_left;
+                    if (!pick)
+                    {
+                        continue;
+                    }
+                }
+
+                current_total += values[i].effective_value;
+                included[i] = true;
+                if (current_total >= target)
+                {
+                    reached_target = true;
+                    if (current_total < best_total)
+                    {
+                        best_total = current_total;
+                        best = included;
+                    }
+                    // Try to find a better subset without this candidate.
+                    current_total -= values[i].effective_value;
+                    included[i] = false;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+Selection select_knapsack(
+        const Candidates& candidates,
+        uint64_t target,
+        uint64_t target_with_change)
+{
+    // Candidates that are smaller than target (with change), and the single
+    // smallest of those that are bigger.
+    // Here Candidate::index is a position in candidates rather than in pool.
+    Candidates lower;
+    uint64_t lower_total = 0;
+    const Candidate* lowest_larger = nullptr;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const Candidate& candidate = candidates[i];
+        if (candidate.effective_value == target)
+        {
+            return Selection{i};
+        }
+        else if (candidate.effective_value < target_with_change)
+        {
+            lower.push_back(Candidate{candidate.effective_value, i});
+            lower_total += candidate.effective_value;
+        }
+        else if (!lowest_larger
+                || candidate.effective_value < lowest_larger->effective_value)
+        {
+            lowest_larger = &candidate;
+        }
+    }
+
+    const Selection larger_only = lowest_larger
+            ? Selection{static_cast<size_t>(lowest_larger - candidates.data())}
+            : Selection{};
+
+    if (lower_total < target)
+    {
+        return larger_only;
+    }
+
+    std::sort(lower.begin(), lower.end(),
+            [](const Candidate& left, const Candidate& right)
+            {
+                return left.effective_value > right.effective_value;
+            });
+
+    std::mt19937 random(KNAPSACK_RANDOM_SEED);
+    std::vector<bool> best = approximate_best_subset(
+            lower, lower_total, target, &random);
+    uint64_t best_total = 0;
+    for (size_t i = 0; i < lower.size(); ++i)
+    {
+        best_total += best[i] ? lower[i].effective_value : 0;
+    }
+
+    if (best_total != target && lower_total >= target_with_change)
+    {
+        best = approximate_best_subset(
+                lower, lower_total, target_with_change, &random);
+        best_total = 0;
+        for (size_t i = 0; i < lower.size(); ++i)
+        {
+            best_total += best[i] ? lower[i].effective_value : 0;
+        }
+    }
+
+    // Prefer single larger candidate if subset of lower ones is not
+    // an exact match and produces too little change, or is just bigger.
+    if (lowest_larger
+            && ((best_total != target && best_total < target_with_change)
+                    || lowest_larger->effective_value <= best_total))
+    {
+        return larger_only;
+    }
+
+    Selection result;
+    for (size_t i = 0; i < lower.size(); ++i)
+    {
+        if (best[i])
+        {
+            result.push_back(lower[i].index);
+        }
+    }
+    return result;
+}
+
+Selection select_largest_first(const Candidates& candidates, uint64_t target)
+{
+    // Heap makes it O(N + K*log(N)) for selecting K of N candidates.
+    std::vector<size_t> heap(candidates.size());
+    for (size_t i = 0; i < heap.size(); ++i)
+    {
+        heap[i] = i;
+    }
+    const auto less = [&candidates](size_t left, size_t right)
+    {
+        return candidates[left].effective_value < candidates[right].effective_value;
+    };
+    std::make_heap(heap.begin(), heap.end(), less);
+
+    Selection result;
+    uint64_t total = 0;
+    auto heap_end = heap.end();
+    while (total < target && heap_end != heap.begin())
+    {
+        std::pop_heap(heap.begin(), heap_end, less);
+        --heap_end;
+        result.push_back(*heap_end);
+        total += candidates[*heap_end].effective_value;
+    }
+    return result;
+}
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+CoinSelectionResult select_bitcoin_coins(
+        const BitcoinUnspentOutput* pool,
+        size_t pool_size,
+        const BitcoinCoinSelectionTarget* targets,
+        size_t targets_count,
+        uint64_t fee_per_byte,
+        BitcoinAddressType change_address_type,
+        BitcoinCoinSelectionStrategy strategy)
+{
+    INVARIANT(pool != nullptr || pool_size == 0);
+    INVARIANT(targets != nullptr || targets_count == 0);
+
+    const uint64_t change_output_fee = checked_mul(
+            get_output_size(change_address_type), fee_per_byte);
+    const uint64_t change_input_fee = get_fee_for_weight(
+            get_input_weight(change_address_type, false), fee_per_byte);
+    const uint64_t min_change = get_dust_threshold(change_address_type);
+
+    uint64_t targets_amount = 0;
+    uint64_t outputs_size = 0;
+    for (size_t i = 0; i < targets_count; ++i)
+    {
+        targets_amount = checked_add(targets_amount, targets[i].amount);
+        outputs_size += get_output_size(targets[i].address_type);
+    }
+
+    bool has_segwit_candidates = false;
+    for (size_t i = 0; i < pool_size; ++i)
+    {
+        has_segwit_candidates |= is_segwit(pool[i].address_type);
+    }
+
+    // Each candidate is charged for the weight of it's own input, rest of the
+    // fee is covered by the target.
+    Candidates candidates;
+    candidates.reserve(pool_size);
+    uint64_t available = 0;
+    for (size_t i = 0; i < pool_size; ++i)
+    {
+        const uint64_t input_fee = get_fee_for_weight(
+                get_input_weight(pool[i].address_type, has_segwit_candidates),
+                fee_per_byte);
+        if (pool[i].amount <= input_fee)
+        {
+            // Not worth spending.
+            continue;
+        }
+        candidates.push_back(Candidate{pool[i].amount - input_fee, i});
+        available = checked_add(available, candidates.back().effective_value);
+    }
+
+    // Since each part of the fee is rounded up separately, their sum is never
+    // less than fee of the whole transaction. Counters are assumed to take
+    // as much space as needed to fit all candidates and all outputs.
+    const uint64_t transaction_weight = (BITCOIN_TRANSACTION_HEADER_SIZE
+            + get_compact_size_len(candidates.size())
+            + get_compact_size_len(targets_count + 1)
+            + outputs_size) * WITNESS_SCALE_FACTOR
+            + (has_segwit_candidates ? BITCOIN_SEGWIT_HEADER_WEIGHT : 0);
+
+    const uint64_t target = checked_add(targets_amount,
+            get_fee_for_weight(transaction_weight, fee_per_byte));
+    const uint64_t target_with_change = checked_add(target,
+            checked_add(change_output_fee, min_change));
+
+    if (available < target)
+    {
+        THROW_EXCEPTION2(ERROR_TRANSACTION_INSUFFICIENT_FUNDS,
+                "Not enough funds to pay for all targets and a fee.")
+                << " Available: " << available << ", required: " << target;
+    }
+
+    Selection selection;
+    switch (strategy)
+    {
+        case BITCOIN_COIN_SELECTION_BRANCH_AND_BOUND:
+        {
+            std::sort(candidates.begin(), candidates.end(),
+                    [](const Candidate& left, const Candidate& right)
+                    {
+                        return left.effective_value > right.effective_value
+                                || (left.effective_value == right.effective_value
+                                        && left.index < right.index);
+                    });
+            selection = select_branch_and_bound(candidates, available, target,
+                    checked_add(target,
+                            checked_add(change_output_fee, change_input_fee)));
+            if (selection.empty())
+            {
+                selection = select_knapsack(candidates, target, target_with_change);
+            }
+            break;
+        }
+        case BITCOIN_COIN_SELECTION_KNAPSACK:
+            selection = select_knapsack(candidates, target, target_with_change);
+            break;
+        case BITCOIN_COIN_SELECTION_LARGEST_FIRST:
+            selection = select_largest_first(candidates, target);
+            break;
+        default:
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Invalid coin selection strategy.")
+                    << " Strategy: " << strategy;
+    }
+    INVARIANT(sum_effective_values(candidates, selection) >= target);
+
+    // Compute fee for exactly the selected inputs.
+    CoinSelectionResult result;
+    bool has_segwit_inputs = false;
+    for (const size_t i : selection)
+    {
+        result.selected.push_back(candidates[i].index);
+        has_segwit_inputs |= is_segwit(pool[candidates[i].index].address_type);
+    }
+    std::sort(result.selected.begin(), result.selected.end());
+
+    uint64_t selected_amount = 0;
+    uint64_t inputs_weight = 0;
+    for (const size_t i : result.selected)
+    {
+        selected_amount += pool[i].amount;
+        inputs_weight += get_input_weight(pool[i].address_type, has_segwit_inputs);
+    }
+    const uint64_t weight_with_change = (BITCOIN_TRANSACTION_HEADER_SIZE
+            + get_compact_size_len(selection.size())
+            + get_compact_size_len(targets_count + 1)
+            + outputs_size + get_output_size(change_address_type))
+            * WITNESS_SCALE_FACTOR
+            + (has_segwit_inputs ? BITCOIN_SEGWIT_HEADER_WEIGHT : 0)
+            + inputs_weight;
+    const uint64_t fee_with_change = get_fee_for_weight(weight_with_change, fee_per_byte);
+
+    const uint64_t remainder = selected_amount - targets_amount;
+    if (remainder >= fee_with_change + min_change)
+    {
+        result.change_amount = remainder - fee_with_change;
+        result.fee = fee_with_change;
+    }
+    else
+    {
+        result.change_amount = 0;
+        result.fee = remainder;
+    }
+
+    return result;
+}
+
+} // namespace internal
+} // namespace multy_core
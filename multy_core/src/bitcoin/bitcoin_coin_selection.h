@@ -0,0 +1,53 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_BITCOIN_COIN_SELECTION_H
+#define MULTY_CORE_SRC_BITCOIN_COIN_SELECTION_H
+
+#include "multy_core/bitcoin_coin_selection.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace multy_core
+{
+namespace internal
+{
+
+struct CoinSelectionResult
+{
+    std::vector<size_t> selected; // indices in the pool, in ascending order.
+    uint64_t change_amount;       // 0 if there is no change output.
+    uint64_t fee;
+};
+
+/** Select UTXOs from the pool to pay for all targets and a fee.
+ *
+ * Fee is estimated with the worst-case signature size for every selected
+ * output, segwit (P2SH-P2WPKH) inputs are accounted by their virtual size.
+ * If change is too small to be worth an output (i.e. it is dust), it is added
+ * to the fee and change_amount is zero.
+ *
+ * Complexity is O(N*log(N)) in pool size, plus a bounded amount of work
+ * for BRANCH_AND_BOUND and KNAPSACK strategies, which makes it suitable
+ * for pools of hundreds of thousands of outputs.
+ *
+ * @throw Exception with ERROR_TRANSACTION_INSUFFICIENT_FUNDS if pool
+ * doesn't have enough funds.
+ */
+CoinSelectionResult select_bitcoin_coins(
+        const BitcoinUnspentOutput* pool,
+        size_t pool_size,
+        const BitcoinCoinSelectionTarget* targets,
+        size_t targets_count,
+        uint64_t fee_per_byte,
+        BitcoinAddressType change_address_type,
+        BitcoinCoinSelectionStrategy strategy);
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_SRC_BITCOIN_COIN_SELECTION_H
@@ -66,6 +66,17 @@ HDAccountPtr BitcoinFacade::make_hd_account(
         index));
 }
 
+HDAccountPtr BitcoinFacade::make_watch_only_hd_account(
+        BlockchainType blockchain_type,
+        uint32_t account_type,
+        const ExtendedKey& account_public_key) const
+{
+    return HDAccountPtr(new BitcoinHDAccount(
+            blockchain_type,
+            to_bitcoin_account_type(account_type),
+            account_public_key));
+}
+
 AccountPtr BitcoinFacade::make_account(
         BlockchainType blockchain_type,
         uint32_t account_type,
@@ -35,6 +35,11 @@ public:
             const ExtendedKey& master_key,
             uint32_t index) const override;
 
+    HDAccountPtr make_watch_only_hd_account(
+            BlockchainType blockchain_type,
+            uint32_t account_type,
+            const ExtendedKey& account_public_key) const override;
+
     AccountPtr make_account(
             BlockchainType blockchain_type,
             uint32_t account_type,
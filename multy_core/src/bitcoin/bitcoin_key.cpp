@@ -78,7 +78,9 @@ BitcoinPrivateKey::BitcoinPrivateKey(KeyData data,
     : m_data(std::move(data)),
       m_net_type(net_type),
       m_public_key_format(public_key_format),
-      m_account_type(account_type)
+      m_account_type(account_type),
+      m_public_key_data(),
+      m_public_key_hash()
 {
     ec_validate_private_key(as_binary_data(m_data));
 }
@@ -90,7 +92,9 @@ BitcoinPrivateKey::BitcoinPrivateKey(const BinaryData& data,
     : m_data(data.data, data.data + data.len),
       m_net_type(net_type),
       m_public_key_format(public_key_format),
-      m_account_type(account_type)
+      m_account_type(account_type),
+      m_public_key_data(),
+      m_public_key_hash()
 {
     ec_validate_private_key(as_binary_data(m_data));
 }
@@ -121,17 +125,40 @@ std::string BitcoinPrivateKey::to_string() const
 
 PublicKeyPtr BitcoinPrivateKey::make_public_key() const
 {
-    const size_t public_key_size =
-            (m_public_key_format == EC_PUBLIC_KEY_COMPRESSED)
-                    ? EC_PUBLIC_KEY_LEN : EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
-    BitcoinPublicKey::KeyData key_data(public_key_size, 0);
-    BinaryData public_key_data = as_binary_data(key_data);
+    return PublicKeyPtr(new BitcoinPublicKey(get_public_key_data()));
+}
 
-    ec_private_to_public_key(as_binary_data(m_data),
-            m_public_key_format,
-            &public_key_data);
+const BitcoinPrivateKey::KeyData& BitcoinPrivateKey::get_public_key_data() const
+{
+    return m_public_key_data.get([this]()
+    {
+        const size_t public_key_size =
+                (m_public_key_format == EC_PUBLIC_KEY_COMPRESSED)
+                        ? EC_PUBLIC_KEY_LEN : EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+        KeyData key_data(public_key_size, 0);
+        BinaryData public_key_data = as_binary_data(key_data);
+
+        ec_private_to_public_key(as_binary_data(m_data),
+                m_public_key_format,
+                &public_key_data);
+
+        return key_data;
+    });
+}
 
-    return PublicKeyPtr(new BitcoinPublicKey(key_data));
+const BitcoinPrivateKey::PublicKeyHash& BitcoinPrivateKey::get_public_key_hash() const
+{
+    return m_public_key_hash.get([this]()
+    {
+        const KeyData& key_data = get_public_key_data();
+
+        PublicKeyHash result;
+        THROW_IF_WALLY_ERROR(
+                wally_hash160(key_data.data(), key_data.size(),
+                        result.data(), result.size()),
+                "hash160 failed.");
+        return result;
+    });
 }
 
 PrivateKeyPtr BitcoinPrivateKey::clone() const
@@ -142,15 +169,21 @@ PrivateKeyPtr BitcoinPrivateKey::clone() const
 BinaryDataPtr BitcoinPrivateKey::sign(const BinaryData& data) const
 {
     auto data_hash = do_hash<SHA2_DOUBLE, 256>(data);
+    BinaryDataPtr result = sign_hash(as_binary_data(data_hash));
+    wally_bzero(data_hash.data(), data_hash.size());
+
+    return result;
+}
 
+BinaryDataPtr BitcoinPrivateKey::sign_hash(const BinaryData& hash) const
+{
     std::array<uint8_t, EC_SIGNATURE_LEN> signature;
     THROW_IF_WALLY_ERROR(
             wally_ec_sig_from_bytes(
                     m_data.data(), m_data.size(),
-                    data_hash.data(), data_hash.size(),
+                    hash.data, hash.len,
                     EC_FLAG_ECDSA, signature.data(), signature.size()),
             "Failed to sign binary data with private key.");
-    wally_bzero(data_hash.data(), data_hash.size());
 
     std::array<uint8_t, EC_SIGNATURE_DER_MAX_LEN> der_signature;
     size_t written;
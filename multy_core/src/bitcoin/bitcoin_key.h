@@ -10,10 +10,14 @@
 #include "multy_core/bitcoin.h"
 
 #include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/cached_value.h"
 #include "multy_core/src/ec_key_utils.h"
 
+#include "wally_crypto.h"
+
 struct BinaryData;
 
+#include <array>
 #include <vector>
 #include <cstdint>
 #include <string>
@@ -45,6 +49,7 @@ private:
 struct BitcoinPrivateKey : public PrivateKey
 {
     typedef std::vector<uint8_t> KeyData;
+    typedef std::array<uint8_t, HASH160_LEN> PublicKeyHash;
 
     BitcoinPrivateKey(KeyData data,
             BitcoinNetType net_type,
@@ -63,8 +68,15 @@ struct BitcoinPrivateKey : public PrivateKey
     PrivateKeyPtr clone() const override;
     BinaryDataPtr sign(const BinaryData& data) const override;
 
+    // Sign a 32-byte hash of the data, sign(data) is sign_hash(SHA2_DOUBLE(data)).
+    BinaryDataPtr sign_hash(const BinaryData& hash) const;
+
     BitcoinNetType get_net_type() const;
 
+    // Public key and it's HASH160 are computed on first use and then cached.
+    const KeyData& get_public_key_data() const;
+    const PublicKeyHash& get_public_key_hash() const;
+
 private:
     // TODO: use a shared_pointer to KeyData here to keep a single copy of
     // the private key data in memory.
@@ -72,6 +84,8 @@ private:
     const BitcoinNetType m_net_type;
     const PublicKeyFormat m_public_key_format;
     const BitcoinAccountType m_account_type;
+    CachedValue<KeyData> m_public_key_data;
+    CachedValue<PublicKeyHash> m_public_key_hash;
 };
 
 BitcoinPrivateKeyPtr make_bitcoin_private_key_from_wif(const char* wif_string, BitcoinAccountType account_type);
@@ -14,6 +14,8 @@
 #include "multy_core/src/exception_stream.h"
 #include "multy_core/src/api/properties_impl.h"
 #include "multy_core/src/bitcoin/bitcoin_account.h"
+#include "multy_core/src/bitcoin/bitcoin_key.h"
+#include "multy_core/src/bitcoin/bitcoin_transaction_view.h"
 #include "multy_core/src/exception.h"
 #include "multy_core/src/hash.h"
 #include "multy_core/src/u_ptr.h"
@@ -28,16 +30,18 @@
 #include <limits>
 #include <sstream>
 #include <string.h>
-#include <unordered_map>
 
 namespace
 {
 using namespace multy_core::internal;
 const size_t BITCOIN_MAX_MESSAGE_LENGTH = 75;
-const size_t BITCOIN_DUST_RELAY_FEE_PER_BYTE = 3;
-const size_t BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_NON_SEGWIT = 182;
-const size_t BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_SEGWIT = 98;
 const uint32_t BITCOIN_INPUT_SEQ_FINAL = 0xFFFFFFFF;
+const uint8_t BITCOIN_SIGHASH_ALL = 1;
+
+// P2WPKH witness program: version byte and a push of 20-bytes public key hash.
+const size_t BITCOIN_P2WPKH_WITNESS_PROGRAM_LEN = 1 + 1 + HASH160_LEN;
+const size_t BITCOIN_P2SH_SCRIPT_PUBKEY_LEN = 1 + 1 + HASH160_LEN + 1;
+const size_t BITCOIN_WITNESS_ITEMS_COUNT = 2; // signature and public key
 
 // BIP-125: Any value less than (BITCOIN_INPUT_SEQ_FINAL - 1) would do, see
 // https://github.com/bitcoin/bips/blob/master/bip-0125.mediawiki
@@ -104,9 +108,12 @@ public:
 class BitcoinDataStream : public BitcoinStream
 {
 public:
-    BitcoinDataStream()
+    // size_hint is the expected size of the data, to avoid reallocations.
+    explicit BitcoinDataStream(size_t size_hint = 0)
         : m_data()
-    {}
+    {
+        m_data.reserve(size_hint);
+    }
 
     BitcoinDataStream& write_data(const uint8_t* data, uint32_t len) override
     {
@@ -126,24 +133,50 @@ private:
     std::vector<uint8_t> m_data;
 };
 
+// Writes into BinaryData of exact size, computed with BitcoinBytesCountStream.
+class BitcoinBinaryDataStream : public BitcoinStream
+{
+public:
+    explicit BitcoinBinaryDataStream(size_t size)
+        : m_writer(size)
+    {}
+
+    BitcoinBinaryDataStream& write_data(const uint8_t* data, uint32_t len) override
+    {
+        m_writer.write_data(data, len);
+        return *this;
+    }
+
+    BinaryDataPtr release_content()
+    {
+        return m_writer.release();
+    }
+
+private:
+    FixedSizeBinaryDataWriter m_writer;
+};
+
+// Hashes data as it is written, without buffering it.
+// Copy of the stream carries over SHA-256 midstate, which allows to hash
+// common prefix of several messages only once.
 class BitcoinHashStream : public BitcoinStream
 {
 public:
     BitcoinHashStream& write_data(const uint8_t* data, uint32_t len) override
     {
-        m_stream.write_data(data, len);
+        m_hasher.update(BinaryData{data, len});
         return *this;
     }
 
-    BinaryData get_hash() const
+    // Double SHA-256 of all the data written so far.
+    hash<256> get_hash() const
     {
-        m_hash = do_hash<SHA2_DOUBLE, 256>(m_stream.get_content());
-        return as_binary_data(m_hash);
+        IncrementalHasher<SHA2_DOUBLE, 256> hasher(m_hasher);
+        return hasher.finalize();
     }
 
 private:
-    BitcoinDataStream m_stream;
-    mutable hash<256> m_hash;
+    IncrementalHasher<SHA2_DOUBLE, 256> m_hasher;
 };
 
 // Does no writing, only counting how many bytes would have been written.
@@ -156,6 +189,12 @@ public:
         return *this;
     }
 
+    // Count bytes that are not backed by any actual data.
+    void write_size(size_t len)
+    {
+        bytes_count += len;
+    }
+
     size_t get_bytes_count() const
     {
         return bytes_count;
@@ -289,6 +328,13 @@ BitcoinStream& operator<<(BitcoinStream& stream, const ReversedBinaryData& data)
     return stream;
 }
 
+size_t get_compact_size_len(uint64_t size)
+{
+    BitcoinBytesCountStream counter_stream;
+    write_compact_size(size, &counter_stream);
+    return counter_stream.get_bytes_count();
+}
+
 void write_compact_size(uint64_t size, BitcoinStream* stream)
 {
     if (size < 253)
@@ -338,6 +384,104 @@ BinaryDataPtr make_script_pub_key(const BinaryData& public_key_hash, BitcoinAddr
     return make_clone(sig_stream.get_content());
 }
 
+// P2WPKH witness program, that is put into scriptSig of P2SH-P2WPKH input.
+BinaryDataPtr make_p2wpkh_witness_program(const BinaryData& public_key_hash)
+{
+    BitcoinDataStream program_stream;
+    program_stream << OP_FALSE; // witness version 0
+    program_stream << as_compact_size(public_key_hash.len);
+    program_stream << public_key_hash;
+
+    return make_clone(program_stream.get_content());
+}
+
+/** Makes script_pubkey of the output spendable with given public key.
+ *
+ * @param public_key - public key.
+ * @param address_type - either BITCOIN_ADDRESS_P2PKH or BITCOIN_ADDRESS_P2SH_P2WPKH.
+ */
+BinaryDataPtr make_script_pub_key_from_public_key(
+        const PublicKey& public_key, BitcoinAddressType address_type)
+{
+    std::array<uint8_t, HASH160_LEN> public_key_hash = {};
+    BinaryData public_key_hash_data = as_binary_data(public_key_hash);
+    bitcoin_hash_160(public_key.get_content(), &public_key_hash_data);
+
+    if (address_type == BITCOIN_ADDRESS_P2SH_P2WPKH)
+    {
+        std::array<uint8_t, HASH160_LEN> script_hash = {};
+        BinaryData script_hash_data = as_binary_data(script_hash);
+        bitcoin_hash_160(*make_p2wpkh_witness_program(public_key_hash_data),
+                &script_hash_data);
+
+        return make_script_pub_key(script_hash_data, BITCOIN_ADDRESS_P2SH);
+    }
+
+    return make_script_pub_key(public_key_hash_data, address_type);
+}
+
+void write_signature_and_public_key(const BinaryData& signature,
+        const BinaryData& public_key,
+        BitcoinStream* stream)
+{
+    *stream << as_compact_size(signature.len + sizeof(BITCOIN_SIGHASH_ALL));
+    *stream << signature;
+    *stream << BITCOIN_SIGHASH_ALL; // hash-code type
+
+    *stream << as_compact_size(public_key.len);
+    *stream << public_key;
+}
+
+size_t get_max_signature_and_public_key_size(const PrivateKey& private_key)
+{
+    // Length of the DER-encoded signature is not known until the data is
+    // actually signed, hence the longest possible signature is assumed.
+    const size_t signature_size = EC_SIGNATURE_DER_MAX_LEN + sizeof(BITCOIN_SIGHASH_ALL);
+    const size_t public_key_size = private_key.make_public_key()->get_content().len;
+
+    return get_compact_size_len(signature_size) + signature_size
+            + get_compact_size_len(public_key_size) + public_key_size;
+}
+
+const BitcoinPrivateKey& get_bitcoin_private_key(const PrivateKey& private_key)
+{
+    const BitcoinPrivateKey* result
+            = dynamic_cast<const BitcoinPrivateKey*>(&private_key);
+    if (!result)
+    {
+        THROW_EXCEPTION2(ERROR_TRANSACTION_INVALID_PRIVATE_KEY,
+                "Source private key is not a Bitcoin private key.");
+    }
+    return *result;
+}
+
+/** Signs each of the signature hashes with the corresponding private key.
+ *
+ * Signatures are computed on up to threads_count threads, see parallel_for().
+ * Since ECDSA signatures are deterministic (RFC6979), result does not
+ * depend on threads_count.
+ */
+std::vector<BinaryDataPtr> sign_all(
+        const std::vector<const BitcoinPrivateKey*>& private_keys,
+        const std::vector<hash<256>>& sighashes,
+        size_t threads_count)
+{
+    INVARIANT(private_keys.size() == sighashes.size());
+
+    std::vector<BinaryDataPtr> signatures(sighashes.size());
+    parallel_for(sighashes.size(), 1, std::max<size_t>(1, threads_count),
+            [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    signatures[i] = private_keys[i]->sign_hash(
+                            as_binary_data(sighashes[i]));
+                }
+            });
+
+    return signatures;
+}
+
 BinaryDataPtr make_script_pub_key_from_address(const BitcoinNetType expected_net_type, const std::string& address)
 {
     BitcoinNetType net_type;
@@ -493,8 +637,7 @@ public:
     friend BitcoinStream& operator<<(
             BitcoinStream& stream, const BitcoinTransactionSource& source)
     {
-        stream << reverse(**source.prev_transaction_hash);
-        stream << source.prev_transaction_out_index;
+        source.write_outpoint(&stream);
 
         if (source.script_signature)
         {
@@ -511,6 +654,61 @@ public:
         return stream;
     }
 
+    void write_outpoint(BitcoinStream* stream) const
+    {
+        *stream << reverse(**prev_transaction_hash);
+        *stream << prev_transaction_out_index;
+    }
+
+    // Writes source with given sig script instead of script_signature.
+    void write_with_script(const BinaryData& script, BitcoinStream* stream) const
+    {
+        write_outpoint(stream);
+        *stream << as_compact_size(script.len);
+        *stream << script;
+        *stream << seq;
+    }
+
+    // Spends P2SH-P2WPKH output, which is the only supported kind of P2SH.
+    bool is_segwit() const
+    {
+        const BinaryData& script_pubkey = **prev_transaction_out_script_pubkey;
+        return script_pubkey.len == BITCOIN_P2SH_SCRIPT_PUBKEY_LEN
+                && script_pubkey.data[0] == OP_HASH160
+                && script_pubkey.data[script_pubkey.len - 1] == OP_EQUAL;
+    }
+
+    /** Size of the source serialized with a signed script, computed without signing.
+     *
+     * Witness data is not included, see get_max_witness_size().
+     */
+    size_t get_max_serialized_size() const
+    {
+        const size_t script_signature_size = is_segwit()
+                ? get_compact_size_len(BITCOIN_P2WPKH_WITNESS_PROGRAM_LEN)
+                        + BITCOIN_P2WPKH_WITNESS_PROGRAM_LEN
+                : get_max_signature_and_public_key_size(**private_key);
+
+        return prev_transaction_hash.get_value()->len
+                + sizeof(uint32_t) // prev_transaction_out_index
+                + get_compact_size_len(script_signature_size)
+                + script_signature_size
+                + sizeof(seq);
+    }
+
+    // Size of the witness data of the source, computed without signing.
+    size_t get_max_witness_size() const
+    {
+        if (!is_segwit())
+        {
+            // empty witness
+            return get_compact_size_len(0);
+        }
+
+        return get_compact_size_len(BITCOIN_WITNESS_ITEMS_COUNT)
+                + get_max_signature_and_public_key_size(**private_key);
+    }
+
 public:
     PropertyT<BinaryDataPtr> prev_transaction_hash;
     PropertyT<int32_t> prev_transaction_out_index;
@@ -525,19 +723,155 @@ public:
     PropertyT<BigInt> amount; // Not serialized:
 };
 
+/** Computes BIP143 signature hashes for segwit sources.
+ *
+ * hashPrevouts, hashSequence and hashOutputs are the same for all sources
+ * of the transaction, so those are computed only once, which makes signing
+ * linear in transaction size.
+ * See https://github.com/bitcoin/bips/blob/master/bip-0143.mediawiki
+ */
+class BitcoinSegwitSighashBuilder
+{
+public:
+    BitcoinSegwitSighashBuilder(int32_t version,
+            const std::vector<BitcoinTransactionSourcePtr>& sources,
+            const BinaryData& outputs,
+            uint32_t lock_time)
+        : m_version(version),
+          m_lock_time(lock_time),
+          m_hash_prevouts(),
+          m_hash_sequence(),
+          m_hash_outputs()
+    {
+        BitcoinHashStream prevouts_stream;
+        BitcoinHashStream sequence_stream;
+        for (const auto& source : sources)
+        {
+            source->write_outpoint(&prevouts_stream);
+            sequence_stream << source->seq;
+        }
+
+        m_hash_prevouts = prevouts_stream.get_hash();
+        m_hash_sequence = sequence_stream.get_hash();
+        m_hash_outputs = do_hash<SHA2_DOUBLE, 256>(outputs);
+    }
+
+    hash<256> get_hash(const BitcoinTransactionSource& source,
+            const BinaryData& script_code) const
+    {
+        BitcoinHashStream stream;
+        stream << m_version;
+        stream << as_binary_data(m_hash_prevouts);
+        stream << as_binary_data(m_hash_sequence);
+        source.write_outpoint(&stream);
+        stream << as_compact_size(script_code.len);
+        stream << script_code;
+        stream << source.amount;
+        stream << source.seq;
+        stream << as_binary_data(m_hash_outputs);
+        stream << m_lock_time;
+        stream << static_cast<uint32_t>(BITCOIN_SIGHASH_ALL);
+
+        return stream.get_hash();
+    }
+
+private:
+    const int32_t m_version;
+    const uint32_t m_lock_time;
+    hash<256> m_hash_prevouts;
+    hash<256> m_hash_sequence;
+    hash<256> m_hash_outputs;
+};
+
+/** Computes legacy (pre-segwit) SIGHASH_ALL signature hashes for non-segwit sources.
+ *
+ * Preimage for the source is the transaction with sig script of that source
+ * set to prev_tx_pubscript and all other sig scripts empty, followed by
+ * the hash type. Preimages of all sources share the common prefix: version
+ * and all sources before the one being signed. That prefix is hashed only
+ * once and SHA-256 midstate is reused for every source, so sources has to
+ * be processed in order.
+ */
+class BitcoinLegacySighashBuilder
+{
+public:
+    BitcoinLegacySighashBuilder(int32_t version,
+            const std::vector<BitcoinTransactionSourcePtr>& sources,
+            size_t outputs_count,
+            const BinaryData& outputs,
+            uint32_t lock_time)
+        : m_sources(sources),
+          m_prefix_stream(),
+          m_prefix_sources_count(0),
+          m_suffix()
+    {
+        m_prefix_stream << version;
+        m_prefix_stream << as_compact_size(sources.size());
+
+        BitcoinDataStream suffix_stream;
+        suffix_stream << as_compact_size(outputs_count);
+        suffix_stream << outputs;
+        suffix_stream << lock_time;
+        suffix_stream << static_cast<uint32_t>(BITCOIN_SIGHASH_ALL);
+        m_suffix = make_clone(suffix_stream.get_content());
+    }
+
+    hash<256> get_hash(size_t source_index)
+    {
+        INVARIANT(source_index < m_sources.size());
+        INVARIANT(source_index >= m_prefix_sources_count);
+
+        const BinaryData empty_script{nullptr, 0};
+        for (; m_prefix_sources_count < source_index; ++m_prefix_sources_count)
+        {
+            m_sources[m_prefix_sources_count]->write_with_script(
+                    empty_script, &m_prefix_stream);
+        }
+
+        BitcoinHashStream stream(m_prefix_stream);
+        const BitcoinTransactionSource& source = *m_sources[source_index];
+        source.write_with_script(
+                **source.prev_transaction_out_script_pubkey, &stream);
+        for (size_t i = source_index + 1; i < m_sources.size(); ++i)
+        {
+            m_sources[i]->write_with_script(empty_script, &stream);
+        }
+        stream << *m_suffix;
+
+        return stream.get_hash();
+    }
+
+private:
+    const std::vector<BitcoinTransactionSourcePtr>& m_sources;
+    BitcoinHashStream m_prefix_stream;
+    size_t m_prefix_sources_count;
+    BinaryDataPtr m_suffix; // outputs, lock_time and hash type.
+};
+
 BitcoinTransaction::BitcoinTransaction(BlockchainType blockchain_type)
     : TransactionBase(blockchain_type),
       m_version(1),
-      m_is_segwit_transaction(0),
       m_lock_time(0),
       m_is_replaceable(1, get_transaction_properties(),
                 "is_replaceable", Property::OPTIONAL),
+      m_signing_threads_count(1, get_transaction_properties(),
+                "signing_threads_count", Property::OPTIONAL,
+                [](const int32_t& threads_count)
+                {
+                    if (threads_count < 1)
+                    {
+                        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                                "Signing threads count should be >= 1.");
+                    }
+                }),
       m_fee(new BitcoinTransactionFee),
       m_sources(),
       m_destinations(),
-      m_message()
+      m_message(),
+      m_bulk_outputs(),
+      m_bulk_outputs_count(0),
+      m_bulk_outputs_amount(0)
 {
-    //    m_properties.bind_property("segwit_mode", &m_is_segwit_transaction);
     //    m_properties.bind_property("lock_time", &m_lock_time);
     register_properties("", m_fee->get_properties());
 }
@@ -547,27 +881,49 @@ BinaryDataPtr BitcoinTransaction::serialize()
     update();
     sign();
 
-    BitcoinDataStream data_stream;
+    BitcoinBytesCountStream counter_stream;
+    serialize_to_stream(&counter_stream, WITH_POSITIVE_CHANGE_AMOUNT, WITH_WITNESS);
 
-    serialize_to_stream(&data_stream, WITH_POSITIVE_CHANGE_AMOUNT);
-    return make_clone(data_stream.get_content());
+    BitcoinBinaryDataStream data_stream(counter_stream.get_bytes_count());
+    serialize_to_stream(&data_stream, WITH_POSITIVE_CHANGE_AMOUNT, WITH_WITNESS);
+    return data_stream.release_content();
 }
 
 template <typename T>
-void BitcoinTransaction::serialize_to_stream(T* stream, DestinationsToUse destinations_to_use) const
+void BitcoinTransaction::serialize_to_stream(T* stream,
+        DestinationsToUse destinations_to_use,
+        WitnessToUse witness_to_use) const
 {
+    const bool with_witness = witness_to_use == WITH_WITNESS && is_segwit();
+
     *stream << m_version;
+    if (with_witness)
+    {
+        *stream << BITCOIN_SEGWIT_MARKER;
+        *stream << BITCOIN_SEGWIT_FLAG;
+    }
     *stream << as_compact_size(m_sources.size());
     for (const auto& source : m_sources)
     {
         *stream << *source;
     }
 
-    const auto destinations = get_non_zero_destinations(destinations_to_use);
-    *stream << as_compact_size(destinations.size());
-    for (const auto& destination : destinations)
+    *stream << as_compact_size(get_outputs_count(destinations_to_use));
+    write_outputs(stream, destinations_to_use);
+
+    if (with_witness)
     {
-        *stream << *destination;
+        for (const auto& source : m_sources)
+        {
+            if (source->script_witness)
+            {
+                *stream << *source->script_witness;
+            }
+            else
+            {
+                *stream << as_compact_size(0);
+            }
+        }
     }
 
     *stream << m_lock_time;
@@ -575,33 +931,55 @@ void BitcoinTransaction::serialize_to_stream(T* stream, DestinationsToUse destin
 
 bool BitcoinTransaction::is_segwit() const
 {
-    return m_is_segwit_transaction != 0
-            && std::any_of(
-                       m_sources.begin(), m_sources.end(),
-                       [](const BitcoinTransactionSourcePtr& source) -> bool {
-                           return source->script_witness
-                                   && source->script_witness->len > 0;
-                       });
+    return std::any_of(
+            m_sources.begin(), m_sources.end(),
+            [](const BitcoinTransactionSourcePtr& source) -> bool {
+                return source->is_segwit();
+            });
 }
 
-BitcoinTransaction::Destinations BitcoinTransaction::get_non_zero_destinations(DestinationsToUse destinations_to_use) const
+bool BitcoinTransaction::is_serialized(
+        const BitcoinTransactionDestination& destination,
+        DestinationsToUse destinations_to_use) const
+{
+    return *destination.amount > BigInt(0)
+            || (destinations_to_use == WITH_NONPOSITIVE_CHANGE_AMOUNT
+                    && *destination.is_change);
+}
+
+size_t BitcoinTransaction::get_outputs_count(DestinationsToUse destinations_to_use) const
+{
+    size_t result = m_message ? 1 : 0;
+    for (const auto& destination : m_destinations)
+    {
+        if (is_serialized(*destination, destinations_to_use))
+        {
+            ++result;
+        }
+    }
+    return result + m_bulk_outputs_count;
+}
+
+void BitcoinTransaction::write_outputs(BitcoinStream* stream,
+        DestinationsToUse destinations_to_use) const
 {
-    // TODO: include also change destination and payload-only destination.
-    Destinations result;
     if (m_message)
     {
-        result.push_back(m_message.get());
+        *stream << *m_message;
     }
 
-    for (const auto& dest : m_destinations)
+    for (const auto& destination : m_destinations)
     {
-        if ( *dest->amount > BigInt(0) ||
-             (destinations_to_use == WITH_NONPOSITIVE_CHANGE_AMOUNT ? *dest->is_change : 0) )
+        if (is_serialized(*destination, destinations_to_use))
         {
-            result.push_back(dest.get());
+            *stream << *destination;
         }
     }
-    return result;
+
+    if (!m_bulk_outputs.empty())
+    {
+        stream->write_data(m_bulk_outputs.data(), m_bulk_outputs.size());
+    }
 }
 
 size_t BitcoinTransaction::estimate_transaction_size() const
@@ -610,7 +988,7 @@ size_t BitcoinTransaction::estimate_transaction_size() const
     // destinations.
     // Note that this estimation is valid only for non-segwit transactions.
     const size_t sources_count = m_sources.size();
-    const size_t destinations_count = get_non_zero_destinations(WITH_NONPOSITIVE_CHANGE_AMOUNT).size();
+    const size_t destinations_count = get_outputs_count(WITH_NONPOSITIVE_CHANGE_AMOUNT);
     // look function estimate_total_fee
     return static_cast<int64_t>(
             sources_count * (150 + 32) + destinations_count * 34 + 10);
@@ -636,6 +1014,7 @@ BigInt BitcoinTransaction::get_total_spent() const
             total_spent += *d->amount;
         }
     }
+    total_spent += m_bulk_outputs_amount;
 
     return total_spent + get_total_fee();
 }
@@ -658,7 +1037,7 @@ BigInt BitcoinTransaction::calculate_diff() const
         available += *s->amount;
     }
 
-    BigInt total_spent(0);
+    BigInt total_spent(m_bulk_outputs_amount);
     for (const auto& d : m_destinations)
     {
         total_spent += *d->amount;
@@ -674,7 +1053,7 @@ void BitcoinTransaction::verify() const
                 "Transaction should have at least one source.");
     }
 
-    if (m_destinations.empty())
+    if (m_destinations.empty() && m_bulk_outputs_count == 0)
     {
         THROW_EXCEPTION2(ERROR_TRANSACTION_NO_DESTINATIONS,
                 "Transaction should have at least one destination.");
@@ -700,18 +1079,16 @@ void BitcoinTransaction::verify() const
     for (const auto& s : m_sources)
     {
         const auto& public_key = s->private_key->make_public_key();
-        std::array<uint8_t, HASH160_LEN> public_key_hash;
-        BinaryData public_key_hash_data = as_binary_data(public_key_hash);
-
-        bitcoin_hash_160(public_key->get_content(), &public_key_hash_data);
-        BinaryDataPtr sig_script = make_script_pub_key(public_key_hash_data, BITCOIN_ADDRESS_P2PKH);
+        const bool is_segwit_source = s->is_segwit();
+        BinaryDataPtr sig_script = make_script_pub_key_from_public_key(
+                *public_key,
+                is_segwit_source ? BITCOIN_ADDRESS_P2SH_P2WPKH : BITCOIN_ADDRESS_P2PKH);
 
         if (*sig_script != **s->prev_transaction_out_script_pubkey)
         {
             AccountPtr error_account = make_bitcoin_account(
                     s->private_key->to_string().c_str(),
-                    // TODO: get account type from initial account, and put it here.
-                    BITCOIN_ACCOUNT_DEFAULT);
+                    is_segwit_source ? BITCOIN_ACCOUNT_SEGWIT : BITCOIN_ACCOUNT_DEFAULT);
 
             THROW_EXCEPTION2(ERROR_TRANSACTION_INVALID_PRIVATE_KEY,
                     "Source can't be spent using given private key.")
@@ -771,14 +1148,15 @@ void BitcoinTransaction::update()
                 << " Currenctly there are: " << change_destinations_count;
     }
 
-    // In order to compute transaction total cost we'll have to serialize tx.
+    // Transaction size doesn't depend on the change amount (it is always
+    // serialized as 8 bytes), hence the change can be computed in one go,
+    // with no need to serialize and sign the transaction multiple times.
     if (change_destination)
     {
         change_destination->amount.get_value() = BigInt{0};
-        uint64_t tx_size = get_transaction_serialized_size(WITH_NONPOSITIVE_CHANGE_AMOUNT);
-        BigInt expected_fee = tx_size * *m_fee->amount_per_byte;
-        BigInt current_fee = calculate_diff();
-        const BigInt remainder = current_fee - expected_fee;
+        const uint64_t tx_size = get_transaction_serialized_size(WITH_NONPOSITIVE_CHANGE_AMOUNT);
+        const BigInt expected_fee = tx_size * *m_fee->amount_per_byte;
+        const BigInt remainder = calculate_diff() - expected_fee;
 
         // NOTE: Not adding a change if output is an "dust". cost of spending money from that output exceeds its value.
         //
@@ -794,109 +1172,140 @@ void BitcoinTransaction::update()
         if (!is_dust_amount(remainder, change_destination->m_is_segwit_destination))
         {
             // not setting value with set_value(), since that would fail for read-only property.
-            change_destination->amount.get_value() += remainder;
-
-            tx_size = get_transaction_serialized_size(WITH_POSITIVE_CHANGE_AMOUNT);
-            expected_fee = tx_size * *m_fee->amount_per_byte;
-            current_fee = calculate_diff();
-            while (expected_fee > current_fee)
-            {
-                // NOTE: get shortage fee from change_destination amount
-                //      diff_fee is always negative here.
-                const BigInt diff_fee = current_fee - expected_fee;
-                change_destination->amount.get_value() += diff_fee;
-                // Recalculate transaction fee after changes in transaction
-                tx_size = get_transaction_serialized_size(WITH_POSITIVE_CHANGE_AMOUNT);
-                expected_fee = tx_size * *m_fee->amount_per_byte;
-                current_fee = calculate_diff();
-            }
-
-            if (is_dust_amount(change_destination->amount.get_value(), change_destination->m_is_segwit_destination))
-            {
-                change_destination->amount.get_value() = BigInt{0};
-            }
+            change_destination->amount.get_value() = remainder;
         }
     }
 
-    m_fee->validate_fee(calculate_diff(), get_transaction_serialized_size(WITH_POSITIVE_CHANGE_AMOUNT));   
+    m_fee->validate_fee(calculate_diff(), get_transaction_serialized_size(WITH_POSITIVE_CHANGE_AMOUNT));
 
-    if (get_non_zero_destinations(WITH_POSITIVE_CHANGE_AMOUNT).size() == 0)
+    if (get_outputs_count(WITH_POSITIVE_CHANGE_AMOUNT) == 0)
     {
         THROW_EXCEPTION2(ERROR_TRANSACTION_CHANGE_IS_TOO_SMALL_AND_NO_OTHER_DESTINATIONS,
                 "Transaction change is to small because of high fee.");
     }
 }
 
-uint64_t BitcoinTransaction::get_transaction_serialized_size(DestinationsToUse destinations_to_use)
+uint64_t BitcoinTransaction::get_transaction_serialized_size(DestinationsToUse destinations_to_use) const
 {
-    sign();
+    // Size of the signed transaction, computed without signing it:
+    // sources are estimated with the worst-case signature size,
+    // everything else is counted exactly as it would have been serialized.
+    // For segwit transaction that is a virtual size, as defined by BIP141.
     BitcoinBytesCountStream counter_stream;
-    serialize_to_stream(&counter_stream, destinations_to_use);
-    return counter_stream.get_bytes_count();
+    counter_stream << m_version;
+    counter_stream << as_compact_size(m_sources.size());
+    for (const auto& source : m_sources)
+    {
+        counter_stream.write_size(source->get_max_serialized_size());
+    }
+
+    counter_stream << as_compact_size(get_outputs_count(destinations_to_use));
+    write_outputs(&counter_stream, destinations_to_use);
+
+    counter_stream << m_lock_time;
+
+    const size_t base_size = counter_stream.get_bytes_count();
+    if (!is_segwit())
+    {
+        return base_size;
+    }
+
+    size_t witness_size = sizeof(BITCOIN_SEGWIT_MARKER) + sizeof(BITCOIN_SEGWIT_FLAG);
+    for (const auto& source : m_sources)
+    {
+        witness_size += source->get_max_witness_size();
+    }
+
+    // weight = base_size * 3 + total_size, virtual size is weight / 4 rounded up.
+    return (base_size * 4 + witness_size + 3) / 4;
 }
 
 void BitcoinTransaction::sign()
 {
-    // Sign inputs:
-    // for every input:
-    //      reset sig script with nullptr
-    // for every input:
-    //      set sig_script with prev_tx_pubscript
-    //      serialize transaction
-    //      save sig script to the variable
-    // once signing is done
-    // for every input:
-    //      reset sig script from variable
-
-    // for all inputs but the one being signed, sig script should be empty.
+    // Signing is done in three steps:
+    // 1. sequentially compute signature hash for every input:
+    //      segwit inputs according to BIP143, see BitcoinSegwitSighashBuilder,
+    //      non-segwit inputs with BitcoinLegacySighashBuilder.
+    // 2. sign hashes, in parallel if m_signing_threads_count > 1.
+    // 3. sequentially put signatures into sig scripts and witnesses.
     for (auto& source : m_sources)
     {
         source->script_signature.reset();
+        source->script_witness.reset();
     }
 
-    // Sign all inputs one by one and save sig_scripts for later.
-    std::unordered_map<BitcoinTransactionSource*, BinaryDataPtr> sig_scripts;
-    for (auto& source : m_sources)
+    // Outputs are serialized only once and shared by both builders.
+    BitcoinBytesCountStream outputs_size_stream;
+    write_outputs(&outputs_size_stream, WITH_POSITIVE_CHANGE_AMOUNT);
+    BitcoinDataStream outputs_stream(outputs_size_stream.get_bytes_count());
+    write_outputs(&outputs_stream, WITH_POSITIVE_CHANGE_AMOUNT);
+    const BinaryData outputs = outputs_stream.get_content();
+
+    BitcoinLegacySighashBuilder legacy_sighash_builder(m_version, m_sources,
+            get_outputs_count(WITH_POSITIVE_CHANGE_AMOUNT), outputs, m_lock_time);
+    BitcoinSegwitSighashBuilder segwit_sighash_builder(
+            m_version, m_sources, outputs, m_lock_time);
+
+    std::vector<PublicKeyPtr> public_keys;
+    std::vector<const BitcoinPrivateKey*> private_keys;
+    std::vector<hash<256>> sighashes;
+    public_keys.reserve(m_sources.size());
+    private_keys.reserve(m_sources.size());
+    sighashes.reserve(m_sources.size());
+
+    for (size_t i = 0; i < m_sources.size(); ++i)
     {
-        source->script_signature.swap(
-                source->prev_transaction_out_script_pubkey.get_value());
-        BinaryDataPtr sig_script;
+        const auto& source = m_sources[i];
+        const BitcoinPrivateKey& private_key = get_bitcoin_private_key(
+                **source->private_key);
+        PublicKeyPtr public_key = private_key.make_public_key();
 
+        if (source->is_segwit())
         {
-            BitcoinDataStream hash_stream;
-            serialize_to_stream(&hash_stream, WITH_POSITIVE_CHANGE_AMOUNT);
-            hash_stream << uint32_t(1); // signature version
-
-            const PrivateKeyPtr& private_key = source->private_key.get_value();
-            BinaryDataPtr signature
-                    = private_key->sign(hash_stream.get_content());
-
-            BitcoinDataStream sig_script_stream;
-            sig_script_stream << as_compact_size(signature->len + 1);
-            sig_script_stream << *signature;
-            sig_script_stream << uint8_t(1); // hash-code type
-
-            const PublicKeyPtr& public_key = private_key->make_public_key();
-            const BinaryData& public_key_data = public_key->get_content();
-            sig_script_stream << as_compact_size(public_key_data.len);
-            sig_script_stream << public_key_data;
-
-            sig_script = make_clone(sig_script_stream.get_content());
+            sighashes.push_back(segwit_sighash_builder.get_hash(*source,
+                    *make_script_pub_key(
+                            as_binary_data(private_key.get_public_key_hash()),
+                            BITCOIN_ADDRESS_P2PKH)));
+        }
+        else
+        {
+            sighashes.push_back(legacy_sighash_builder.get_hash(i));
         }
-        source->script_signature.swap(
-                source->prev_transaction_out_script_pubkey.get_value());
 
-        const auto p = sig_scripts.emplace(source.get(), std::move(sig_script));
-        INVARIANT(p.second == true);
+        public_keys.push_back(std::move(public_key));
+        private_keys.push_back(&private_key);
     }
 
-    // restore all sig scripts
-    for (auto& source : m_sources)
+    // NOTE: libwally creates secp256k1 context lazily in non thread-safe manner,
+    // it was already done by make_public_key() above, so signing from
+    // multiple threads is safe.
+    const std::vector<BinaryDataPtr> signatures = sign_all(
+            private_keys, sighashes, *m_signing_threads_count);
+
+    for (size_t i = 0; i < m_sources.size(); ++i)
     {
-        const auto p = sig_scripts.find(source.get());
-        INVARIANT(p != sig_scripts.end());
+        auto& source = m_sources[i];
+        const BinaryData& public_key_data = public_keys[i]->get_content();
 
-        source->script_signature.swap(p->second);
+        BitcoinDataStream sig_script_stream;
+        if (source->is_segwit())
+        {
+            BitcoinDataStream witness_stream;
+            witness_stream << as_compact_size(BITCOIN_WITNESS_ITEMS_COUNT);
+            write_signature_and_public_key(*signatures[i], public_key_data, &witness_stream);
+            source->script_witness = make_clone(witness_stream.get_content());
+
+            const BinaryDataPtr witness_program = make_p2wpkh_witness_program(
+                    as_binary_data(private_keys[i]->get_public_key_hash()));
+            sig_script_stream << as_compact_size(witness_program->len);
+            sig_script_stream << *witness_program;
+        }
+        else
+        {
+            write_signature_and_public_key(*signatures[i], public_key_data, &sig_script_stream);
+        }
+
+        source->script_signature = make_clone(sig_script_stream.get_content());
     }
 }
 
@@ -919,6 +1328,75 @@ Properties& BitcoinTransaction::add_destination()
             m_destinations.back()->get_properties());
 }
 
+void BitcoinTransaction::add_destinations(
+        const BitcoinBulkDestination* destinations, size_t count)
+{
+    INVARIANT(destinations != nullptr || count == 0);
+
+    const bool check_dust = get_net_type() == BITCOIN_NET_TYPE_MAINNET;
+
+    // Outputs are serialized to a temporary stream, so that nothing is added
+    // if any of destinations is invalid.
+    // amount, script size and P2PKH script, which is the longest supported one.
+    const size_t max_output_size = sizeof(uint64_t) + 1 + 1 + 1 + 1 + HASH160_LEN + 1 + 1;
+    BitcoinDataStream outputs_stream(count * max_output_size);
+    BigInt total_amount(0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const BitcoinBulkDestination& destination = destinations[i];
+        if ((destination.address == nullptr) == (destination.script_pubkey == nullptr))
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Exactly one of address or script_pubkey must be set.")
+                    << " Destination index: " << i;
+        }
+
+        BinaryDataPtr address_script_pubkey;
+        if (destination.address)
+        {
+            address_script_pubkey = make_script_pub_key_from_address(
+                    get_net_type(), destination.address);
+        }
+        else
+        {
+            BitcoinAddressType address_type;
+            if (!destination.script_pubkey->data
+                    || !get_bitcoin_script_pubkey_address_type(
+                            *destination.script_pubkey, &address_type))
+            {
+                THROW_EXCEPTION2(ERROR_INVALID_ADDRESS,
+                        "Unsupported script_pubkey, expected P2PKH or P2SH.")
+                        << " Destination index: " << i;
+            }
+        }
+        const BinaryData& script_pubkey = address_script_pubkey
+                ? *address_script_pubkey : *destination.script_pubkey;
+
+        const BigInt amount(destination.amount);
+        if (destination.amount == 0 || (check_dust && is_dust_amount(amount, false)))
+        {
+            THROW_EXCEPTION2(ERROR_TRANSACTION_TRANSFER_AMOUNT_TOO_SMALL,
+                    "Bitcoin dust output.")
+                    << " Destination index: " << i
+                    << ", amount: " << destination.amount;
+        }
+
+        outputs_stream << destination.amount;
+        outputs_stream << as_compact_size(script_pubkey.len);
+        outputs_stream << script_pubkey;
+        total_amount += amount;
+    }
+
+    const BinaryData outputs = outputs_stream.get_content();
+    if (outputs.len != 0)
+    {
+        m_bulk_outputs.insert(m_bulk_outputs.end(),
+                outputs.data, outputs.data + outputs.len);
+    }
+    m_bulk_outputs_count += count;
+    m_bulk_outputs_amount += total_amount;
+}
+
 void BitcoinTransaction::set_message(const BinaryData& value)
 {
     if (value.len > BITCOIN_MAX_MESSAGE_LENGTH)
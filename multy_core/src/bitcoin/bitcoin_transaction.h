@@ -7,6 +7,8 @@
 #ifndef MULTY_CORE_BITCOIN_TRANSACTION_H
 #define MULTY_CORE_BITCOIN_TRANSACTION_H
 
+#include "multy_core/bitcoin_bulk_payout.h"
+
 #include "multy_core/src/transaction_base.h"
 #include "multy_core/src/bitcoin/bitcoin_account.h"
 #include "multy_core/src/api/properties_impl.h"
@@ -24,6 +26,29 @@ enum DestinationsToUse
     WITH_NONPOSITIVE_CHANGE_AMOUNT
 };
 
+enum WitnessToUse
+{
+    WITH_WITNESS, // has effect only if there are segwit sources.
+    WITHOUT_WITNESS
+};
+
+// BIP-144: Serialization of the transaction with witness data.
+const uint8_t BITCOIN_SEGWIT_MARKER = 0x00;
+const uint8_t BITCOIN_SEGWIT_FLAG = 0x01;
+
+// BIP-141: weight of non-witness data is 4 weight units per byte,
+// virtual size of the transaction is weight / 4 rounded up.
+const size_t WITNESS_SCALE_FACTOR = 4;
+
+// Output is dust if spending it costs more than its value at this fee rate
+// (satoshi per byte), given the size of the output and the input spending it.
+const uint64_t BITCOIN_DUST_RELAY_FEE_PER_BYTE = 3;
+const uint64_t BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_NON_SEGWIT = 182;
+const uint64_t BITCOIN_AVERAGE_OUTPUT_AND_INPUT_SIZE_SEGWIT = 98;
+
+// Size of the value serialized as Bitcoin compact size (aka var int).
+size_t get_compact_size_len(uint64_t size);
+
 class BitcoinAccount;
 class BitcoinTransactionDestination;
 class BitcoinTransactionFee;
@@ -50,32 +75,47 @@ public:
     Properties& get_fee() override;
     void set_message(const BinaryData& value) override;
 
+    // See transaction_add_bitcoin_destinations().
+    void add_destinations(const BitcoinBulkDestination* destinations, size_t count);
+
 private:
-    uint64_t get_transaction_serialized_size(DestinationsToUse destinations_to_use);
+    uint64_t get_transaction_serialized_size(DestinationsToUse destinations_to_use) const;
     BigInt calculate_diff() const;
     void verify() const;
     void sign();
 
     template <typename T>
-    void serialize_to_stream(T* stream, DestinationsToUse destinations_to_use) const;
+    void serialize_to_stream(T* stream,
+            DestinationsToUse destinations_to_use,
+            WitnessToUse witness_to_use) const;
     bool is_segwit() const;
 
-    typedef std::vector<const BitcoinTransactionDestination*> Destinations;
-    Destinations get_non_zero_destinations(DestinationsToUse destinations_to_use) const;
+    bool is_serialized(const BitcoinTransactionDestination& destination,
+            DestinationsToUse destinations_to_use) const;
+    size_t get_outputs_count(DestinationsToUse destinations_to_use) const;
+    // Writes all outputs (message, destinations and bulk outputs), but not their count.
+    void write_outputs(BitcoinStream* stream,
+            DestinationsToUse destinations_to_use) const;
 
     size_t estimate_transaction_size() const;
     BitcoinNetType get_net_type() const;
 
 private:
     int32_t m_version;
-    int32_t m_is_segwit_transaction;
     uint32_t m_lock_time;
     PropertyT<int32_t> m_is_replaceable;
+    // Number of threads used to sign inputs, 1 means signing on calling thread only.
+    PropertyT<int32_t> m_signing_threads_count;
 
     BitcoinTransactionFeePtr m_fee;
     std::vector<BitcoinTransactionSourcePtr> m_sources;
     std::vector<BitcoinTransactionDestinationPtr> m_destinations;
     BitcoinTransactionDestinationPtr m_message;
+
+    // Outputs added with add_destinations(), serialized back to back.
+    std::vector<uint8_t> m_bulk_outputs;
+    size_t m_bulk_outputs_count;
+    BigInt m_bulk_outputs_amount;
 };
 
 } // namespace internal
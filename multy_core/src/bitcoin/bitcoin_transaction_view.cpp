@@ -0,0 +1,366 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/bitcoin/bitcoin_transaction_view.h"
+
+#include "multy_core/error.h"
+
+#include "multy_core/src/bitcoin/bitcoin_opcode.h"
+#include "multy_core/src/bitcoin/bitcoin_transaction.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+#include "wally_crypto.h"
+
+#include "third-party/portable_endian.h"
+
+#include <string.h>
+
+namespace
+{
+using namespace multy_core::internal;
+
+const size_t BITCOIN_TRANSACTION_HASH_SIZE = 32;
+
+// prev tx hash, prev tx out index, script length, sequence.
+const size_t BITCOIN_MIN_INPUT_SIZE = BITCOIN_TRANSACTION_HASH_SIZE + 4 + 1 + 4;
+// amount, script length.
+const size_t BITCOIN_MIN_OUTPUT_SIZE = 8 + 1;
+
+// Reads serialized values from the buffer, without copying the data.
+class BitcoinDataReader
+{
+public:
+    explicit BitcoinDataReader(const BinaryData& data)
+        : m_data(data),
+          m_offset(0)
+    {}
+
+    BinaryData read_data(size_t size)
+    {
+        if (size > get_bytes_left())
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Unexpected end of serialized transaction.")
+                    << " Offset: " << m_offset << ", requested: " << size
+                    << ", available: " << get_bytes_left();
+        }
+        const BinaryData result{m_data.data + m_offset, size};
+        m_offset += size;
+        return result;
+    }
+
+    template <typename T>
+    T read_value()
+    {
+        T result;
+        memcpy(&result, read_data(sizeof(result)).data, sizeof(result));
+        return result;
+    }
+
+    uint8_t read_uint8()
+    {
+        return read_value<uint8_t>();
+    }
+
+    uint32_t read_uint32()
+    {
+        return le32toh(read_value<uint32_t>());
+    }
+
+    uint64_t read_uint64()
+    {
+        return le64toh(read_value<uint64_t>());
+    }
+
+    uint64_t read_compact_size()
+    {
+        const size_t start_offset = m_offset;
+        const uint8_t prefix = read_uint8();
+        uint64_t result = prefix;
+        if (prefix == 253)
+        {
+            result = le16toh(read_value<uint16_t>());
+        }
+        else if (prefix == 254)
+        {
+            result = read_uint32();
+        }
+        else if (prefix == 255)
+        {
+            result = read_uint64();
+        }
+
+        if (get_compact_size_len(result) != m_offset - start_offset)
+        {
+            // Do not accept non-canonical encoding, otherwise re-serialized
+            // transaction would have different hash.
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Non-canonical compact size value in serialized transaction.")
+                    << " Offset: " << m_offset;
+        }
+        return result;
+    }
+
+    // Reads compact size and checks that there is enough data for
+    // given number of items of at least min_item_size.
+    size_t read_items_count(size_t min_item_size)
+    {
+        const uint64_t result = read_compact_size();
+        if (result > get_bytes_left() / min_item_size)
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Items count is too big for the serialized transaction.")
+                    << " Count: " << result << ", offset: " << m_offset;
+        }
+        return static_cast<size_t>(result);
+    }
+
+    BinaryData read_sized_data()
+    {
+        const uint64_t size = read_compact_size();
+        if (size > get_bytes_left())
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Unexpected end of serialized transaction.")
+                    << " Offset: " << m_offset << ", requested: " << size
+                    << ", available: " << get_bytes_left();
+        }
+        return read_data(static_cast<size_t>(size));
+    }
+
+    uint8_t peek_uint8(size_t ahead) const
+    {
+        if (ahead >= get_bytes_left())
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Unexpected end of serialized transaction.")
+                    << " Offset: " << m_offset;
+        }
+        return m_data.data[m_offset + ahead];
+    }
+
+    size_t get_offset() const
+    {
+        return m_offset;
+    }
+
+    size_t get_bytes_left() const
+    {
+        return m_data.len - m_offset;
+    }
+
+    BinaryData get_data_since(size_t offset) const
+    {
+        return BinaryData{m_data.data + offset, m_offset - offset};
+    }
+
+private:
+    const BinaryData m_data;
+    size_t m_offset;
+};
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+BitcoinTransactionView::BitcoinTransactionView(const BinaryData& serialized_transaction)
+    : m_data(serialized_transaction),
+      m_version(0),
+      m_lock_time(0),
+      m_is_segwit(false),
+      m_inputs_and_outputs{nullptr, 0},
+      m_inputs(),
+      m_outputs()
+{
+    INVARIANT(serialized_transaction.data != nullptr);
+
+    BitcoinDataReader reader(m_data);
+    m_version = static_cast<int32_t>(reader.read_uint32());
+
+    // Marker is indistinguishable from zero inputs count, and zero flag
+    // is the same as zero outputs count, i.e. an empty transaction.
+    if (reader.peek_uint8(0) == BITCOIN_SEGWIT_MARKER && reader.peek_uint8(1) != 0)
+    {
+        reader.read_uint8();
+        if (reader.read_uint8() != BITCOIN_SEGWIT_FLAG)
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Invalid segwit flag in serialized transaction.");
+        }
+        m_is_segwit = true;
+    }
+
+    const size_t inputs_and_outputs_offset = reader.get_offset();
+    m_inputs.resize(reader.read_items_count(BITCOIN_MIN_INPUT_SIZE));
+    for (Input& input : m_inputs)
+    {
+        input.prev_transaction_hash = reader.read_data(BITCOIN_TRANSACTION_HASH_SIZE);
+        input.prev_transaction_out_index = reader.read_uint32();
+        input.script_signature = reader.read_sized_data();
+        input.sequence = reader.read_uint32();
+        input.witness = BinaryData{nullptr, 0};
+        input.witness_items_count = 0;
+    }
+
+    m_outputs.resize(reader.read_items_count(BITCOIN_MIN_OUTPUT_SIZE));
+    for (Output& output : m_outputs)
+    {
+        output.amount = reader.read_uint64();
+        output.script_pubkey = reader.read_sized_data();
+    }
+    m_inputs_and_outputs = reader.get_data_since(inputs_and_outputs_offset);
+
+    if (m_is_segwit)
+    {
+        bool has_non_empty_witness = false;
+        for (Input& input : m_inputs)
+        {
+            const size_t witness_offset = reader.get_offset();
+            input.witness_items_count = reader.read_items_count(1);
+            for (size_t i = 0; i < input.witness_items_count; ++i)
+            {
+                reader.read_sized_data();
+            }
+            input.witness = reader.get_data_since(witness_offset);
+            has_non_empty_witness |= input.witness_items_count != 0;
+        }
+
+        if (!has_non_empty_witness)
+        {
+            // BIP144 requires witness serialization to be used only if there
+            // is at least one non-empty witness.
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Serialized transaction has segwit marker, but no witness data.");
+        }
+    }
+
+    m_lock_time = reader.read_uint32();
+
+    if (reader.get_bytes_left() != 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Unexpected data after the end of serialized transaction.")
+                << " Bytes left: " << reader.get_bytes_left();
+    }
+}
+
+int32_t BitcoinTransactionView::get_version() const
+{
+    return m_version;
+}
+
+uint32_t BitcoinTransactionView::get_lock_time() const
+{
+    return m_lock_time;
+}
+
+bool BitcoinTransactionView::is_segwit() const
+{
+    return m_is_segwit;
+}
+
+const std::vector<BitcoinTransactionView::Input>& BitcoinTransactionView::get_inputs() const
+{
+    return m_inputs;
+}
+
+const std::vector<BitcoinTransactionView::Output>& BitcoinTransactionView::get_outputs() const
+{
+    return m_outputs;
+}
+
+BinaryData BitcoinTransactionView::get_witness_item(
+        size_t input_index, size_t item_index) const
+{
+    if (input_index >= m_inputs.size())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Input index is out of range.")
+                << " Index: " << input_index << ", inputs count: " << m_inputs.size();
+    }
+
+    const Input& input = m_inputs[input_index];
+    if (item_index >= input.witness_items_count)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Witness item index is out of range.")
+                << " Index: " << item_index
+                << ", items count: " << input.witness_items_count;
+    }
+
+    // Witness was validated on construction, so it is safe to just walk it.
+    BitcoinDataReader reader(input.witness);
+    reader.read_compact_size();
+    for (size_t i = 0; i < item_index; ++i)
+    {
+        reader.read_sized_data();
+    }
+    return reader.read_sized_data();
+}
+
+hash<256> BitcoinTransactionView::get_txid() const
+{
+    IncrementalHasher<SHA2_DOUBLE, 256> hasher;
+    hasher.update(BinaryData{m_data.data, sizeof(m_version)});
+    hasher.update(m_inputs_and_outputs);
+    hasher.update(BinaryData{m_data.data + m_data.len - sizeof(m_lock_time),
+            sizeof(m_lock_time)});
+    return hasher.finalize();
+}
+
+hash<256> BitcoinTransactionView::get_wtxid() const
+{
+    return do_hash<SHA2_DOUBLE, 256>(m_data);
+}
+
+size_t BitcoinTransactionView::get_size() const
+{
+    return m_data.len;
+}
+
+size_t BitcoinTransactionView::get_virtual_size() const
+{
+    const size_t base_size = sizeof(m_version) + m_inputs_and_outputs.len
+            + sizeof(m_lock_time);
+    const size_t weight = base_size * (WITNESS_SCALE_FACTOR - 1) + m_data.len;
+
+    return (weight + WITNESS_SCALE_FACTOR - 1) / WITNESS_SCALE_FACTOR;
+}
+
+bool get_bitcoin_script_pubkey_address_type(
+        const BinaryData& script_pubkey, BitcoinAddressType* address_type)
+{
+    INVARIANT(address_type != nullptr);
+
+    const uint8_t* script = script_pubkey.data;
+    if (script_pubkey.len == 1 + 1 + 1 + HASH160_LEN + 1 + 1
+            && script[0] == OP_DUP
+            && script[1] == OP_HASH160
+            && script[2] == HASH160_LEN
+            && script[3 + HASH160_LEN] == OP_EQUALVERIFY
+            && script[4 + HASH160_LEN] == OP_CHECKSIG)
+    {
+        *address_type = BITCOIN_ADDRESS_P2PKH;
+        return true;
+    }
+
+    if (script_pubkey.len == 1 + 1 + HASH160_LEN + 1
+            && script[0] == OP_HASH160
+            && script[1] == HASH160_LEN
+            && script[2 + HASH160_LEN] == OP_EQUAL)
+    {
+        *address_type = BITCOIN_ADDRESS_P2SH;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace internal
+} // namespace multy_core
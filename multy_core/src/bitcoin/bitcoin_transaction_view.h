@@ -0,0 +1,97 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_BITCOIN_TRANSACTION_VIEW_H
+#define MULTY_CORE_SRC_BITCOIN_TRANSACTION_VIEW_H
+
+#include "multy_core/binary_data.h"
+#include "multy_core/bitcoin.h"
+
+#include "multy_core/src/hash.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Read-only view of the serialized Bitcoin transaction.
+ *
+ * Parses transaction (with or without BIP144 witness data) once, on
+ * construction. All BinaryData values point into the original buffer,
+ * nothing is copied, hence view MUST NOT outlive the buffer.
+ *
+ * @throw Exception with ERROR_INVALID_ARGUMENT if data is not a valid
+ * serialized transaction.
+ */
+class BitcoinTransactionView
+{
+public:
+    struct Input
+    {
+        // As serialized, i.e. in reverse order to the txid as it is displayed.
+        BinaryData prev_transaction_hash;
+        uint32_t prev_transaction_out_index;
+        BinaryData script_signature;
+        uint32_t sequence;
+        // Serialized witness stack: items count and items, empty if there is
+        // no witness data. See get_witness_item().
+        BinaryData witness;
+        size_t witness_items_count;
+    };
+
+    struct Output
+    {
+        uint64_t amount; // in satoshi
+        BinaryData script_pubkey;
+    };
+
+    explicit BitcoinTransactionView(const BinaryData& serialized_transaction);
+
+    int32_t get_version() const;
+    uint32_t get_lock_time() const;
+    bool is_segwit() const;
+
+    const std::vector<Input>& get_inputs() const;
+    const std::vector<Output>& get_outputs() const;
+
+    // Item of the input witness stack, like signature or public key.
+    BinaryData get_witness_item(size_t input_index, size_t item_index) const;
+
+    // Serialized transaction without witness data is hashed by parts, without copying.
+    hash<256> get_txid() const;
+    // Same as get_txid() for non-segwit transactions.
+    hash<256> get_wtxid() const;
+
+    size_t get_size() const;
+    // BIP141 virtual size, rounded up.
+    size_t get_virtual_size() const;
+
+private:
+    BinaryData m_data;
+    int32_t m_version;
+    uint32_t m_lock_time;
+    bool m_is_segwit;
+    // Inputs and outputs part of m_data, no segwit marker, flag or witness.
+    BinaryData m_inputs_and_outputs;
+    std::vector<Input> m_inputs;
+    std::vector<Output> m_outputs;
+};
+
+/** Get address type from the script_pubkey of the transaction output.
+ *
+ * P2SH-P2WPKH outputs are indistinguishable from any other P2SH output.
+ * @return false if script is neither P2PKH nor P2SH.
+ */
+bool get_bitcoin_script_pubkey_address_type(
+        const BinaryData& script_pubkey, BitcoinAddressType* address_type);
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_SRC_BITCOIN_TRANSACTION_VIEW_H
@@ -34,6 +34,38 @@ BlockchainFacadeBase::~BlockchainFacadeBase()
 {
 }
 
+HDAccountPtr BlockchainFacadeBase::make_watch_only_hd_account(
+        BlockchainType blockchain_type,
+        uint32_t /*account_type*/,
+        const ExtendedKey& /*account_public_key*/) const
+{
+    THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+            "Watch-only HD accounts are not supported for this blockchain.")
+            << " Blockchain: " << to_string(blockchain_type);
+}
+
+void BlockchainFacadeBase::validate_addresses(BlockchainType blockchain_type,
+        const char* const* addresses, size_t count, bool* out_valid) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_valid[i] = false;
+        if (addresses[i] == nullptr)
+        {
+            continue;
+        }
+
+        try
+        {
+            validate_address(blockchain_type, addresses[i]);
+            out_valid[i] = true;
+        }
+        catch (const Exception&)
+        {
+        }
+    }
+}
+
 BlockchainFacadeRegistry::BlockchainFacadeRegistry()
     : m_instances(),
       m_factory_functions()
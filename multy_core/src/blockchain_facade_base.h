@@ -35,6 +35,14 @@ public:
             const ExtendedKey& master_key,
             uint32_t index) const = 0;
 
+    /** Makes watch-only HD account from the public key of the BIP44 account.
+     * By default throws ERROR_FEATURE_NOT_SUPPORTED.
+     */
+    virtual HDAccountPtr make_watch_only_hd_account(
+            BlockchainType blockchain_type,
+            uint32_t account_type,
+            const ExtendedKey& account_public_key) const;
+
     virtual AccountPtr make_account(
             BlockchainType blockchain_type,
             uint32_t account_type,
@@ -44,6 +52,11 @@ public:
 
     virtual void validate_address(BlockchainType, const char*) const = 0;
 
+    // By default validates each address with validate_address(),
+    // blockchains may provide faster implementation.
+    virtual void validate_addresses(BlockchainType blockchain_type,
+            const char* const* addresses, size_t count, bool* out_valid) const;
+
     virtual std::string encode_serialized_transaction(
             const BinaryData& serialized_transaction) const = 0;
 };
@@ -0,0 +1,69 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_CACHED_VALUE_H
+#define MULTY_CORE_SRC_CACHED_VALUE_H
+
+#include <memory>
+#include <mutex>
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Thread-safe lazily computed value.
+ *
+ * Value is computed by the first call to get(), all subsequent calls return
+ * reference to the same value, which is valid for the lifetime of the
+ * CachedValue object. Copy of the CachedValue gets a copy of the value,
+ * if it was already computed.
+ */
+template <typename T>
+class CachedValue
+{
+public:
+    CachedValue()
+        : m_mutex(),
+          m_value()
+    {}
+
+    CachedValue(const CachedValue& other)
+        : m_mutex(),
+          m_value()
+    {
+        std::lock_guard<std::mutex> lock(other.m_mutex);
+        if (other.m_value)
+        {
+            m_value.reset(new T(*other.m_value));
+        }
+    }
+
+    CachedValue& operator=(const CachedValue&) = delete;
+
+    /** Get value, computing it with make_value() if that wasn't done yet.
+     * If make_value() throws, value is not cached and the exception is propagated.
+     */
+    template <typename MakeValue>
+    const T& get(MakeValue make_value) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_value)
+        {
+            m_value.reset(new T(make_value()));
+        }
+        return *m_value;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    mutable std::unique_ptr<T> m_value;
+};
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_SRC_CACHED_VALUE_H
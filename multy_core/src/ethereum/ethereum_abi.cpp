@@ -0,0 +1,901 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_abi.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/codec.h"
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/hash.h"
+#include "multy_core/src/utility.h"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <string.h>
+
+namespace
+{
+using namespace multy_core::internal;
+
+const size_t WORD_SIZE = ETHEREUM_ABI_WORD_SIZE;
+const size_t ETHEREUM_ADDRESS_SIZE = 20;
+const uint8_t ZEROES[WORD_SIZE] = {0};
+
+EthereumAbiWord make_word(uint64_t value)
+{
+    EthereumAbiWord result = {{0}};
+    for (size_t i = result.size(); i > 0 && value != 0; --i)
+    {
+        result[i - 1] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+    return result;
+}
+
+// Parses signature like "name(type1,type2)", does not allocate anything but the types.
+class SignatureParser
+{
+public:
+    explicit SignatureParser(const std::string& signature)
+        : m_signature(signature),
+          m_position(0)
+    {
+    }
+
+    // Returns name of the function, arguments are stored in *arguments as a tuple.
+    std::string parse(EthereumAbiType* arguments)
+    {
+        const size_t name_end = m_signature.find('(');
+        if (name_end == std::string::npos || name_end == 0)
+        {
+            fail("Function name and arguments list expected.");
+        }
+        std::string name = m_signature.substr(0, name_end);
+        for (const char c : name)
+        {
+            if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '$')
+            {
+                fail("Invalid function name.");
+            }
+        }
+        m_position = name_end;
+
+        *arguments = parse_type();
+        if (arguments->kind != EthereumAbiType::TUPLE || m_position != m_signature.size())
+        {
+            fail("Unexpected characters after arguments list.");
+        }
+        return name;
+    }
+
+private:
+    EthereumAbiType parse_type()
+    {
+        EthereumAbiType result;
+        if (peek() == '(')
+        {
+            ++m_position;
+            result.kind = EthereumAbiType::TUPLE;
+            result.size = 0;
+            while (peek() != ')')
+            {
+                if (!result.components.empty())
+                {
+                    expect(',');
+                }
+                result.components.push_back(parse_type());
+            }
+            expect(')');
+        }
+        else
+        {
+            result = parse_elementary_type();
+        }
+
+        while (peek() == '[')
+        {
+            ++m_position;
+            EthereumAbiType array;
+            array.kind = EthereumAbiType::ARRAY;
+            array.size = 0;
+            if (peek() != ']')
+            {
+                array.kind = EthereumAbiType::FIXED_ARRAY;
+                array.size = parse_number();
+                if (array.size == 0)
+                {
+                    fail("Fixed array can't be empty.");
+                }
+            }
+            expect(']');
+            array.components.push_back(std::move(result));
+            result = std::move(array);
+        }
+
+        return result;
+    }
+
+    EthereumAbiType parse_elementary_type()
+    {
+        const size_t name_begin = m_position;
+        while (m_position < m_signature.size()
+                && isalpha(static_cast<unsigned char>(m_signature[m_position])))
+        {
+            ++m_position;
+        }
+        const std::string name = m_signature.substr(name_begin, m_position - name_begin);
+        const bool has_size = m_position < m_signature.size()
+                && isdigit(static_cast<unsigned char>(m_signature[m_position]));
+        const size_t size = has_size ? parse_number() : 0;
+
+        EthereumAbiType result;
+        result.size = size;
+        if (name == "uint" || name == "int")
+        {
+            result.kind = (name == "uint") ? EthereumAbiType::UINT : EthereumAbiType::INT;
+            if (!has_size)
+            {
+                result.size = 256;
+            }
+            else if (size == 0 || size > 256 || size % 8 != 0)
+            {
+                fail("Invalid integer size.");
+            }
+        }
+        else if (name == "bytes")
+        {
+            result.kind = has_size ? EthereumAbiType::FIXED_BYTES : EthereumAbiType::BYTES;
+            if (has_size && (size == 0 || size > WORD_SIZE))
+            {
+                fail("Invalid fixed bytes size.");
+            }
+        }
+        else if (!has_size && name == "address")
+        {
+            result.kind = EthereumAbiType::ADDRESS;
+        }
+        else if (!has_size && name == "bool")
+        {
+            result.kind = EthereumAbiType::BOOL;
+        }
+        else if (!has_size && name == "string")
+        {
+            result.kind = EthereumAbiType::STRING;
+        }
+        else
+        {
+            fail("Unsupported type.");
+        }
+
+        return result;
+    }
+
+    size_t parse_number()
+    {
+        size_t result = 0;
+        const size_t begin = m_position;
+        while (m_position < m_signature.size()
+                && isdigit(static_cast<unsigned char>(m_signature[m_position])))
+        {
+            // Overly large numbers are of no use anyway.
+            if (m_position - begin >= 9)
+            {
+                fail("Number is too big.");
+            }
+            result = result * 10 + (m_signature[m_position] - '0');
+            ++m_position;
+        }
+        if (m_position == begin)
+        {
+            fail("Number expected.");
+        }
+        return result;
+    }
+
+    char peek() const
+    {
+        return m_position < m_signature.size() ? m_signature[m_position] : '\0';
+    }
+
+    void expect(char c)
+    {
+        if (peek() != c)
+        {
+            fail("Unexpected character.");
+        }
+        ++m_position;
+    }
+
+    void fail(const char* message) const
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, message)
+                << " Signature: \"" << m_signature << "\", position: " << m_position;
+    }
+
+private:
+    const std::string& m_signature;
+    size_t m_position;
+};
+
+void append_type_name(const EthereumAbiType& type, std::string* out)
+{
+    switch (type.kind)
+    {
+        case EthereumAbiType::UINT:
+            *out += "uint" + std::to_string(type.size);
+            break;
+        case EthereumAbiType::INT:
+            *out += "int" + std::to_string(type.size);
+            break;
+        case EthereumAbiType::ADDRESS:
+            *out += "address";
+            break;
+        case EthereumAbiType::BOOL:
+            *out += "bool";
+            break;
+        case EthereumAbiType::FIXED_BYTES:
+            *out += "bytes" + std::to_string(type.size);
+            break;
+        case EthereumAbiType::BYTES:
+            *out += "bytes";
+            break;
+        case EthereumAbiType::STRING:
+            *out += "string";
+            break;
+        case EthereumAbiType::ARRAY:
+            append_type_name(type.components[0], out);
+            *out += "[]";
+            break;
+        case EthereumAbiType::FIXED_ARRAY:
+            append_type_name(type.components[0], out);
+            *out += "[" + std::to_string(type.size) + "]";
+            break;
+        case EthereumAbiType::TUPLE:
+            *out += "(";
+            for (size_t i = 0; i < type.components.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    *out += ",";
+                }
+                append_type_name(type.components[i], out);
+            }
+            *out += ")";
+            break;
+    }
+}
+
+std::string get_type_name(const EthereumAbiType& type)
+{
+    std::string result;
+    append_type_name(type, &result);
+    return result;
+}
+
+bool is_dynamic(const EthereumAbiType& type)
+{
+    switch (type.kind)
+    {
+        case EthereumAbiType::BYTES:
+        case EthereumAbiType::STRING:
+        case EthereumAbiType::ARRAY:
+            return true;
+        case EthereumAbiType::FIXED_ARRAY:
+            return is_dynamic(type.components[0]);
+        case EthereumAbiType::TUPLE:
+            return std::any_of(type.components.begin(), type.components.end(),
+                    [](const EthereumAbiType& component)
+                    {
+                        return is_dynamic(component);
+                    });
+        default:
+            return false;
+    }
+}
+
+// Size of the value in the head of enclosing tuple or array.
+size_t get_head_size(const EthereumAbiType& type)
+{
+    if (is_dynamic(type))
+    {
+        // Offset of the value.
+        return WORD_SIZE;
+    }
+
+    switch (type.kind)
+    {
+        case EthereumAbiType::FIXED_ARRAY:
+            return type.size * get_head_size(type.components[0]);
+        case EthereumAbiType::TUPLE:
+        {
+            size_t result = 0;
+            for (const EthereumAbiType& component : type.components)
+            {
+                result += get_head_size(component);
+            }
+            return result;
+        }
+        default:
+            return WORD_SIZE;
+    }
+}
+
+size_t get_padded_size(size_t size)
+{
+    return (size + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
+}
+
+const EthereumAbiType& get_item_type(const EthereumAbiType& type, size_t index)
+{
+    return type.kind == EthereumAbiType::TUPLE ? type.components[index] : type.components[0];
+}
+
+void throw_type_mismatch(const EthereumAbiType& type, const char* message)
+{
+    THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, message)
+            << " Type: " << get_type_name(type);
+}
+
+// All bits above given number of lowest bits must be equal to the sign.
+bool fits_in_bits(const EthereumAbiWord& word, bool is_negative, size_t bits)
+{
+    const uint8_t fill = is_negative ? 0xff : 0x00;
+    const size_t fill_size = (WORD_SIZE * 8 - bits) / 8;
+    return std::all_of(word.begin(), word.begin() + fill_size,
+            [fill](uint8_t byte)
+            {
+                return byte == fill;
+            });
+}
+
+void check_static_value(const EthereumAbiType& type, const EthereumAbiValue& value)
+{
+    bool matches = false;
+    switch (type.kind)
+    {
+        case EthereumAbiType::UINT:
+            matches = value.get_kind() == EthereumAbiValue::INTEGER;
+            if (matches && (value.is_negative()
+                    || !fits_in_bits(value.get_word(), false, type.size)))
+            {
+                throw_type_mismatch(type, "Value is out of range.");
+            }
+            break;
+        case EthereumAbiType::INT:
+            matches = value.get_kind() == EthereumAbiValue::INTEGER;
+            // Sign bit of the N-bit integer is also set for negative values.
+            if (matches && (!fits_in_bits(value.get_word(), value.is_negative(), type.size)
+                    || ((value.get_word()[WORD_SIZE - type.size / 8] & 0x80) != 0)
+                            != value.is_negative()))
+            {
+                throw_type_mismatch(type, "Value is out of range.");
+            }
+            break;
+        case EthereumAbiType::ADDRESS:
+            matches = value.get_kind() == EthereumAbiValue::ADDRESS;
+            break;
+        case EthereumAbiType::BOOL:
+            matches = value.get_kind() == EthereumAbiValue::BOOL;
+            break;
+        case EthereumAbiType::FIXED_BYTES:
+            matches = value.get_kind() == EthereumAbiValue::FIXED_BYTES
+                    && value.get_size() == type.size;
+            break;
+        default:
+            INVARIANT2(false, "Not a static elementary type.");
+    }
+
+    if (!matches)
+    {
+        throw_type_mismatch(type, "Value doesn't match the type.");
+    }
+}
+
+void check_items(const EthereumAbiType& type, const std::vector<EthereumAbiValue>& items)
+{
+    const size_t expected_count = type.kind == EthereumAbiType::TUPLE
+            ? type.components.size() : type.size;
+    if (type.kind != EthereumAbiType::ARRAY && items.size() != expected_count)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid number of items.")
+                << " Type: " << get_type_name(type)
+                << ", expected: " << expected_count << ", got: " << items.size();
+    }
+}
+
+size_t get_items_encoded_size(const EthereumAbiType& type,
+        const std::vector<EthereumAbiValue>& items);
+
+// Also checks that value matches the type.
+size_t get_encoded_size(const EthereumAbiType& type, const EthereumAbiValue& value)
+{
+    switch (type.kind)
+    {
+        case EthereumAbiType::BYTES:
+        case EthereumAbiType::STRING:
+            if (value.get_kind() != (type.kind == EthereumAbiType::BYTES
+                    ? EthereumAbiValue::BYTES : EthereumAbiValue::STRING))
+            {
+                throw_type_mismatch(type, "Value doesn't match the type.");
+            }
+            // Length and padded data.
+            return WORD_SIZE + get_padded_size(value.get_data().len);
+        case EthereumAbiType::ARRAY:
+        case EthereumAbiType::FIXED_ARRAY:
+        case EthereumAbiType::TUPLE:
+        {
+            if (value.get_kind() != EthereumAbiValue::LIST)
+            {
+                throw_type_mismatch(type, "Value doesn't match the type.");
+            }
+            const size_t length_size = (type.kind == EthereumAbiType::ARRAY) ? WORD_SIZE : 0;
+            return length_size + get_items_encoded_size(type, value.get_items());
+        }
+        default:
+            check_static_value(type, value);
+            return WORD_SIZE;
+    }
+}
+
+size_t get_items_encoded_size(const EthereumAbiType& type,
+        const std::vector<EthereumAbiValue>& items)
+{
+    check_items(type, items);
+
+    size_t result = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const EthereumAbiType& item_type = get_item_type(type, i);
+        // Offset in the head for dynamic items.
+        result += (is_dynamic(item_type) ? WORD_SIZE : 0)
+                + get_encoded_size(item_type, items[i]);
+    }
+    return result;
+}
+
+void write_word(const EthereumAbiWord& word, FixedSizeBinaryDataWriter* writer)
+{
+    writer->write_data(word.data(), word.size());
+}
+
+void write_items(const EthereumAbiType& type,
+        const std::vector<EthereumAbiValue>& items,
+        FixedSizeBinaryDataWriter* writer);
+
+void write_value(const EthereumAbiType& type, const EthereumAbiValue& value,
+        FixedSizeBinaryDataWriter* writer)
+{
+    switch (type.kind)
+    {
+        case EthereumAbiType::BYTES:
+        case EthereumAbiType::STRING:
+        {
+            const BinaryData& data = value.get_data();
+            write_word(make_word(data.len), writer);
+            writer->write_data(data.data, data.len);
+            writer->write_data(ZEROES, get_padded_size(data.len) - data.len);
+            break;
+        }
+        case EthereumAbiType::ARRAY:
+            write_word(make_word(value.get_items().size()), writer);
+            write_items(type, value.get_items(), writer);
+            break;
+        case EthereumAbiType::FIXED_ARRAY:
+        case EthereumAbiType::TUPLE:
+            write_items(type, value.get_items(), writer);
+            break;
+        default:
+            check_static_value(type, value);
+            write_word(value.get_word(), writer);
+            break;
+    }
+}
+
+// Heads of all items, static ones are written as is, offsets for dynamic ones,
+// followed by encoded dynamic items.
+void write_items(const EthereumAbiType& type,
+        const std::vector<EthereumAbiValue>& items,
+        FixedSizeBinaryDataWriter* writer)
+{
+    check_items(type, items);
+
+    size_t tail_offset = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        tail_offset += get_head_size(get_item_type(type, i));
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const EthereumAbiType& item_type = get_item_type(type, i);
+        if (is_dynamic(item_type))
+        {
+            write_word(make_word(tail_offset), writer);
+            tail_offset += get_encoded_size(item_type, items[i]);
+        }
+        else
+        {
+            write_value(item_type, items[i], writer);
+        }
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const EthereumAbiType& item_type = get_item_type(type, i);
+        if (is_dynamic(item_type))
+        {
+            write_value(item_type, items[i], writer);
+        }
+    }
+}
+
+std::string trim(const std::string& text)
+{
+    const char* const SPACES = " \t\r\n";
+    const size_t begin = text.find_first_not_of(SPACES);
+    if (begin == std::string::npos)
+    {
+        return std::string();
+    }
+    return text.substr(begin, text.find_last_not_of(SPACES) - begin + 1);
+}
+
+// Makes values of text arguments, owns the data values refer to.
+class TextArgumentParser
+{
+public:
+    EthereumAbiValue parse(const EthereumAbiType& type, const std::string& text)
+    {
+        const std::string value = trim(text);
+        switch (type.kind)
+        {
+            case EthereumAbiType::UINT:
+            case EthereumAbiType::INT:
+                return EthereumAbiValue::make_int(BigInt(value.c_str()));
+            case EthereumAbiType::ADDRESS:
+                m_buffers.push_back(ethereum_parse_address(value.c_str()));
+                return EthereumAbiValue::make_address(*m_buffers.back());
+            case EthereumAbiType::BOOL:
+                if (value != "true" && value != "false")
+                {
+                    fail(type, text);
+                }
+                return EthereumAbiValue::make_bool(value == "true");
+            case EthereumAbiType::FIXED_BYTES:
+                return EthereumAbiValue::make_fixed_bytes(parse_hex(value));
+            case EthereumAbiType::BYTES:
+                return EthereumAbiValue::make_bytes(parse_hex(value));
+            case EthereumAbiType::STRING:
+                m_strings.push_back(text);
+                return EthereumAbiValue::make_string(m_strings.back().c_str());
+            case EthereumAbiType::ARRAY:
+            case EthereumAbiType::FIXED_ARRAY:
+            case EthereumAbiType::TUPLE:
+            {
+                const bool is_tuple = type.kind == EthereumAbiType::TUPLE;
+                if (value.size() < 2 || value.front() != (is_tuple ? '(' : '[')
+                        || value.back() != (is_tuple ? ')' : ']'))
+                {
+                    fail(type, text);
+                }
+                const std::vector<std::string> items = split_items(
+                        type, value.substr(1, value.size() - 2));
+
+                std::vector<EthereumAbiValue> values;
+                values.reserve(items.size());
+                for (size_t i = 0; i < items.size(); ++i)
+                {
+                    if (is_tuple && i >= type.components.size())
+                    {
+                        fail(type, text);
+                    }
+                    values.push_back(parse(get_item_type(type, i), trim(items[i])));
+                }
+                return EthereumAbiValue::make_list(std::move(values));
+            }
+        }
+        fail(type, text);
+        return EthereumAbiValue::make_bool(false);
+    }
+
+private:
+    BinaryData parse_hex(const std::string& value)
+    {
+        const size_t prefix_size = (value.compare(0, 2, "0x") == 0) ? 2 : 0;
+        m_buffers.push_back(decode(value.c_str() + prefix_size,
+                value.size() - prefix_size, CODEC_HEX));
+        return *m_buffers.back();
+    }
+
+    // Items of array or tuple, separated by commas outside of nested lists.
+    static std::vector<std::string> split_items(const EthereumAbiType& type,
+            const std::string& text)
+    {
+        std::vector<std::string> result;
+        if (trim(text).empty())
+        {
+            return result;
+        }
+
+        int depth = 0;
+        size_t item_begin = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            const char c = text[i];
+            if (c == '[' || c == '(')
+            {
+                ++depth;
+            }
+            else if (c == ']' || c == ')')
+            {
+                if (--depth < 0)
+                {
+                    fail(type, text);
+                }
+            }
+            else if (c == ',' && depth == 0)
+            {
+                result.push_back(text.substr(item_begin, i - item_begin));
+                item_begin = i + 1;
+            }
+        }
+        if (depth != 0)
+        {
+            fail(type, text);
+        }
+        result.push_back(text.substr(item_begin));
+        return result;
+    }
+
+    static void fail(const EthereumAbiType& type, const std::string& text)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid argument value.")
+                << " Type: " << get_type_name(type) << ", value: \"" << text << "\"";
+    }
+
+private:
+    // Values refer to the contents, so those must never be moved.
+    std::deque<std::string> m_strings;
+    std::vector<BinaryDataPtr> m_buffers;
+};
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+EthereumAbiSelector ethereum_abi_selector(const std::string& signature)
+{
+    const hash<256> signature_hash = do_hash<KECCAK, 256>(signature);
+
+    EthereumAbiSelector result;
+    memcpy(result.data(), signature_hash.data(), result.size());
+    return result;
+}
+
+EthereumAbiValue::EthereumAbiValue(Kind kind)
+    : m_kind(kind),
+      m_word(),
+      m_is_negative(false),
+      m_size(0),
+      m_data{nullptr, 0},
+      m_items()
+{
+}
+
+EthereumAbiValue EthereumAbiValue::make_int(const BigInt& value)
+{
+    EthereumAbiValue result(INTEGER);
+    result.m_is_negative = value < BigInt(0);
+
+    const BigInt magnitude = result.m_is_negative ? -value : value;
+    const size_t size = magnitude.get_exported_size_in_bytes();
+    if (size > WORD_SIZE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Integer is too big.")
+                << " Value: " << value.get_value();
+    }
+    magnitude.export_to_buffer(BigInt::EXPORT_BIG_ENDIAN,
+            result.m_word.data() + WORD_SIZE - size, size);
+
+    if (result.m_is_negative)
+    {
+        // Two's complement: invert and add one.
+        bool carry = true;
+        for (size_t i = WORD_SIZE; i > 0; --i)
+        {
+            uint8_t& byte = result.m_word[i - 1];
+            byte = ~byte;
+            if (carry)
+            {
+                ++byte;
+                carry = (byte == 0);
+            }
+        }
+        // Sign bit is not set if magnitude is bigger than 2^255.
+        if ((result.m_word[0] & 0x80) == 0)
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Integer is too small.")
+                    << " Value: " << value.get_value();
+        }
+    }
+
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_address(const BinaryData& address)
+{
+    INVARIANT(address.data != nullptr);
+    if (address.len != ETHEREUM_ADDRESS_SIZE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ADDRESS, "Invalid address size.")
+                << " Expected: " << ETHEREUM_ADDRESS_SIZE << ", got: " << address.len;
+    }
+
+    EthereumAbiValue result(ADDRESS);
+    memcpy(result.m_word.data() + WORD_SIZE - address.len, address.data, address.len);
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_bool(bool value)
+{
+    EthereumAbiValue result(BOOL);
+    result.m_word = make_word(value ? 1 : 0);
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_fixed_bytes(const BinaryData& value)
+{
+    INVARIANT(value.data != nullptr);
+    if (value.len == 0 || value.len > WORD_SIZE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid fixed bytes size.")
+                << " Size: " << value.len;
+    }
+
+    // Padded on the right, unlike integers.
+    EthereumAbiValue result(FIXED_BYTES);
+    memcpy(result.m_word.data(), value.data, value.len);
+    result.m_size = value.len;
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_bytes(const BinaryData& value)
+{
+    INVARIANT(value.data != nullptr || value.len == 0);
+
+    EthereumAbiValue result(BYTES);
+    result.m_data = value;
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_string(const char* value)
+{
+    INVARIANT(value != nullptr);
+
+    EthereumAbiValue result(STRING);
+    result.m_data = as_binary_data(value);
+    return result;
+}
+
+EthereumAbiValue EthereumAbiValue::make_list(std::vector<EthereumAbiValue> items)
+{
+    EthereumAbiValue result(LIST);
+    result.m_items = std::move(items);
+    return result;
+}
+
+EthereumAbiValue::Kind EthereumAbiValue::get_kind() const
+{
+    return m_kind;
+}
+
+const EthereumAbiWord& EthereumAbiValue::get_word() const
+{
+    return m_word;
+}
+
+bool EthereumAbiValue::is_negative() const
+{
+    return m_is_negative;
+}
+
+size_t EthereumAbiValue::get_size() const
+{
+    return m_size;
+}
+
+const BinaryData& EthereumAbiValue::get_data() const
+{
+    return m_data;
+}
+
+const std::vector<EthereumAbiValue>& EthereumAbiValue::get_items() const
+{
+    return m_items;
+}
+
+EthereumAbiFunction::EthereumAbiFunction(const std::string& signature)
+    : m_arguments(),
+      m_signature(),
+      m_selector()
+{
+    std::string normalized_signature(signature);
+    normalized_signature.erase(std::remove_if(normalized_signature.begin(),
+            normalized_signature.end(),
+            [](char c)
+            {
+                return isspace(static_cast<unsigned char>(c)) != 0;
+            }),
+            normalized_signature.end());
+
+    const std::string name = SignatureParser(normalized_signature).parse(&m_arguments);
+    m_signature = name + get_type_name(m_arguments);
+    m_selector = ethereum_abi_selector(m_signature);
+}
+
+const std::string& EthereumAbiFunction::get_signature() const
+{
+    return m_signature;
+}
+
+const EthereumAbiSelector& EthereumAbiFunction::get_selector() const
+{
+    return m_selector;
+}
+
+size_t EthereumAbiFunction::get_call_size(
+        const std::vector<EthereumAbiValue>& arguments) const
+{
+    return m_selector.size() + get_items_encoded_size(m_arguments, arguments);
+}
+
+void EthereumAbiFunction::write_call(
+        const std::vector<EthereumAbiValue>& arguments,
+        FixedSizeBinaryDataWriter* writer) const
+{
+    INVARIANT(writer != nullptr);
+
+    writer->write_data(m_selector.data(), m_selector.size());
+    write_items(m_arguments, arguments, writer);
+}
+
+BinaryDataPtr EthereumAbiFunction::encode_call(
+        const std::vector<EthereumAbiValue>& arguments) const
+{
+    FixedSizeBinaryDataWriter writer(get_call_size(arguments));
+    write_call(arguments, &writer);
+    return writer.release();
+}
+
+BinaryDataPtr EthereumAbiFunction::encode_call_from_text(
+        const std::vector<std::string>& arguments) const
+{
+    if (arguments.size() != m_arguments.components.size())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid number of arguments.")
+                << " Signature: " << m_signature
+                << ", expected: " << m_arguments.components.size()
+                << ", got: " << arguments.size();
+    }
+
+    TextArgumentParser parser;
+    std::vector<EthereumAbiValue> values;
+    values.reserve(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        values.push_back(parser.parse(m_arguments.components[i], arguments[i]));
+    }
+    return encode_call(values);
+}
+
+} // namespace internal
+} // namespace multy_core
@@ -0,0 +1,159 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_ETHEREUM_ABI_H
+#define MULTY_CORE_ETHEREUM_ABI_H
+
+#include "multy_core/binary_data.h"
+
+#include "multy_core/src/u_ptr.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BigInt;
+
+namespace multy_core
+{
+namespace internal
+{
+class FixedSizeBinaryDataWriter;
+
+/* Solidity contract ABI encoding of function calls, see
+ * https://solidity.readthedocs.io/en/develop/abi-spec.html
+ */
+
+const size_t ETHEREUM_ABI_WORD_SIZE = 32;
+typedef std::array<uint8_t, 4> EthereumAbiSelector;
+typedef std::array<uint8_t, ETHEREUM_ABI_WORD_SIZE> EthereumAbiWord;
+
+/// First 4 bytes of Keccak-256 of the canonical function signature.
+EthereumAbiSelector ethereum_abi_selector(const std::string& signature);
+
+struct EthereumAbiType
+{
+    enum Kind
+    {
+        UINT,
+        INT,
+        ADDRESS,
+        BOOL,
+        FIXED_BYTES, // bytes1 to bytes32
+        BYTES,
+        STRING,
+        ARRAY, // T[]
+        FIXED_ARRAY, // T[k]
+        TUPLE,
+    };
+
+    Kind kind;
+    // Bits of the integer, size of fixed bytes or length of the fixed array.
+    size_t size;
+    // Element type of the array, or components of the tuple.
+    std::vector<EthereumAbiType> components;
+};
+
+/** Value of an argument, for any type of matching kind.
+ *
+ * Static values (integers, addresses, etc.) are stored as ready to use
+ * 32-byte words. Bytes and strings are NOT copied, hence value MUST NOT
+ * outlive the data it was made of.
+ */
+class EthereumAbiValue
+{
+public:
+    enum Kind
+    {
+        INTEGER, // any of intN or uintN, if fits
+        ADDRESS,
+        BOOL,
+        FIXED_BYTES,
+        BYTES,
+        STRING,
+        LIST, // any array or tuple
+    };
+
+    static EthereumAbiValue make_int(const BigInt& value);
+    static EthereumAbiValue make_address(const BinaryData& address);
+    static EthereumAbiValue make_bool(bool value);
+    static EthereumAbiValue make_fixed_bytes(const BinaryData& value);
+    static EthereumAbiValue make_bytes(const BinaryData& value);
+    static EthereumAbiValue make_string(const char* value);
+    static EthereumAbiValue make_list(std::vector<EthereumAbiValue> items);
+
+    Kind get_kind() const;
+    // Encoded static value.
+    const EthereumAbiWord& get_word() const;
+    bool is_negative() const;
+    // Size of the fixed bytes value.
+    size_t get_size() const;
+    // Contents of bytes or string.
+    const BinaryData& get_data() const;
+    const std::vector<EthereumAbiValue>& get_items() const;
+
+private:
+    explicit EthereumAbiValue(Kind kind);
+
+private:
+    Kind m_kind;
+    EthereumAbiWord m_word;
+    bool m_is_negative;
+    size_t m_size;
+    BinaryData m_data;
+    std::vector<EthereumAbiValue> m_items;
+};
+
+/** Contract function, made of signature like "transfer(address,uint256)".
+ *
+ * Signature is parsed once, types of arguments are checked on every call.
+ * Encoded call can be written straight into the pre-sized buffer,
+ * like the data field of the RLP-encoded transaction.
+ */
+class EthereumAbiFunction
+{
+public:
+    /** @param signature - name and argument types, "uint" and "int" aliases
+     *      and whitespace are allowed, i.e. "f(uint, (bytes32, string)[])".
+     *  @throw Exception with ERROR_INVALID_ARGUMENT if signature is invalid.
+     */
+    explicit EthereumAbiFunction(const std::string& signature);
+
+    // Canonical signature, the selector is computed of.
+    const std::string& get_signature() const;
+    const EthereumAbiSelector& get_selector() const;
+
+    /** Size of the selector and encoded arguments.
+     *  @throw Exception with ERROR_INVALID_ARGUMENT if arguments do not match the types.
+     */
+    size_t get_call_size(const std::vector<EthereumAbiValue>& arguments) const;
+    // Writes exactly get_call_size(arguments) bytes.
+    void write_call(const std::vector<EthereumAbiValue>& arguments,
+            FixedSizeBinaryDataWriter* writer) const;
+    BinaryDataPtr encode_call(const std::vector<EthereumAbiValue>& arguments) const;
+
+    /** Same as encode_call(), but arguments are given as text, one per argument:
+     *  integers in decimal, addresses as "0x"-prefixed hex, bool as "true" or
+     *  "false", bytes and bytesN as hex with optional "0x" prefix, strings as is;
+     *  arrays as "[item,...]" and tuples as "(item,...)". Strings inside arrays
+     *  and tuples are trimmed and can't contain any of ",[]()".
+     *  @throw Exception with ERROR_INVALID_ARGUMENT if arguments can't be parsed
+     *      or do not match the types.
+     */
+    BinaryDataPtr encode_call_from_text(const std::vector<std::string>& arguments) const;
+
+private:
+    // Arguments as a single tuple.
+    EthereumAbiType m_arguments;
+    std::string m_signature;
+    EthereumAbiSelector m_selector;
+};
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_ETHEREUM_ABI_H
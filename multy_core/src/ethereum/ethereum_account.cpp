@@ -9,6 +9,7 @@
 #include "multy_core/ethereum.h"
 #include "multy_core/common.h"
 
+#include "multy_core/src/cached_value.h"
 #include "multy_core/src/ec_key_utils.h"
 #include "multy_core/src/exception.h"
 #include "multy_core/src/exception_stream.h"
@@ -17,7 +18,6 @@
 #include "multy_core/src/hash.h"
 
 extern "C" {
-#include "ccan/str/hex/hex.h"
 #include "libwally-core/src/internal.h"
 } // extern "C"
 #include "secp256k1_recovery.h"
@@ -27,8 +27,11 @@ extern "C" {
 #include "wally_core.h"
 #include "wally_crypto.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string.h>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -37,6 +40,139 @@ const size_t ETHEREUM_BINARY_ADDRESS_SIZE = 20;
 const char* ETHEREUM_ADDRESS_PREFIX = "0x";
 
 typedef std::array<unsigned char, ETHEREUM_BINARY_ADDRESS_SIZE> EthereumAddressValue;
+// Lowercase hex of the address, without prefix, that is what EIP-55 checksum is computed of.
+typedef std::array<char, ETHEREUM_BINARY_ADDRESS_SIZE * 2> EthereumAddressHex;
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Value of every hex digit, -1 for any other character.
+struct HexDigitValues
+{
+    HexDigitValues()
+        : values()
+    {
+        std::fill(std::begin(values), std::end(values), -1);
+        for (int i = 0; i < 10; ++i)
+        {
+            values['0' + i] = static_cast<int8_t>(i);
+        }
+        for (int i = 0; i < 6; ++i)
+        {
+            values['a' + i] = static_cast<int8_t>(10 + i);
+            values['A' + i] = static_cast<int8_t>(10 + i);
+        }
+    }
+
+    int8_t values[256];
+};
+
+const HexDigitValues HEX_DIGIT_VALUES;
+
+enum AddressDecodeResult
+{
+    ADDRESS_VALID,
+    ADDRESS_INVALID_SIZE,
+    ADDRESS_INVALID_CHARACTER,
+};
+
+const char* skip_address_prefix(const char* address)
+{
+    const size_t prefix_size = strlen(ETHEREUM_ADDRESS_PREFIX);
+    if (strncmp(address, ETHEREUM_ADDRESS_PREFIX, prefix_size) == 0)
+    {
+        return address + prefix_size;
+    }
+    return address;
+}
+
+/** Decodes address hex string (without prefix), does not allocate.
+ *
+ * @param hex - address hex string, without prefix.
+ * @param address - decoded address.
+ * @param lowercase_hex - normalized address string.
+ * @param has_checksum - set to true if address is mixed-case, i.e. has an EIP-55 checksum.
+ */
+AddressDecodeResult decode_address(const char* hex,
+        EthereumAddressValue* address,
+        EthereumAddressHex* lowercase_hex,
+        bool* has_checksum)
+{
+    // Not using strlen() to avoid scanning arbitrary long strings.
+    for (size_t i = 0; i < lowercase_hex->size(); ++i)
+    {
+        if (hex[i] == '\0')
+        {
+            return ADDRESS_INVALID_SIZE;
+        }
+    }
+    if (hex[lowercase_hex->size()] != '\0')
+    {
+        return ADDRESS_INVALID_SIZE;
+    }
+
+    bool has_lowercase = false;
+    bool has_uppercase = false;
+    for (size_t i = 0; i < lowercase_hex->size(); ++i)
+    {
+        const unsigned char c = static_cast<unsigned char>(hex[i]);
+        const int8_t value = HEX_DIGIT_VALUES.values[c];
+        if (value < 0)
+        {
+            return ADDRESS_INVALID_CHARACTER;
+        }
+        has_lowercase |= (c >= 'a');
+        has_uppercase |= (c >= 'A' && c <= 'F');
+
+        (*lowercase_hex)[i] = HEX_DIGITS[value];
+        unsigned char& byte = (*address)[i / 2];
+        byte = (i % 2 == 0) ? (value << 4) : (byte | value);
+    }
+    *has_checksum = has_lowercase && has_uppercase;
+
+    return ADDRESS_VALID;
+}
+
+// EIP-55: hex letter is uppercase if corresponding nibble of the checksum hash is >= 8.
+bool is_uppercase_in_checksum(const hash<256>& checksum, size_t i)
+{
+    const uint8_t byte = checksum[i / 2];
+    return ((i % 2 == 0) ? (byte >> 4) : (byte & 0x0f)) >= 8;
+}
+
+bool verify_checksum(const char* hex, const hash<256>& checksum)
+{
+    for (size_t i = 0; i < ETHEREUM_BINARY_ADDRESS_SIZE * 2; ++i)
+    {
+        const char c = hex[i];
+        // Digits have no case.
+        if (c > '9' && (c <= 'F') != is_uppercase_in_checksum(checksum, i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string format_address(const EthereumAddressValue& address)
+{
+    EthereumAddressHex hex;
+    for (size_t i = 0; i < address.size(); ++i)
+    {
+        hex[i * 2] = HEX_DIGITS[address[i] >> 4];
+        hex[i * 2 + 1] = HEX_DIGITS[address[i] & 0x0f];
+    }
+    const hash<256> checksum = do_hash<KECCAK, 256>(as_binary_data(hex));
+
+    std::string result(ETHEREUM_ADDRESS_PREFIX);
+    result.reserve(result.size() + hex.size());
+    for (size_t i = 0; i < hex.size(); ++i)
+    {
+        const char c = hex[i];
+        result.push_back(c > '9' && is_uppercase_in_checksum(checksum, i)
+                ? static_cast<char>(c - 'a' + 'A') : c);
+    }
+    return result;
+}
 
 struct EthereumPublicKey : public PublicKey
 {
@@ -76,11 +212,28 @@ private:
 
 typedef UPtr<EthereumPublicKey> EthereumPublicKeyPtr;
 
+EthereumAddressValue make_address(const BinaryData& public_key_data)
+{
+    const auto& address_hash = do_hash<KECCAK, 256>(public_key_data);
+
+    EthereumAddressValue result;
+    static_assert(
+            sizeof(address_hash) - result.size() == 12,
+            "Invalid EthereumAddressValue size.");
+
+    // Copy right 20 bytes
+    memcpy(result.data(), address_hash.data() + 12, result.size());
+    return result;
+}
+
 struct EthereumPrivateKey : public PrivateKey
 {
     typedef std::array<uint8_t, 32> KeyData;
 
-    explicit EthereumPrivateKey(const KeyData& data) : m_data(data)
+    explicit EthereumPrivateKey(const KeyData& data)
+        : m_data(data),
+          m_public_key_data(),
+          m_address()
     {
     }
 
@@ -96,20 +249,37 @@ struct EthereumPrivateKey : public PrivateKey
 
     PublicKeyPtr make_public_key() const override
     {
-        EthereumPublicKey::KeyData key_data(EC_PUBLIC_KEY_UNCOMPRESSED_LEN, 0);
-        BinaryData public_key_data = as_binary_data(key_data);
+        return PublicKeyPtr(new EthereumPublicKey(get_public_key_data()));
+    }
 
-        ec_private_to_public_key(as_binary_data(m_data),
-                EC_PUBLIC_KEY_UNCOMPRESSED,
-                &public_key_data);
+    // Public key and address are computed on first use and then cached.
+    const EthereumPublicKey::KeyData& get_public_key_data() const
+    {
+        return m_public_key_data.get([this]()
+        {
+            EthereumPublicKey::KeyData key_data(EC_PUBLIC_KEY_UNCOMPRESSED_LEN, 0);
+            BinaryData public_key_data = as_binary_data(key_data);
+
+            ec_private_to_public_key(as_binary_data(m_data),
+                    EC_PUBLIC_KEY_UNCOMPRESSED,
+                    &public_key_data);
+
+            if (key_data[0] != 0x04)
+            {
+                THROW_EXCEPTION2(ERROR_KEY_CORRUPT,
+                        "Invalid uncompressed public key prefix.");
+            }
+            key_data.erase(key_data.begin());
+            return key_data;
+        });
+    }
 
-        if (key_data[0] != 0x04)
+    const EthereumAddressValue& get_address() const
+    {
+        return m_address.get([this]()
         {
-            THROW_EXCEPTION2(ERROR_KEY_CORRUPT,
-                    "Invalid uncompressed public key prefix.");
-        }
-        key_data.erase(key_data.begin());
-        return PublicKeyPtr(new EthereumPublicKey(std::move(key_data)));
+            return make_address(as_binary_data(get_public_key_data()));
+        });
     }
 
     PrivateKeyPtr clone() const override
@@ -150,23 +320,10 @@ struct EthereumPrivateKey : public PrivateKey
 
 private:
     const KeyData m_data;
+    CachedValue<EthereumPublicKey::KeyData> m_public_key_data;
+    CachedValue<EthereumAddressValue> m_address;
 };
 
-EthereumAddressValue make_address(const EthereumPublicKey& key)
-{
-    const BinaryData key_data = key.get_content();
-    const auto& address_hash = do_hash<KECCAK, 256>(key_data);
-
-    EthereumAddressValue result;
-    static_assert(
-            sizeof(address_hash) - result.size() == 12,
-            "Invalid EthereumAddressValue size.");
-
-    // Copy right 20 bytes
-    memcpy(result.data(), address_hash.data() + 12, result.size());
-    return result;
-}
-
 typedef UPtr<EthereumPrivateKey> EthereumPrivateKeyPtr;
 typedef UPtr<EthereumPublicKey> EthereumPublicKeyPtr;
 
@@ -178,34 +335,22 @@ public:
             EthereumPrivateKeyPtr private_key,
             const HDPath& path = HDPath())
         : AccountBase(blockchain_type, *private_key, path),
-          m_private_key(std::move(private_key))
+          m_private_key(std::move(private_key)),
+          m_address()
     {
     }
 
     std::string get_address() const override
     {
-        EthereumPublicKeyPtr public_key(
-                reinterpret_cast<EthereumPublicKey*>(
-                        m_private_key->make_public_key().release()));
-
-        EthereumAddressValue address(make_address(*public_key));
-
-        std::string result(hex_str_size(strlen(ETHEREUM_ADDRESS_PREFIX))
-                + hex_str_size(address.size()),
-                '\0');
-        if (!hex_encode(address.data(), address.size(),
-                const_cast<char*>(result.data()), result.size()))
+        return m_address.get([this]()
         {
-            INVARIANT2(false, "Faield to hex-encode Ethereum address.");
-        }
-        result.insert(0, ETHEREUM_ADDRESS_PREFIX);
-        trim_excess_trailing_null(&result);
-
-        return result;
+            return format_address(m_private_key->get_address());
+        });
     }
 
 private:
     EthereumPrivateKeyPtr m_private_key;
+    CachedValue<std::string> m_address;
 };
 
 uint32_t get_chain_index(BlockchainType blockchain_type)
@@ -243,6 +388,13 @@ EthereumHDAccount::EthereumHDAccount(
 {
 }
 
+EthereumHDAccount::EthereumHDAccount(
+        BlockchainType blockchain_type,
+        const ExtendedKey& account_public_key)
+    : HDAccountBase(blockchain_type, get_chain_index(blockchain_type), account_public_key)
+{
+}
+
 AccountPtr EthereumHDAccount::make_account(
         const ExtendedKey& parent_key, AddressType type, uint32_t index) const
 {
@@ -251,7 +403,7 @@ AccountPtr EthereumHDAccount::make_account(
 
     EthereumPrivateKey::KeyData data;
     static_assert(sizeof(address_key->key.priv_key) == data.max_size() + 1, "");
-    memcpy(data.data(), address_key->key.priv_key + 1, data.size() - 1);
+    memcpy(data.data(), address_key->key.priv_key + 1, data.size());
 
     EthereumPrivateKeyPtr private_key(new EthereumPrivateKey(data));
 
@@ -259,11 +411,63 @@ AccountPtr EthereumHDAccount::make_account(
             new EthereumAccount(
                     get_blockchain_type(),
                     std::move(private_key),
-                    make_child_path(make_child_path(get_path(), type), index)));
+                    make_leaf_path(type, index)));
 
     return result;
 }
 
+PublicKeyFormat EthereumHDAccount::get_address_public_key_format() const
+{
+    return EC_PUBLIC_KEY_UNCOMPRESSED;
+}
+
+void EthereumHDAccount::make_addresses(const unsigned char* public_keys,
+        size_t count, std::string* out_addresses) const
+{
+    static_assert(sizeof(EthereumAddressValue) == ETHEREUM_BINARY_ADDRESS_SIZE,
+            "EthereumAddressValue must have no padding.");
+    std::vector<EthereumAddressValue> addresses(count);
+    make_address_hashes(public_keys, count,
+            reinterpret_cast<unsigned char*>(addresses.data()));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_addresses[i] = format_address(addresses[i]);
+    }
+}
+
+void EthereumHDAccount::make_address_hashes(const unsigned char* public_keys,
+        size_t count, unsigned char* out_hashes) const
+{
+    // Skip uncompressed key prefix, just like EthereumPrivateKey does.
+    std::vector<BinaryData> hashing_inputs;
+    hashing_inputs.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        hashing_inputs.push_back(BinaryData{
+                public_keys + i * EC_PUBLIC_KEY_UNCOMPRESSED_LEN + 1,
+                EC_PUBLIC_KEY_UNCOMPRESSED_LEN - 1});
+    }
+    const std::vector<hash<256>> key_hashes = keccak_256_many(
+            hashing_inputs.data(), hashing_inputs.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Copy right 20 bytes
+        memcpy(out_hashes + i * ETHEREUM_BINARY_ADDRESS_SIZE,
+                key_hashes[i].data() + key_hashes[i].size() - ETHEREUM_BINARY_ADDRESS_SIZE,
+                ETHEREUM_BINARY_ADDRESS_SIZE);
+    }
+}
+
+PublicKeyPtr EthereumHDAccount::make_leaf_public_key(
+        const unsigned char* public_key) const
+{
+    // Skip uncompressed key prefix, just like EthereumPrivateKey does.
+    return PublicKeyPtr(new EthereumPublicKey(EthereumPublicKey::KeyData(
+            public_key + 1, public_key + EC_PUBLIC_KEY_UNCOMPRESSED_LEN)));
+}
+
 AccountPtr make_ethereum_account(BlockchainType blockchain_type,
         const char* serialized_private_key)
 {
@@ -301,24 +505,149 @@ BinaryDataPtr ethereum_parse_address(const char* address)
 {
     INVARIANT(address != nullptr);
 
-    if (strncmp(address, ETHEREUM_ADDRESS_PREFIX, strlen(ETHEREUM_ADDRESS_PREFIX)) == 0)
+    const char* hex = skip_address_prefix(address);
+    EthereumAddressValue value;
+    EthereumAddressHex lowercase_hex;
+    bool has_checksum = false;
+    switch (decode_address(hex, &value, &lowercase_hex, &has_checksum))
+    {
+        case ADDRESS_VALID:
+            break;
+        case ADDRESS_INVALID_SIZE:
+            THROW_EXCEPTION2(ERROR_INVALID_ADDRESS,
+                    "Invalid address size.")
+                    << " Expected " << lowercase_hex.size() << " hex digits,"
+                    << " got: " << strlen(hex);
+        case ADDRESS_INVALID_CHARACTER:
+            THROW_EXCEPTION2(ERROR_INVALID_ADDRESS,
+                    "Address is not a valid hex string.");
+    }
+
+    if (has_checksum && !verify_checksum(hex,
+            do_hash<KECCAK, 256>(as_binary_data(lowercase_hex))))
     {
-        address += strlen(ETHEREUM_ADDRESS_PREFIX);
+        THROW_EXCEPTION2(ERROR_INVALID_ADDRESS,
+                "Invalid EIP-55 address checksum.")
+                << " Address: \"" << address << "\"";
     }
 
-    BinaryDataPtr binary_address;
-    throw_if_error(make_binary_data_from_hex(address,
-            reset_sp(binary_address)));
+    BinaryDataPtr result;
+    throw_if_error(make_binary_data_from_bytes(
+            value.data(), value.size(), reset_sp(result)));
+    return result;
+}
+
+std::string ethereum_format_address(const BinaryData& address)
+{
+    INVARIANT(address.data != nullptr);
 
-    if (binary_address->len != ETHEREUM_BINARY_ADDRESS_SIZE)
+    EthereumAddressValue value;
+    if (address.len != value.size())
     {
         THROW_EXCEPTION2(ERROR_INVALID_ADDRESS,
-                "Invalid decoded address size.")
-                << " Expected size: " << ETHEREUM_BINARY_ADDRESS_SIZE
-                << " Actual size: " << binary_address->len;
+                "Invalid binary address size.")
+                << " Expected size: " << value.size()
+                << " Actual size: " << address.len;
+    }
+    memcpy(value.data(), address.data, value.size());
+
+    return format_address(value);
+}
+
+void ethereum_validate_addresses(const char* const* addresses, size_t count,
+        bool* out_valid)
+{
+    INVARIANT(addresses != nullptr || count == 0);
+    INVARIANT(out_valid != nullptr || count == 0);
+
+    // Checksums of all mixed-case addresses are computed in one go.
+    std::vector<EthereumAddressHex> checksummed;
+    std::vector<size_t> checksummed_indices;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_valid[i] = false;
+        if (addresses[i] == nullptr)
+        {
+            continue;
+        }
+
+        EthereumAddressValue value;
+        EthereumAddressHex lowercase_hex;
+        bool has_checksum = false;
+        if (decode_address(skip_address_prefix(addresses[i]),
+                &value, &lowercase_hex, &has_checksum) != ADDRESS_VALID)
+        {
+            continue;
+        }
+
+        if (has_checksum)
+        {
+            checksummed.push_back(lowercase_hex);
+            checksummed_indices.push_back(i);
+        }
+        else
+        {
+            out_valid[i] = true;
+        }
+    }
+
+    std::vector<BinaryData> hashing_inputs;
+    hashing_inputs.reserve(checksummed.size());
+    for (const EthereumAddressHex& hex : checksummed)
+    {
+        hashing_inputs.push_back(as_binary_data(hex));
+    }
+    const std::vector<hash<256>> checksums = keccak_256_many(
+            hashing_inputs.data(), hashing_inputs.size());
+
+    for (size_t i = 0; i < checksums.size(); ++i)
+    {
+        const size_t index = checksummed_indices[i];
+        out_valid[index] = verify_checksum(
+                skip_address_prefix(addresses[index]), checksums[i]);
+    }
+}
+
+BinaryDataPtr ethereum_recover_address(const BinaryData& hash,
+        const BinaryData& signature, int recovery_id)
+{
+    INVARIANT(hash.data != nullptr);
+    INVARIANT(signature.data != nullptr);
+
+    if (hash.len != 32 || signature.len != 64)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid hash or signature size.")
+                << " Hash size: " << hash.len
+                << ", signature size: " << signature.len;
+    }
+
+    secp256k1_ecdsa_recoverable_signature recoverable_signature;
+    secp256k1_pubkey public_key;
+    if (recovery_id < 0 || recovery_id > 3
+            || !secp256k1_ecdsa_recoverable_signature_parse_compact(secp_ctx(),
+                    &recoverable_signature, signature.data, recovery_id)
+            || !secp256k1_ecdsa_recover(secp_ctx(), &public_key,
+                    &recoverable_signature, hash.data))
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Failed to recover public key from signature.")
+                << " Recovery id: " << recovery_id;
     }
 
-    return binary_address;
+    std::array<unsigned char, EC_PUBLIC_KEY_UNCOMPRESSED_LEN> public_key_data;
+    size_t public_key_size = public_key_data.size();
+    secp256k1_ec_pubkey_serialize(secp_ctx(), public_key_data.data(),
+            &public_key_size, &public_key, SECP256K1_EC_UNCOMPRESSED);
+
+    // Skip uncompressed key prefix, just like EthereumPrivateKey does.
+    const EthereumAddressValue& address = make_address(
+            BinaryData{public_key_data.data() + 1, public_key_data.size() - 1});
+
+    BinaryDataPtr result;
+    throw_if_error(make_binary_data_from_bytes(
+            address.data(), address.size(), reset_sp(result)));
+    return result;
 }
 
 } // namespace internal
@@ -9,6 +9,8 @@
 
 #include "multy_core/src/account_base.h"
 
+#include <string>
+
 namespace multy_core
 {
 namespace internal
@@ -18,17 +20,57 @@ class EthereumHDAccount : public HDAccountBase
 {
 public:
     EthereumHDAccount(BlockchainType blockchain_type, const ExtendedKey& bip44_master_key, uint32_t index);
+    // Watch-only account, see HDAccountBase.
+    EthereumHDAccount(BlockchainType blockchain_type, const ExtendedKey& account_public_key);
 
 protected:
     AccountPtr make_account(
             const ExtendedKey& parent_key, AddressType type, uint32_t index) const override;
+
+    PublicKeyFormat get_address_public_key_format() const override;
+    void make_addresses(const unsigned char* public_keys, size_t count,
+            std::string* out_addresses) const override;
+    void make_address_hashes(const unsigned char* public_keys, size_t count,
+            unsigned char* out_hashes) const override;
+    PublicKeyPtr make_leaf_public_key(const unsigned char* public_key) const override;
 };
 
 AccountPtr make_ethereum_account(BlockchainType blockchain_type,
         const char* serialized_private_key);
 
+/** Parses hex address, with or without "0x" prefix.
+ *
+ * Mixed-case address must have a valid EIP-55 checksum,
+ * all-lowercase and all-uppercase addresses are accepted as is.
+ * @return 20-byte binary address.
+ * @throw Exception with ERROR_INVALID_ADDRESS if address is invalid.
+ */
 BinaryDataPtr ethereum_parse_address(const char* address);
 
+/// Formats 20-byte binary address as "0x"-prefixed EIP-55 checksummed hex string.
+std::string ethereum_format_address(const BinaryData& address);
+
+/** Validates many addresses at once, with same rules as ethereum_parse_address().
+ *
+ * Nothing is thrown for invalid addresses and checksums of all mixed-case
+ * addresses are computed in a single batch.
+ * @param addresses - count addresses, null ones are invalid.
+ * @param out_valid - count items, each is set to true if address is valid.
+ */
+void ethereum_validate_addresses(const char* const* addresses, size_t count,
+        bool* out_valid);
+
+/** Recovers address of the signer from the signature.
+ *
+ * @param hash - 32-byte hash of the signed data.
+ * @param signature - 64 bytes: r and s, each 32-byte big-endian.
+ * @param recovery_id - 0 to 3.
+ * @return 20-byte binary address.
+ * @throw Exception with ERROR_INVALID_ARGUMENT if signature is invalid.
+ */
+BinaryDataPtr ethereum_recover_address(const BinaryData& hash,
+        const BinaryData& signature, int recovery_id);
+
 } // namespace internal
 } // namespace multy_core
 
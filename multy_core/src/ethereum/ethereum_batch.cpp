@@ -0,0 +1,152 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_batch.h"
+
+#include "multy_core/ethereum.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/ethereum/ethereum_rlp.h"
+#include "multy_core/src/ethereum/ethereum_token.h"
+#include "multy_core/src/ethereum/ethereum_transaction.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+using namespace multy_core::internal;
+
+void check_non_negative(const BigInt& value, const char* name)
+{
+    if (value < 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Value should be non-negative.")
+                << " Value: " << name << " = " << value.get_value();
+    }
+}
+
+// Signs transactions in range [begin, end).
+void sign_transactions(const PrivateKey& private_key,
+        EthereumChainId chain_id,
+        size_t begin,
+        size_t end,
+        std::vector<BinaryDataPtr>* transactions)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        // Encoded fields are replaced with the signed transaction.
+        BinaryDataPtr& transaction = (*transactions)[i];
+        const BinaryDataPtr unsigned_transaction
+                = ethereum_encode_unsigned_transaction(*transaction, chain_id);
+        const BinaryDataPtr signature = private_key.sign(*unsigned_transaction);
+        transaction = ethereum_encode_signed_transaction(
+                *transaction, chain_id, *signature);
+    }
+}
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+std::vector<BinaryDataPtr> make_signed_ethereum_transactions(
+        const Account& account,
+        const BigInt& first_nonce,
+        const BigInt& gas_price,
+        const BigInt& gas_limit,
+        const EthereumTransfer* transfers,
+        size_t transfers_count,
+        size_t threads_count)
+{
+    INVARIANT(transfers != nullptr || transfers_count == 0);
+
+    const BlockchainType blockchain_type = account.get_blockchain_type();
+    if (blockchain_type.blockchain != BLOCKCHAIN_ETHEREUM)
+    {
+        THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+                "Batch signing is supported only for Ethereum accounts.");
+    }
+    const EthereumChainId chain_id = static_cast<EthereumChainId>(
+            blockchain_type.net_type);
+
+    check_non_negative(first_nonce, "first_nonce");
+    check_non_negative(gas_price, "gas_price");
+    check_non_negative(gas_limit, "gas_limit");
+
+    // Each token contract is parsed only once.
+    std::unordered_map<std::string, EthereumSmartContractPayloadPtr> token_transfers;
+    std::vector<BinaryDataPtr> result(transfers_count);
+    BigInt nonce(first_nonce);
+    for (size_t i = 0; i < transfers_count; ++i, nonce += 1)
+    {
+        const EthereumTransfer& transfer = transfers[i];
+        if (transfer.address == nullptr || transfer.amount == nullptr)
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "Transfer address and amount must be set.")
+                    << " Transfer index: " << i;
+        }
+        check_non_negative(*transfer.amount, "amount");
+
+        const BinaryDataPtr address = ethereum_parse_address(transfer.address);
+        const BigInt zero_value;
+        const BinaryData* destination = address.get();
+        const BigInt* value = transfer.amount;
+        const EthereumSmartContractPayload* token_transfer = nullptr;
+        if (transfer.token_transfer != nullptr)
+        {
+            EthereumSmartContractPayloadPtr& cached_token_transfer
+                    = token_transfers[transfer.token_transfer];
+            if (!cached_token_transfer)
+            {
+                cached_token_transfer = parse_token_transfer_data(transfer.token_transfer);
+            }
+            token_transfer = cached_token_transfer.get();
+            destination = &token_transfer->get_contract_address();
+            value = &zero_value;
+        }
+
+        result[i] = encode_rlp([&](EthereumRlpEncoder* encoder)
+        {
+            ethereum_write_transaction_fields(nonce, gas_price, gas_limit,
+                    *destination, *value,
+                    token_transfer, address.get(), transfer.amount,
+                    nullptr,
+                    encoder);
+        });
+    }
+
+    if (transfers_count == 0)
+    {
+        return result;
+    }
+
+    const PrivateKeyPtr private_key = account.get_private_key();
+
+    // First transaction is signed before any threads are started, that also
+    // initializes the secp256k1 context, which is created lazily and not thread-safe.
+    sign_transactions(*private_key, chain_id, 0, 1, &result);
+
+    parallel_for(transfers_count - 1, 1, threads_count,
+            [&](size_t begin, size_t end)
+            {
+                sign_transactions(*private_key, chain_id, 1 + begin, 1 + end, &result);
+            });
+
+    return result;
+}
+
+} // namespace internal
+} // namespace multy_core
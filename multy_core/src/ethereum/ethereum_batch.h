@@ -0,0 +1,44 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_ETHEREUM_BATCH_H
+#define MULTY_CORE_SRC_ETHEREUM_BATCH_H
+
+#include "multy_core/ethereum_batch.h"
+
+#include "multy_core/src/u_ptr.h"
+
+#include <vector>
+
+struct Account;
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Make signed transactions with consecutive nonces, one per transfer.
+ *
+ * All transfers are validated and encoded first, on the calling thread,
+ * then those are signed, possibly in parallel.
+ *
+ * @param threads_count - 0 means std::thread::hardware_concurrency().
+ * @throw Exception if account is not an Ethereum account or any of transfers
+ * is invalid.
+ */
+std::vector<BinaryDataPtr> make_signed_ethereum_transactions(
+        const Account& account,
+        const BigInt& first_nonce,
+        const BigInt& gas_price,
+        const BigInt& gas_limit,
+        const EthereumTransfer* transfers,
+        size_t transfers_count,
+        size_t threads_count);
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_SRC_ETHEREUM_BATCH_H
@@ -53,6 +53,16 @@ HDAccountPtr EthereumFacade::make_hd_account(
     return HDAccountPtr(new EthereumHDAccount(blockchain_type, master_key, index));
 }
 
+HDAccountPtr EthereumFacade::make_watch_only_hd_account(
+        BlockchainType blockchain_type,
+        uint32_t account_type,
+        const ExtendedKey& account_public_key) const
+{
+    validate_ethereum_account_type(account_type);
+
+    return HDAccountPtr(new EthereumHDAccount(blockchain_type, account_public_key));
+}
+
 AccountPtr EthereumFacade::make_account(
         BlockchainType blockchain_type,
         uint32_t account_type,
@@ -74,6 +84,12 @@ void EthereumFacade::validate_address(
     ethereum_parse_address(address);
 }
 
+void EthereumFacade::validate_addresses(BlockchainType,
+        const char* const* addresses, size_t count, bool* out_valid) const
+{
+    ethereum_validate_addresses(addresses, count, out_valid);
+}
+
 std::string EthereumFacade::encode_serialized_transaction(
         const BinaryData& serialized_transaction) const
 {
@@ -35,6 +35,11 @@ public:
             const ExtendedKey& master_key,
             uint32_t index) const override;
 
+    HDAccountPtr make_watch_only_hd_account(
+            BlockchainType blockchain_type,
+            uint32_t account_type,
+            const ExtendedKey& account_public_key) const override;
+
     AccountPtr make_account(
             BlockchainType blockchain_type,
             uint32_t account_type,
@@ -43,6 +48,9 @@ public:
     TransactionPtr make_transaction(const Account&) const override;
     void validate_address(BlockchainType blockchain_type,
             const char* address) const override;
+    void validate_addresses(BlockchainType blockchain_type,
+            const char* const* addresses, size_t count,
+            bool* out_valid) const override;
 
     std::string encode_serialized_transaction(
                 const BinaryData& serialized_transaction) const override;
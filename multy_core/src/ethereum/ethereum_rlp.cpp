@@ -0,0 +1,383 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_rlp.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+
+namespace
+{
+using namespace multy_core::internal;
+
+const uint8_t RLP_STRING_BASE = 0x80;
+const uint8_t RLP_LIST_BASE = 0xc0;
+// Payloads shorter than that have length embedded into the header byte.
+const size_t RLP_MAX_SHORT_LENGTH = 55;
+// Ethereum integers are at most 256 bit long.
+const size_t RLP_MAX_INLINE_UINT_SIZE = 32;
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+EthereumRlpEncoder::EthereumRlpEncoder()
+    : m_is_writing(false),
+      m_offset(0),
+      m_list_lengths(),
+      m_next_list(0),
+      m_open_lists(),
+      m_writer()
+{
+}
+
+EthereumRlpEncoder::~EthereumRlpEncoder()
+{
+}
+
+void EthereumRlpEncoder::write_bytes(const BinaryData& data)
+{
+    INVARIANT(data.data != nullptr || data.len == 0);
+
+    if (data.len == 1 && data.data[0] < RLP_STRING_BASE)
+    {
+        write_raw(data.data, 1);
+        return;
+    }
+
+    write_header(data.len, RLP_STRING_BASE);
+    write_raw(data.data, data.len);
+}
+
+void EthereumRlpEncoder::write_bytes(size_t size,
+        const std::function<void (FixedSizeBinaryDataWriter*)>& write_content)
+{
+    if (size == 1)
+    {
+        // Header depends on the value of the single byte.
+        FixedSizeBinaryDataWriter writer(1);
+        write_content(&writer);
+        write_bytes(*writer.release());
+        return;
+    }
+
+    write_header(size, RLP_STRING_BASE);
+    if (m_is_writing)
+    {
+        write_content(m_writer.get());
+    }
+    m_offset += size;
+}
+
+void EthereumRlpEncoder::write_big_endian_uint(const BinaryData& value)
+{
+    size_t leading_zeroes = 0;
+    while (leading_zeroes < value.len && value.data[leading_zeroes] == 0)
+    {
+        ++leading_zeroes;
+    }
+
+    write_bytes(BinaryData{value.data + leading_zeroes, value.len - leading_zeroes});
+}
+
+void EthereumRlpEncoder::write_uint(uint64_t value)
+{
+    uint8_t buffer[sizeof(value)];
+    for (size_t i = sizeof(value); i > 0; --i)
+    {
+        buffer[i - 1] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+
+    write_big_endian_uint(as_binary_data(buffer));
+}
+
+void EthereumRlpEncoder::write_big_int(const BigInt& value)
+{
+    if (value.compare(int64_t(0)) < 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Can't RLP-encode negative integer.")
+                << " Value: " << value.get_value();
+    }
+
+    if (value.get_exported_size_in_bytes() > RLP_MAX_INLINE_UINT_SIZE)
+    {
+        write_bytes(*value.export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN));
+        return;
+    }
+
+    uint8_t buffer[RLP_MAX_INLINE_UINT_SIZE];
+    const size_t size = value.export_to_buffer(BigInt::EXPORT_BIG_ENDIAN,
+            buffer, sizeof(buffer));
+    write_bytes(BinaryData{buffer, size});
+}
+
+void EthereumRlpEncoder::write_encoded(const BinaryData& encoded)
+{
+    INVARIANT(encoded.data != nullptr || encoded.len == 0);
+
+    write_raw(encoded.data, encoded.len);
+}
+
+void EthereumRlpEncoder::begin_list()
+{
+    size_t list_index = 0;
+    if (m_is_writing)
+    {
+        INVARIANT(m_next_list < m_list_lengths.size());
+        list_index = m_next_list++;
+        write_header(m_list_lengths[list_index], RLP_LIST_BASE);
+    }
+    else
+    {
+        // Length is not known yet, header is accounted for in end_list().
+        list_index = m_list_lengths.size();
+        m_list_lengths.push_back(0);
+    }
+
+    m_open_lists.push_back(std::make_pair(list_index, m_offset));
+}
+
+void EthereumRlpEncoder::end_list()
+{
+    INVARIANT(!m_open_lists.empty());
+
+    const size_t list_index = m_open_lists.back().first;
+    const size_t payload_length = m_offset - m_open_lists.back().second;
+    m_open_lists.pop_back();
+
+    if (m_is_writing)
+    {
+        INVARIANT2(payload_length == m_list_lengths[list_index],
+                "Sizing and writing passes are different.");
+    }
+    else
+    {
+        m_list_lengths[list_index] = payload_length;
+        write_header(payload_length, RLP_LIST_BASE);
+    }
+}
+
+void EthereumRlpEncoder::start_writing()
+{
+    INVARIANT(!m_is_writing);
+    INVARIANT(m_open_lists.empty());
+
+    m_writer.reset(new FixedSizeBinaryDataWriter(m_offset));
+    m_is_writing = true;
+    m_offset = 0;
+    m_next_list = 0;
+}
+
+BinaryDataPtr EthereumRlpEncoder::release()
+{
+    INVARIANT(m_is_writing);
+    INVARIANT(m_open_lists.empty());
+    INVARIANT2(m_next_list == m_list_lengths.size(),
+            "Sizing and writing passes are different.");
+
+    return m_writer->release();
+}
+
+void EthereumRlpEncoder::write_header(size_t length, uint8_t short_header_base)
+{
+    if (length <= RLP_MAX_SHORT_LENGTH)
+    {
+        const uint8_t header = static_cast<uint8_t>(short_header_base + length);
+        write_raw(&header, 1);
+        return;
+    }
+
+    const size_t length_size = get_bytes_len(length);
+    uint8_t header[1 + sizeof(length)];
+    header[0] = static_cast<uint8_t>(
+            short_header_base + RLP_MAX_SHORT_LENGTH + length_size);
+    for (size_t i = length_size; i > 0; --i)
+    {
+        header[i] = static_cast<uint8_t>(length);
+        length >>= 8;
+    }
+    write_raw(header, 1 + length_size);
+}
+
+void EthereumRlpEncoder::write_raw(const void* data, size_t size)
+{
+    if (m_is_writing)
+    {
+        m_writer->write_data(data, size);
+    }
+    m_offset += size;
+}
+
+EthereumRlpReader::EthereumRlpReader(const BinaryData& data)
+    : m_data(data),
+      m_offset(0)
+{
+    INVARIANT(data.data != nullptr || data.len == 0);
+}
+
+bool EthereumRlpReader::has_more() const
+{
+    return m_offset < m_data.len;
+}
+
+size_t EthereumRlpReader::get_offset() const
+{
+    return m_offset;
+}
+
+EthereumRlpItem EthereumRlpReader::read_item()
+{
+    if (!has_more())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Unexpected end of RLP data.")
+                << " Offset: " << m_offset;
+    }
+
+    const size_t item_offset = m_offset;
+    const uint8_t header = m_data.data[m_offset++];
+
+    EthereumRlpItem result;
+    result.is_list = header >= RLP_LIST_BASE;
+
+    size_t length = 0;
+    if (header < RLP_STRING_BASE)
+    {
+        // Single byte, it is a payload itself.
+        length = 1;
+        --m_offset;
+    }
+    else
+    {
+        const uint8_t base = result.is_list ? RLP_LIST_BASE : RLP_STRING_BASE;
+        length = header - base;
+        if (length > RLP_MAX_SHORT_LENGTH)
+        {
+            length = read_length(static_cast<uint8_t>(length - RLP_MAX_SHORT_LENGTH));
+        }
+    }
+
+    if (length > m_data.len - m_offset)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Unexpected end of RLP data.")
+                << " Offset: " << m_offset << ", requested: " << length
+                << ", available: " << m_data.len - m_offset;
+    }
+
+    result.payload = BinaryData{m_data.data + m_offset, length};
+    m_offset += length;
+    result.encoded = BinaryData{m_data.data + item_offset, m_offset - item_offset};
+
+    if (!result.is_list && header == RLP_STRING_BASE + 1
+            && result.payload.data[0] < RLP_STRING_BASE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Non-canonical RLP encoding of a single byte.")
+                << " Offset: " << item_offset;
+    }
+
+    return result;
+}
+
+BinaryData EthereumRlpReader::read_bytes()
+{
+    const EthereumRlpItem item = read_item();
+    if (item.is_list)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Expected RLP string, got a list.")
+                << " Offset: " << m_offset - item.encoded.len;
+    }
+    return item.payload;
+}
+
+EthereumRlpReader EthereumRlpReader::read_list()
+{
+    const EthereumRlpItem item = read_item();
+    if (!item.is_list)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Expected RLP list, got a string.")
+                << " Offset: " << m_offset - item.encoded.len;
+    }
+    return EthereumRlpReader(item.payload);
+}
+
+BinaryData EthereumRlpReader::read_uint_bytes()
+{
+    const BinaryData result = read_bytes();
+    if (result.len > 0 && result.data[0] == 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Non-canonical RLP integer with leading zero bytes.")
+                << " Offset: " << m_offset - result.len;
+    }
+    return result;
+}
+
+uint64_t EthereumRlpReader::read_uint64()
+{
+    const BinaryData value = read_uint_bytes();
+    if (value.len > sizeof(uint64_t))
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "RLP integer value is too big.")
+                << " Size: " << value.len;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < value.len; ++i)
+    {
+        result = (result << 8) | value.data[i];
+    }
+    return result;
+}
+
+BigInt EthereumRlpReader::read_big_int()
+{
+    BigInt result;
+    result.import_from_binary_data(read_uint_bytes(), BigInt::EXPORT_BIG_ENDIAN);
+    return result;
+}
+
+size_t EthereumRlpReader::read_length(uint8_t length_size)
+{
+    if (length_size > sizeof(size_t) || length_size > m_data.len - m_offset)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid RLP length.")
+                << " Offset: " << m_offset << ", length size: " << static_cast<int>(length_size);
+    }
+
+    if (m_data.data[m_offset] == 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Non-canonical RLP length with leading zero bytes.")
+                << " Offset: " << m_offset;
+    }
+
+    size_t result = 0;
+    for (size_t i = 0; i < length_size; ++i)
+    {
+        result = (result << 8) | m_data.data[m_offset++];
+    }
+
+    if (result <= RLP_MAX_SHORT_LENGTH)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Non-canonical RLP encoding of a short length.")
+                << " Offset: " << m_offset << ", length: " << result;
+    }
+    return result;
+}
+
+} // namespace internal
+} // namespace multy_core
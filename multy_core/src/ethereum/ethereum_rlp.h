@@ -0,0 +1,142 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_ETHEREUM_RLP_H
+#define MULTY_CORE_ETHEREUM_RLP_H
+
+#include "multy_core/binary_data.h"
+
+#include "multy_core/src/u_ptr.h"
+#include "multy_core/src/utility.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct BigInt;
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Two-pass RLP encoder, see https://github.com/ethereum/wiki/wiki/RLP
+ *
+ * Exactly the same sequence of calls has to be made twice: first one is a
+ * sizing pass, that only computes lengths of all (possibly nested) lists
+ * and total size; second one, after start_writing(), writes everything
+ * straight into the buffer of exact size. See encode_rlp().
+ */
+class EthereumRlpEncoder
+{
+public:
+    EthereumRlpEncoder();
+    ~EthereumRlpEncoder();
+
+    // Byte string.
+    void write_bytes(const BinaryData& data);
+    // Byte string of known size, write_content() must write exactly that much
+    // straight into the output buffer, it is not called on the sizing pass.
+    // Except for size of 1: encoded size depends on the value of that byte,
+    // so write_content() is called on both passes, into a temporary buffer.
+    void write_bytes(size_t size,
+            const std::function<void (FixedSizeBinaryDataWriter*)>& write_content);
+    // Big-endian integer, leading zero bytes are stripped.
+    void write_big_endian_uint(const BinaryData& value);
+    void write_uint(uint64_t value);
+    // Value must be non-negative.
+    void write_big_int(const BigInt& value);
+    // Already RLP-encoded item(s), written as is.
+    void write_encoded(const BinaryData& encoded);
+
+    void begin_list();
+    void end_list();
+
+    // Ends sizing pass and allocates the buffer.
+    void start_writing();
+    // Ends writing pass, returns encoded data.
+    BinaryDataPtr release();
+
+private:
+    void write_header(size_t length, uint8_t short_header_base);
+    void write_raw(const void* data, size_t size);
+
+private:
+    bool m_is_writing;
+    size_t m_offset;
+    // Length of payload of each list, in order of begin_list() calls.
+    std::vector<size_t> m_list_lengths;
+    size_t m_next_list;
+    // Index in m_list_lengths and payload start offset of each open list.
+    std::vector<std::pair<size_t, size_t>> m_open_lists;
+    std::unique_ptr<FixedSizeBinaryDataWriter> m_writer;
+};
+
+/** Encodes items written by write_items(encoder) with EthereumRlpEncoder.
+ *
+ * write_items is called twice and must produce same sequence of items each time.
+ */
+template <typename WriteItems>
+BinaryDataPtr encode_rlp(const WriteItems& write_items)
+{
+    EthereumRlpEncoder encoder;
+    write_items(&encoder);
+    encoder.start_writing();
+    write_items(&encoder);
+
+    return encoder.release();
+}
+
+/// RLP-encoded item, all data points inside the buffer being decoded.
+struct EthereumRlpItem
+{
+    bool is_list;
+    // Data of the string, or encoded items of the list.
+    BinaryData payload;
+    // Whole item, including the header.
+    BinaryData encoded;
+};
+
+/** Reads RLP items one by one, without copying any data.
+ *
+ * Only canonical encoding is accepted, i.e. the one produced by
+ * EthereumRlpEncoder. Results point inside the data, hence those
+ * MUST NOT outlive it.
+ *
+ * @throw Exception with ERROR_INVALID_ARGUMENT on malformed data.
+ */
+class EthereumRlpReader
+{
+public:
+    explicit EthereumRlpReader(const BinaryData& data);
+
+    bool has_more() const;
+    // Offset of the next item from the beginning of the data.
+    size_t get_offset() const;
+
+    EthereumRlpItem read_item();
+    // Throws if next item is not a string.
+    BinaryData read_bytes();
+    // Reader of the items of the list, throws if next item is not a list.
+    EthereumRlpReader read_list();
+    // Integer as big-endian bytes, leading zeroes are not allowed.
+    BinaryData read_uint_bytes();
+    uint64_t read_uint64();
+    BigInt read_big_int();
+
+private:
+    size_t read_length(uint8_t length_size);
+
+private:
+    const BinaryData m_data;
+    size_t m_offset;
+};
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_ETHEREUM_RLP_H
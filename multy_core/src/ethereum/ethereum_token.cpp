@@ -6,13 +6,13 @@
 
 #include "multy_core/src/ethereum/ethereum_token.h"
 
+#include "multy_core/src/ethereum/ethereum_abi.h"
 #include "multy_core/src/ethereum/ethereum_extra_data.h"
+#include "multy_core/src/ethereum/ethereum_rlp.h"
 
 #include "multy_core/src/exception_stream.h"
 #include "multy_core/src/utility.h"
 
-#include <array>
-#include <regex>
 #include <unordered_map>
 #include <vector>
 
@@ -26,95 +26,41 @@ enum EthereumTokenStandard
     ETHEREUM_TOKEN_STANDARD_ERC20
 };
 
-const size_t ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT = 32;
-const size_t ETH_METHOD_HASH_SIZE = 4;
-typedef std::array<uint8_t, ETH_METHOD_HASH_SIZE> EthereumContractMethodHash;
+const char TOKEN_TRANSFER_SEPARATOR = ':';
 
-} // namespace
-
-
-namespace multy_core
-{
-namespace internal
-{
-EthereumSmartContractPayload::~EthereumSmartContractPayload()
-{
-}
-
-struct EthereumContractPayloadStream
+// Both transfer(address,uint256) and approve(address,uint256).
+class ERC20TokenCall : public EthereumSmartContractPayload
 {
 public:
-    EthereumContractPayloadStream()
-        : m_data()
+    ERC20TokenCall(const EthereumAbiFunction& method, BinaryDataPtr contract_address)
+        : m_method(method),
+          m_contract_address(std::move(contract_address))
     {
-        m_data.reserve(256);
     }
 
-    void write_data(const void* data, size_t size)
-    {
-        const uint8_t* d = reinterpret_cast<const uint8_t*>(data);
-        m_data.insert(m_data.end(), d, d + size);
-    }
-
-    BinaryDataPtr get_content()
-    {
-        return make_clone(as_binary_data(m_data));
-    }
-
-    ~EthereumContractPayloadStream()
-    {
-    }
-
-protected:
-    std::vector<std::uint8_t> m_data;
-};
-
-
-EthereumContractPayloadStream& operator<<(EthereumContractPayloadStream& stream, const BinaryData& data)
-{
-    INVARIANT(data.data != nullptr);
-    INVARIANT(data.len <= ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT);
-
-    static const std::array<uint8_t, ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT> ZEROES = {0};
-    stream.write_data(ZEROES.data(), ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT - data.len);
-    stream.write_data(data.data, data.len);
-    return stream;
-}
-
-EthereumContractPayloadStream& operator<<(EthereumContractPayloadStream& stream, const EthereumContractMethodHash& method_hash)
-{
-    stream.write_data(method_hash.data(), method_hash.size());
-    return stream;
-}
-
-EthereumContractPayloadStream& operator<<(EthereumContractPayloadStream& stream, const BigInt& value)
-{
-    const BinaryDataPtr data = value.export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN);
-    if (data->len > ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT)
+    void write_call(const BinaryData& receiver_address, const BigInt& amount,
+            EthereumRlpEncoder* encoder) const override
     {
-        THROW_EXCEPTION2(ERROR_TRANSACTION_SPECIFIC_ERROR_BASE,
-                "Invalid amount to transfer.")
-                << " Expected: less than " << ETHEREUM_SIZE_VARIABLE_FUNCTION_CONTRACT << " bytes, got: " << data->len;
-    }
-    stream << *data;
-    return stream;
-}
+        // Too big amount is a transaction error, other range checks
+        // are done by the encoder.
+        if (amount.get_exported_size_in_bytes() > ETHEREUM_ABI_WORD_SIZE)
+        {
+            THROW_EXCEPTION2(ERROR_TRANSACTION_SPECIFIC_ERROR_BASE,
+                    "Invalid amount to transfer.")
+                    << " Expected: less than " << ETHEREUM_ABI_WORD_SIZE
+                    << " bytes, got: " << amount.get_exported_size_in_bytes();
+        }
 
-class EthereumSmartContractPayloadBase: public EthereumSmartContractPayload
-{
-public:
-    EthereumSmartContractPayloadBase(
-            const EthereumTokenStandard standard,
-            const EthereumContractMethodHash method_hash,
-            BinaryDataPtr contract_address)
-        : m_standard(standard),
-        m_method_hash(method_hash),
-        m_contract_address(std::move(contract_address))
-    {
-    }
+        const std::vector<EthereumAbiValue> arguments = {
+            EthereumAbiValue::make_address(receiver_address),
+            EthereumAbiValue::make_int(amount)
+        };
 
-    virtual ~EthereumSmartContractPayloadBase()
-    {
+        encoder->write_bytes(m_method.get_call_size(arguments),
+                [this, &arguments](FixedSizeBinaryDataWriter* writer)
+                {
+                    m_method.write_call(arguments, writer);
+                });
     }
 
     EthereumTransactionDestinationPtr get_destination() override
@@ -126,60 +72,14 @@ public:
         return contract_destination;
     }
 
-protected:
-    EthereumTokenStandard m_standard;
-    EthereumContractMethodHash m_method_hash;
-    BinaryDataPtr m_contract_address;
-};
-
-class ERC20TransferToken : public EthereumSmartContractPayloadBase
-{
-public:
-    explicit ERC20TransferToken(BinaryDataPtr contract_address)
-        : EthereumSmartContractPayloadBase(ETHEREUM_TOKEN_STANDARD_ERC20,
-                {0xa9, 0x05, 0x9c, 0xbb},
-                std::move(contract_address))
-    {
-    }
-
-    BinaryDataPtr serialize(const EthereumTransactionDestination& receiver) const override
-    {
-        EthereumContractPayloadStream list;
-        list << m_method_hash;
-        list << *receiver.address;
-        list << *receiver.amount;
-
-        return list.get_content();
-    }
-
-    virtual ~ERC20TransferToken()
-    {
-    }
-};
-
-class ERC20ApproveToken : public EthereumSmartContractPayloadBase
-{
-public:
-    explicit ERC20ApproveToken(BinaryDataPtr contract_address)
-        : EthereumSmartContractPayloadBase(ETHEREUM_TOKEN_STANDARD_ERC20,
-                {0x09, 0x5e, 0xa7, 0xb3},
-                std::move(contract_address))
+    const BinaryData& get_contract_address() const override
     {
+        return *m_contract_address;
     }
 
-    BinaryDataPtr serialize(const EthereumTransactionDestination& receiver) const override
-    {
-        EthereumContractPayloadStream list;
-        list << m_method_hash;
-        list << *receiver.address;
-        list << *receiver.amount;
-
-        return list.get_content();
-    }
-
-    virtual ~ERC20ApproveToken()
-    {
-    }
+private:
+    const EthereumAbiFunction& m_method;
+    BinaryDataPtr m_contract_address;
 };
 
 EthereumTokenStandard get_token_standard_by_name(const std::string& name)
@@ -202,58 +102,83 @@ EthereumTokenStandard get_token_standard_by_name(const std::string& name)
     return s->second;
 }
 
-EthereumSmartContractPayloadPtr parse_token_transfer_data(const std::string& value)
+const EthereumAbiFunction& get_erc20_method(const std::string& name)
 {
-    static const std::regex SPLIT_TOKEN_RE(":");
+    // Signatures are parsed and selectors are computed only once.
+    static const EthereumAbiFunction TRANSFER("transfer(address,uint256)");
+    static const EthereumAbiFunction APPROVE("approve(address,uint256)");
 
-    std::sregex_token_iterator iterator(value.begin(), value.end(), SPLIT_TOKEN_RE, -1);
+    if (name == "transfer")
+    {
+        return TRANSFER;
+    }
+    else if (name == "approve")
+    {
+        return APPROVE;
+    }
+
+    THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_INVALID_METHOD,
+            "Unsupported Ethereum token transfer method.")
+            << " Got: \"" << name << "\".";
+}
 
-    if (iterator == std::sregex_token_iterator())
+} // namespace
+
+
+namespace multy_core
+{
+namespace internal
+{
+EthereumSmartContractPayload::~EthereumSmartContractPayload()
+{
+}
+
+EthereumSmartContractPayloadPtr parse_token_transfer_data(const std::string& value)
+{
+    // "<standard>:<contract address>:<method>"
+    const size_t address_begin = value.find(TOKEN_TRANSFER_SEPARATOR) + 1;
+    const size_t method_begin = address_begin == 0
+            ? std::string::npos
+            : value.find(TOKEN_TRANSFER_SEPARATOR, address_begin);
+
+    const std::string standard = value.substr(0, address_begin - 1);
+    if (standard.empty())
     {
         THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_MISSING_STANDARD,
                 "Missing Token Smart Contract standard.");
     }
-    const EthereumTokenStandard token_standard = get_token_standard_by_name(*iterator);
-    ++iterator;
+    const EthereumTokenStandard token_standard = get_token_standard_by_name(standard);
 
-    if (iterator == std::sregex_token_iterator())
+    const std::string address = address_begin == 0
+            ? std::string()
+            : value.substr(address_begin, method_begin - address_begin);
+    if (address.empty())
     {
         THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_MISSING_ADDRESS,
                 "Missing Token Smart Contract address.");
     }
-    BinaryDataPtr contract_address = ethereum_parse_address(iterator->str().c_str());
-    ++iterator;
+    BinaryDataPtr contract_address = ethereum_parse_address(address.c_str());
 
-    if (iterator == std::sregex_token_iterator())
+    const std::string method = method_begin == std::string::npos
+            ? std::string()
+            : value.substr(method_begin + 1);
+    if (method.empty())
     {
         THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_MISSING_METHOD,
                 "Missing Token Smart Contract method.");
     }
 
     EthereumSmartContractPayloadPtr result;
-
     switch (token_standard)
     {
         case ETHEREUM_TOKEN_STANDARD_ERC20:
-            if (iterator->str() == "transfer")
-            {
-                result.reset(new ERC20TransferToken(std::move(contract_address)));
-            }
-            else if (iterator->str() == "approve")
-            {
-                result.reset(new ERC20ApproveToken(std::move(contract_address)));
-            }
-            else
-            {
-               THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_INVALID_METHOD,
-                     "Unsupported Ethereum token transfer method.")
-                     << " Got: \" " << token_standard << "\".";
-            }
+            result.reset(new ERC20TokenCall(get_erc20_method(method),
+                    std::move(contract_address)));
             break;
         default:
             THROW_EXCEPTION2(ERROR_TRANSACTION_TOKEN_TRANSFER_INVALID_STANDARD,
                     "Invalid Ethereum token standard.")
-                    << " Got: \" " << token_standard << "\".";;
+                    << " Got: \" " << token_standard << "\".";
             break;
     }
 
@@ -9,6 +9,8 @@
 
 #include "multy_core/src/u_ptr.h"
 
+#include "multy_core/binary_data.h"
+
 #include <memory>
 #include <string>
 
@@ -16,6 +18,7 @@ namespace multy_core
 {
 namespace internal
 {
+class EthereumRlpEncoder;
 struct EthereumTransactionDestination;
 typedef std::unique_ptr<EthereumTransactionDestination> EthereumTransactionDestinationPtr;
 
@@ -25,15 +28,21 @@ public:
     virtual ~EthereumSmartContractPayload();
 
     /**
-     * Serializes smart contract call as transaction payload.
-     * Uses receiver destination for getting address and token amount to transfer.
+     * Writes smart contract call as the data field of the transaction,
+     * straight into the RLP-encoded transaction fields.
+     * Receiver address and amount are arguments of the call.
      */
-    virtual BinaryDataPtr serialize(const EthereumTransactionDestination& receiver) const = 0;
+    virtual void write_call(const BinaryData& receiver_address,
+            const BigInt& amount, EthereumRlpEncoder* encoder) const = 0;
     virtual EthereumTransactionDestinationPtr get_destination() = 0;
+    virtual const BinaryData& get_contract_address() const = 0;
 };
 
 typedef std::unique_ptr<EthereumSmartContractPayload> EthereumSmartContractPayloadPtr;
 
+/** Parses "token_transfer" property value, like "ERC20:<contract address>:transfer".
+ * @throw Exception if standard, address or method is missing or not supported.
+ */
 EthereumSmartContractPayloadPtr parse_token_transfer_data(const std::string& value);
 
 } // namespace internal
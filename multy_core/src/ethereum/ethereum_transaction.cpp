@@ -8,53 +8,14 @@
 
 #include "multy_core/src/ethereum/ethereum_token.h"
 #include "multy_core/src/ethereum/ethereum_extra_data.h"
+#include "multy_core/src/ethereum/ethereum_rlp.h"
 #include "multy_core/src/exception_stream.h"
 #include "multy_core/src/api/key_impl.h"
 #include "multy_core/src/utility.h"
 
-
 namespace
 {
-using namespace multy_core::internal;
-
-// based on cpp-ethereum/libdevcore/RLP.h
-const uint8_t RLP_MAX_LENGTH_BYTES = 8;
-const uint8_t RLP_DATA_IMM_LEN_START = 0x80;
-const uint8_t RLP_LIST_START = 0xc0;
-const uint8_t RLP_DATA_IMM_LEN_COUNT = RLP_LIST_START - RLP_DATA_IMM_LEN_START - RLP_MAX_LENGTH_BYTES;
-const uint8_t RLP_DATA_IND_LEN_ZERO = RLP_DATA_IMM_LEN_START + RLP_DATA_IMM_LEN_COUNT - 1;
-const uint8_t RLP_LIST_IMM_LEN_COUNT = 256 - RLP_LIST_START - RLP_MAX_LENGTH_BYTES;
-const uint8_t RLP_LIST_IND_LEN_ZERO = RLP_LIST_START + RLP_LIST_IMM_LEN_COUNT - 1;
-
-template <typename T>
-struct IntWrapper
-{
-    const T value;
-    const size_t size;
-
-    IntWrapper(const T& value, const size_t size)
-        : value(value),
-          size(size)
-    {}
-};
-
-template <typename T>
-IntWrapper<uint8_t> as_uint8(const T& value)
-{
-    return IntWrapper<uint8_t>(value, 1);
-}
-
-IntWrapper<uint8_t> as_uint8(const BigInt& value)
-{
-    return IntWrapper<uint8_t>(value.get_value_as_uint64(), 1);
-}
-
-template <typename T>
-IntWrapper<T> as_int(const T& value, size_t size)
-{
-    return IntWrapper<T>(value, size);
-}
-
+const size_t ETHEREUM_SIGNATURE_SIZE = 65;
 } // namespace
 
 namespace multy_core
@@ -62,260 +23,76 @@ namespace multy_core
 namespace internal
 {
 
-size_t get_bytes_len(const BigInt& value)
-{
-    return value.get_exported_size_in_bytes();
-}
-
-struct EthereumDataStream
-{
-    EthereumDataStream()
-        : m_data()
-    {
-        m_data.reserve(256);
-    }
-
-    void write_data(const void* data, size_t size)
+void ethereum_write_transaction_fields(const BigInt& nonce,
+        const BigInt& gas_price, const BigInt& gas_limit,
+        const BinaryData& destination, const BigInt& value,
+        const EthereumSmartContractPayload* token_transfer,
+        const BinaryData* token_recipient, const BigInt* token_amount,
+        const BinaryData* payload,
+        EthereumRlpEncoder* encoder)
+{
+    encoder->write_big_int(nonce);
+    encoder->write_big_int(gas_price);
+    encoder->write_big_int(gas_limit);
+    encoder->write_bytes(destination);
+    encoder->write_big_int(value);
+    if (token_transfer)
     {
-        const uint8_t* d = reinterpret_cast<const uint8_t*>(data);
-        m_data.insert(m_data.end(), d, d + size);
+        INVARIANT(token_recipient != nullptr);
+        INVARIANT(token_amount != nullptr);
+        token_transfer->write_call(*token_recipient, *token_amount, encoder);
     }
-
-    BinaryData get_content()
+    else if (payload && payload->data != nullptr)
     {
-        return BinaryData{m_data.data(), m_data.size()};
-    }
-
-protected:
-    std::vector<std::uint8_t> m_data;
-};
-
-struct EthereumDataStreamList : public EthereumDataStream
-{
-    size_t length() const
-    {
-        return m_data.size();
-    }
-    const std::uint8_t* data() const
-    {
-        return m_data.data();
-    }
-};
-
-template <typename T>
-void write_int(const T& value, EthereumDataStream* stream);
-EthereumDataStream& operator<<(EthereumDataStream& stream, const BinaryData& data);
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const uint8_t& data)
-{
-    write_int(data, &stream);
-    return stream;
-}
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const uint16_t& data)
-{
-    write_int(data, &stream);
-    return stream;
-}
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const uint32_t& data)
-{
-    write_int(data, &stream);
-    return stream;
-}
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const IntWrapper<uint8_t>& wrapper)
-{
-    stream.write_data(&wrapper.value, sizeof(wrapper.value));
-    return stream;
-}
-
-template <typename T>
-EthereumDataStream& operator<<(EthereumDataStream& stream, const IntWrapper<T>& wrapper)
-{
-    assert(wrapper.size <= sizeof(wrapper.value));
-    T value = wrapper.value;
-    for (size_t i = 0; i < wrapper.size; ++i)
-    {
-        value >>= 8;
-        stream << as_uint8(value);
-    }
-    return stream;
-}
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const IntWrapper<BigInt>& wrapper)
-{
-    const BinaryDataPtr data = wrapper.value.export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN);
-    if (wrapper.size > data->len)
-    {
-        THROW_EXCEPTION("Can't serialize BigInt as fixed-size blob.")
-                << " Required size: " << wrapper.size
-                << " available size: " << data->len;
-    }
-
-    const size_t offset = data->len - wrapper.size;
-    const size_t size = data->len - offset;
-    const BinaryData to_write = slice(*data, offset, size);
-
-    stream.write_data(to_write.data, to_write.len);
-    return stream;
-}
-
-template <typename T>
-std::string to_string(const T& t)
-{
-    std::stringstream sstr;
-    sstr << t;
-    return sstr.str();
-}
-
-std::string to_string(const BigInt& amount)
-{
-    return amount.get_value();
-}
-
-template <typename T>
-void write_int(const T& value, EthereumDataStream* stream)
-{
-    if (value == 0)
-    {
-        *stream << as_uint8(RLP_DATA_IMM_LEN_START);
-    }
-    else if (value < RLP_DATA_IMM_LEN_START)
-    {
-        *stream << as_uint8(value);
+        encoder->write_bytes(*payload);
     }
     else
     {
-        const size_t len = get_bytes_len(value);
-        if (len < RLP_DATA_IMM_LEN_START)
-        {
-            *stream << as_uint8(len + RLP_DATA_IMM_LEN_START);
-        }
-        else
-        {
-            const size_t len_of_len = get_bytes_len(len);
-            if (RLP_DATA_IND_LEN_ZERO + len_of_len > 0xff)
-            {
-                THROW_EXCEPTION("Number is too big for RLP") << to_string(value);
-            }
-            *stream << as_uint8(RLP_DATA_IND_LEN_ZERO + len_of_len);
-            *stream << as_int(len, len_of_len);
-        }
-        *stream << as_int(value, len);
+        encoder->write_bytes(BinaryData{nullptr, 0});
     }
 }
 
-EthereumDataStream& operator<<(EthereumDataStream& stream, const BigInt& data)
+BinaryDataPtr ethereum_encode_unsigned_transaction(
+        const BinaryData& encoded_fields, EthereumChainId chain_id)
 {
-    write_int(data, &stream);
-    return stream;
-}
-
-template <typename T, typename D>
-EthereumDataStream& operator<<(EthereumDataStream& stream, const std::unique_ptr<T, D>& ptr)
-{
-    INVARIANT(ptr != nullptr);
-
-    return stream << *ptr;
-}
-
-template <typename T>
-EthereumDataStream& operator<<(EthereumDataStream& stream, const PropertyT<T>& property)
-{
-    return stream << *property;
-}
-
-EthereumDataStream& operator<<(EthereumDataStream& stream, const BinaryData& binary_data)
-{
-    const size_t len = binary_data.len;
-    const unsigned char* data = binary_data.data;
-    if (len == 1 && data[0] < RLP_DATA_IMM_LEN_START)
-    {
-        stream << as_uint8(data[0]);
-    }
-    else
+    return encode_rlp([&encoded_fields, chain_id](EthereumRlpEncoder* encoder)
     {
-        if (len < RLP_DATA_IMM_LEN_COUNT)
-        {
-            stream << as_uint8(len + RLP_DATA_IMM_LEN_START);
-        }
-        else
+        encoder->begin_list();
+        encoder->write_encoded(encoded_fields);
+        if (chain_id > 0)
         {
-            size_t length_size = get_bytes_len(len);
-            if (RLP_DATA_IND_LEN_ZERO + length_size > 0xFF)
-            {
-                THROW_EXCEPTION("BinaryData is too big for RLP")
-                        << " length : " << to_string(len);
-            }
-
-            stream << as_uint8(RLP_DATA_IND_LEN_ZERO + length_size);
-            size_t writen_len =len ;
-            for (; writen_len != 0; writen_len >>= 8)
-            {
-                stream << as_uint8(writen_len);
-            }
+            // EIP-155: chain id, r = 0, s = 0.
+            encoder->write_uint(chain_id);
+            encoder->write_uint(0);
+            encoder->write_uint(0);
         }
-        stream.write_data(data, len);
-    }
-    return stream;
+        encoder->end_list();
+    });
 }
 
-EthereumDataStream& operator<<(EthereumDataStream& stream, const EthereumDataStreamList& list)
+BinaryDataPtr ethereum_encode_signed_transaction(const BinaryData& encoded_fields,
+        EthereumChainId chain_id, const BinaryData& signature)
 {
-    const size_t length_size = get_bytes_len(list.length());
-    if (list.length() < RLP_LIST_IMM_LEN_COUNT)
-    {
-        stream << as_uint8(RLP_LIST_START + list.length());
-    }
-    else if (RLP_LIST_IND_LEN_ZERO + length_size < 0xFF)
-    {
-        stream << as_uint8(RLP_LIST_IND_LEN_ZERO + length_size);
-        for (size_t list_size = list.length(); list_size != 0; list_size >>= 8)
-        {
-            stream << as_uint8(list_size);
-        }
-    }
-    else
+    if (signature.len != ETHEREUM_SIGNATURE_SIZE)
     {
-        THROW_EXCEPTION("List is too big for RLP. ")
-                << " Length: " << list.length();
+        THROW_EXCEPTION2(ERROR_TRANSACTION_INVALID_SIGNATURE,
+                "Invalid signature size.")
+                << " Expected: " << ETHEREUM_SIGNATURE_SIZE
+                << " bytes, got: " << signature.len;
     }
 
-    stream.write_data(list.data(), list.length());
-    return stream;
-}
-
-struct EthereumTransactionSignature
-{
-    EthereumTransactionSignature()
-        : recovery_id(0),
-          m_signature_data()
-    {}
-
-    void set_signature(BinaryDataPtr signature_data)
+    const uint32_t v = chain_id * 2 + 35 + signature.data[64];
+    return encode_rlp([&encoded_fields, &signature, v](EthereumRlpEncoder* encoder)
     {
-        if (signature_data->len != 65)
-        {
-            THROW_EXCEPTION2(ERROR_TRANSACTION_INVALID_SIGNATURE,
-                    "Invalid signature size.")
-                    << " Expected: 65 bytes, got: " << signature_data->len;
-        }
-        m_signature_data.swap(signature_data);
-        recovery_id = m_signature_data->data[64];
-    }
-    void write_to_stream(size_t offset, EthereumDataStream* stream) const
-    {
-        //(m_signature->v + offset) << (u256)m_vrs->r << (u256)m_vrs->s;
-        *stream << uint32_t(offset + recovery_id)
-                << slice(*m_signature_data, 0, 32)
-                << slice(*m_signature_data, 0 + 32, 32);
-    }
-
-private:
-    uint8_t recovery_id;
-    BinaryDataPtr m_signature_data;
-};
+        encoder->begin_list();
+        encoder->write_encoded(encoded_fields);
+        // v, r, s; r and s are integers, hence leading zeroes are stripped.
+        encoder->write_uint(v);
+        encoder->write_big_endian_uint(slice(signature, 0, 32));
+        encoder->write_big_endian_uint(slice(signature, 32, 32));
+        encoder->end_list();
+    });
+}
 
 EthereumTransaction::EthereumTransaction(const Account& account)
     : TransactionBase(account.get_blockchain_type()),
@@ -342,7 +119,8 @@ EthereumTransaction::EthereumTransaction(const Account& account)
       m_source(),
       m_destination(),
       m_internal_destination(),
-      m_signature()
+      m_signature(),
+      m_encoded_fields()
 {
 }
 
@@ -355,46 +133,23 @@ BinaryDataPtr EthereumTransaction::serialize()
     update();
     sign();
 
-    EthereumDataStream data_stream;
-    serialize_to_stream(data_stream, SERIALIZE_WITH_SIGNATURE);
+    INVARIANT(m_encoded_fields != nullptr);
+    INVARIANT(m_signature != nullptr);
 
-    return make_clone(data_stream.get_content());
+    return ethereum_encode_signed_transaction(*m_encoded_fields, m_chain_id,
+            *m_signature);
 }
 
-void EthereumTransaction::serialize_to_stream(EthereumDataStream& stream, SerializationMode mode) const
+void EthereumTransaction::write_fields(EthereumRlpEncoder* encoder) const
 {
-    EthereumDataStreamList list;
-    list << m_nonce;
-    list << m_fee->gas_price;
-    list << m_fee->gas_limit;
-    list << m_internal_destination->address;
-    list << m_internal_destination->amount;
-    if (m_token_transfer_data)
-    {
-        const BinaryDataPtr call_method = m_token_transfer_data->serialize(*m_destination);
-        list <<  *call_method;
-    }
-    else if(m_payload && (m_payload->data != nullptr))
-    {
-        list << m_payload;
-    }
-    else
-    {
-        list << BinaryData{nullptr, 0};
-    }
-
-    if (mode == SERIALIZE_WITH_SIGNATURE)
-    {
-        INVARIANT(m_signature != nullptr);
-
-        const uint32_t offset = m_chain_id*2 + 35;
-        m_signature->write_to_stream(offset, &list);
-    }
-    else if (mode == SERIALIZE_WITH_CHAIN_ID)
-    {
-        list << static_cast<uint32_t>(m_chain_id) << 0u << 0u;
-    }
-    stream << list;
+    ethereum_write_transaction_fields(*m_nonce,
+            *m_fee->gas_price, *m_fee->gas_limit,
+            *m_internal_destination->address, *m_internal_destination->amount,
+            m_token_transfer_data.get(),
+            m_token_transfer_data ? m_destination->address.get() : nullptr,
+            m_token_transfer_data ? &*m_destination->amount : nullptr,
+            m_payload.get(),
+            encoder);
 }
 
 void EthereumTransaction::on_token_transfer_set(const std::string& value)
@@ -467,13 +222,15 @@ void EthereumTransaction::update()
 
 void EthereumTransaction::sign()
 {
-    EthereumDataStream data_stream;
-    serialize_to_stream(data_stream,
-            m_chain_id > 0 ? SERIALIZE_WITH_CHAIN_ID : SERIALIZE);
+    // Fields are encoded only once, and reused by serialize().
+    m_encoded_fields = encode_rlp([this](EthereumRlpEncoder* encoder)
+    {
+        write_fields(encoder);
+    });
 
-    m_signature.reset(new EthereumTransactionSignature);
-    m_signature->set_signature(m_account.get_private_key()->sign(
-            data_stream.get_content()));
+    const BinaryDataPtr unsigned_transaction = ethereum_encode_unsigned_transaction(
+            *m_encoded_fields, m_chain_id);
+    m_signature = m_account.get_private_key()->sign(*unsigned_transaction);
 }
 
 BigInt EthereumTransaction::estimate_total_fee(size_t, size_t) const
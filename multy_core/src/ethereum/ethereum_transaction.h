@@ -17,8 +17,7 @@ namespace multy_core
 {
 namespace internal
 {
-struct EthereumTransactionSignature;
-struct EthereumDataStream;
+class EthereumRlpEncoder;
 struct EthereumTransactionFee;
 struct EthereumTransactionSource;
 struct EthereumTransactionDestination;
@@ -28,7 +27,6 @@ typedef std::unique_ptr<EthereumSmartContractPayload> EthereumSmartContractPaylo
 typedef std::unique_ptr<EthereumTransactionFee> EthereumTransactionFeePtr;
 typedef std::unique_ptr<EthereumTransactionSource> EthereumTransactionSourcePtr;
 typedef std::unique_ptr<EthereumTransactionDestination> EthereumTransactionDestinationPtr;
-typedef std::unique_ptr<EthereumTransactionSignature> EthereumTransactionSignaturePtr;
 
 class EthereumTransaction : public TransactionBase
 {
@@ -51,13 +49,8 @@ public:
     void set_message(const BinaryData& value) override;
 
 private:
-    enum SerializationMode
-    {
-        SERIALIZE,
-        SERIALIZE_WITH_SIGNATURE,
-        SERIALIZE_WITH_CHAIN_ID,
-    };
-    void serialize_to_stream(EthereumDataStream& stream, SerializationMode mode) const;
+    // Writes fields common for signed and unsigned transaction.
+    void write_fields(EthereumRlpEncoder* encoder) const;
     void on_token_transfer_set(const std::string& value);
 
 private:
@@ -76,10 +69,41 @@ private:
     // from token transfer info or just a receiver info (in case of plain Ether transfer).
     EthereumTransactionDestinationPtr m_internal_destination;
     EthereumSmartContractPayloadPtr m_token_transfer_data;
-    EthereumTransactionSignaturePtr m_signature;
+    // 65 bytes: r, s and recovery id, set by sign().
+    BinaryDataPtr m_signature;
     BinaryDataPtr m_payload;
+    // RLP-encoded fields (see write_fields()), set by sign().
+    BinaryDataPtr m_encoded_fields;
 };
 
+/** Writes fields common for signed and unsigned transaction:
+ * nonce, gas price, gas limit, destination, value and data.
+ *
+ * @param token_transfer - if not null, data is a call to transfer token_amount
+ *      of tokens to token_recipient, and payload is ignored.
+ * @param payload - data of the transaction, may be null.
+ */
+void ethereum_write_transaction_fields(const BigInt& nonce,
+        const BigInt& gas_price, const BigInt& gas_limit,
+        const BinaryData& destination, const BigInt& value,
+        const EthereumSmartContractPayload* token_transfer,
+        const BinaryData* token_recipient, const BigInt* token_amount,
+        const BinaryData* payload,
+        EthereumRlpEncoder* encoder);
+
+/** RLP-encoded data to be signed for a transaction with given fields.
+ *
+ * @param encoded_fields - RLP-encoded nonce, gas price, gas limit,
+ *      destination, value and data.
+ * @param chain_id - EIP-155 replay protection is used if chain_id is positive.
+ */
+BinaryDataPtr ethereum_encode_unsigned_transaction(
+        const BinaryData& encoded_fields, EthereumChainId chain_id);
+
+/// Signed transaction, signature is 65 bytes: r, s and recovery id.
+BinaryDataPtr ethereum_encode_signed_transaction(const BinaryData& encoded_fields,
+        EthereumChainId chain_id, const BinaryData& signature);
+
 } // namespace internal
 } // namespace multy_core
 
@@ -0,0 +1,260 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_transaction_view.h"
+
+#include "multy_core/error.h"
+
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/ethereum/ethereum_rlp.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/utility.h"
+
+#include <array>
+#include <string.h>
+
+namespace
+{
+using namespace multy_core::internal;
+
+const size_t ETHEREUM_BINARY_ADDRESS_SIZE = 20;
+const size_t ETHEREUM_SIGNATURE_VALUE_SIZE = 32;
+
+// Half of the secp256k1 curve order, big-endian.
+const unsigned char SECP256K1_HALF_ORDER[ETHEREUM_SIGNATURE_VALUE_SIZE] = {
+    0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x5d, 0x57, 0x6e, 0x73, 0x57, 0xa4, 0x50, 0x1d,
+    0xdf, 0xe9, 0x2f, 0x46, 0x68, 0x1b, 0x20, 0xa0
+};
+
+// Pre-EIP-155 v is 27 + recovery id.
+const uint64_t ETHEREUM_PRE_EIP155_V_OFFSET = 27;
+// EIP-155 v is chain_id * 2 + 35 + recovery id.
+const uint64_t ETHEREUM_EIP155_V_OFFSET = 35;
+
+BigInt to_big_int(const BinaryData& value)
+{
+    BigInt result;
+    result.import_from_binary_data(value, BigInt::EXPORT_BIG_ENDIAN);
+    return result;
+}
+
+BinaryData read_signature_value(EthereumRlpReader* reader, const char* name)
+{
+    const BinaryData result = reader->read_uint_bytes();
+    if (result.len == 0 || result.len > ETHEREUM_SIGNATURE_VALUE_SIZE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid signature value size in serialized transaction.")
+                << " Value: " << name << ", size: " << result.len;
+    }
+    return result;
+}
+
+// EIP-2: since Homestead, s must be in the lower half of the curve order,
+// otherwise there would be two valid signatures (and hashes) of the same
+// transaction.
+bool is_low_s(const BinaryData& s)
+{
+    std::array<unsigned char, ETHEREUM_SIGNATURE_VALUE_SIZE> value;
+    value.fill(0);
+    memcpy(value.data() + value.size() - s.len, s.data, s.len);
+    return memcmp(value.data(), SECP256K1_HALF_ORDER, value.size()) <= 0;
+}
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+EthereumTransactionView::EthereumTransactionView(
+        const BinaryData& serialized_transaction)
+    : m_data(serialized_transaction),
+      m_encoded_fields{nullptr, 0},
+      m_nonce{nullptr, 0},
+      m_gas_price{nullptr, 0},
+      m_gas_limit{nullptr, 0},
+      m_destination{nullptr, 0},
+      m_value{nullptr, 0},
+      m_payload{nullptr, 0},
+      m_v(0),
+      m_r{nullptr, 0},
+      m_s{nullptr, 0}
+{
+    INVARIANT(serialized_transaction.data != nullptr);
+
+    EthereumRlpReader reader(m_data);
+    const EthereumRlpItem transaction = reader.read_item();
+    if (!transaction.is_list)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Serialized transaction is not an RLP list.");
+    }
+    if (reader.has_more())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Unexpected data after the end of serialized transaction.");
+    }
+
+    EthereumRlpReader fields(transaction.payload);
+    m_nonce = fields.read_uint_bytes();
+    m_gas_price = fields.read_uint_bytes();
+    m_gas_limit = fields.read_uint_bytes();
+    m_destination = fields.read_bytes();
+    m_value = fields.read_uint_bytes();
+    m_payload = fields.read_bytes();
+    m_encoded_fields = BinaryData{transaction.payload.data, fields.get_offset()};
+
+    m_v = fields.read_uint64();
+    m_r = read_signature_value(&fields, "r");
+    m_s = read_signature_value(&fields, "s");
+    if (!is_low_s(m_s))
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Signature s value is not in the lower half of the curve order (EIP-2).");
+    }
+
+    if (fields.has_more())
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Too many fields in serialized transaction.");
+    }
+
+    if (m_destination.len != 0 && m_destination.len != ETHEREUM_BINARY_ADDRESS_SIZE)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid destination address size in serialized transaction.")
+                << " Size: " << m_destination.len;
+    }
+
+    if (m_v != ETHEREUM_PRE_EIP155_V_OFFSET
+            && m_v != ETHEREUM_PRE_EIP155_V_OFFSET + 1
+            && m_v < ETHEREUM_EIP155_V_OFFSET)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid signature v value in serialized transaction.")
+                << " v: " << m_v;
+    }
+
+    // EIP-155 v with chain id 0 would be taken for a pre-EIP-155 transaction.
+    if (m_v >= ETHEREUM_EIP155_V_OFFSET && m_v < ETHEREUM_EIP155_V_OFFSET + 2)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Invalid chain id 0 in signature v value of serialized transaction.")
+                << " v: " << m_v;
+    }
+}
+
+BigInt EthereumTransactionView::get_nonce() const
+{
+    return to_big_int(m_nonce);
+}
+
+BigInt EthereumTransactionView::get_gas_price() const
+{
+    return to_big_int(m_gas_price);
+}
+
+BigInt EthereumTransactionView::get_gas_limit() const
+{
+    return to_big_int(m_gas_limit);
+}
+
+BinaryData EthereumTransactionView::get_destination() const
+{
+    return m_destination;
+}
+
+BigInt EthereumTransactionView::get_value() const
+{
+    return to_big_int(m_value);
+}
+
+BinaryData EthereumTransactionView::get_data() const
+{
+    return m_payload;
+}
+
+uint64_t EthereumTransactionView::get_v() const
+{
+    return m_v;
+}
+
+BinaryData EthereumTransactionView::get_r() const
+{
+    return m_r;
+}
+
+BinaryData EthereumTransactionView::get_s() const
+{
+    return m_s;
+}
+
+uint64_t EthereumTransactionView::get_chain_id() const
+{
+    if (m_v < ETHEREUM_EIP155_V_OFFSET)
+    {
+        return 0;
+    }
+    return (m_v - ETHEREUM_EIP155_V_OFFSET) / 2;
+}
+
+int EthereumTransactionView::get_recovery_id() const
+{
+    if (m_v < ETHEREUM_EIP155_V_OFFSET)
+    {
+        return static_cast<int>(m_v - ETHEREUM_PRE_EIP155_V_OFFSET);
+    }
+    return static_cast<int>((m_v - ETHEREUM_EIP155_V_OFFSET) % 2);
+}
+
+hash<256> EthereumTransactionView::get_hash() const
+{
+    return do_hash<KECCAK, 256>(m_data);
+}
+
+hash<256> EthereumTransactionView::get_signing_hash() const
+{
+    const uint64_t chain_id = get_chain_id();
+    const BinaryDataPtr unsigned_transaction = encode_rlp(
+            [this, chain_id](EthereumRlpEncoder* encoder)
+            {
+                encoder->begin_list();
+                encoder->write_encoded(m_encoded_fields);
+                if (chain_id > 0)
+                {
+                    encoder->write_uint(chain_id);
+                    encoder->write_uint(0);
+                    encoder->write_uint(0);
+                }
+                encoder->end_list();
+            });
+
+    return do_hash<KECCAK, 256>(*unsigned_transaction);
+}
+
+BinaryDataPtr EthereumTransactionView::recover_sender_address() const
+{
+    // r and s are stored without leading zeroes, but recovery requires
+    // both to be exactly 32 bytes long.
+    std::array<unsigned char, ETHEREUM_SIGNATURE_VALUE_SIZE * 2> signature;
+    signature.fill(0);
+    memcpy(signature.data() + ETHEREUM_SIGNATURE_VALUE_SIZE - m_r.len,
+            m_r.data, m_r.len);
+    memcpy(signature.data() + signature.size() - m_s.len,
+            m_s.data, m_s.len);
+
+    const hash<256> signing_hash = get_signing_hash();
+    return ethereum_recover_address(as_binary_data(signing_hash),
+            as_binary_data(signature), get_recovery_id());
+}
+
+} // namespace internal
+} // namespace multy_core
@@ -0,0 +1,83 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_ETHEREUM_TRANSACTION_VIEW_H
+#define MULTY_CORE_SRC_ETHEREUM_TRANSACTION_VIEW_H
+
+#include "multy_core/binary_data.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/hash.h"
+#include "multy_core/src/u_ptr.h"
+
+#include <cstdint>
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Read-only view of the serialized signed Ethereum transaction.
+ *
+ * Parses RLP-encoded transaction once, on construction. All BinaryData values
+ * point into the original buffer, nothing is copied, hence view MUST NOT
+ * outlive the buffer. Integer values are converted to BigInt only on request.
+ *
+ * Both pre-EIP-155 (v is 27 or 28) and EIP-155 signatures are supported.
+ * Signatures with high s value are rejected, as required by EIP-2.
+ *
+ * @throw Exception with ERROR_INVALID_ARGUMENT if data is not a valid
+ * serialized signed transaction.
+ */
+class EthereumTransactionView
+{
+public:
+    explicit EthereumTransactionView(const BinaryData& serialized_transaction);
+
+    BigInt get_nonce() const;
+    BigInt get_gas_price() const;
+    BigInt get_gas_limit() const;
+    // 20-byte address, empty for contract creation transaction.
+    BinaryData get_destination() const;
+    BigInt get_value() const;
+    BinaryData get_data() const;
+
+    uint64_t get_v() const;
+    // Big-endian, without leading zero bytes.
+    BinaryData get_r() const;
+    BinaryData get_s() const;
+
+    // 0 for pre-EIP-155 signature.
+    uint64_t get_chain_id() const;
+    int get_recovery_id() const;
+
+    // Transaction hash, as used by the block explorers.
+    hash<256> get_hash() const;
+    // Hash that was signed by the sender.
+    hash<256> get_signing_hash() const;
+    // 20-byte binary address of the sender.
+    BinaryDataPtr recover_sender_address() const;
+
+private:
+    BinaryData m_data;
+    // Encoded nonce, gas price, gas limit, destination, value and data,
+    // as those are included into the signed data.
+    BinaryData m_encoded_fields;
+    BinaryData m_nonce;
+    BinaryData m_gas_price;
+    BinaryData m_gas_limit;
+    BinaryData m_destination;
+    BinaryData m_value;
+    BinaryData m_payload;
+    uint64_t m_v;
+    BinaryData m_r;
+    BinaryData m_s;
+};
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_SRC_ETHEREUM_TRANSACTION_VIEW_H
@@ -10,6 +10,7 @@
 
 #include "multy_core/common.h"
 #include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/cached_value.h"
 #include "multy_core/src/hash.h"
 #include "multy_core/src/utility.h"
 #include "multy_core/src/exception.h"
@@ -127,24 +128,31 @@ class GolosPrivateKey : public PrivateKey
 public:
     typedef std::vector<uint8_t> KeyData;
     explicit GolosPrivateKey(const KeyData& data)
-        : m_data(data)
+        : m_data(data),
+          m_public_key_data()
     {}
 
     explicit GolosPrivateKey(const BinaryData& data)
-        : m_data(data.data, data.data + data.len)
+        : m_data(data.data, data.data + data.len),
+          m_public_key_data()
     {}
 
     PublicKeyPtr make_public_key() const override
     {
-        const size_t public_key_size = EC_PUBLIC_KEY_LEN;
-        GolosPublicKey::KeyData key_data(public_key_size, 0);
-        BinaryData public_key_data = as_binary_data(key_data);
+        // Public key is computed on first use and then cached.
+        const GolosPublicKey::KeyData& key_data = m_public_key_data.get([this]()
+        {
+            GolosPublicKey::KeyData key_data(EC_PUBLIC_KEY_LEN, 0);
+            BinaryData public_key_data = as_binary_data(key_data);
+
+            ec_private_to_public_key(as_binary_data(m_data),
+                    EC_PUBLIC_KEY_COMPRESSED,
+                    &public_key_data);
 
-        ec_private_to_public_key(as_binary_data(m_data),
-                EC_PUBLIC_KEY_COMPRESSED,
-                &public_key_data);
+            return key_data;
+        });
 
-        return PublicKeyPtr(new GolosPublicKey(std::move(key_data)));
+        return PublicKeyPtr(new GolosPublicKey(key_data));
     }
 
     PrivateKeyPtr clone() const override
@@ -200,6 +208,7 @@ public:
 
 private:
     KeyData m_data;
+    CachedValue<GolosPublicKey::KeyData> m_public_key_data;
 };
 
 GolosHDAccount::GolosHDAccount(
@@ -229,8 +238,7 @@ AccountPtr GolosHDAccount::make_account(
             new GolosAccount(
                     get_blockchain_type(),
                     std::move(private_key),
-                    make_child_path(get_path(),
-                            {type, index})));
+                    make_leaf_path(type, index)));
 }
 
 AccountPtr make_golos_account(BlockchainType blockchain_type,
@@ -12,48 +12,50 @@
 #include "multy_core/binary_data.h"
 #include "multy_core/blockchain.h"
 
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/key_impl.h"
 #include "multy_core/src/api/properties_impl.h"
 #include "multy_core/src/blockchain_facade_base.h"
-#include "multy_core/src/codec.h"
 #include "multy_core/src/exception.h"
 #include "multy_core/src/exception_stream.h"
+#include "multy_core/src/json_writer.h"
+#include "multy_core/src/time_utility.h"
 #include "multy_core/src/utility.h"
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstring>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
+#include <type_traits>
 
-namespace multy_core
-{
-namespace internal
+namespace
 {
+typedef std::array<unsigned char, 32> GolosChainId;
 
-const char* ISO8601_TIME_FORMAT="%FT%T%z";
+// Signed data is prefixed with chain id, so signatures are valid only on one network.
+const GolosChainId GOLOS_MAINNET_CHAIN_ID =
+{
+    0x78, 0x2a, 0x30, 0x39, 0xb4, 0x78, 0xc8, 0x39,
+    0xe4, 0xcb, 0x0c, 0x94, 0x1f, 0xf4, 0xea, 0xeb,
+    0x7d, 0xf4, 0x0b, 0xdd, 0x68, 0xbd, 0x44, 0x1a,
+    0xfd, 0x44, 0x4b, 0x9d, 0xa7, 0x63, 0xde, 0x12
+};
 
-std::string format_iso8601_string(const std::time_t& time)
+const GolosChainId GOLOS_TESTNET_CHAIN_ID =
 {
-    std::ostringstream ss;
-    ss << std::put_time(std::gmtime(&time), ISO8601_TIME_FORMAT);
+    0x58, 0x76, 0x89, 0x4a, 0x41, 0xe6, 0x36, 0x1b,
+    0xde, 0x2e, 0x73, 0x27, 0x8f, 0x07, 0x34, 0x0f,
+    0x2e, 0xb8, 0xb4, 0x1c, 0x2f, 0xac, 0xd2, 0x90,
+    0x99, 0xde, 0x9d, 0xee, 0xf6, 0xcd, 0xb6, 0x79
+};
 
-    return ss.str();
-}
+} // namespace
 
-std::time_t parse_iso8601_string(const std::string& str)
+namespace multy_core
+{
+namespace internal
 {
-    std::tm tm;
-    std::istringstream ss(str);
-    ss >> std::get_time(&tm, ISO8601_TIME_FORMAT);
-    const auto result = std::mktime(&tm);
-    if (result < 0)
-    {
-        THROW_EXCEPTION("Invalid ISO8601 date/time value.");
-    }
-
-    return result;
-}
 
 std::time_t to_system_seconds(size_t seconds)
 {
@@ -68,6 +70,7 @@ std::time_t get_system_time_now()
             std::chrono::system_clock::now());
 }
 
+// Graphene binary serialization, as used for signing transactions.
 class GolosBinaryStream
 {
 public:
@@ -75,6 +78,11 @@ public:
         : m_data()
     {}
 
+    void reserve(size_t size)
+    {
+        m_data.reserve(size);
+    }
+
     void write_data(const unsigned char* data, size_t len)
     {
         if (!data)
@@ -85,88 +93,78 @@ public:
         m_data.insert(m_data.end(), data, data + len);
     }
 
-    BinaryData get_content() const
+    // Fixed-size little-endian integer.
+    template <typename T>
+    void write_uint(T value)
     {
-        return as_binary_data(m_data);
+        static_assert(std::is_unsigned<T>::value, "Only unsigned types are allowed.");
+        for (size_t i = 0; i < sizeof(value); ++i)
+        {
+            m_data.push_back(static_cast<unsigned char>(value >> (i * 8)));
+        }
     }
 
-private:
-    std::vector<unsigned char> m_data;
-};
-
-class GolosJsonStream
-{
-public:
-    GolosJsonStream()
-        : m_sstr()
-    {}
+    // LEB128-encoded integer, used for sizes of strings and vectors.
+    void write_varint(uint64_t value)
+    {
+        do
+        {
+            unsigned char byte = value & 0x7F;
+            value >>= 7;
+            if (value)
+            {
+                byte |= 0x80;
+            }
+            m_data.push_back(byte);
+        } while (value);
+    }
 
-    void write_string(const char* str, size_t len)
+    void write_string(const std::string& str)
     {
-        m_sstr.write(str, len);
+        write_varint(str.size());
+        m_data.insert(m_data.end(), str.begin(), str.end());
     }
 
-    std::string get_string() const
+    BinaryData get_content() const
     {
-        return m_sstr.str();
+        return as_binary_data(m_data);
     }
 
 private:
-    std::ostringstream m_sstr;
+    std::vector<unsigned char> m_data;
 };
 
-GolosJsonStream& operator<<(GolosJsonStream& stream, const std::string& str)
-{
-    stream.write_string(str.c_str(), str.length());
-
-    return stream;
-}
-
-GolosJsonStream& operator<<(GolosJsonStream& stream, const char* str)
-{
-    assert(str);
-    const size_t length = strlen(str);
-    stream.write_string(str, length);
-
-    return stream;
-}
-
 class GolosTransactionOperation
 {
 public:
     virtual ~GolosTransactionOperation() = default;
 
+    // Values are ids of operations in Golos protocol.
     enum OperationType
     {
-        TRANSFER
+        TRANSFER = 2
     };
 
     virtual OperationType get_type() const = 0;
     virtual void write_to_stream(GolosBinaryStream* /*stream*/) const = 0;
-    virtual void write_to_stream(GolosJsonStream* stream) const = 0;
+    // Writes operation-specific object, without the type name.
+    virtual void write_to_stream(JsonWriter* writer) const = 0;
+    // Upper bound of the binary-serialized operation size.
+    virtual size_t get_binary_size_estimate() const = 0;
 
-    std::string get_type_name() const
+    const char* get_type_name() const
     {
-        static const std::unordered_map<size_t, std::string> NAMES =
+        switch (get_type())
         {
-            {TRANSFER, "transfer"},
-        };
-
-        const OperationType type = get_type();
-        auto p = NAMES.find(type);
-        assert(p != NAMES.end());
+            case TRANSFER:
+                return "transfer";
+        }
 
-        return p->second;
+        THROW_EXCEPTION("Unknown Golos operation type.")
+                << " Type: " << get_type();
     }
 };
 
-GolosJsonStream& operator<<(GolosJsonStream& stream, const GolosTransactionOperation& op)
-{
-    op.write_to_stream(&stream);
-
-    return stream;
-}
-
 GolosBinaryStream& operator<<(GolosBinaryStream& stream, const GolosTransactionOperation& op)
 {
     op.write_to_stream(&stream);
@@ -195,48 +193,48 @@ public:
         return TRANSFER;
     }
 
-    void write_to_stream(GolosBinaryStream* /*stream*/) const override
+    void write_to_stream(GolosBinaryStream* stream) const override
     {
+        // Asset is serialized as 64-bit amount followed by 64-bit symbol:
+        // number of decimal places and up to 7 chars of the token name.
+        const size_t GOLOS_SYMBOL_NAME_MAX_LENGTH = 7;
+        if (token_name.length() > GOLOS_SYMBOL_NAME_MAX_LENGTH)
+        {
+            THROW_EXCEPTION("Token name is too long.")
+                    << " Max length: " << GOLOS_SYMBOL_NAME_MAX_LENGTH
+                    << ", token name: \"" << token_name << "\".";
+        }
+        std::array<unsigned char, GOLOS_SYMBOL_NAME_MAX_LENGTH> symbol_name{};
+        std::copy(token_name.begin(), token_name.end(), symbol_name.begin());
+
+        stream->write_varint(get_type());
+        stream->write_string(from);
+        stream->write_string(to);
+        stream->write_uint(static_cast<uint64_t>(amount.get_value_as_int64()));
+        stream->write_uint(static_cast<uint8_t>(GOLOS_VALUE_DECIMAL_PLACES));
+        stream->write_data(symbol_name.data(), symbol_name.size());
+        stream->write_string(memo);
     }
 
-    void write_to_stream(GolosJsonStream* stream) const override
+    size_t get_binary_size_estimate() const override
     {
-        std::string amount_value = amount.get_value();
-        if (amount_value.length() <= GOLOS_VALUE_DECIMAL_PLACES)
-        {
-            // Prepending small values with leading zeroes up to
-            // GOLOS_VALUE_DECIMAL_PLACES + 1.
-
-            // Golos implementation expects 64bit fractional part,
-            // so that would take at most 19.2 decimal digits.
-            // Rounding that up to 20 and here you go, 20 zeroes:
-            const char* zeroes = "00000000000000000000";
-            amount_value.insert(amount_value.begin(),
-                    zeroes,
-                    zeroes + (GOLOS_VALUE_DECIMAL_PLACES - amount_value.length() + 1));
-        }
-        amount_value.insert(amount_value.end() - GOLOS_VALUE_DECIMAL_PLACES, '.');
-        //TODO: should we remove all trailing zeroes?
-
-        char buf[1024];
-        const int len = snprintf(buf, sizeof(buf),
-                R"transfer(
-    "from": "%s",
-    "to": "%s",
-    "amount": "%s %s",
-    "memo": "%s"
-)transfer",
-                 from.c_str(),
-                 to.c_str(),
-                 amount_value.c_str(),
-                 token_name.c_str(),
-                 memo.c_str());
-        if (len < 0 || static_cast<size_t>(len) == sizeof(buf))
-        {
-            THROW_EXCEPTION("Failed to format transfer operation as JSON.");
-        }
+        // Op id, lengths of strings and asset are at most 32 bytes total.
+        return 32 + from.size() + to.size() + memo.size();
+    }
 
-        *stream << buf;
+    void write_to_stream(JsonWriter* writer) const override
+    {
+        writer->begin_object();
+        writer->write_key("amount");
+        writer->write_fixed_point(amount.get_value_as_int64(),
+                GOLOS_VALUE_DECIMAL_PLACES, token_name.c_str());
+        writer->write_key("from");
+        writer->write_string(from);
+        writer->write_key("memo");
+        writer->write_string(memo);
+        writer->write_key("to");
+        writer->write_string(to);
+        writer->end_object();
     }
 
 public:
@@ -299,8 +297,9 @@ public:
     PropertyT<BigInt> amount;
 };
 
-GolosTransaction::GolosTransaction(BlockchainType blockchain_type)
-    : TransactionBase(blockchain_type),
+GolosTransaction::GolosTransaction(const Account& account)
+    : TransactionBase(account.get_blockchain_type()),
+      m_account(account),
       m_message(),
       m_source(),
       m_destination(),
@@ -346,7 +345,9 @@ GolosTransaction::GolosTransaction(BlockchainType blockchain_type)
                             << " Expected: " << 160 /8
                             << ", received: " << data.len << ".";
                 }
-            })
+            }),
+      m_expiration(),
+      m_signature()
 {
 }
 
@@ -356,7 +357,7 @@ GolosTransaction::~GolosTransaction()
 
 void GolosTransaction::set_expiration(const std::string& new_expiration)
 {
-    m_expiration = parse_iso8601_string(new_expiration);
+    m_expiration = parse_iso8601_time(new_expiration);
 }
 
 void GolosTransaction::verify()
@@ -402,45 +403,81 @@ void GolosTransaction::update()
         std::string(reinterpret_cast<const char*>(message.data), message.len)
     });
 
-    //TODO: binary-serialize this TX, sign it and update m_signature.
-    m_signature = make_clone(as_binary_data("FAKE GOLOS TX SIGNATURE"));
+    sign();
 }
 
-BinaryDataPtr GolosTransaction::serialize()
+uint16_t GolosTransaction::get_ref_block_num() const
 {
-    update();
+    return static_cast<uint16_t>(static_cast<uint32_t>(*m_ref_block_num));
+}
 
-    const uint16_t ref_block_num = static_cast<uint16_t>(
-            static_cast<uint32_t>(*m_ref_block_num));
+uint32_t GolosTransaction::get_ref_block_prefix() const
+{
+    // Second 32-bit little-endian word of the block id.
+    const unsigned char* data = m_ref_block_hash.get_value()->data;
+    return static_cast<uint32_t>(data[4])
+            | static_cast<uint32_t>(data[5]) << 8
+            | static_cast<uint32_t>(data[6]) << 16
+            | static_cast<uint32_t>(data[7]) << 24;
+}
 
-    const uint32_t ref_block_prefix =
-            reinterpret_cast<const uint32_t*>(
-                    m_ref_block_hash.get_value()->data)[1];
+void GolosTransaction::sign()
+{
+    const GolosChainId& chain_id =
+            get_blockchain_type().net_type == GOLOS_NET_TYPE_TESTNET
+            ? GOLOS_TESTNET_CHAIN_ID : GOLOS_MAINNET_CHAIN_ID;
+
+    // Chain id, header, operations and extensions are written into single
+    // buffer, which is hashed and signed by GolosPrivateKey::sign().
+    GolosBinaryStream stream;
+    stream.reserve(chain_id.size() + 16 + m_operation->get_binary_size_estimate());
+    stream.write_data(chain_id.data(), chain_id.size());
+
+    stream.write_uint(get_ref_block_num());
+    stream.write_uint(get_ref_block_prefix());
+    stream.write_uint(static_cast<uint32_t>(m_expiration));
+
+    stream.write_varint(1);
+    stream << *m_operation;
+    // No extensions.
+    stream.write_varint(0);
+
+    m_signature = m_account.get_private_key()->sign(stream.get_content());
+}
 
-    GolosJsonStream operations_stream;
-    operations_stream << "[\""
-            << m_operation->get_type_name() << "\","
-            << *m_operation << "]";
+BinaryDataPtr GolosTransaction::serialize()
+{
+    update();
 
-    char buffer[1024] = {'\0'};
-    snprintf(buffer, sizeof(buffer), R"json(
-    {
-        "ref_block_num": %ud,
-        "ref_block_prefix": %ud,
-        "expiration": "%s",
-        "operations": [%s],
-        "extensions": [],
-        "signatures": ["%s"]
-    }
-    )json",
-            ref_block_num,
-            ref_block_prefix,
-            format_iso8601_string(m_expiration).c_str(),
-            operations_stream.get_string().c_str(),
-            encode(*m_signature, CODEC_HEX).c_str()
-            );
-
-    return make_clone(as_binary_data(buffer));
+    // Keys are in alphabetical order, same as in Golos node output.
+    JsonWriter writer(256 + m_signature->len * 2
+            + m_operation->get_binary_size_estimate() * 2);
+    writer.begin_object();
+    writer.write_key("expiration");
+    writer.write_timestamp(m_expiration);
+    writer.write_key("extensions");
+    writer.begin_array();
+    writer.end_array();
+
+    writer.write_key("operations");
+    writer.begin_array();
+    writer.begin_array();
+    writer.write_string(m_operation->get_type_name());
+    m_operation->write_to_stream(&writer);
+    writer.end_array();
+    writer.end_array();
+
+    writer.write_key("ref_block_num");
+    writer.write_uint(get_ref_block_num());
+    writer.write_key("ref_block_prefix");
+    writer.write_uint(get_ref_block_prefix());
+    writer.write_key("signatures");
+    writer.begin_array();
+    writer.write_hex(*m_signature);
+    writer.end_array();
+    writer.end_object();
+
+    return writer.make_binary_data();
 }
 
 BigInt GolosTransaction::get_total_fee() const
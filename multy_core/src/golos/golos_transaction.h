@@ -36,7 +36,7 @@ typedef std::unique_ptr<GolosTransactionOperation> GolosTransactionOperationPtr;
 class GolosTransaction : public TransactionBase
 {
 public:
-    GolosTransaction(BlockchainType blockchain_type);
+    explicit GolosTransaction(const Account& account);
     ~GolosTransaction();
 
     void update() override;
@@ -52,8 +52,12 @@ public:
 private:
     void verify();
     void set_expiration(const std::string&);
+    uint16_t get_ref_block_num() const;
+    uint32_t get_ref_block_prefix() const;
+    void sign();
 
 private:
+    const Account& m_account;
     BinaryDataPtr m_message;
     GolosTransactionSourcePtr m_source;
     GolosTransactionDestinationPtr m_destination;
@@ -65,6 +69,7 @@ private:
     PropertyT<BinaryDataPtr> m_ref_block_hash;
 
     std::time_t m_expiration;
+    // 65 bytes: recovery param, r and s, set by sign().
     BinaryDataPtr m_signature;
 };
 
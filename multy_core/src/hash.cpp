@@ -6,118 +6,37 @@
 
 #include "multy_core/src/hash.h"
 
-#include "multy_core/src/api/sha3_impl.h"
+#include "multy_core/error.h"
+
 #include "multy_core/src/exception.h"
 #include "multy_core/src/exception_stream.h"
-#include "multy_core/src/utility.h"
-
-extern "C" {
-#include "ccan/ccan/crypto/ripemd160/ripemd160.h"
-} // extern "C"
 
-#include "wally_crypto.h"
+#include "wally_core.h"
 
-#include <string.h>
+#include <algorithm>
 
 namespace
 {
 using namespace multy_core::internal;
 
-class Sha2Hasher : public Hasher
-{
-    typedef int (*HashFunction)(const unsigned char *, size_t, unsigned char *, size_t);
-
-public:
-    void hash(const BinaryData& input, BinaryData* output) const override
-    {
-        assert(output);
-        const HashFunction hash_function = get_hash_function(output->len * 8);
-        assert(hash_function != nullptr);
-
-        THROW_IF_WALLY_ERROR(
-                hash_function(input.data, input.len,
-                const_cast<unsigned char*>(output->data), output->len),
-                "Failed to sha2-256 the input.");
-    }
-
-    static HashFunction get_hash_function(size_t size)
-    {
-        switch (size)
-        {
-            case 256:
-                return &wally_sha256;
-            case 512:
-                return &wally_sha512;
-            default:
-                THROW_EXCEPTION("Can't do a sha-2 with requested hash size, "
-                        "only 256 and 512 are supported.")
-                        << " Requested hash size in bytes: " << size;
-        }
-    }
-};
-
-class KeccakHasher : public Hasher
-{
-public:
-    void hash(const BinaryData& input, BinaryData* output) const override
-    {
-        assert(output);
-        keccak_256(input, output);
-    }
-};
+typedef IncrementalHasher<SHA2, 512> Sha512Hasher;
 
-class Sha3Hasher : public Hasher
-{
-public:
-    void hash(const BinaryData& input, BinaryData* output) const override
-    {
-        assert(output);
-        sha3(input, output);
-    }
-};
+// Size of the SHA512 input block, HMAC key is padded to that size.
+const size_t SHA512_BLOCK_SIZE = 128;
 
-class RipemdHasher : public Hasher
+Sha512Hasher make_hmac_pad_hasher(const unsigned char* key, unsigned char pad_value)
 {
-public:
-    void hash(const BinaryData& input, BinaryData* output) const override
+    unsigned char pad[SHA512_BLOCK_SIZE];
+    for (size_t i = 0; i < sizeof(pad); ++i)
     {
-        assert(output);
-        if (output->len != 160 / 8)
-        {
-            THROW_EXCEPTION("Unsupported Ripemd hash size.")
-                    << " Requested hash size: " << output->len;
-        }
-
-        struct ripemd160 ripemd;
-        ripemd160(&ripemd, input.data, input.len);
-        memcpy(const_cast<unsigned char*>(output->data), &ripemd, sizeof(ripemd));
+        pad[i] = key[i] ^ pad_value;
     }
-};
 
-template <typename HasherT>
-class DoubleHasher : public Hasher
-{
-    void hash(const BinaryData& input, BinaryData* output) const override
-    {
-        assert(output);
-        // Writing first hash into large enough tmp buffer
-        // to avoid modifying output if exception is thrown in the middle.
-
-        multy_core::internal::hash<1024> tmp_buffer;
-        BinaryData tmp_buffer_binary_data = as_binary_data(tmp_buffer);
-        assert(tmp_buffer_binary_data.len >= output->len);
-        tmp_buffer_binary_data.len = output->len;
-
-        HasherT hasher;
-        hasher.hash(input, &tmp_buffer_binary_data);
-        hasher.hash(tmp_buffer_binary_data, output);
-    }
-};
+    Sha512Hasher hasher;
+    hasher.update(as_binary_data(pad));
+    wally_bzero(pad, sizeof(pad));
 
-template <typename HasherT>
-HasherPtr make_hasher()
-{
-    return HasherPtr(new HasherT);
+    return hasher;
 }
 
 } // namespace
@@ -127,28 +46,84 @@ namespace multy_core
 namespace internal
 {
 
-Hasher::~Hasher()
-{}
-
-HasherPtr make_hasher(HasherType hasher_type, size_t /*size*/)
+void pbkdf2_hmac_sha512(const BinaryData& password,
+        const BinaryData& salt, uint32_t iterations,
+        unsigned char* out, size_t out_size)
 {
-    switch(hasher_type)
+    INVARIANT(password.data != nullptr || password.len == 0);
+    INVARIANT(salt.data != nullptr || salt.len == 0);
+    INVARIANT(out != nullptr || out_size == 0);
+
+    if (iterations == 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "PBKDF2 requires at least one iteration.");
+    }
+
+    unsigned char key[SHA512_BLOCK_SIZE] = {0};
+    if (password.len > sizeof(key))
     {
-        case SHA2:
-            return ::make_hasher<::Sha2Hasher>();
-        case SHA2_DOUBLE:
-            return ::make_hasher<::DoubleHasher<::Sha2Hasher>>();
-        case SHA3:
-            return ::make_hasher<::Sha3Hasher>();
-        case KECCAK:
-            return ::make_hasher<::KeccakHasher>();
-        case RIPEMD:
-            return ::make_hasher<::RipemdHasher>();
-        default:
-            THROW_EXCEPTION("Unknown hasher type.")
-                    << hasher_type;
+        hash<512> key_hash = do_hash<SHA2, 512>(password);
+        memcpy(key, key_hash.data(), key_hash.size());
+        wally_bzero(key_hash.data(), key_hash.size());
     }
-    return nullptr;
+    else if (password.len > 0)
+    {
+        memcpy(key, password.data, password.len);
+    }
+
+    // State after hashing the pads, shared by all HMAC invocations.
+    Sha512Hasher inner_hasher = make_hmac_pad_hasher(key, 0x36);
+    Sha512Hasher outer_hasher = make_hmac_pad_hasher(key, 0x5C);
+    Sha512Hasher hasher;
+    wally_bzero(key, sizeof(key));
+
+    hash<512> u;
+    hash<512> block;
+    for (uint32_t block_index = 1; out_size > 0; ++block_index)
+    {
+        const unsigned char block_index_be[4] = {
+                static_cast<unsigned char>(block_index >> 24),
+                static_cast<unsigned char>(block_index >> 16),
+                static_cast<unsigned char>(block_index >> 8),
+                static_cast<unsigned char>(block_index)};
+
+        hasher = inner_hasher;
+        hasher.update(salt);
+        hasher.update(as_binary_data(block_index_be));
+        u = hasher.finalize();
+        hasher = outer_hasher;
+        hasher.update(as_binary_data(u));
+        u = hasher.finalize();
+        block = u;
+
+        for (uint32_t i = 1; i < iterations; ++i)
+        {
+            hasher = inner_hasher;
+            hasher.update(as_binary_data(u));
+            u = hasher.finalize();
+            hasher = outer_hasher;
+            hasher.update(as_binary_data(u));
+            u = hasher.finalize();
+
+            for (size_t j = 0; j < block.size(); ++j)
+            {
+                block[j] ^= u[j];
+            }
+        }
+
+        const size_t size = std::min(out_size, block.size());
+        memcpy(out, block.data(), size);
+        out += size;
+        out_size -= size;
+    }
+
+    // Midstates of the pad hashers are as good as the key itself.
+    inner_hasher.clear();
+    outer_hasher.clear();
+    hasher.clear();
+    wally_bzero(u.data(), u.size());
+    wally_bzero(block.data(), block.size());
 }
 
 } // namespace internal
@@ -10,10 +10,22 @@
 #include "multy_core/api.h"
 
 #include "multy_core/common.h"
+#include "multy_core/src/error_utility.h"
 #include "multy_core/src/utility.h"
 
+extern "C" {
+#include "ccan/ccan/crypto/ripemd160/ripemd160.h"
+#include "ccan/ccan/crypto/sha256/sha256.h"
+#include "ccan/ccan/crypto/sha512/sha512.h"
+} // extern "C"
+#include "multy_core/src/keccak_f1600.h"
+
+#include "wally_core.h"
+
 #include <array>
-#include <memory>
+#include <vector>
+
+#include <string.h>
 
 struct BinaryData;
 
@@ -26,15 +38,6 @@ namespace internal
 template <size_t N>
 using hash = std::array<std::uint8_t, N/8>;
 
-// TODO: implemenet progressive hashing, when not all data available at once.
-class Hasher
-{
-public:
-    virtual ~Hasher();
-    virtual void hash(const BinaryData& input, BinaryData* output) const = 0;
-};
-
-typedef std::unique_ptr<Hasher> HasherPtr;
 enum HasherType
 {
     SHA2, // 256, 512 only
@@ -44,20 +47,256 @@ enum HasherType
     RIPEMD, // 160 only
 };
 
-MULTY_CORE_API HasherPtr make_hasher(HasherType hasher_type, size_t size);
+/** Incremental hasher, allows to hash data by parts, as it is produced.
+ *
+ * Hasher type and size are resolved at compile time, hashing state is
+ * stored in the object itself and nothing is allocated on the heap.
+ * Copy of the hasher carries over hashing state, so common prefix of
+ * several messages can be hashed only once.
+ *
+ * Every specialization has:
+ *      void update(const BinaryData& data);
+ *      hash<N> finalize(); // also resets hasher to the initial state.
+ *      void clear(); // wipes hashing state and resets hasher to the initial state.
+ *
+ * Unsupported combination of HasherType and size fails to compile.
+ */
+template <HasherType HasherT, size_t N>
+class IncrementalHasher;
+
+template <>
+class IncrementalHasher<SHA2, 256>
+{
+public:
+    IncrementalHasher()
+        : m_context()
+    {
+        sha256_init(&m_context);
+    }
+
+    void update(const BinaryData& data)
+    {
+        sha256_update(&m_context, data.data, data.len);
+    }
+
+    hash<256> finalize()
+    {
+        struct sha256 digest;
+        sha256_done(&m_context, &digest);
+        sha256_init(&m_context);
+
+        hash<256> result;
+        static_assert(sizeof(digest) == sizeof(result), "Hash size mismatch.");
+        memcpy(result.data(), &digest, result.size());
+        return result;
+    }
+
+    void clear()
+    {
+        wally_bzero(&m_context, sizeof(m_context));
+        sha256_init(&m_context);
+    }
+
+private:
+    sha256_ctx m_context;
+};
+
+template <>
+class IncrementalHasher<SHA2, 512>
+{
+public:
+    IncrementalHasher()
+        : m_context()
+    {
+        sha512_init(&m_context);
+    }
+
+    void update(const BinaryData& data)
+    {
+        sha512_update(&m_context, data.data, data.len);
+    }
+
+    hash<512> finalize()
+    {
+        struct sha512 digest;
+        sha512_done(&m_context, &digest);
+        sha512_init(&m_context);
+
+        hash<512> result;
+        static_assert(sizeof(digest) == sizeof(result), "Hash size mismatch.");
+        memcpy(result.data(), &digest, result.size());
+        return result;
+    }
+
+    void clear()
+    {
+        wally_bzero(&m_context, sizeof(m_context));
+        sha512_init(&m_context);
+    }
+
+private:
+    sha512_ctx m_context;
+};
+
+template <size_t N>
+class IncrementalHasher<SHA2_DOUBLE, N>
+{
+public:
+    void update(const BinaryData& data)
+    {
+        m_hasher.update(data);
+    }
+
+    hash<N> finalize()
+    {
+        hash<N> result = m_hasher.finalize();
+        m_hasher.update(as_binary_data(result));
+        result = m_hasher.finalize();
+        return result;
+    }
+
+    void clear()
+    {
+        m_hasher.clear();
+    }
+
+private:
+    IncrementalHasher<SHA2, N> m_hasher;
+};
+
+// Keccak sponge, used for both SHA3 and Ethereum Keccak.
+template <size_t N, uint8_t Delimiter>
+class KeccakSpongeHasher
+{
+public:
+    KeccakSpongeHasher()
+        : m_sponge()
+    {
+        keccak_sponge_init(&m_sponge, RATE, Delimiter);
+    }
+
+    void update(const BinaryData& data)
+    {
+        THROW_IF_WALLY_ERROR(
+                keccak_sponge_absorb(&m_sponge, data.data, data.len),
+                "Failed to hash input data.");
+    }
+
+    hash<N> finalize()
+    {
+        hash<N> result;
+        THROW_IF_WALLY_ERROR(
+                keccak_sponge_squeeze(&m_sponge, result.data(), result.size()),
+                "Failed to hash input data.");
+        keccak_sponge_init(&m_sponge, RATE, Delimiter);
+        return result;
+    }
+
+    void clear()
+    {
+        wally_bzero(&m_sponge, sizeof(m_sponge));
+        keccak_sponge_init(&m_sponge, RATE, Delimiter);
+    }
+
+private:
+    static const size_t RATE = KECCAK_F1600_STATE_SIZE - N / 4;
+    keccak_sponge m_sponge;
+};
+
+template <size_t N>
+class IncrementalHasher<SHA3, N> : public KeccakSpongeHasher<N, 0x06>
+{
+    static_assert(N == 224 || N == 256 || N == 384 || N == 512,
+            "Unsupported SHA3 hash size.");
+};
+
+template <>
+class IncrementalHasher<KECCAK, 256> : public KeccakSpongeHasher<256, 0x01>
+{
+};
+
+template <>
+class IncrementalHasher<RIPEMD, 160>
+{
+public:
+    IncrementalHasher()
+        : m_context()
+    {
+        ripemd160_init(&m_context);
+    }
+
+    void update(const BinaryData& data)
+    {
+        ripemd160_update(&m_context, data.data, data.len);
+    }
+
+    hash<160> finalize()
+    {
+        struct ripemd160 digest;
+        ripemd160_done(&m_context, &digest);
+        ripemd160_init(&m_context);
+
+        hash<160> result;
+        static_assert(sizeof(digest) == sizeof(result), "Hash size mismatch.");
+        memcpy(result.data(), &digest, result.size());
+        return result;
+    }
+
+    void clear()
+    {
+        wally_bzero(&m_context, sizeof(m_context));
+        ripemd160_init(&m_context);
+    }
+
+private:
+    ripemd160_ctx m_context;
+};
 
 // Hash given data with sepecific hasher and hash size.
 template <HasherType HasherT, size_t N, typename T>
 inline hash<N> do_hash(const T& input)
 {
-    HasherPtr hashser = make_hasher(HasherT, N);
-    hash<N> result;
-    BinaryData result_data = as_binary_data(result);
-    hashser->hash(as_binary_data(input), &result_data);
+    IncrementalHasher<HasherT, N> hasher;
+    hasher.update(as_binary_data(input));
+    return hasher.finalize();
+}
 
+/** Keccak-256 of many independent inputs at once.
+ *
+ * Faster than hashing inputs one by one, since inputs of similar size
+ * (like public keys) are hashed in parallel with SIMD, if CPU supports it.
+ */
+inline std::vector<hash<256>> keccak_256_many(const BinaryData* inputs, size_t count)
+{
+    INVARIANT(inputs != nullptr || count == 0);
+
+    std::vector<const uint8_t*> data(count);
+    std::vector<size_t> sizes(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        data[i] = inputs[i].data;
+        sizes[i] = inputs[i].len;
+    }
+
+    std::vector<hash<256>> result(count);
+    static_assert(sizeof(hash<256>) == 256 / 8, "Unexpected hash<256> layout.");
+    THROW_IF_WALLY_ERROR(
+            ::keccak_256_many(result.data()->data(), data.data(), sizes.data(), count),
+            "Failed to hash input data.");
     return result;
 }
 
+/** PBKDF2 with HMAC-SHA512 as PRF (RFC 8018), e.g. for BIP39 seeds.
+ *
+ * HMAC pads are hashed once and hasher state is copied on every iteration,
+ * so each iteration costs two SHA512 compressions rather than four.
+ * @param out - out_size bytes of derived key, any size is supported.
+ * @throw Exception if iterations is 0.
+ */
+MULTY_CORE_API void pbkdf2_hmac_sha512(const BinaryData& password,
+        const BinaryData& salt, uint32_t iterations,
+        unsigned char* out, size_t out_size);
+
 } // namespace internal
 } // namespace multy_core
 
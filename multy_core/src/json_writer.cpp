@@ -0,0 +1,373 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/json_writer.h"
+
+#include "multy_core/error.h"
+
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+#include "multy_core/src/time_utility.h"
+#include "multy_core/src/utility.h"
+
+#include <cstring>
+
+namespace
+{
+const char HEX_DIGITS[] = "0123456789abcdef";
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+const size_t JsonWriter::MAX_DEPTH;
+
+JsonWriter::JsonWriter(size_t reserve_size)
+    : m_buffer(),
+      m_is_object(0),
+      m_has_items(0),
+      m_depth(0),
+      m_after_key(false)
+{
+    m_buffer.reserve(reserve_size);
+}
+
+void JsonWriter::begin_object()
+{
+    begin_value();
+    push('{');
+}
+
+void JsonWriter::end_object()
+{
+    pop('}');
+}
+
+void JsonWriter::begin_array()
+{
+    begin_value();
+    push('[');
+}
+
+void JsonWriter::end_array()
+{
+    pop(']');
+}
+
+void JsonWriter::write_key(const char* key)
+{
+    INVARIANT(key != nullptr);
+
+    if (m_depth == 0 || !(m_is_object & (1ULL << (m_depth - 1))) || m_after_key)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "JSON key is allowed only for members of an object.")
+                << " Key: \"" << key << "\".";
+    }
+
+    const uint64_t level_bit = 1ULL << (m_depth - 1);
+    if (m_has_items & level_bit)
+    {
+        m_buffer.push_back(',');
+    }
+    m_has_items |= level_bit;
+
+    m_buffer.push_back('"');
+    m_buffer.append(key);
+    m_buffer.append("\":", 2);
+    m_after_key = true;
+}
+
+void JsonWriter::write_string(const char* str, size_t len)
+{
+    INVARIANT(str != nullptr || len == 0);
+
+    begin_value();
+    m_buffer.push_back('"');
+    write_escaped(str, len);
+    m_buffer.push_back('"');
+}
+
+void JsonWriter::write_string(const char* str)
+{
+    INVARIANT(str != nullptr);
+
+    write_string(str, strlen(str));
+}
+
+void JsonWriter::write_string(const std::string& str)
+{
+    write_string(str.data(), str.size());
+}
+
+void JsonWriter::write_hex(const BinaryData& data)
+{
+    INVARIANT(data.data != nullptr || data.len == 0);
+
+    begin_value();
+    m_buffer.reserve(m_buffer.size() + data.len * 2 + 2);
+    m_buffer.push_back('"');
+    for (size_t i = 0; i < data.len; ++i)
+    {
+        m_buffer.push_back(HEX_DIGITS[data.data[i] >> 4]);
+        m_buffer.push_back(HEX_DIGITS[data.data[i] & 0x0F]);
+    }
+    m_buffer.push_back('"');
+}
+
+void JsonWriter::write_timestamp(std::time_t time)
+{
+    char buffer[ISO8601_TIME_LENGTH];
+    format_iso8601_time(time, buffer);
+
+    write_string(buffer, sizeof(buffer));
+}
+
+void JsonWriter::write_fixed_point(int64_t value, size_t decimal_places, const char* suffix)
+{
+    // Max uint64 is 20 digits, '-', '0', '.' and a lot of leading zeroes.
+    char buffer[64];
+    if (decimal_places > sizeof(buffer) - 24)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Too many decimal places for JSON fixed-point value.")
+                << " Decimal places: " << decimal_places;
+    }
+
+    // Negating as unsigned, so that INT64_MIN is not an overflow.
+    uint64_t abs_value = value < 0
+            ? 0 - static_cast<uint64_t>(value)
+            : static_cast<uint64_t>(value);
+
+    // Written backwards from the end of the buffer.
+    char* const end = buffer + sizeof(buffer);
+    char* out = end;
+    for (size_t i = 0; i < decimal_places; ++i)
+    {
+        *--out = static_cast<char>('0' + abs_value % 10);
+        abs_value /= 10;
+    }
+    if (decimal_places > 0)
+    {
+        *--out = '.';
+    }
+    do
+    {
+        *--out = static_cast<char>('0' + abs_value % 10);
+        abs_value /= 10;
+    } while (abs_value);
+    if (value < 0)
+    {
+        *--out = '-';
+    }
+
+    begin_value();
+    m_buffer.push_back('"');
+    m_buffer.append(out, end - out);
+    if (suffix)
+    {
+        m_buffer.push_back(' ');
+        write_escaped(suffix, strlen(suffix));
+    }
+    m_buffer.push_back('"');
+}
+
+void JsonWriter::write_int(int64_t value)
+{
+    begin_value();
+    if (value < 0)
+    {
+        m_buffer.push_back('-');
+    }
+    write_uint_digits(value < 0
+            ? 0 - static_cast<uint64_t>(value)
+            : static_cast<uint64_t>(value));
+}
+
+void JsonWriter::write_uint(uint64_t value)
+{
+    begin_value();
+    write_uint_digits(value);
+}
+
+void JsonWriter::write_bool(bool value)
+{
+    begin_value();
+    if (value)
+    {
+        m_buffer.append("true", 4);
+    }
+    else
+    {
+        m_buffer.append("false", 5);
+    }
+}
+
+void JsonWriter::write_null()
+{
+    begin_value();
+    m_buffer.append("null", 4);
+}
+
+void JsonWriter::write_raw(const char* json, size_t len)
+{
+    INVARIANT(json != nullptr);
+
+    begin_value();
+    m_buffer.append(json, len);
+}
+
+const std::string& JsonWriter::get_content() const
+{
+    if (m_depth != 0)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "JSON is not complete.")
+                << " Unclosed objects or arrays: " << m_depth;
+    }
+
+    return m_buffer;
+}
+
+BinaryDataPtr JsonWriter::make_binary_data() const
+{
+    return make_clone(as_binary_data(get_content()));
+}
+
+void JsonWriter::begin_value()
+{
+    if (m_depth == 0)
+    {
+        if (!m_buffer.empty())
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "JSON can have only one top-level value.");
+        }
+        return;
+    }
+
+    const uint64_t level_bit = 1ULL << (m_depth - 1);
+    if (m_is_object & level_bit)
+    {
+        if (!m_after_key)
+        {
+            THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                    "JSON object member must have a key.");
+        }
+        m_after_key = false;
+        return;
+    }
+
+    if (m_has_items & level_bit)
+    {
+        m_buffer.push_back(',');
+    }
+    m_has_items |= level_bit;
+}
+
+void JsonWriter::push(char bracket)
+{
+    if (m_depth >= MAX_DEPTH)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "JSON is nested too deep.")
+                << " Max depth: " << MAX_DEPTH;
+    }
+
+    const uint64_t level_bit = 1ULL << m_depth;
+    if (bracket == '{')
+    {
+        m_is_object |= level_bit;
+    }
+    else
+    {
+        m_is_object &= ~level_bit;
+    }
+    m_has_items &= ~level_bit;
+    ++m_depth;
+
+    m_buffer.push_back(bracket);
+}
+
+void JsonWriter::pop(char bracket)
+{
+    const bool is_object = bracket == '}';
+    if (m_depth == 0
+            || static_cast<bool>(m_is_object & (1ULL << (m_depth - 1))) != is_object
+            || m_after_key)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Unexpected end of JSON ")
+                << (is_object ? "object." : "array.");
+    }
+    --m_depth;
+
+    m_buffer.push_back(bracket);
+}
+
+void JsonWriter::write_escaped(const char* str, size_t len)
+{
+    const char* begin = str;
+    const char* const end = str + len;
+    for (const char* p = str; p != end; ++p)
+    {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+
+        // Unescaped chars are appended in chunks.
+        m_buffer.append(begin, p - begin);
+        begin = p + 1;
+
+        m_buffer.push_back('\\');
+        switch (c)
+        {
+            case '"':
+            case '\\':
+                m_buffer.push_back(static_cast<char>(c));
+                break;
+            case '\b':
+                m_buffer.push_back('b');
+                break;
+            case '\f':
+                m_buffer.push_back('f');
+                break;
+            case '\n':
+                m_buffer.push_back('n');
+                break;
+            case '\r':
+                m_buffer.push_back('r');
+                break;
+            case '\t':
+                m_buffer.push_back('t');
+                break;
+            default:
+                m_buffer.append("u00", 3);
+                m_buffer.push_back(HEX_DIGITS[c >> 4]);
+                m_buffer.push_back(HEX_DIGITS[c & 0x0F]);
+                break;
+        }
+    }
+    m_buffer.append(begin, end - begin);
+}
+
+void JsonWriter::write_uint_digits(uint64_t value)
+{
+    char buffer[20];
+    char* const end = buffer + sizeof(buffer);
+    char* out = end;
+    do
+    {
+        *--out = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    m_buffer.append(out, end - out);
+}
+
+} // namespace internal
+} // namespace multy_core
@@ -0,0 +1,104 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_JSON_WRITER_H
+#define MULTY_CORE_JSON_WRITER_H
+
+#include "multy_core/api.h"
+#include "multy_core/binary_data.h"
+
+#include "multy_core/src/u_ptr.h"
+
+#include <ctime>
+#include <string>
+
+#include <stdint.h>
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Writes compact JSON into a single growing buffer.
+ *
+ * Commas between items are inserted automatically, keys must be written
+ * before each value of an object. Strings are escaped, numbers and
+ * timestamps are formatted by hand, without iostreams or locale.
+ *
+ * Usage:
+ *     JsonWriter writer(128);
+ *     writer.begin_object();
+ *     writer.write_key("ids");
+ *     writer.begin_array();
+ *     writer.write_uint(1);
+ *     writer.write_uint(2);
+ *     writer.end_array();
+ *     writer.end_object();
+ *     // writer.get_content() is {"ids":[1,2]}
+ */
+class MULTY_CORE_API JsonWriter
+{
+public:
+    // Max nesting of objects and arrays.
+    static const size_t MAX_DEPTH = 64;
+
+    /// @param reserve_size - expected size of the output, to avoid reallocations.
+    explicit JsonWriter(size_t reserve_size = 0);
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+
+    /// Key of the next object member, must be a valid JSON string contents.
+    void write_key(const char* key);
+
+    void write_string(const char* str, size_t len);
+    void write_string(const char* str);
+    void write_string(const std::string& str);
+    /// Writes data as a hex-encoded string.
+    void write_hex(const BinaryData& data);
+    /// Writes time as UTC ISO-8601 string: "2018-03-22T14:42:00".
+    void write_timestamp(std::time_t time);
+    /// Writes fixed-point number as a string, i.e. 5 with 3 decimal places is "0.005".
+    void write_fixed_point(int64_t value, size_t decimal_places, const char* suffix = nullptr);
+
+    void write_int(int64_t value);
+    void write_uint(uint64_t value);
+    void write_bool(bool value);
+    void write_null();
+
+    /// Value is not checked and written as is.
+    void write_raw(const char* json, size_t len);
+
+    /** Output written so far.
+     *  @throw Exception if some objects or arrays are not closed.
+     */
+    const std::string& get_content() const;
+    BinaryDataPtr make_binary_data() const;
+
+private:
+    // Writes comma before all but the first item of the current object/array.
+    void begin_value();
+    void push(char bracket);
+    void pop(char bracket);
+    void write_escaped(const char* str, size_t len);
+    void write_uint_digits(uint64_t value);
+
+private:
+    std::string m_buffer;
+    // Bit per nesting level: set if level is an object.
+    uint64_t m_is_object;
+    // Bit per nesting level: set if level already has items.
+    uint64_t m_has_items;
+    size_t m_depth;
+    bool m_after_key;
+};
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_JSON_WRITER_H
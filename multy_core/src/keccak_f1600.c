@@ -0,0 +1,477 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/keccak_f1600.h"
+
+#include <string.h>
+
+/* Like keccak-tiny, state is hashed as an array of 64-bit lanes,
+ * that is valid only on little-endian machines, which all targets are. */
+
+static const uint64_t ROUND_CONSTANTS[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+#define KECCAK_256_RATE (KECCAK_F1600_STATE_SIZE - 256 / 4)
+#define KECCAK_256_SIZE 32
+#define KECCAK_DELIMITER 0x01
+
+/* Lanes are indexed as a[x + 5 * y]. */
+#define A(x, y) a[(x) + 5 * (y)]
+#define R(x, y) r[(x) + 5 * (y)]
+
+/* Rotation offsets of the rho step. */
+#define RHO_0_0 0
+#define RHO_1_0 1
+#define RHO_2_0 62
+#define RHO_3_0 28
+#define RHO_4_0 27
+#define RHO_0_1 36
+#define RHO_1_1 44
+#define RHO_2_1 6
+#define RHO_3_1 55
+#define RHO_4_1 20
+#define RHO_0_2 3
+#define RHO_1_2 10
+#define RHO_2_2 43
+#define RHO_3_2 25
+#define RHO_4_2 39
+#define RHO_0_3 41
+#define RHO_1_3 45
+#define RHO_2_3 15
+#define RHO_3_3 21
+#define RHO_4_3 8
+#define RHO_0_4 18
+#define RHO_1_4 2
+#define RHO_2_4 61
+#define RHO_3_4 56
+#define RHO_4_4 14
+
+#define ROL(x, s) (((x) << (s)) | ((x) >> ((64 - (s)) % 64)))
+
+/* Theta, rho and pi of lane (x, y), see keccak_f1600_round() below. */
+#define TRP(x, y) ROL(A(x, y) ^ d[x], RHO_##x##_##y)
+
+/** Keccak-f[1600] round, fully unrolled.
+ *
+ * Reads state from a, writes it to r. Uses the lane complementing transform:
+ * lanes (1, 0), (2, 0), (3, 1), (2, 2), (2, 3) and (0, 4) are kept inverted
+ * between the rounds, which replaces most of NOTs of the chi step by ORs.
+ * See "Keccak implementation overview", section 2.2.
+ */
+static inline void keccak_f1600_round(uint64_t* r, const uint64_t* a, uint64_t rc)
+{
+    uint64_t c[5], d[5];
+
+    c[0] = A(0, 0) ^ A(0, 1) ^ A(0, 2) ^ A(0, 3) ^ A(0, 4);
+    c[1] = A(1, 0) ^ A(1, 1) ^ A(1, 2) ^ A(1, 3) ^ A(1, 4);
+    c[2] = A(2, 0) ^ A(2, 1) ^ A(2, 2) ^ A(2, 3) ^ A(2, 4);
+    c[3] = A(3, 0) ^ A(3, 1) ^ A(3, 2) ^ A(3, 3) ^ A(3, 4);
+    c[4] = A(4, 0) ^ A(4, 1) ^ A(4, 2) ^ A(4, 3) ^ A(4, 4);
+
+    d[0] = ROL(c[1], 1) ^ c[4];
+    d[1] = ROL(c[2], 1) ^ c[0];
+    d[2] = ROL(c[3], 1) ^ c[1];
+    d[3] = ROL(c[4], 1) ^ c[2];
+    d[4] = ROL(c[0], 1) ^ c[3];
+
+    c[0] = A(0, 0) ^ d[0];
+    c[1] = TRP(1, 1);
+    c[2] = TRP(2, 2);
+    c[3] = TRP(3, 3);
+    c[4] = TRP(4, 4);
+    R(0, 0) = c[0] ^ ( c[1] | c[2]) ^ rc;
+    R(1, 0) = c[1] ^ (~c[2] | c[3]);
+    R(2, 0) = c[2] ^ ( c[3] & c[4]);
+    R(3, 0) = c[3] ^ ( c[4] | c[0]);
+    R(4, 0) = c[4] ^ ( c[0] & c[1]);
+
+    c[0] = TRP(3, 0);
+    c[1] = TRP(4, 1);
+    c[2] = TRP(0, 2);
+    c[3] = TRP(1, 3);
+    c[4] = TRP(2, 4);
+    R(0, 1) = c[0] ^ (c[1] |  c[2]);
+    R(1, 1) = c[1] ^ (c[2] &  c[3]);
+    R(2, 1) = c[2] ^ (c[3] | ~c[4]);
+    R(3, 1) = c[3] ^ (c[4] |  c[0]);
+    R(4, 1) = c[4] ^ (c[0] &  c[1]);
+
+    c[0] = TRP(1, 0);
+    c[1] = TRP(2, 1);
+    c[2] = TRP(3, 2);
+    c[3] = TRP(4, 3);
+    c[4] = TRP(0, 4);
+    R(0, 2) =  c[0] ^ ( c[1] | c[2]);
+    R(1, 2) =  c[1] ^ ( c[2] & c[3]);
+    R(2, 2) =  c[2] ^ (~c[3] & c[4]);
+    R(3, 2) = ~c[3] ^ ( c[4] | c[0]);
+    R(4, 2) =  c[4] ^ ( c[0] & c[1]);
+
+    c[0] = TRP(4, 0);
+    c[1] = TRP(0, 1);
+    c[2] = TRP(1, 2);
+    c[3] = TRP(2, 3);
+    c[4] = TRP(3, 4);
+    R(0, 3) =  c[0] ^ ( c[1] & c[2]);
+    R(1, 3) =  c[1] ^ ( c[2] | c[3]);
+    R(2, 3) =  c[2] ^ (~c[3] | c[4]);
+    R(3, 3) = ~c[3] ^ ( c[4] & c[0]);
+    R(4, 3) =  c[4] ^ ( c[0] | c[1]);
+
+    c[0] = TRP(2, 0);
+    c[1] = TRP(3, 1);
+    c[2] = TRP(4, 2);
+    c[3] = TRP(0, 3);
+    c[4] = TRP(1, 4);
+    R(0, 4) =  c[0] ^ (~c[1] & c[2]);
+    R(1, 4) = ~c[1] ^ ( c[2] | c[3]);
+    R(2, 4) =  c[2] ^ ( c[3] & c[4]);
+    R(3, 4) =  c[3] ^ ( c[4] | c[0]);
+    R(4, 4) =  c[4] ^ ( c[0] & c[1]);
+}
+
+static inline void complement_lanes(uint64_t* a)
+{
+    A(1, 0) = ~A(1, 0);
+    A(2, 0) = ~A(2, 0);
+    A(3, 1) = ~A(3, 1);
+    A(2, 2) = ~A(2, 2);
+    A(2, 3) = ~A(2, 3);
+    A(0, 4) = ~A(0, 4);
+}
+
+void keccak_f1600(uint64_t* a)
+{
+    uint64_t t[25];
+    int i;
+
+    complement_lanes(a);
+    for (i = 0; i < 24; i += 2)
+    {
+        keccak_f1600_round(t, a, ROUND_CONSTANTS[i]);
+        keccak_f1600_round(a, t, ROUND_CONSTANTS[i + 1]);
+    }
+    complement_lanes(a);
+}
+
+/* 4-way Keccak-f[1600] with AVX2, selected at runtime. */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KECCAK_HAVE_AVX2 1
+#include <immintrin.h>
+
+#define AVX2 __attribute__((target("avx2")))
+
+/* Lane j of each of 4 states is in a[j], one state per 64-bit element. */
+#define XOR4(x, y) _mm256_xor_si256(x, y)
+#define ROL4(x, s) _mm256_or_si256(_mm256_slli_epi64(x, s), _mm256_srli_epi64(x, 64 - (s)))
+/* x ^ (~y & z) */
+#define CHI4(x, y, z) _mm256_xor_si256(x, _mm256_andnot_si256(y, z))
+#define TRP4(x, y) ROL4(XOR4(A(x, y), d[x]), RHO_##x##_##y)
+
+/* Same as keccak_f1600_round(), but without lane complementing transform,
+ * since AVX2 has and-not instruction. */
+static inline AVX2 void keccak_f1600_round_x4(__m256i* r, const __m256i* a, uint64_t rc)
+{
+    __m256i c[5], d[5];
+
+    c[0] = XOR4(XOR4(XOR4(A(0, 0), A(0, 1)), XOR4(A(0, 2), A(0, 3))), A(0, 4));
+    c[1] = XOR4(XOR4(XOR4(A(1, 0), A(1, 1)), XOR4(A(1, 2), A(1, 3))), A(1, 4));
+    c[2] = XOR4(XOR4(XOR4(A(2, 0), A(2, 1)), XOR4(A(2, 2), A(2, 3))), A(2, 4));
+    c[3] = XOR4(XOR4(XOR4(A(3, 0), A(3, 1)), XOR4(A(3, 2), A(3, 3))), A(3, 4));
+    c[4] = XOR4(XOR4(XOR4(A(4, 0), A(4, 1)), XOR4(A(4, 2), A(4, 3))), A(4, 4));
+
+    d[0] = XOR4(ROL4(c[1], 1), c[4]);
+    d[1] = XOR4(ROL4(c[2], 1), c[0]);
+    d[2] = XOR4(ROL4(c[3], 1), c[1]);
+    d[3] = XOR4(ROL4(c[4], 1), c[2]);
+    d[4] = XOR4(ROL4(c[0], 1), c[3]);
+
+    c[0] = XOR4(A(0, 0), d[0]);
+    c[1] = TRP4(1, 1);
+    c[2] = TRP4(2, 2);
+    c[3] = TRP4(3, 3);
+    c[4] = TRP4(4, 4);
+    R(0, 0) = XOR4(CHI4(c[0], c[1], c[2]), _mm256_set1_epi64x((long long)rc));
+    R(1, 0) = CHI4(c[1], c[2], c[3]);
+    R(2, 0) = CHI4(c[2], c[3], c[4]);
+    R(3, 0) = CHI4(c[3], c[4], c[0]);
+    R(4, 0) = CHI4(c[4], c[0], c[1]);
+
+    c[0] = TRP4(3, 0);
+    c[1] = TRP4(4, 1);
+    c[2] = TRP4(0, 2);
+    c[3] = TRP4(1, 3);
+    c[4] = TRP4(2, 4);
+    R(0, 1) = CHI4(c[0], c[1], c[2]);
+    R(1, 1) = CHI4(c[1], c[2], c[3]);
+    R(2, 1) = CHI4(c[2], c[3], c[4]);
+    R(3, 1) = CHI4(c[3], c[4], c[0]);
+    R(4, 1) = CHI4(c[4], c[0], c[1]);
+
+    c[0] = TRP4(1, 0);
+    c[1] = TRP4(2, 1);
+    c[2] = TRP4(3, 2);
+    c[3] = TRP4(4, 3);
+    c[4] = TRP4(0, 4);
+    R(0, 2) = CHI4(c[0], c[1], c[2]);
+    R(1, 2) = CHI4(c[1], c[2], c[3]);
+    R(2, 2) = CHI4(c[2], c[3], c[4]);
+    R(3, 2) = CHI4(c[3], c[4], c[0]);
+    R(4, 2) = CHI4(c[4], c[0], c[1]);
+
+    c[0] = TRP4(4, 0);
+    c[1] = TRP4(0, 1);
+    c[2] = TRP4(1, 2);
+    c[3] = TRP4(2, 3);
+    c[4] = TRP4(3, 4);
+    R(0, 3) = CHI4(c[0], c[1], c[2]);
+    R(1, 3) = CHI4(c[1], c[2], c[3]);
+    R(2, 3) = CHI4(c[2], c[3], c[4]);
+    R(3, 3) = CHI4(c[3], c[4], c[0]);
+    R(4, 3) = CHI4(c[4], c[0], c[1]);
+
+    c[0] = TRP4(2, 0);
+    c[1] = TRP4(3, 1);
+    c[2] = TRP4(4, 2);
+    c[3] = TRP4(0, 3);
+    c[4] = TRP4(1, 4);
+    R(0, 4) = CHI4(c[0], c[1], c[2]);
+    R(1, 4) = CHI4(c[1], c[2], c[3]);
+    R(2, 4) = CHI4(c[2], c[3], c[4]);
+    R(3, 4) = CHI4(c[3], c[4], c[0]);
+    R(4, 4) = CHI4(c[4], c[0], c[1]);
+}
+
+static AVX2 void keccak_f1600_x4(__m256i* a)
+{
+    __m256i t[25];
+    int i;
+
+    for (i = 0; i < 24; i += 2)
+    {
+        keccak_f1600_round_x4(t, a, ROUND_CONSTANTS[i]);
+        keccak_f1600_round_x4(a, t, ROUND_CONSTANTS[i + 1]);
+    }
+}
+
+/* Hashes 4 messages at once, all must have same number of full blocks. */
+static AVX2 void keccak_256_x4(uint8_t* out,
+        const uint8_t* const* in, const size_t* inlen)
+{
+    const size_t rate = KECCAK_256_RATE;
+    const size_t blocks = inlen[0] / rate;
+    uint8_t last[4][KECCAK_256_RATE];
+    uint64_t lanes[4];
+    __m256i a[25];
+    size_t b, j, k;
+
+    for (k = 0; k < 4; ++k)
+    {
+        /* Last block with the delimiter and padding. */
+        const size_t len = inlen[k] - blocks * rate;
+        memset(last[k], 0, rate);
+        if (len != 0)
+        {
+            memcpy(last[k], in[k] + blocks * rate, len);
+        }
+        last[k][len] ^= KECCAK_DELIMITER;
+        last[k][rate - 1] ^= 0x80;
+    }
+    for (j = 0; j < 25; ++j)
+    {
+        a[j] = _mm256_setzero_si256();
+    }
+
+    for (b = 0; b <= blocks; ++b)
+    {
+        for (j = 0; j < rate / 8; ++j)
+        {
+            for (k = 0; k < 4; ++k)
+            {
+                const uint8_t* block = (b < blocks) ? in[k] + b * rate : last[k];
+                memcpy(&lanes[k], block + 8 * j, 8);
+            }
+            a[j] = _mm256_xor_si256(a[j], _mm256_loadu_si256((const __m256i*)lanes));
+        }
+        keccak_f1600_x4(a);
+    }
+
+    for (j = 0; j < KECCAK_256_SIZE / 8; ++j)
+    {
+        _mm256_storeu_si256((__m256i*)lanes, a[j]);
+        for (k = 0; k < 4; ++k)
+        {
+            memcpy(out + KECCAK_256_SIZE * k + 8 * j, &lanes[k], 8);
+        }
+    }
+}
+
+#undef XOR4
+#undef ROL4
+#undef CHI4
+#undef TRP4
+#endif
+
+#undef TRP
+#undef A
+#undef R
+
+static void xor_bytes(uint64_t* state, size_t offset, const uint8_t* in, size_t size)
+{
+    uint8_t* bytes = (uint8_t*)state + offset;
+    size_t i;
+
+    for (i = 0; i < size; ++i)
+    {
+        bytes[i] ^= in[i];
+    }
+}
+
+static void wipe(void* data, size_t size)
+{
+    volatile uint8_t* bytes = (volatile uint8_t*)data;
+    while (size--)
+    {
+        *bytes++ = 0;
+    }
+}
+
+void keccak_sponge_init(keccak_sponge* sponge, size_t rate, uint8_t delimiter)
+{
+    memset(sponge->state, 0, sizeof(sponge->state));
+    sponge->offset = 0;
+    sponge->rate = rate;
+    sponge->delimiter = delimiter;
+}
+
+int keccak_sponge_absorb(keccak_sponge* sponge, const uint8_t* in, size_t inlen)
+{
+    size_t rate;
+
+    if (sponge == NULL || (in == NULL && inlen != 0)
+            || sponge->rate == 0 || sponge->rate >= KECCAK_F1600_STATE_SIZE)
+    {
+        return -1;
+    }
+
+    rate = sponge->rate;
+    while (inlen != 0)
+    {
+        const size_t len = (rate - sponge->offset) < inlen
+                ? (rate - sponge->offset) : inlen;
+        xor_bytes(sponge->state, sponge->offset, in, len);
+        sponge->offset += len;
+        in += len;
+        inlen -= len;
+        if (sponge->offset == rate)
+        {
+            keccak_f1600(sponge->state);
+            sponge->offset = 0;
+        }
+    }
+    return 0;
+}
+
+int keccak_sponge_squeeze(keccak_sponge* sponge, uint8_t* out, size_t outlen)
+{
+    uint8_t* bytes;
+    size_t rate;
+
+    if (sponge == NULL || out == NULL
+            || sponge->rate == 0 || sponge->rate >= KECCAK_F1600_STATE_SIZE)
+    {
+        return -1;
+    }
+
+    rate = sponge->rate;
+    bytes = (uint8_t*)sponge->state;
+    bytes[sponge->offset] ^= sponge->delimiter;
+    bytes[rate - 1] ^= 0x80;
+    keccak_f1600(sponge->state);
+
+    while (outlen != 0)
+    {
+        const size_t len = outlen < rate ? outlen : rate;
+        memcpy(out, bytes, len);
+        out += len;
+        outlen -= len;
+        if (outlen != 0)
+        {
+            keccak_f1600(sponge->state);
+        }
+    }
+    wipe(sponge->state, sizeof(sponge->state));
+    return 0;
+}
+
+static void keccak_256(uint8_t* out, const uint8_t* in, size_t inlen)
+{
+    keccak_sponge sponge;
+
+    keccak_sponge_init(&sponge, KECCAK_256_RATE, KECCAK_DELIMITER);
+    keccak_sponge_absorb(&sponge, in, inlen);
+    keccak_sponge_squeeze(&sponge, out, KECCAK_256_SIZE);
+}
+
+int keccak_256_many(uint8_t* out,
+        const uint8_t* const* in, const size_t* inlen,
+        size_t count)
+{
+    size_t i;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    if (out == NULL || in == NULL || inlen == NULL)
+    {
+        return -1;
+    }
+    for (i = 0; i < count; ++i)
+    {
+        if (in[i] == NULL && inlen[i] != 0)
+        {
+            return -1;
+        }
+    }
+
+    i = 0;
+#ifdef KECCAK_HAVE_AVX2
+    if (count >= 4 && __builtin_cpu_supports("avx2"))
+    {
+        while (i + 4 <= count)
+        {
+            const size_t blocks = inlen[i] / KECCAK_256_RATE;
+            if (inlen[i + 1] / KECCAK_256_RATE == blocks
+                    && inlen[i + 2] / KECCAK_256_RATE == blocks
+                    && inlen[i + 3] / KECCAK_256_RATE == blocks)
+            {
+                keccak_256_x4(out + KECCAK_256_SIZE * i, in + i, inlen + i);
+                i += 4;
+            }
+            else
+            {
+                keccak_256(out + KECCAK_256_SIZE * i, in[i], inlen[i]);
+                ++i;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        keccak_256(out + KECCAK_256_SIZE * i, in[i], inlen[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_SRC_KECCAK_F1600_H
+#define MULTY_CORE_SRC_KECCAK_F1600_H
+
+/** Optimized Keccak-f[1600] permutation, sponge and multi-buffer Keccak-256.
+ *
+ * Same results as keccak-tiny, which is kept as is in third-party, but faster:
+ * rounds are unrolled and use the lane complementing transform, and
+ * Keccak-256 of several inputs is computed 4 at a time with AVX2
+ * if CPU supports it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Size of Keccak-f[1600] state in bytes.
+#define KECCAK_F1600_STATE_SIZE 200
+
+/** Applies Keccak-f[1600] to the state in place.
+ * @param state - 25 lanes, lane (x, y) is state[x + 5 * y], little-endian.
+ */
+void keccak_f1600(uint64_t* state);
+
+/** Incremental Keccak sponge, input can be fed by parts.
+ * rate is (200 - bits / 4) bytes, delimiter is 0x06 for SHA3, 0x01 for Keccak.
+ * Sponge can't be used after squeeze without calling keccak_sponge_init().
+ */
+typedef struct keccak_sponge
+{
+    uint64_t state[25];
+    size_t offset;
+    size_t rate;
+    uint8_t delimiter;
+} keccak_sponge;
+
+void keccak_sponge_init(keccak_sponge* sponge, size_t rate, uint8_t delimiter);
+
+/** @return 0 on success, -1 on invalid arguments. */
+int keccak_sponge_absorb(keccak_sponge* sponge, const uint8_t* in, size_t inlen);
+
+/** Pads the input, writes outlen bytes of hash to out and wipes the state.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int keccak_sponge_squeeze(keccak_sponge* sponge, uint8_t* out, size_t outlen);
+
+/** Keccak-256 of count inputs at once.
+ * Consecutive inputs of similar size (like public keys) are hashed 4 at a time
+ * if CPU supports AVX2.
+ * @param out - must have room for count * 32 bytes.
+ * @param in - count inputs, input can be null if its length is 0.
+ * @param inlen - count input lengths.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int keccak_256_many(uint8_t* out,
+        const uint8_t* const* in, const size_t* inlen,
+        size_t count);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MULTY_CORE_SRC_KECCAK_F1600_H */
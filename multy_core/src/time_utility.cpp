@@ -0,0 +1,220 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/time_utility.h"
+
+#include "multy_core/error.h"
+
+#include "multy_core/src/error_utility.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+
+#include <stdint.h>
+
+namespace
+{
+const int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+// Floor division, rounds towards negative infinity.
+int64_t floor_div(int64_t value, int64_t divisor)
+{
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+// Conversions between days since 1970-01-01 and proleptic Gregorian calendar date.
+// Algorithms by Howard Hinnant: http://howardhinnant.github.io/date_algorithms.html
+int64_t days_from_civil(int64_t year, uint32_t month, uint32_t day)
+{
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = floor_div(year, 400);
+    const uint32_t year_of_era = static_cast<uint32_t>(year - era * 400);
+    const uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t day_of_era = year_of_era * 365 + year_of_era / 4
+            - year_of_era / 100 + day_of_year;
+
+    return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+void civil_from_days(int64_t days, int64_t* year, uint32_t* month, uint32_t* day)
+{
+    days += 719468;
+    const int64_t era = floor_div(days, 146097);
+    const uint32_t day_of_era = static_cast<uint32_t>(days - era * 146097);
+    const uint32_t year_of_era = (day_of_era - day_of_era / 1460
+            + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const uint32_t day_of_year = day_of_era
+            - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t month_index = (5 * day_of_year + 2) / 153;
+
+    *day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    *month = month_index < 10 ? month_index + 3 : month_index - 9;
+    *year = static_cast<int64_t>(year_of_era) + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+uint32_t days_in_month(int64_t year, uint32_t month)
+{
+    static const uint8_t DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool is_leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+
+    return DAYS[month - 1] + (month == 2 && is_leap ? 1 : 0);
+}
+
+// Reads exactly width decimal digits, returns false if any of chars is not a digit.
+bool read_digits(const char* str, size_t width, uint32_t* out)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < width; ++i)
+    {
+        const uint32_t digit = static_cast<uint32_t>(str[i]) - '0';
+        if (digit > 9)
+        {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    *out = value;
+
+    return true;
+}
+
+char* write_digits(char* out, uint32_t value, size_t width)
+{
+    for (size_t i = width; i > 0; --i)
+    {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+// Parses optional timezone designator, returns false if it is invalid.
+bool parse_utc_offset(const char* str, size_t len, int32_t* out_offset_seconds)
+{
+    *out_offset_seconds = 0;
+    if (len == 0 || (len == 1 && str[0] == 'Z'))
+    {
+        return true;
+    }
+
+    // "+HH:MM" or "+HHMM"
+    if ((len != 6 && len != 5) || (str[0] != '+' && str[0] != '-'))
+    {
+        return false;
+    }
+    const size_t minutes_pos = len == 6 ? 4 : 3;
+    uint32_t hours = 0;
+    uint32_t minutes = 0;
+    if (!read_digits(str + 1, 2, &hours)
+            || (len == 6 && str[3] != ':')
+            || !read_digits(str + minutes_pos, 2, &minutes)
+            || hours > 23 || minutes > 59)
+    {
+        return false;
+    }
+
+    const int32_t offset = static_cast<int32_t>(hours * 3600 + minutes * 60);
+    *out_offset_seconds = str[0] == '-' ? -offset : offset;
+
+    return true;
+}
+
+} // namespace
+
+namespace multy_core
+{
+namespace internal
+{
+
+std::time_t parse_iso8601_time(const char* str, size_t len)
+{
+    INVARIANT(str != nullptr);
+
+    uint32_t year = 0;
+    uint32_t month = 0;
+    uint32_t day = 0;
+    uint32_t hours = 0;
+    uint32_t minutes = 0;
+    uint32_t seconds = 0;
+    int32_t offset_seconds = 0;
+
+    // "YYYY-MM-DDTHH:MM:SS"
+    const bool is_valid = len >= ISO8601_TIME_LENGTH
+            && read_digits(str, 4, &year) && str[4] == '-'
+            && read_digits(str + 5, 2, &month) && str[7] == '-'
+            && read_digits(str + 8, 2, &day) && str[10] == 'T'
+            && read_digits(str + 11, 2, &hours) && str[13] == ':'
+            && read_digits(str + 14, 2, &minutes) && str[16] == ':'
+            && read_digits(str + 17, 2, &seconds)
+            && month >= 1 && month <= 12
+            && day >= 1 && day <= days_in_month(year, month)
+            && hours <= 23 && minutes <= 59 && seconds <= 59
+            && parse_utc_offset(str + ISO8601_TIME_LENGTH,
+                    len - ISO8601_TIME_LENGTH, &offset_seconds);
+    if (!is_valid)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT, "Invalid ISO8601 date/time value.")
+                << " Value: \"" << std::string(str, len) << "\".";
+    }
+
+    const int64_t result = days_from_civil(year, month, day) * SECONDS_PER_DAY
+            + hours * 3600 + minutes * 60 + seconds - offset_seconds;
+    if (static_cast<int64_t>(static_cast<std::time_t>(result)) != result)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "ISO8601 date/time value is out of range.")
+                << " Value: \"" << std::string(str, len) << "\".";
+    }
+
+    return static_cast<std::time_t>(result);
+}
+
+std::time_t parse_iso8601_time(const std::string& str)
+{
+    return parse_iso8601_time(str.data(), str.size());
+}
+
+void format_iso8601_time(std::time_t time, char* out)
+{
+    INVARIANT(out != nullptr);
+
+    const int64_t seconds = static_cast<int64_t>(time);
+    const int64_t days = floor_div(seconds, SECONDS_PER_DAY);
+    const uint32_t seconds_of_day = static_cast<uint32_t>(seconds - days * SECONDS_PER_DAY);
+
+    int64_t year = 0;
+    uint32_t month = 0;
+    uint32_t day = 0;
+    civil_from_days(days, &year, &month, &day);
+    if (year < 0 || year > 9999)
+    {
+        THROW_EXCEPTION2(ERROR_INVALID_ARGUMENT,
+                "Time is out of range of ISO8601 timestamp.")
+                << " Seconds since epoch: " << seconds;
+    }
+
+    out = write_digits(out, static_cast<uint32_t>(year), 4);
+    *out++ = '-';
+    out = write_digits(out, month, 2);
+    *out++ = '-';
+    out = write_digits(out, day, 2);
+    *out++ = 'T';
+    out = write_digits(out, seconds_of_day / 3600, 2);
+    *out++ = ':';
+    out = write_digits(out, seconds_of_day / 60 % 60, 2);
+    *out++ = ':';
+    write_digits(out, seconds_of_day % 60, 2);
+}
+
+std::string format_iso8601_time(std::time_t time)
+{
+    char buffer[ISO8601_TIME_LENGTH];
+    format_iso8601_time(time, buffer);
+
+    return std::string(buffer, sizeof(buffer));
+}
+
+} // namespace internal
+} // namespace multy_core
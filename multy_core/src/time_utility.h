@@ -0,0 +1,48 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#ifndef MULTY_CORE_TIME_UTILITY_H
+#define MULTY_CORE_TIME_UTILITY_H
+
+#include "multy_core/api.h"
+
+#include <ctime>
+#include <string>
+
+namespace multy_core
+{
+namespace internal
+{
+
+/** Fixed-format ISO-8601 timestamps: "YYYY-MM-DDTHH:MM:SS", always UTC.
+ *
+ * Calendar arithmetic is done directly, so results do not depend on
+ * locale or timezone of the process, and nothing is allocated.
+ */
+
+// Length of the formatted timestamp, without terminating null.
+const size_t ISO8601_TIME_LENGTH = 19;
+
+/** Parses timestamp, optionally followed by 'Z' or UTC offset like "+03:00" or "-0130".
+ *
+ * @param str - timestamp, not null-terminated.
+ * @param len - length of str.
+ * @return seconds since the epoch.
+ * @throw Exception with ERROR_INVALID_ARGUMENT if timestamp is invalid.
+ */
+MULTY_CORE_API std::time_t parse_iso8601_time(const char* str, size_t len);
+MULTY_CORE_API std::time_t parse_iso8601_time(const std::string& str);
+
+/** Writes exactly ISO8601_TIME_LENGTH chars into out, no terminating null.
+ *  @throw Exception with ERROR_INVALID_ARGUMENT if year is not in range [0, 9999].
+ */
+MULTY_CORE_API void format_iso8601_time(std::time_t time, char* out);
+MULTY_CORE_API std::string format_iso8601_time(std::time_t time);
+
+} // namespace internal
+} // namespace multy_core
+
+#endif // MULTY_CORE_TIME_UTILITY_H
@@ -7,6 +7,7 @@
 #include "multy_core/src/u_ptr.h"
 
 #include "multy_core/account.h"
+#include "multy_core/address_index.h"
 #include "multy_core/big_int.h"
 #include "multy_core/binary_data.h"
 #include "multy_core/common.h"
@@ -32,6 +33,11 @@ void UniversalDeleter::operator()(Account* account) const
     free_account(account);
 }
 
+void UniversalDeleter::operator()(AddressIndex* index) const
+{
+    free_address_index(index);
+}
+
 void UniversalDeleter::operator()(BigInt* amount) const
 {
     free_big_int(amount);
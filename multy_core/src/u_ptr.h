@@ -12,6 +12,7 @@
 #include <memory>
 
 struct Account;
+struct AddressIndex;
 struct BigInt;
 struct BinaryData;
 struct Error;
@@ -33,6 +34,7 @@ public:
     void operator()(char*) const;
     void operator()(const char*) const;
     void operator()(Account*) const;
+    void operator()(AddressIndex*) const;
     void operator()(BigInt*) const;
     void operator()(BinaryData*) const;
     void operator()(Error*) const;
@@ -48,6 +50,7 @@ template <typename T>
 using UPtr = std::unique_ptr<T, UniversalDeleter>;
 
 typedef UPtr<Account> AccountPtr;
+typedef UPtr<AddressIndex> AddressIndexPtr;
 typedef UPtr<BigInt> BigIntPtr;
 typedef UPtr<BinaryData> BinaryDataPtr;
 typedef UPtr<char> CharPtr;
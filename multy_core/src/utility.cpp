@@ -19,9 +19,12 @@
 #include "wally_core.h"
 
 #include <cassert>
+#include <exception>
 #include <string>
 #include <string.h>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -83,6 +86,42 @@ char* copy_string(const char* str)
     return new_message;
 }
 
+FixedSizeBinaryDataWriter::FixedSizeBinaryDataWriter(size_t size)
+    : m_data(),
+      m_offset(0)
+{
+    throw_if_error(make_binary_data(size, reset_sp(m_data)));
+}
+
+void FixedSizeBinaryDataWriter::write_data(const void* data, size_t len)
+{
+    INVARIANT(m_data != nullptr);
+    if (len > m_data->len - m_offset)
+    {
+        THROW_EXCEPTION("Attempt to write past the end of the buffer.")
+                << " Size: " << m_data->len << ", offset: " << m_offset
+                << ", length: " << len;
+    }
+    if (len != 0)
+    {
+        INVARIANT(data != nullptr);
+        memcpy(const_cast<unsigned char*>(m_data->data) + m_offset, data, len);
+        m_offset += len;
+    }
+}
+
+BinaryDataPtr FixedSizeBinaryDataWriter::release()
+{
+    INVARIANT(m_data != nullptr);
+    if (m_offset != m_data->len)
+    {
+        THROW_EXCEPTION("Not all of the buffer was written.")
+                << " Size: " << m_data->len << ", written: " << m_offset;
+    }
+    m_offset = 0;
+    return std::move(m_data);
+}
+
 bool operator==(const BlockchainType& left, const BlockchainType& right)
 {
     return left.blockchain == right.blockchain
@@ -172,5 +211,85 @@ void trim_excess_trailing_null(std::string* str)
     }
 }
 
+void parallel_for(size_t count, size_t min_items_per_thread,
+        size_t max_threads_count,
+        const std::function<void(size_t begin, size_t end)>& process)
+{
+    INVARIANT(min_items_per_thread > 0);
+
+    if (max_threads_count == 0)
+    {
+        max_threads_count = std::thread::hardware_concurrency();
+    }
+    const size_t threads_count = std::max<size_t>(1,
+            std::min(max_threads_count, count / min_items_per_thread));
+    if (threads_count == 1)
+    {
+        process(0, count);
+        return;
+    }
+
+    // Last range is processed on the current thread.
+    const size_t range_size = (count + threads_count - 1) / threads_count;
+    std::vector<std::exception_ptr> errors(threads_count);
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        const size_t begin = std::min(count, t * range_size);
+        const size_t end = std::min(count, begin + range_size);
+        auto run = [&process, &errors, t, begin, end]()
+        {
+            try
+            {
+                process(begin, end);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        if (t + 1 < threads_count)
+        {
+            try
+            {
+                threads.emplace_back(run);
+            }
+            catch (...)
+            {
+                // Failed to start a thread, can't leave already started ones running.
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                throw;
+            }
+        }
+        else
+        {
+            run();
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void parallel_for(size_t count, size_t min_items_per_thread,
+        const std::function<void(size_t begin, size_t end)>& process)
+{
+    parallel_for(count, min_items_per_thread, 0, process);
+}
+
 } // namespace internal
 } // namespace multy_core
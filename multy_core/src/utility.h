@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -141,6 +142,27 @@ inline BinaryDataPtr make_clone(const BinaryData& other)
     return result;
 }
 
+/** Writes data into BinaryData that is allocated only once, with exact size.
+ *
+ * Size must be known beforehand, e.g. computed by a counting pass over the
+ * same data, hence there are no reallocations and no copying of the result.
+ */
+class MULTY_CORE_API FixedSizeBinaryDataWriter
+{
+public:
+    explicit FixedSizeBinaryDataWriter(size_t size);
+
+    // Throws exception if there is not enough room left.
+    void write_data(const void* data, size_t len);
+
+    // Throws exception if written data is smaller than the size.
+    BinaryDataPtr release();
+
+private:
+    BinaryDataPtr m_data;
+    size_t m_offset;
+};
+
 // Gets minimum number of bytes required to represent integer value.
 template <typename T>
 size_t get_bytes_len(T value)
@@ -185,6 +207,21 @@ MULTY_CORE_API std::string to_string(GolosNetType net_type);
 // remove excess '\0' chars at end of string.
 void trim_excess_trailing_null(std::string* str);
 
+/** Calls process(begin, end) for subranges of [0, count) on several threads.
+ *
+ * Number of threads is limited by max_threads_count (0 means hardware
+ * concurrency) and by min_items_per_thread, so small ranges are processed
+ * on the calling thread, which always does its share of work too.
+ * Returns when all subranges are processed, rethrows first exception if any.
+ */
+MULTY_CORE_API void parallel_for(size_t count, size_t min_items_per_thread,
+        size_t max_threads_count,
+        const std::function<void(size_t begin, size_t end)>& process);
+
+/// Same as above, limited by hardware concurrency only.
+MULTY_CORE_API void parallel_for(size_t count, size_t min_items_per_thread,
+        const std::function<void(size_t begin, size_t end)>& process);
+
 } // namespace internal
 } // namespace multy_core
 
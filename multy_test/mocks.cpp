@@ -7,6 +7,9 @@
 #include "multy_test/mocks.h"
 #include "multy_test/utility.h"
 
+#include "multy_core/src/exception.h"
+#include "multy_core/src/exception_stream.h"
+
 namespace
 {
 using namespace multy_core::internal;
@@ -125,6 +128,14 @@ ExtendedKeyPtr TestHDAccount::get_account_key() const
     return make_clone(test_utility::make_dummy_extended_key());
 }
 
+void TestHDAccount::derive_address_hashes(AddressType /*type*/,
+        uint32_t /*first_index*/, size_t /*count*/,
+        unsigned char* /*out_hashes*/) const
+{
+    THROW_EXCEPTION2(ERROR_FEATURE_NOT_SUPPORTED,
+            "TestHDAccount has no address hashes.");
+}
+
 TestTransaction::TestTransaction(const BigInt& total_value)
     : m_total(total_value),
       m_properties(ERROR_SCOPE_TRANSACTION, "TestTransaction")
@@ -81,6 +81,8 @@ struct TestHDAccount : public HDAccount
     AccountPtr make_leaf_account(
             AddressType type, uint32_t index) const override;
     ExtendedKeyPtr get_account_key() const override;
+    void derive_address_hashes(AddressType type, uint32_t first_index,
+            size_t count, unsigned char* out_hashes) const override;
 
 private:
     const BlockchainType m_blockchain_type;
@@ -10,6 +10,8 @@
 #include "multy_core/common.h"
 #include "multy_core/src/api/account_impl.h"
 #include "multy_core/src/api/key_impl.h"
+#include "multy_core/src/binary_data_utility.h"
+#include "multy_core/src/ec_key_utils.h"
 #include "multy_core/src/u_ptr.h"
 
 #include "multy_test/bip39_test_cases.h"
@@ -18,6 +20,8 @@
 #include "multy_test/value_printers.h"
 #include "multy_test/supported_blockchains.h"
 
+#include "wally_crypto.h"
+
 #include "gtest/gtest.h"
 
 #include <memory>
@@ -291,6 +295,385 @@ TEST_P(AccountTestBlockchainSupportP, create_and_check_account_from_hd_account)
     //    }
 }
 
+TEST_P(AccountTestBlockchainSupportP, leaf_accounts_with_cached_chain_keys)
+{
+    // Chain keys are cached by the HD account, leaf accounts must match
+    // keys derived explicitly from master key: m/44'/coin'/0'/type/index.
+    const ExtendedKey master_key = make_dummy_extended_key();
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            &master_key,
+            GetParam(),
+            ACCOUNT_TYPE_DEFAULT,
+            0,
+            reset_sp(root_account)));
+
+    // Coin type depends on blockchain and net type, taken as is from the path.
+    const HDPath root_path = root_account->get_path();
+    ASSERT_EQ(3, root_path.size());
+    const uint32_t coin_type = root_path[1];
+
+    const ExtendedKeyPtr account_key = make_child_key(
+            *make_child_key(
+                    *make_child_key(master_key, hardened_index(44)),
+                    coin_type),
+            hardened_index(0));
+
+    for (const AddressType type : {ADDRESS_EXTERNAL, ADDRESS_INTERNAL})
+    {
+        for (const uint32_t index : {0, 1, 0, 1000})
+        {
+            SCOPED_TRACE(type);
+            SCOPED_TRACE(index);
+
+            const ExtendedKeyPtr expected_key = make_child_key(
+                    *make_child_key(*account_key, type), index);
+            const BinaryData expected_private_key = slice(
+                    as_binary_data(expected_key->key.priv_key),
+                    1, EC_PRIVATE_KEY_LEN);
+
+            const AccountPtr account = root_account->make_leaf_account(type, index);
+            const PublicKeyPtr public_key = account->get_public_key();
+            const BinaryData actual_public_key = public_key->get_content();
+
+            // Blockchains use either compressed or uncompressed public key,
+            // Ethereum also drops the 0x04 prefix of the uncompressed one.
+            std::vector<unsigned char> expected_public_key(
+                    actual_public_key.len == EC_PUBLIC_KEY_LEN
+                    ? EC_PUBLIC_KEY_LEN : EC_PUBLIC_KEY_UNCOMPRESSED_LEN);
+            BinaryData expected_public_key_data = as_binary_data(expected_public_key);
+            ec_private_to_public_key(expected_private_key,
+                    actual_public_key.len == EC_PUBLIC_KEY_LEN
+                    ? EC_PUBLIC_KEY_COMPRESSED : EC_PUBLIC_KEY_UNCOMPRESSED,
+                    &expected_public_key_data);
+            if (actual_public_key.len == EC_PUBLIC_KEY_UNCOMPRESSED_LEN - 1)
+            {
+                expected_public_key.erase(expected_public_key.begin());
+            }
+
+            EXPECT_EQ(as_binary_data(expected_public_key), actual_public_key);
+
+            const HDPath expected_path = {hardened_index(44), coin_type,
+                    hardened_index(0), static_cast<uint32_t>(type), index};
+            EXPECT_EQ(expected_path, account->get_path());
+        }
+    }
+}
+
+TEST_P(AccountTestBlockchainSupportP, derive_addresses)
+{
+    const ExtendedKey master_key = make_dummy_extended_key();
+    const uint32_t FIRST_INDEX = 5;
+    const size_t COUNT = 10;
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            &master_key,
+            GetParam(),
+            ACCOUNT_TYPE_DEFAULT,
+            0,
+            reset_sp(root_account)));
+
+    std::vector<const char*> addresses(COUNT, nullptr);
+    if (GetParam().blockchain == BLOCKCHAIN_GOLOS)
+    {
+        // Golos accounts have no addresses.
+        EXPECT_ERROR(hd_account_derive_addresses(root_account.get(),
+                ADDRESS_EXTERNAL, FIRST_INDEX, COUNT, addresses.data()));
+        EXPECT_EQ(std::vector<const char*>(COUNT, nullptr), addresses);
+        return;
+    }
+
+    for (const AddressType type : {ADDRESS_EXTERNAL, ADDRESS_INTERNAL})
+    {
+        SCOPED_TRACE(type);
+        HANDLE_ERROR(hd_account_derive_addresses(root_account.get(),
+                type, FIRST_INDEX, COUNT, addresses.data()));
+
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            SCOPED_TRACE(i);
+            ConstCharPtr address(addresses[i]);
+
+            AccountPtr account;
+            HANDLE_ERROR(make_hd_leaf_account(root_account.get(), type,
+                    FIRST_INDEX + static_cast<uint32_t>(i), reset_sp(account)));
+            ConstCharPtr expected_address;
+            HANDLE_ERROR(account_get_address_string(account.get(),
+                    reset_sp(expected_address)));
+
+            ASSERT_NE(nullptr, address);
+            EXPECT_STREQ(expected_address.get(), address.get());
+        }
+    }
+}
+
+GTEST_TEST(AccountTest, derive_addresses_large_range)
+{
+    // Large enough to be split between threads.
+    const ExtendedKey master_key = make_dummy_extended_key();
+    const uint32_t FIRST_INDEX = 100;
+    const size_t COUNT = 5000;
+
+    const struct
+    {
+        BlockchainType blockchain_type;
+        uint32_t account_type;
+    } TEST_CASES[] = {
+        {BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_P2PKH},
+        {BITCOIN_TEST_NET, BITCOIN_ACCOUNT_SEGWIT},
+        {ETHEREUM_MAIN_NET, ACCOUNT_TYPE_DEFAULT},
+    };
+
+    for (const auto& test_case : TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.blockchain_type.blockchain);
+        SCOPED_TRACE(test_case.blockchain_type.net_type);
+        SCOPED_TRACE(test_case.account_type);
+
+        HDAccountPtr root_account;
+        HANDLE_ERROR(make_hd_account(
+                &master_key,
+                test_case.blockchain_type,
+                test_case.account_type,
+                0,
+                reset_sp(root_account)));
+
+        std::vector<const char*> raw_addresses(COUNT, nullptr);
+        HANDLE_ERROR(hd_account_derive_addresses(root_account.get(),
+                ADDRESS_EXTERNAL, FIRST_INDEX, COUNT, raw_addresses.data()));
+        std::vector<ConstCharPtr> addresses(raw_addresses.begin(), raw_addresses.end());
+
+        // Checking some indices from every range, and the last one.
+        for (size_t i = 0; i < COUNT; i += 97)
+        {
+            SCOPED_TRACE(i);
+            const AccountPtr account = root_account->make_leaf_account(
+                    ADDRESS_EXTERNAL, FIRST_INDEX + static_cast<uint32_t>(i));
+
+            ASSERT_NE(nullptr, addresses[i]);
+            EXPECT_EQ(account->get_address(), addresses[i].get());
+        }
+        const AccountPtr last_account = root_account->make_leaf_account(
+                ADDRESS_EXTERNAL, FIRST_INDEX + COUNT - 1);
+        EXPECT_EQ(last_account->get_address(), addresses.back().get());
+    }
+}
+
+GTEST_TEST(AccountTestInvalidArgs, hd_account_derive_addresses)
+{
+    const ExtendedKey master_key = make_dummy_extended_key();
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            &master_key,
+            BITCOIN_MAIN_NET,
+            ACCOUNT_TYPE_DEFAULT,
+            0,
+            reset_sp(root_account)));
+
+    const char* addresses[2] = {nullptr, nullptr};
+    EXPECT_ERROR(hd_account_derive_addresses(nullptr,
+            ADDRESS_EXTERNAL, 0, 2, addresses));
+    EXPECT_ERROR(hd_account_derive_addresses(root_account.get(),
+            static_cast<AddressType>(-1), 0, 2, addresses));
+    EXPECT_ERROR(hd_account_derive_addresses(root_account.get(),
+            ADDRESS_EXTERNAL, HARDENED_INDEX_BASE, 1, addresses));
+    EXPECT_ERROR(hd_account_derive_addresses(root_account.get(),
+            ADDRESS_EXTERNAL, HARDENED_INDEX_BASE - 1, 2, addresses));
+    EXPECT_ERROR(hd_account_derive_addresses(root_account.get(),
+            ADDRESS_EXTERNAL, 0, 2, nullptr));
+    EXPECT_EQ(nullptr, addresses[0]);
+    EXPECT_EQ(nullptr, addresses[1]);
+
+    // Empty range is fine.
+    HANDLE_ERROR(hd_account_derive_addresses(root_account.get(),
+            ADDRESS_EXTERNAL, 0, 0, nullptr));
+}
+
+std::string get_key_string(const Account& account, KeyType key_type)
+{
+    KeyPtr key;
+    throw_if_error(account_get_key(&account, key_type, reset_sp(key)));
+
+    ConstCharPtr key_string;
+    throw_if_error(key_to_string(key.get(), reset_sp(key_string)));
+
+    return key_string.get();
+}
+
+ExtendedKeyPtr make_test_master_key()
+{
+    // Seed from BIP32 test vector 1.
+    const bytes seed = from_hex("000102030405060708090a0b0c0d0e0f");
+    const BinaryData seed_data = as_binary_data(seed);
+
+    ExtendedKeyPtr master_key;
+    throw_if_error(make_master_key(&seed_data, reset_sp(master_key)));
+
+    return master_key;
+}
+
+void check_watch_only_hd_account(BlockchainType blockchain_type, uint32_t account_type)
+{
+    const ExtendedKeyPtr master_key = make_test_master_key();
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            master_key.get(),
+            blockchain_type,
+            account_type,
+            1,
+            reset_sp(root_account)));
+
+    ConstCharPtr account_public_key;
+    HANDLE_ERROR(hd_account_get_public_key_string(
+            root_account.get(), reset_sp(account_public_key)));
+    ASSERT_NE(nullptr, account_public_key);
+    EXPECT_EQ("xpub", std::string(account_public_key.get(), 4));
+
+    HDAccountPtr watch_only_account;
+    HANDLE_ERROR(make_watch_only_hd_account(
+            account_public_key.get(),
+            blockchain_type,
+            account_type,
+            reset_sp(watch_only_account)));
+    ASSERT_NE(nullptr, watch_only_account);
+
+    EXPECT_EQ(root_account->get_path(), watch_only_account->get_path());
+    EXPECT_EQ(blockchain_type, watch_only_account->get_blockchain_type());
+
+    // Public key of watch-only account is the same.
+    ConstCharPtr watch_only_public_key;
+    HANDLE_ERROR(hd_account_get_public_key_string(
+            watch_only_account.get(), reset_sp(watch_only_public_key)));
+    EXPECT_STREQ(account_public_key.get(), watch_only_public_key.get());
+
+    for (const AddressType type : {ADDRESS_EXTERNAL, ADDRESS_INTERNAL})
+    {
+        SCOPED_TRACE(type);
+        for (const uint32_t index : {0, 1, 1000})
+        {
+            SCOPED_TRACE(index);
+
+            AccountPtr expected_account;
+            HANDLE_ERROR(make_hd_leaf_account(
+                    root_account.get(), type, index, reset_sp(expected_account)));
+            AccountPtr account;
+            HANDLE_ERROR(make_hd_leaf_account(
+                    watch_only_account.get(), type, index, reset_sp(account)));
+            ASSERT_NE(nullptr, account);
+
+            EXPECT_EQ(expected_account->get_address(), account->get_address());
+            EXPECT_EQ(expected_account->get_path(), account->get_path());
+            EXPECT_EQ(expected_account->get_blockchain_type(),
+                    account->get_blockchain_type());
+            EXPECT_EQ(get_key_string(*expected_account, KEY_TYPE_PUBLIC),
+                    get_key_string(*account, KEY_TYPE_PUBLIC));
+
+            KeyPtr private_key;
+            EXPECT_ERROR(account_get_key(
+                    account.get(), KEY_TYPE_PRIVATE, reset_sp(private_key)));
+            EXPECT_EQ(nullptr, private_key);
+        }
+
+        EXPECT_EQ(root_account->derive_addresses(type, 10, 20),
+                watch_only_account->derive_addresses(type, 10, 20));
+    }
+}
+
+TEST_P(AccountTestBlockchainSupportP, watch_only_hd_account)
+{
+    if (GetParam().blockchain == BLOCKCHAIN_GOLOS)
+    {
+        // Golos accounts have no addresses, hence nothing to watch.
+        const ExtendedKey master_key = make_dummy_extended_key();
+        HDAccountPtr root_account;
+        HANDLE_ERROR(make_hd_account(
+                &master_key,
+                GetParam(),
+                ACCOUNT_TYPE_DEFAULT,
+                0,
+                reset_sp(root_account)));
+
+        ConstCharPtr account_public_key;
+        HANDLE_ERROR(hd_account_get_public_key_string(
+                root_account.get(), reset_sp(account_public_key)));
+
+        HDAccountPtr watch_only_account;
+        EXPECT_ERROR(make_watch_only_hd_account(
+                account_public_key.get(),
+                GetParam(),
+                ACCOUNT_TYPE_DEFAULT,
+                reset_sp(watch_only_account)));
+        EXPECT_EQ(nullptr, watch_only_account);
+        return;
+    }
+
+    check_watch_only_hd_account(GetParam(), ACCOUNT_TYPE_DEFAULT);
+}
+
+GTEST_TEST(AccountTest, watch_only_hd_account_bitcoin_segwit)
+{
+    check_watch_only_hd_account(BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_SEGWIT);
+    check_watch_only_hd_account(BITCOIN_TEST_NET, BITCOIN_ACCOUNT_SEGWIT);
+}
+
+GTEST_TEST(AccountTestInvalidArgs, make_watch_only_hd_account)
+{
+    const ExtendedKeyPtr master_key = make_test_master_key();
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            master_key.get(),
+            BITCOIN_MAIN_NET,
+            ACCOUNT_TYPE_DEFAULT,
+            0,
+            reset_sp(root_account)));
+    const std::string account_private_key = root_account->get_account_key()->to_string();
+    const std::string purpose_public_key = make_public_extended_key(
+            *make_child_key(*master_key, hardened_index(44)))->to_string();
+
+    const char* INVALID_KEYS[] = {
+        "",
+        "foo-bar-yadda-yadda",
+        // Private keys are not accepted.
+        account_private_key.c_str(),
+        // Not an account key.
+        purpose_public_key.c_str(),
+    };
+
+    for (const char* key : INVALID_KEYS)
+    {
+        SCOPED_TRACE(key);
+        HDAccountPtr account;
+        EXPECT_ERROR(make_watch_only_hd_account(
+                key, BITCOIN_MAIN_NET, ACCOUNT_TYPE_DEFAULT, reset_sp(account)));
+        EXPECT_EQ(nullptr, account);
+    }
+
+    ConstCharPtr account_public_key;
+    HANDLE_ERROR(hd_account_get_public_key_string(
+            root_account.get(), reset_sp(account_public_key)));
+
+    HDAccountPtr account;
+    EXPECT_ERROR(make_watch_only_hd_account(
+            nullptr, BITCOIN_MAIN_NET, ACCOUNT_TYPE_DEFAULT, reset_sp(account)));
+    EXPECT_ERROR(make_watch_only_hd_account(
+            account_public_key.get(), BITCOIN_MAIN_NET, ACCOUNT_TYPE_DEFAULT, nullptr));
+    EXPECT_ERROR(make_watch_only_hd_account(
+            account_public_key.get(), INVALID_BLOCKCHAIN_TYPE,
+            ACCOUNT_TYPE_DEFAULT, reset_sp(account)));
+    EXPECT_ERROR(make_watch_only_hd_account(
+            account_public_key.get(), BITCOIN_MAIN_NET,
+            INVALID_ACCOUNT_TYPE, reset_sp(account)));
+    EXPECT_EQ(nullptr, account);
+
+    EXPECT_ERROR(hd_account_get_public_key_string(nullptr, reset_sp(account_public_key)));
+    EXPECT_ERROR(hd_account_get_public_key_string(root_account.get(), nullptr));
+}
+
 GTEST_TEST(AccountTest, unique_private_keys)
 {
     // Verify that keys for accounts of different blockchains are diffrent.
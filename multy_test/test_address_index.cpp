@@ -0,0 +1,461 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/address_index.h"
+
+#include "multy_core/account.h"
+#include "multy_core/binary_data.h"
+#include "multy_core/bitcoin.h"
+#include "multy_core/key.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/address_index_impl.h"
+#include "multy_core/src/bitcoin/bitcoin_account.h"
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/u_ptr.h"
+
+#include "multy_test/supported_blockchains.h"
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+struct AddressIndexTestCase
+{
+    BlockchainType blockchain_type;
+    uint32_t account_type;
+};
+
+const AddressIndexTestCase ADDRESS_INDEX_TEST_CASES[] =
+{
+    {BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_P2PKH},
+    {BITCOIN_TEST_NET, BITCOIN_ACCOUNT_P2PKH},
+    {BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_SEGWIT},
+    {BITCOIN_TEST_NET, BITCOIN_ACCOUNT_SEGWIT},
+    {ETHEREUM_MAIN_NET, 0},
+};
+
+HDAccountPtr make_test_hd_account(BlockchainType blockchain_type,
+        uint32_t account_type, uint32_t index)
+{
+    // Seed from BIP32 test vector 1.
+    const bytes seed = from_hex("000102030405060708090a0b0c0d0e0f");
+    const BinaryData seed_data = as_binary_data(seed);
+
+    ExtendedKeyPtr master_key;
+    throw_if_error(make_master_key(&seed_data, reset_sp(master_key)));
+
+    HDAccountPtr hd_account;
+    throw_if_error(make_hd_account(master_key.get(), blockchain_type,
+            account_type, index, reset_sp(hd_account)));
+
+    return hd_account;
+}
+
+BinaryDataPtr get_address_hash(const HDAccount& hd_account,
+        AddressType address_type, uint32_t index)
+{
+    AccountPtr account;
+    throw_if_error(make_hd_leaf_account(&hd_account, address_type, index,
+            reset_sp(account)));
+
+    const std::string address = account->get_address();
+    if (hd_account.get_blockchain_type().blockchain == BLOCKCHAIN_ETHEREUM)
+    {
+        return ethereum_parse_address(address.c_str());
+    }
+
+    BitcoinNetType net_type;
+    BitcoinAddressType bitcoin_address_type;
+    return bitcoin_parse_address(address.c_str(), &net_type, &bitcoin_address_type);
+}
+
+std::string make_temp_file_path(const char* name)
+{
+    return std::string("/tmp/multy_test_address_index_") + name;
+}
+
+void write_file(const std::string& file_path, const std::string& content)
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+}
+
+std::string read_file(const std::string& file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+class AddressIndexTestP : public ::testing::TestWithParam<AddressIndexTestCase>
+{
+};
+
+INSTANTIATE_TEST_CASE_P(
+        AddressIndex,
+        AddressIndexTestP,
+        ::testing::ValuesIn(ADDRESS_INDEX_TEST_CASES));
+
+TEST_P(AddressIndexTestP, find)
+{
+    const AddressIndexTestCase& param = GetParam();
+    SCOPED_TRACE(param.blockchain_type.blockchain);
+    SCOPED_TRACE(param.blockchain_type.net_type);
+    SCOPED_TRACE(param.account_type);
+
+    const uint32_t ACCOUNT_IDS[] = {7, 0};
+    const size_t ADDRESS_COUNT = 50;
+
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+
+    std::vector<HDAccountPtr> hd_accounts;
+    for (const uint32_t account_id : ACCOUNT_IDS)
+    {
+        hd_accounts.push_back(make_test_hd_account(param.blockchain_type,
+                param.account_type, account_id));
+
+        for (const AddressType address_type : {ADDRESS_EXTERNAL, ADDRESS_INTERNAL})
+        {
+            HANDLE_ERROR(address_index_add_hd_account_addresses(index.get(),
+                    account_id, hd_accounts.back().get(), address_type,
+                    0, ADDRESS_COUNT));
+        }
+    }
+
+    size_t size = 0;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(2 * 2 * ADDRESS_COUNT, size);
+
+    for (size_t i = 0; i < hd_accounts.size(); ++i)
+    {
+        for (const AddressType address_type : {ADDRESS_EXTERNAL, ADDRESS_INTERNAL})
+        {
+            for (const uint32_t leaf_index : {0, 1, 25, 49})
+            {
+                SCOPED_TRACE(leaf_index);
+                const BinaryDataPtr address_hash = get_address_hash(
+                        *hd_accounts[i], address_type, leaf_index);
+                ASSERT_EQ(ADDRESS_HASH_SIZE, address_hash->len);
+
+                bool found = false;
+                AddressIndexLeaf leaf;
+                HANDLE_ERROR(address_index_find(index.get(), address_hash.get(),
+                        &found, &leaf));
+                ASSERT_TRUE(found);
+                EXPECT_EQ(ACCOUNT_IDS[i], leaf.account_id);
+                EXPECT_EQ(address_type, leaf.address_type);
+                EXPECT_EQ(leaf_index, leaf.index);
+            }
+        }
+    }
+
+    // Leaves that were not added are not found.
+    const BinaryDataPtr missing_hash = get_address_hash(
+            *hd_accounts[0], ADDRESS_EXTERNAL, ADDRESS_COUNT);
+    bool found = true;
+    AddressIndexLeaf leaf;
+    HANDLE_ERROR(address_index_find(index.get(), missing_hash.get(), &found, &leaf));
+    EXPECT_FALSE(found);
+}
+
+GTEST_TEST(AddressIndexTest, empty)
+{
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+
+    size_t size = 1;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(0, size);
+
+    const bytes hash(ADDRESS_HASH_SIZE, 0);
+    const BinaryData hash_data = as_binary_data(hash);
+    bool found = true;
+    AddressIndexLeaf leaf;
+    HANDLE_ERROR(address_index_find(index.get(), &hash_data, &found, &leaf));
+    EXPECT_FALSE(found);
+}
+
+GTEST_TEST(AddressIndexTest, incremental_growth)
+{
+    // Index is extended as gap limit advances, 20 addresses at a time,
+    // same leaves can be added again.
+    const HDAccountPtr hd_account = make_test_hd_account(
+            BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_P2PKH, 0);
+    const size_t GAP_LIMIT = 20;
+    const size_t STEPS = 50;
+
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+    for (size_t step = 0; step < STEPS; ++step)
+    {
+        HANDLE_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+                hd_account.get(), ADDRESS_EXTERNAL,
+                static_cast<uint32_t>(step * GAP_LIMIT / 2), GAP_LIMIT));
+    }
+
+    size_t size = 0;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ((STEPS + 1) * GAP_LIMIT / 2, size);
+
+    for (uint32_t leaf_index = 0; leaf_index < size; leaf_index += 17)
+    {
+        SCOPED_TRACE(leaf_index);
+        const BinaryDataPtr address_hash = get_address_hash(
+                *hd_account, ADDRESS_EXTERNAL, leaf_index);
+
+        bool found = false;
+        AddressIndexLeaf leaf;
+        HANDLE_ERROR(address_index_find(index.get(), address_hash.get(),
+                &found, &leaf));
+        ASSERT_TRUE(found);
+        EXPECT_EQ(1, leaf.account_id);
+        EXPECT_EQ(ADDRESS_EXTERNAL, leaf.address_type);
+        EXPECT_EQ(leaf_index, leaf.index);
+    }
+}
+
+GTEST_TEST(AddressIndexTest, add_replaces_leaf)
+{
+    const bytes hash = from_hex("00112233445566778899aabbccddeeff00112233");
+
+    AddressIndex index;
+    index.add(hash.data(), AddressIndexLeaf{1, ADDRESS_EXTERNAL, 10});
+    index.add(hash.data(), AddressIndexLeaf{2, ADDRESS_INTERNAL, 20});
+    EXPECT_EQ(1, index.size());
+
+    AddressIndexLeaf leaf;
+    ASSERT_TRUE(index.find(hash.data(), &leaf));
+    EXPECT_EQ(2, leaf.account_id);
+    EXPECT_EQ(ADDRESS_INTERNAL, leaf.address_type);
+    EXPECT_EQ(20, leaf.index);
+
+    EXPECT_THROW(index.add(hash.data(),
+            AddressIndexLeaf{AddressIndex::EMPTY_ACCOUNT_ID, ADDRESS_EXTERNAL, 0}),
+            Exception);
+    EXPECT_THROW(index.add(hash.data(),
+            AddressIndexLeaf{1, static_cast<AddressType>(2), 0}),
+            Exception);
+    EXPECT_THROW(index.add(hash.data(),
+            AddressIndexLeaf{1, ADDRESS_EXTERNAL, 0x80000000}),
+            Exception);
+    EXPECT_EQ(1, index.size());
+}
+
+GTEST_TEST(AddressIndexTest, save_and_load)
+{
+    const std::string file_path = make_temp_file_path("save_and_load");
+    const HDAccountPtr hd_account = make_test_hd_account(
+            ETHEREUM_MAIN_NET, 0, 0);
+    const size_t ADDRESS_COUNT = 100;
+
+    {
+        AddressIndexPtr index;
+        HANDLE_ERROR(make_address_index(reset_sp(index)));
+        HANDLE_ERROR(address_index_add_hd_account_addresses(index.get(), 5,
+                hd_account.get(), ADDRESS_INTERNAL, 0, ADDRESS_COUNT));
+        HANDLE_ERROR(address_index_save(index.get(), file_path.c_str()));
+    }
+
+    const BinaryDataPtr first_hash = get_address_hash(
+            *hd_account, ADDRESS_INTERNAL, 0);
+    const BinaryDataPtr next_hash = get_address_hash(
+            *hd_account, ADDRESS_INTERNAL, ADDRESS_COUNT);
+
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    size_t size = 0;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(ADDRESS_COUNT, size);
+
+    bool found = false;
+    AddressIndexLeaf leaf;
+    HANDLE_ERROR(address_index_find(index.get(), first_hash.get(), &found, &leaf));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(5, leaf.account_id);
+    EXPECT_EQ(ADDRESS_INTERNAL, leaf.address_type);
+    EXPECT_EQ(0, leaf.index);
+
+    HANDLE_ERROR(address_index_find(index.get(), next_hash.get(), &found, &leaf));
+    EXPECT_FALSE(found);
+
+    // Loaded index can be extended and saved over the file it was loaded from.
+    HANDLE_ERROR(address_index_add_hd_account_addresses(index.get(), 5,
+            hd_account.get(), ADDRESS_INTERNAL, ADDRESS_COUNT, ADDRESS_COUNT));
+    HANDLE_ERROR(address_index_save(index.get(), file_path.c_str()));
+    index.reset();
+
+    HANDLE_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(2 * ADDRESS_COUNT, size);
+
+    HANDLE_ERROR(address_index_find(index.get(), next_hash.get(), &found, &leaf));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(ADDRESS_COUNT, leaf.index);
+    HANDLE_ERROR(address_index_find(index.get(), first_hash.get(), &found, &leaf));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(0, leaf.index);
+
+    index.reset();
+    std::remove(file_path.c_str());
+}
+
+GTEST_TEST(AddressIndexTest, save_and_load_empty)
+{
+    const std::string file_path = make_temp_file_path("save_and_load_empty");
+
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+    HANDLE_ERROR(address_index_save(index.get(), file_path.c_str()));
+
+    HANDLE_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+    size_t size = 1;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(0, size);
+
+    index.reset();
+    std::remove(file_path.c_str());
+}
+
+GTEST_TEST(AddressIndexTest, load_invalid_file)
+{
+    const std::string file_path = make_temp_file_path("load_invalid_file");
+    AddressIndexPtr index;
+
+    EXPECT_ERROR(make_address_index_from_file(
+            make_temp_file_path("does_not_exist").c_str(), reset_sp(index)));
+
+    write_file(file_path, "");
+    EXPECT_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    write_file(file_path, "not an address index file at all, but long enough");
+    EXPECT_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    // Make a valid file and break it in various ways.
+    {
+        AddressIndex valid_index;
+        const bytes hash(ADDRESS_HASH_SIZE, 0xAB);
+        valid_index.add(hash.data(), AddressIndexLeaf{1, ADDRESS_EXTERNAL, 1});
+        valid_index.save(file_path.c_str());
+    }
+    const std::string valid_content = read_file(file_path);
+    ASSERT_LT(40, valid_content.size());
+    HANDLE_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    // Truncated.
+    write_file(file_path, valid_content.substr(0, valid_content.size() - 1));
+    EXPECT_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    // Extra data at the end.
+    write_file(file_path, valid_content + '\0');
+    EXPECT_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+
+    // Bad magic, version or size.
+    for (const size_t offset : {0, 12, 32})
+    {
+        SCOPED_TRACE(offset);
+        std::string content = valid_content;
+        content[offset] ^= 0x01;
+        write_file(file_path, content);
+        EXPECT_ERROR(make_address_index_from_file(file_path.c_str(), reset_sp(index)));
+    }
+
+    std::remove(file_path.c_str());
+}
+
+GTEST_TEST(AddressIndexTestInvalidArgs, make_address_index)
+{
+    EXPECT_ERROR(make_address_index(nullptr));
+
+    AddressIndexPtr index;
+    EXPECT_ERROR(make_address_index_from_file(nullptr, reset_sp(index)));
+    EXPECT_ERROR(make_address_index_from_file("", nullptr));
+}
+
+GTEST_TEST(AddressIndexTestInvalidArgs, address_index_add_hd_account_addresses)
+{
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+    const HDAccountPtr hd_account = make_test_hd_account(
+            BITCOIN_MAIN_NET, BITCOIN_ACCOUNT_P2PKH, 0);
+
+    EXPECT_ERROR(address_index_add_hd_account_addresses(nullptr, 1,
+            hd_account.get(), ADDRESS_EXTERNAL, 0, 1));
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(),
+            AddressIndex::EMPTY_ACCOUNT_ID, hd_account.get(), ADDRESS_EXTERNAL, 0, 1));
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+            nullptr, ADDRESS_EXTERNAL, 0, 1));
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+            hd_account.get(), static_cast<AddressType>(2), 0, 1));
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+            hd_account.get(), ADDRESS_EXTERNAL, 0x80000000, 1));
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+            hd_account.get(), ADDRESS_EXTERNAL, 0x7FFFFFFF, 2));
+
+    // Golos addresses are not hashes, hence can't be indexed.
+    const HDAccountPtr golos_account = make_test_hd_account(GOLOS_MAIN_NET, 0, 0);
+    EXPECT_ERROR(address_index_add_hd_account_addresses(index.get(), 1,
+            golos_account.get(), ADDRESS_EXTERNAL, 0, 1));
+
+    size_t size = 1;
+    HANDLE_ERROR(address_index_get_size(index.get(), &size));
+    EXPECT_EQ(0, size);
+}
+
+GTEST_TEST(AddressIndexTestInvalidArgs, address_index_find)
+{
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+
+    const bytes hash(ADDRESS_HASH_SIZE, 0);
+    const BinaryData hash_data = as_binary_data(hash);
+    const BinaryData short_hash_data{hash.data(), ADDRESS_HASH_SIZE - 1};
+    const BinaryData null_hash_data{nullptr, ADDRESS_HASH_SIZE};
+    bool found;
+    AddressIndexLeaf leaf;
+
+    EXPECT_ERROR(address_index_find(nullptr, &hash_data, &found, &leaf));
+    EXPECT_ERROR(address_index_find(index.get(), nullptr, &found, &leaf));
+    EXPECT_ERROR(address_index_find(index.get(), &short_hash_data, &found, &leaf));
+    EXPECT_ERROR(address_index_find(index.get(), &null_hash_data, &found, &leaf));
+    EXPECT_ERROR(address_index_find(index.get(), &hash_data, nullptr, &leaf));
+    EXPECT_ERROR(address_index_find(index.get(), &hash_data, &found, nullptr));
+}
+
+GTEST_TEST(AddressIndexTestInvalidArgs, address_index_get_size_and_save)
+{
+    AddressIndexPtr index;
+    HANDLE_ERROR(make_address_index(reset_sp(index)));
+    size_t size;
+
+    EXPECT_ERROR(address_index_get_size(nullptr, &size));
+    EXPECT_ERROR(address_index_get_size(index.get(), nullptr));
+
+    EXPECT_ERROR(address_index_save(nullptr, "/tmp/file"));
+    EXPECT_ERROR(address_index_save(index.get(), nullptr));
+    EXPECT_ERROR(address_index_save(index.get(),
+            "/this/directory/does/not/exist/address_index"));
+}
+
+GTEST_TEST(AddressIndexTestInvalidArgs, free_address_index)
+{
+    free_address_index(nullptr);
+    GTEST_SUCCEED();
+}
@@ -25,6 +25,7 @@
 namespace
 {
 using namespace multy_core::internal;
+using namespace test_utility;
 
 const int64_t DEFAULT_INT64_VALUE = static_cast<int64_t>(std::numeric_limits<int>::max()) + 1;
 
@@ -766,6 +767,27 @@ GTEST_TEST(BigIntTest_API, get_value_as_uint64)
     EXPECT_NO_THROW(value.get_value());
 }
 
+GTEST_TEST(BigIntTest, export_as_binary_data)
+{
+    EXPECT_EQ(0, BigInt(0).get_exported_size_in_bytes());
+    EXPECT_EQ(0, BigInt(0).export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN)->len);
+
+    // 2^64: lower limb is zero, so bytes can't be counted limb-by-limb.
+    const BigInt value("18446744073709551616");
+    EXPECT_EQ(9, value.get_exported_size_in_bytes());
+    EXPECT_EQ(as_binary_data(from_hex("010000000000000000")),
+            *value.export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN));
+    EXPECT_EQ(as_binary_data(from_hex("000000000000000001")),
+            *value.export_as_binary_data(BigInt::EXPORT_LITTLE_ENDIAN));
+
+    unsigned char buffer[9];
+    EXPECT_EQ(2, BigInt(0x1234).export_to_buffer(
+            BigInt::EXPORT_BIG_ENDIAN, buffer, sizeof(buffer)));
+    EXPECT_EQ(as_binary_data(from_hex("1234")), (BinaryData{buffer, 2}));
+    EXPECT_THROW(value.export_to_buffer(
+            BigInt::EXPORT_BIG_ENDIAN, buffer, sizeof(buffer) - 1), Exception);
+}
+
 template <typename T>
 struct BigIntTestP : public ::testing::TestWithParam<BigIntInitTestCase<T>>
 {};
@@ -0,0 +1,379 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/bitcoin_coin_selection.h"
+
+#include "multy_core/error.h"
+
+#include "multy_test/utility.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+using namespace test_utility;
+
+const BitcoinCoinSelectionStrategy ALL_STRATEGIES[] = {
+    BITCOIN_COIN_SELECTION_BRANCH_AND_BOUND,
+    BITCOIN_COIN_SELECTION_KNAPSACK,
+    BITCOIN_COIN_SELECTION_LARGEST_FIRST,
+};
+
+// Transaction sizes with the worst-case signature, for less than 253 inputs.
+const uint64_t P2PKH_INPUT_SIZE = 149;
+const uint64_t P2SH_P2WPKH_INPUT_SIZE = 64;
+const uint64_t P2SH_P2WPKH_INPUT_WITNESS_SIZE = 109;
+const uint64_t P2PKH_OUTPUT_SIZE = 34;
+const uint64_t P2SH_OUTPUT_SIZE = 32;
+const uint64_t TRANSACTION_OVERHEAD_SIZE = 10;
+const uint64_t SEGWIT_MARKER_AND_FLAG_SIZE = 2;
+const uint64_t P2PKH_DUST_THRESHOLD = 546;
+
+struct Selection
+{
+    std::vector<size_t> selected;
+    uint64_t change;
+    uint64_t fee;
+};
+
+Error* select_coins(
+        const std::vector<BitcoinUnspentOutput>& pool,
+        const std::vector<BitcoinCoinSelectionTarget>& targets,
+        uint64_t fee_per_byte,
+        BitcoinCoinSelectionStrategy strategy,
+        Selection* selection)
+{
+    selection->selected.resize(pool.size());
+    size_t selected_count = 0;
+    Error* error = bitcoin_select_coins(
+            pool.data(), pool.size(), targets.data(), targets.size(),
+            fee_per_byte, BITCOIN_ADDRESS_P2PKH, strategy,
+            selection->selected.data(), &selected_count,
+            &selection->change, &selection->fee);
+    selection->selected.resize(selected_count);
+    return error;
+}
+
+std::vector<BitcoinUnspentOutput> make_pool(const std::vector<uint64_t>& amounts)
+{
+    std::vector<BitcoinUnspentOutput> result;
+    for (const uint64_t amount : amounts)
+    {
+        result.push_back(BitcoinUnspentOutput{amount, BITCOIN_ADDRESS_P2PKH});
+    }
+    return result;
+}
+
+std::vector<BitcoinUnspentOutput> make_random_pool(size_t size)
+{
+    std::mt19937 random(size);
+    // Mostly small outputs, like those of a busy wallet.
+    std::lognormal_distribution<double> amount(11, 2);
+
+    std::vector<BitcoinUnspentOutput> result;
+    result.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        result.push_back(BitcoinUnspentOutput{
+                static_cast<uint64_t>(amount(random)) + 1,
+                i % 2 ? BITCOIN_ADDRESS_P2PKH : BITCOIN_ADDRESS_P2SH_P2WPKH});
+    }
+    return result;
+}
+
+// Verify that selection pays for targets, and fee is enough for a
+// transaction made of selected outputs.
+void verify_selection(
+        const std::vector<BitcoinUnspentOutput>& pool,
+        const std::vector<BitcoinCoinSelectionTarget>& targets,
+        uint64_t fee_per_byte,
+        const Selection& selection)
+{
+    ASSERT_FALSE(selection.selected.empty());
+
+    ASSERT_GT(253, selection.selected.size());
+
+    uint64_t selected_amount = 0;
+    uint64_t size = TRANSACTION_OVERHEAD_SIZE;
+    uint64_t witness_size = 0;
+    uint64_t non_segwit_inputs_count = 0;
+    for (size_t i = 0; i < selection.selected.size(); ++i)
+    {
+        ASSERT_LT(selection.selected[i], pool.size());
+        if (i > 0)
+        {
+            ASSERT_LT(selection.selected[i - 1], selection.selected[i]);
+        }
+        const BitcoinUnspentOutput& output = pool[selection.selected[i]];
+        selected_amount += output.amount;
+        if (output.address_type == BITCOIN_ADDRESS_P2SH_P2WPKH)
+        {
+            size += P2SH_P2WPKH_INPUT_SIZE;
+            witness_size += P2SH_P2WPKH_INPUT_WITNESS_SIZE;
+        }
+        else
+        {
+            size += P2PKH_INPUT_SIZE;
+            ++non_segwit_inputs_count;
+        }
+    }
+
+    uint64_t targets_amount = 0;
+    for (const auto& target : targets)
+    {
+        targets_amount += target.amount;
+        size += target.address_type == BITCOIN_ADDRESS_P2PKH
+                ? P2PKH_OUTPUT_SIZE : P2SH_OUTPUT_SIZE;
+    }
+    if (selection.change)
+    {
+        size += P2PKH_OUTPUT_SIZE;
+    }
+    if (witness_size)
+    {
+        // Marker, flag and empty witness for each non-segwit input.
+        witness_size += SEGWIT_MARKER_AND_FLAG_SIZE + non_segwit_inputs_count;
+    }
+
+    EXPECT_EQ(selected_amount,
+            targets_amount + selection.change + selection.fee);
+
+    const uint64_t virtual_size = (size * 4 + witness_size + 3) / 4;
+    EXPECT_LE(virtual_size * fee_per_byte, selection.fee);
+
+    if (selection.change)
+    {
+        EXPECT_LE(P2PKH_DUST_THRESHOLD, selection.change);
+    }
+}
+
+} // namespace
+
+GTEST_TEST(BitcoinCoinSelectionTest, branch_and_bound_exact_match)
+{
+    const auto pool = make_pool({1000, 2000, 5000, 7000, 100000});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {9000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    Selection selection;
+    HANDLE_ERROR(select_coins(pool, targets, 0,
+            BITCOIN_COIN_SELECTION_BRANCH_AND_BOUND, &selection));
+
+    EXPECT_EQ(std::vector<size_t>({1, 3}), selection.selected);
+    EXPECT_EQ(0, selection.change);
+    EXPECT_EQ(0, selection.fee);
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, branch_and_bound_exact_match_with_fee)
+{
+    const uint64_t fee_per_byte = 10;
+    const uint64_t input_fee = P2PKH_INPUT_SIZE * fee_per_byte;
+    const uint64_t transaction_fee = (TRANSACTION_OVERHEAD_SIZE
+            + P2PKH_OUTPUT_SIZE) * fee_per_byte;
+
+    // Only outputs 1 and 3 together pay for target and fee with no change.
+    const auto pool = make_pool({
+            50000,
+            20000 + input_fee + transaction_fee,
+            60000,
+            30000 + input_fee,
+            1000000});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {50000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    Selection selection;
+    HANDLE_ERROR(select_coins(pool, targets, fee_per_byte,
+            BITCOIN_COIN_SELECTION_BRANCH_AND_BOUND, &selection));
+
+    EXPECT_EQ(std::vector<size_t>({1, 3}), selection.selected);
+    EXPECT_EQ(0, selection.change);
+    verify_selection(pool, targets, fee_per_byte, selection);
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, largest_first)
+{
+    const auto pool = make_pool({1000, 2000, 5000, 7000});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {9000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    Selection selection;
+    HANDLE_ERROR(select_coins(pool, targets, 0,
+            BITCOIN_COIN_SELECTION_LARGEST_FIRST, &selection));
+
+    EXPECT_EQ(std::vector<size_t>({2, 3}), selection.selected);
+    EXPECT_EQ(3000, selection.change);
+    EXPECT_EQ(0, selection.fee);
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, knapsack)
+{
+    const auto pool = make_pool({1000, 2000, 5000, 7000, 100000});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {9000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    Selection selection;
+    HANDLE_ERROR(select_coins(pool, targets, 0,
+            BITCOIN_COIN_SELECTION_KNAPSACK, &selection));
+
+    // Smallest subset that covers the target.
+    EXPECT_EQ(std::vector<size_t>({1, 3}), selection.selected);
+    EXPECT_EQ(0, selection.change);
+    EXPECT_EQ(0, selection.fee);
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, dust_change_goes_to_fee)
+{
+    const uint64_t fee_per_byte = 1;
+    const uint64_t fee = (TRANSACTION_OVERHEAD_SIZE + P2PKH_INPUT_SIZE
+            + P2PKH_OUTPUT_SIZE) * fee_per_byte;
+    const auto pool = make_pool({10000 + fee + P2PKH_DUST_THRESHOLD});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {10000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    for (const auto strategy : ALL_STRATEGIES)
+    {
+        SCOPED_TRACE(strategy);
+
+        Selection selection;
+        HANDLE_ERROR(select_coins(pool, targets, fee_per_byte, strategy, &selection));
+
+        EXPECT_EQ(std::vector<size_t>({0}), selection.selected);
+        EXPECT_EQ(0, selection.change);
+        EXPECT_EQ(fee + P2PKH_DUST_THRESHOLD, selection.fee);
+        verify_selection(pool, targets, fee_per_byte, selection);
+    }
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, insufficient_funds)
+{
+    // With non-zero fee last output costs more to spend than it is worth.
+    const auto pool = make_pool({1000, 1800, 100});
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {3000, BITCOIN_ADDRESS_P2PKH}
+    };
+
+    for (const auto strategy : ALL_STRATEGIES)
+    {
+        SCOPED_TRACE(strategy);
+
+        Selection selection;
+        EXPECT_ERROR_WITH_CODE(select_coins(pool, targets, 0, strategy, &selection),
+                ERROR_TRANSACTION_INSUFFICIENT_FUNDS);
+        EXPECT_ERROR_WITH_CODE(select_coins(pool, targets, 1, strategy, &selection),
+                ERROR_TRANSACTION_INSUFFICIENT_FUNDS);
+        EXPECT_ERROR_WITH_CODE(select_coins({}, targets, 0, strategy, &selection),
+                ERROR_TRANSACTION_INSUFFICIENT_FUNDS);
+    }
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, invalid_args)
+{
+    const BitcoinUnspentOutput pool[] = {{10000, BITCOIN_ADDRESS_P2PKH}};
+    const BitcoinCoinSelectionTarget targets[] = {{1000, BITCOIN_ADDRESS_P2PKH}};
+    size_t selected[1];
+    size_t selected_count;
+    uint64_t change;
+    uint64_t fee;
+
+    EXPECT_ERROR(bitcoin_select_coins(nullptr, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, &change, &fee));
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, nullptr, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, &change, &fee));
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            nullptr, &selected_count, &change, &fee));
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, nullptr, &change, &fee));
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, nullptr, &fee));
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, &change, nullptr));
+
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, static_cast<BitcoinCoinSelectionStrategy>(-1),
+            selected, &selected_count, &change, &fee));
+
+    // Spending generic P2SH outputs is not supported.
+    const BitcoinUnspentOutput p2sh_pool[] = {{10000, BITCOIN_ADDRESS_P2SH}};
+    EXPECT_ERROR(bitcoin_select_coins(p2sh_pool, 1, targets, 1, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, &change, &fee));
+
+    const BitcoinCoinSelectionTarget overflow_targets[] = {
+        {UINT64_MAX, BITCOIN_ADDRESS_P2PKH},
+        {UINT64_MAX, BITCOIN_ADDRESS_P2PKH}
+    };
+    EXPECT_ERROR(bitcoin_select_coins(pool, 1, overflow_targets, 2, 1,
+            BITCOIN_ADDRESS_P2PKH, BITCOIN_COIN_SELECTION_KNAPSACK,
+            selected, &selected_count, &change, &fee));
+}
+
+GTEST_TEST(BitcoinCoinSelectionTest, random_pool)
+{
+    const auto pool = make_random_pool(2000);
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {1000000, BITCOIN_ADDRESS_P2PKH},
+        {2500000, BITCOIN_ADDRESS_P2SH},
+    };
+
+    for (const auto strategy : ALL_STRATEGIES)
+    {
+        SCOPED_TRACE(strategy);
+        for (const uint64_t fee_per_byte : {0, 1, 20})
+        {
+            SCOPED_TRACE(fee_per_byte);
+
+            Selection selection;
+            HANDLE_ERROR(select_coins(pool, targets, fee_per_byte, strategy, &selection));
+            verify_selection(pool, targets, fee_per_byte, selection);
+        }
+    }
+}
+
+// Benchmark of selection time vs pool size, run with:
+// --gtest_also_run_disabled_tests --gtest_filter=*BitcoinCoinSelectionTest*benchmark*
+GTEST_TEST(BitcoinCoinSelectionTest, DISABLED_benchmark)
+{
+    const std::vector<BitcoinCoinSelectionTarget> targets = {
+        {50000000, BITCOIN_ADDRESS_P2PKH}
+    };
+    const uint64_t fee_per_byte = 20;
+
+    for (const size_t pool_size : {1000, 10000, 100000, 1000000})
+    {
+        const auto pool = make_random_pool(pool_size);
+        for (const auto strategy : ALL_STRATEGIES)
+        {
+            Selection selection;
+            const auto start = std::chrono::steady_clock::now();
+            HANDLE_ERROR(select_coins(pool, targets, fee_per_byte, strategy, &selection));
+            const auto duration = std::chrono::steady_clock::now() - start;
+
+            verify_selection(pool, targets, fee_per_byte, selection);
+            std::cout << "pool size: " << pool_size
+                    << "\tstrategy: " << strategy
+                    << "\tselected: " << selection.selected.size()
+                    << "\ttime: " << std::chrono::duration_cast<
+                            std::chrono::microseconds>(duration).count()
+                    << " us" << std::endl;
+        }
+    }
+}
@@ -9,6 +9,7 @@
 
 #include "multy_core/account.h"
 #include "multy_core/big_int.h"
+#include "multy_core/bitcoin_bulk_payout.h"
 #include "multy_core/properties.h"
 #include "multy_core/src/api/account_impl.h"
 #include "multy_core/src/api/key_impl.h"
@@ -31,6 +32,10 @@ namespace
 using namespace multy_core::internal;
 using namespace test_utility;
 
+// Fee is computed without signing the transaction, assuming worst-case
+// signature size, which can be only a few bytes longer than the actual one.
+const size_t MAX_SIGNATURE_SIZE_OVERESTIMATION = 4;
+
 bool is_between(const BigInt& left, const BigInt& value, const BigInt& right)
 {
     if (left > right)
@@ -458,12 +463,11 @@ GTEST_TEST(BitcoinTransactionTest, SmokeTest_explicit_change)
     // NOTE: this would not work for SegWit transactions.
     const BigInt expected_total_fee = static_cast<uint64_t>(serialized->len) * fee_per_byte;
 
-    const double delta_factor = 0.00001;
-
-    // check that actual fee is within delta of value set by user.
-    const BigInt delta(static_cast<uint64_t>(expected_total_fee.get<uint64_t>() * delta_factor));
+    // check that actual fee is not less than value set by user and
+    // exceeds it only due to the signature size overestimation.
+    const BigInt delta = MAX_SIGNATURE_SIZE_OVERESTIMATION * fee_per_byte;
     EXPECT_PRED3(is_between,
-            expected_total_fee - delta,
+            expected_total_fee,
             transaction->get_total_fee(),
             expected_total_fee + delta);
 
@@ -472,9 +476,9 @@ GTEST_TEST(BitcoinTransactionTest, SmokeTest_explicit_change)
 
     ASSERT_LT(0, change_amount);
     EXPECT_PRED3(is_between,
-            available - dest_amount - static_cast<uint64_t>(expected_total_fee.get<uint64_t>() * (1 + delta_factor)),
+            available - dest_amount - expected_total_fee - delta,
             change_amount,
-            available - dest_amount - static_cast<uint64_t>(expected_total_fee.get<uint64_t>() * (1 - delta_factor)));
+            available - dest_amount - expected_total_fee);
 
     ASSERT_GE(available - dest_amount - expected_total_fee, change_amount);
 }
@@ -1167,6 +1171,134 @@ GTEST_TEST(BitcoinTransactionTest, DISABLED_SmokeTest_SegWit_mainnet2)
             "e58420371eb97cc574f2870cc0c88abfb699c5a87f28bb6bbf50b55f158fb5fe0700")), *serialied);
 }
 
+GTEST_TEST(BitcoinTransactionTest, SmokeTest_SegWit_testnet)
+{
+    // Spending P2SH-P2WPKH output, signed according to BIP143.
+    AccountPtr account;
+    HANDLE_ERROR(
+            make_account(
+                    BITCOIN_TEST_NET,
+                    BITCOIN_ACCOUNT_SEGWIT,
+                    "cNDJeJQZgLDzWS5yz6Pf1a9LzC26nDn6SZpJHcRc4212aGJ6NSXJ",
+                    reset_sp(account)));
+    ASSERT_NE(nullptr, account);
+    EXPECT_EQ("2Mwd414ETKsgn4BvLdYNSkK6Qa5bboxDwes", account->get_address());
+
+    const PrivateKeyPtr private_key = account->get_private_key();
+
+    const TransactionTemplate TEST_TX
+    {
+        nullptr,
+        TransactionFee
+        { // fee:
+            10_SATOSHI
+        },
+        { // Sources
+            TransactionSource
+            {
+                1.30049879_BTC,
+                from_hex("b84f0713dbfbc9091d426e2e2cef3691e305746b7dec3aceaee39ec431d564ab"),
+                0,
+                from_hex("a9143001515d9592fa730931df154306f24ba8ece52f87"),
+                private_key.get()
+            }
+        },
+        { // Destinations
+            TransactionDestination
+            {
+                "2MzwcmDo5WBjrjHzfYuyzsdZHmo682krVnf",
+                0.30048219_BTC
+            },
+            TransactionDestination
+            {
+                "2N9YrGCkmGNzZfU3aMXqZkMw4iH2f2x9U37",
+                1.0_BTC
+            }
+        }
+    };
+    TransactionPtr transaction = make_transaction_from_template(TEST_TX, account);
+
+    transaction->get_transaction_properties()
+            .set_property_value("is_replaceable", 0);
+
+    const BinaryDataPtr serialied = transaction->serialize();
+    ASSERT_EQ(as_binary_data(from_hex(
+            "01000000000101ab64d531c49ee3aece3aec7d6b7405e39136ef2c2e6e421d09c9fbdb13074fb80000000017160014b57593a5a0e96bcd52fc2f7a325fb913916db674ffffffff02"
+            "db7fca010000000017a914546c87c7a5187edac7ad3fcf22dc3597ce37b1998700e1f5050000000017a914b2d75d4297ba8de492351d4701cee065e9c852ce8702483045022100c4"
+            "143c3a63e17ec8c2d8ce8ed17c496b072f521912eeb05fb4f4b53a7a474ed302203a28bc404ad05dc8ade46c67002afa00c76f53ef7e4f5b14f15b218b01668741012103295d829f"
+            "209b8b1e7c56029f20f8440382be6e43c7b03ae637ad4327f36fb2ab00000000")), *serialied);
+}
+
+GTEST_TEST(BitcoinTransactionTest, SmokeTest_SegWit_and_P2PKH_sources_testnet)
+{
+    // Spending both P2SH-P2WPKH and P2PKH outputs in the same transaction.
+    AccountPtr segwit_account;
+    HANDLE_ERROR(
+            make_account(
+                    BITCOIN_TEST_NET,
+                    BITCOIN_ACCOUNT_SEGWIT,
+                    "cNDJeJQZgLDzWS5yz6Pf1a9LzC26nDn6SZpJHcRc4212aGJ6NSXJ",
+                    reset_sp(segwit_account)));
+    ASSERT_NE(nullptr, segwit_account);
+
+    const AccountPtr account = make_account(BITCOIN_TEST_NET,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7");
+
+    const PrivateKeyPtr segwit_private_key = segwit_account->get_private_key();
+    const PrivateKeyPtr private_key = account->get_private_key();
+
+    const TransactionTemplate TEST_TX
+    {
+        nullptr,
+        TransactionFee
+        { // fee:
+            10_SATOSHI
+        },
+        { // Sources
+            TransactionSource
+            {
+                1.30049879_BTC,
+                from_hex("b84f0713dbfbc9091d426e2e2cef3691e305746b7dec3aceaee39ec431d564ab"),
+                0,
+                from_hex("a9143001515d9592fa730931df154306f24ba8ece52f87"),
+                segwit_private_key.get()
+            },
+            TransactionSource
+            {
+                2000500_SATOSHI,
+                from_hex("48979223adb5f7f340c4f27d6cc45a38adb37876b2d7e34d2457cbf57342a391"),
+                0,
+                from_hex("76a914d3f68b887224cabcc90a9581c7bbdace878666db88ac"),
+                private_key.get()
+            }
+        },
+        { // Destinations
+            TransactionDestination
+            {
+                "2MzwcmDo5WBjrjHzfYuyzsdZHmo682krVnf",
+                1.3_BTC
+            },
+            TransactionChangeDestination
+            {
+                "mzqiDnETWkunRDZxjUQ34JzN1LDevh5DpU"
+            }
+        }
+    };
+    TransactionPtr transaction = make_transaction_from_template(TEST_TX, account);
+
+    transaction->get_transaction_properties()
+            .set_property_value("is_replaceable", 0);
+
+    const BinaryDataPtr serialied = transaction->serialize();
+    ASSERT_EQ(as_binary_data(from_hex(
+            "01000000000102ab64d531c49ee3aece3aec7d6b7405e39136ef2c2e6e421d09c9fbdb13074fb80000000017160014b57593a5a0e96bcd52fc2f7a325fb913916db674ffffffff91"
+            "a34273f5cb57244de3d7b27678b3ad385ac46c7df2c440f3f7b5ad23929748000000006b483045022100bfcbe19915e81dceb229dd4342405ac54f5f36fa8741547924c3e8b0e5e8"
+            "a8e702203729453bba1df1980aaa1c5879baf06712d370c98bd0cf64e093ec37df2a6930012102163387c2c86f897b8aef15ee24e1f135da70c52e7dde12c06e122891c704d694ff"
+            "ffffff0280a4bf070000000017a914546c87c7a5187edac7ad3fcf22dc3597ce37b19987e93c1f00000000001976a914d3f68b887224cabcc90a9581c7bbdace878666db88ac0247"
+            "304402205ffcf48738622c228cf7b0f9f397b91c9626263163ed0769546e509827f90229022033c90e4717ec56213fb82681170af304cd18ea99fbac7c1bab775fa3ca21cdd90121"
+            "03295d829f209b8b1e7c56029f20f8440382be6e43c7b03ae637ad4327f36fb2ab0000000000")), *serialied);
+}
+
 GTEST_TEST(BitcoinTransactionTest, transaction_update)
 {
     // Verify that transaction_update() modifies TX internal state.
@@ -1199,14 +1331,88 @@ GTEST_TEST(BitcoinTransactionTest, transaction_update)
     HANDLE_ERROR(transaction_serialize(transaction.get(), reset_sp(serialized)));
 
     // Verifying that fee is within some bounds of user set value.
-    const double delta = 0.0001;
     EXPECT_PRED3(is_between,
-            DEFAULT_TX_TEMPLATE.fee.amount_per_byte * static_cast<int64_t>(serialized->len * (1 - delta)),
+            DEFAULT_TX_TEMPLATE.fee.amount_per_byte * static_cast<int64_t>(serialized->len),
             *updated_total_fee,
-            DEFAULT_TX_TEMPLATE.fee.amount_per_byte * static_cast<int64_t>(serialized->len * (1 + delta))
+            DEFAULT_TX_TEMPLATE.fee.amount_per_byte * static_cast<int64_t>(
+                    serialized->len + MAX_SIGNATURE_SIZE_OVERESTIMATION)
     );
 }
 
+GTEST_TEST(BitcoinTransactionTest, transaction_update_many_sources)
+{
+    // Verify that fee computed without signing the transaction is within
+    // bounds of the actual signed transaction size for many-inputs TX.
+    const AccountPtr account = make_account(BITCOIN_TEST_NET,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7");
+    const size_t sources_count = 50;
+
+    TransactionTemplate TEST_TX = DEFAULT_TX_TEMPLATE;
+    TEST_TX.sources.clear();
+    for (size_t i = 0; i < sources_count; ++i)
+    {
+        TransactionSource source = DEFAULT_TX_TEMPLATE.sources[0];
+        source.prev_tx_index = i;
+        TEST_TX.sources.push_back(source);
+    }
+
+    TransactionPtr transaction = make_transaction_from_template(
+            TEST_TX, account, account->get_private_key());
+
+    BinaryDataPtr serialized;
+    HANDLE_ERROR(transaction_serialize(transaction.get(), reset_sp(serialized)));
+
+    BigIntPtr total_fee;
+    HANDLE_ERROR(transaction_get_total_fee(transaction.get(), reset_sp(total_fee)));
+
+    EXPECT_PRED3(is_between,
+            TEST_TX.fee.amount_per_byte * static_cast<int64_t>(serialized->len),
+            *total_fee,
+            TEST_TX.fee.amount_per_byte * static_cast<int64_t>(
+                    serialized->len + sources_count * MAX_SIGNATURE_SIZE_OVERESTIMATION));
+
+    // Re-serializing produces exactly same result.
+    BinaryDataPtr serialized2;
+    HANDLE_ERROR(transaction_serialize(transaction.get(), reset_sp(serialized2)));
+    EXPECT_EQ(*serialized, *serialized2);
+}
+
+GTEST_TEST(BitcoinTransactionTest, parallel_signing)
+{
+    // Signing on multiple threads produces exactly same result as on single one.
+    const AccountPtr account = make_account(BITCOIN_TEST_NET,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7");
+
+    TransactionTemplate TEST_TX = DEFAULT_TX_TEMPLATE;
+    TEST_TX.sources.clear();
+    for (size_t i = 0; i < 10; ++i)
+    {
+        TransactionSource source = DEFAULT_TX_TEMPLATE.sources[0];
+        source.prev_tx_index = i;
+        TEST_TX.sources.push_back(source);
+    }
+
+    TransactionPtr transaction = make_transaction_from_template(
+            TEST_TX, account, account->get_private_key());
+    const BinaryDataPtr expected = transaction->serialize();
+
+    for (const int32_t threads_count : {2, 3, 10, 100})
+    {
+        SCOPED_TRACE(threads_count);
+        transaction->get_transaction_properties()
+                .set_property_value("signing_threads_count", threads_count);
+
+        BinaryDataPtr serialized;
+        HANDLE_ERROR(transaction_serialize(transaction.get(), reset_sp(serialized)));
+        EXPECT_EQ(*expected, *serialized);
+    }
+
+    Properties* properties = nullptr;
+    HANDLE_ERROR(transaction_get_properties(transaction.get(), &properties));
+    EXPECT_ERROR(properties_set_int32_value(properties, "signing_threads_count", 0));
+    EXPECT_ERROR(properties_set_int32_value(properties, "signing_threads_count", -1));
+}
+
 GTEST_TEST(BitcoinTransactionTest, transaction_get_total_spent)
 {
     const AccountPtr account = make_account(BITCOIN_TEST_NET,
@@ -1713,3 +1919,148 @@ GTEST_TEST(BitcoinTransactionTest, transaction_set_destination_address_mainnet)
     EXPECT_ERROR(properties_set_string_value(&destination_mainnet, "address", "mzqiDnETWkunRDZxjUQ34JzN1LDevh5DpU"));
     EXPECT_ERROR(properties_set_string_value(&destination_mainnet, "address", "TEST"));
 }
+
+GTEST_TEST(BitcoinTransactionTest, bulk_destinations)
+{
+    // Transaction with bulk destinations is exactly the same as the one
+    // with destinations added one by one.
+    const AccountPtr account = make_account(BITCOIN_TEST_NET,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7");
+
+    TransactionTemplate TEST_TX = DEFAULT_TX_TEMPLATE;
+    TEST_TX.sources[0].available = 12.0_BTC;
+    TEST_TX.destinations = {TransactionChangeDestination(account->get_address())};
+
+    const std::string addresses[] = {
+            "mfgq7S1Va1GREFgN66MVoxX35X6juKov6A",
+            "2MwsRtyuZyW2HuPUcUKGa4dAm9M9RkUPacK"
+    };
+    const bytes script_pubkey = from_hex(
+            "76a914323c1ea8756feaaaa85d0d0e51b0cc07b4c7ac5e88ac");
+    const BinaryData script_pubkey_data = as_binary_data(script_pubkey);
+
+    const size_t DESTINATIONS_COUNT = 300;
+    std::vector<BitcoinBulkDestination> bulk_destinations;
+    TransactionTemplate expected_tx = TEST_TX;
+    for (size_t i = 0; i < DESTINATIONS_COUNT; ++i)
+    {
+        const uint64_t amount = 10000 + i;
+        if (i % 3 == 2)
+        {
+            bulk_destinations.push_back(
+                    BitcoinBulkDestination{nullptr, &script_pubkey_data, amount});
+            expected_tx.destinations.push_back(TransactionDestination(
+                    "mk6a6qeXNXuQDpA4DPxuouTJJTeFYJAkep", BigInt(amount)));
+        }
+        else
+        {
+            const std::string& address = addresses[i % 3];
+            bulk_destinations.push_back(
+                    BitcoinBulkDestination{address.c_str(), nullptr, amount});
+            expected_tx.destinations.push_back(
+                    TransactionDestination(address, BigInt(amount)));
+        }
+    }
+
+    TransactionPtr expected_transaction = make_transaction_from_template(
+            expected_tx, account, account->get_private_key());
+    TransactionPtr transaction = make_transaction_from_template(
+            TEST_TX, account, account->get_private_key());
+    // Adding in several batches is the same as adding all at once.
+    HANDLE_ERROR(transaction_add_bitcoin_destinations(transaction.get(),
+            bulk_destinations.data(), 100));
+    HANDLE_ERROR(transaction_add_bitcoin_destinations(transaction.get(),
+            bulk_destinations.data() + 100, DESTINATIONS_COUNT - 100));
+    HANDLE_ERROR(transaction_add_bitcoin_destinations(transaction.get(),
+            nullptr, 0));
+
+    for (Transaction* tx : {expected_transaction.get(), transaction.get()})
+    {
+        tx->set_message(as_binary_data(from_hex("6d756c7479")));
+    }
+
+    const BinaryDataPtr expected = expected_transaction->serialize();
+    EXPECT_EQ(*expected, *transaction->serialize());
+    EXPECT_EQ(expected_transaction->get_total_fee(), transaction->get_total_fee());
+    EXPECT_EQ(expected_transaction->get_total_spent(), transaction->get_total_spent());
+
+    // Transaction with bulk destinations only.
+    TEST_TX.destinations.clear();
+    TEST_TX.sources[0].available = 0.031_BTC;
+    transaction = make_transaction_from_template(
+            TEST_TX, account, account->get_private_key());
+    HANDLE_ERROR(transaction_add_bitcoin_destinations(transaction.get(),
+            bulk_destinations.data(), 3));
+    HANDLE_ERROR(transaction_update(transaction.get()));
+    EXPECT_EQ(BigInt(0.031_BTC), transaction->get_total_spent());
+    EXPECT_EQ(BigInt(0.031_BTC) - BigInt(10000 + 10001 + 10002),
+            transaction->get_total_fee());
+}
+
+GTEST_TEST(BitcoinTransactionTest, bulk_destinations_invalid)
+{
+    const AccountPtr account = make_account(BITCOIN_TEST_NET,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7");
+    TransactionTemplate TEST_TX = DEFAULT_TX_TEMPLATE;
+    TEST_TX.destinations.clear();
+    TransactionPtr transaction = make_transaction_from_template(
+            TEST_TX, account, account->get_private_key());
+
+    const char* address = "mfgq7S1Va1GREFgN66MVoxX35X6juKov6A";
+    const bytes script_pubkey = from_hex(
+            "76a914323c1ea8756feaaaa85d0d0e51b0cc07b4c7ac5e88ac");
+    const BinaryData script_pubkey_data = as_binary_data(script_pubkey);
+    const bytes op_return_script = from_hex("6a0461626364");
+    const BinaryData op_return_script_data = as_binary_data(op_return_script);
+
+    const BitcoinBulkDestination INVALID_DESTINATIONS[] = {
+        {nullptr, nullptr, 10000},
+        {address, &script_pubkey_data, 10000},
+        {address, nullptr, 0},
+        {"3HGwSrGh7ARwDbzr3SwmRcavk6UWJtyUd2", nullptr, 10000}, // mainnet
+        {"TEST", nullptr, 10000},
+        {nullptr, &op_return_script_data, 10000},
+    };
+    for (const BitcoinBulkDestination& invalid : INVALID_DESTINATIONS)
+    {
+        SCOPED_TRACE(&invalid - INVALID_DESTINATIONS);
+        // None of the destinations is added if any of them is invalid.
+        const BitcoinBulkDestination destinations[] = {
+            {address, nullptr, 10000},
+            invalid
+        };
+        EXPECT_ERROR(transaction_add_bitcoin_destinations(
+                transaction.get(), destinations, 2));
+        EXPECT_ERROR_WITH_CODE(transaction_update(transaction.get()),
+                ERROR_TRANSACTION_NO_DESTINATIONS);
+    }
+
+    EXPECT_ERROR(transaction_add_bitcoin_destinations(nullptr, nullptr, 0));
+    EXPECT_ERROR(transaction_add_bitcoin_destinations(transaction.get(), nullptr, 1));
+
+    // Dust is rejected on mainnet only.
+    const BitcoinBulkDestination dust{address, nullptr, 500};
+    HANDLE_ERROR(transaction_add_bitcoin_destinations(transaction.get(), &dust, 1));
+
+    const AccountPtr mainnet_account = make_account(BITCOIN_MAIN_NET,
+            "5KDejYL1XnGkhwhH1ubSqiFCqXGxYzuJYHXhU7UqeVLEDeqBJ22");
+    TransactionPtr mainnet_transaction;
+    HANDLE_ERROR(make_transaction(mainnet_account.get(),
+            reset_sp(mainnet_transaction)));
+    const BitcoinBulkDestination mainnet_dust{
+            "1MCvJ6pqJrGJEjo55RhLhr1de2wFLoDBXF", nullptr, 500};
+    EXPECT_ERROR_WITH_CODE(transaction_add_bitcoin_destinations(
+            mainnet_transaction.get(), &mainnet_dust, 1),
+            ERROR_TRANSACTION_TRANSFER_AMOUNT_TOO_SMALL);
+
+    // Not a Bitcoin transaction.
+    AccountPtr ethereum_account;
+    HANDLE_ERROR(make_account(ETHEREUM_MAIN_NET, ACCOUNT_TYPE_DEFAULT,
+            "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00",
+            reset_sp(ethereum_account)));
+    TransactionPtr ethereum_transaction;
+    HANDLE_ERROR(make_transaction(ethereum_account.get(),
+            reset_sp(ethereum_transaction)));
+    EXPECT_ERROR(transaction_add_bitcoin_destinations(
+            ethereum_transaction.get(), &dust, 1));
+}
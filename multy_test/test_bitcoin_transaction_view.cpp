@@ -0,0 +1,262 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/bitcoin/bitcoin_transaction_view.h"
+
+#include "multy_core/bitcoin_transaction_view.h"
+
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+// Signed by BitcoinTransactionTest.SmokeTest_testnet3
+const char* P2PKH_TX =
+        "0100000001da1ca8202f16683e307b47fe4c9e65804569e4b50f84e14ed79b60e54a65ae13010000006b483045022100e217cfb592"
+        "0878da55069a919029ab910ff106cfb20fd901e82de041b149d71902202756c5700377294837893cca854e60b6cca86423f4407b8faf"
+        "92ff898aded00a012102163387c2c86f897b8aef15ee24e1f135da70c52e7dde12c06e122891c704d694ffffffff0300e1f505000000"
+        "001976a91401de29d6f0aaf3467da7881a981c5c5ef90258bd88ac00e1f505000000001976a914323c1ea8756feaaaa85d0d0e51b0cc"
+        "07b4c7ac5e88acc0878b3b000000001976a914d3f68b887224cabcc90a9581c7bbdace878666db88ac00000000";
+
+// Signed by BitcoinTransactionTest.SmokeTest_SegWit_and_P2PKH_sources_testnet
+const char* SEGWIT_TX =
+        "01000000000102ab64d531c49ee3aece3aec7d6b7405e39136ef2c2e6e421d09c9fbdb13074fb80000000017160014b57593a5a0e96b"
+        "cd52fc2f7a325fb913916db674ffffffff91a34273f5cb57244de3d7b27678b3ad385ac46c7df2c440f3f7b5ad23929748000000006b"
+        "483045022100bfcbe19915e81dceb229dd4342405ac54f5f36fa8741547924c3e8b0e5e8a8e702203729453bba1df1980aaa1c5879ba"
+        "f06712d370c98bd0cf64e093ec37df2a6930012102163387c2c86f897b8aef15ee24e1f135da70c52e7dde12c06e122891c704d694ff"
+        "ffffff0280a4bf070000000017a914546c87c7a5187edac7ad3fcf22dc3597ce37b19987e93c1f00000000001976a914d3f68b887224"
+        "cabcc90a9581c7bbdace878666db88ac0247304402205ffcf48738622c228cf7b0f9f397b91c9626263163ed0769546e509827f90229"
+        "022033c90e4717ec56213fb82681170af304cd18ea99fbac7c1bab775fa3ca21cdd9012103295d829f209b8b1e7c56029f20f8440382"
+        "be6e43c7b03ae637ad4327f36fb2ab0000000000";
+
+// txid as it is displayed, i.e. in reverse byte order.
+std::string to_txid_string(const hash<256>& txid)
+{
+    hash<256> reversed = txid;
+    std::reverse(reversed.begin(), reversed.end());
+    return to_hex(as_binary_data(reversed));
+}
+
+BitcoinAddressType get_address_type(const BinaryData& script_pubkey)
+{
+    BitcoinAddressType result;
+    if (!get_bitcoin_script_pubkey_address_type(script_pubkey, &result))
+    {
+        throw std::runtime_error("Unknown script_pubkey");
+    }
+    return result;
+}
+
+} // namespace
+
+GTEST_TEST(BitcoinTransactionViewTest, P2PKH)
+{
+    const bytes data = from_hex(P2PKH_TX);
+    const BitcoinTransactionView view(as_binary_data(data));
+
+    EXPECT_EQ(1, view.get_version());
+    EXPECT_EQ(0, view.get_lock_time());
+    EXPECT_FALSE(view.is_segwit());
+
+    ASSERT_EQ(1, view.get_inputs().size());
+    const auto& input = view.get_inputs()[0];
+    EXPECT_EQ(as_binary_data(from_hex(
+            "da1ca8202f16683e307b47fe4c9e65804569e4b50f84e14ed79b60e54a65ae13")),
+            input.prev_transaction_hash);
+    EXPECT_EQ(1, input.prev_transaction_out_index);
+    EXPECT_EQ(0x6b, input.script_signature.len);
+    // Points inside the original buffer.
+    EXPECT_EQ(data.data() + 4 + 1 + 32 + 4 + 1, input.script_signature.data);
+    EXPECT_EQ(0xFFFFFFFF, input.sequence);
+    EXPECT_EQ(0, input.witness.len);
+    EXPECT_EQ(0, input.witness_items_count);
+
+    ASSERT_EQ(3, view.get_outputs().size());
+    EXPECT_EQ(100000000, view.get_outputs()[0].amount);
+    EXPECT_EQ(100000000, view.get_outputs()[1].amount);
+    EXPECT_EQ(999000000, view.get_outputs()[2].amount);
+    EXPECT_EQ(as_binary_data(from_hex(
+            "76a914d3f68b887224cabcc90a9581c7bbdace878666db88ac")),
+            view.get_outputs()[2].script_pubkey);
+    for (const auto& output : view.get_outputs())
+    {
+        EXPECT_EQ(BITCOIN_ADDRESS_P2PKH, get_address_type(output.script_pubkey));
+    }
+
+    // This transaction is spent by SmokeTest_with_many_input_from_different_addreses_testnet
+    EXPECT_EQ("a1fdb0d8776cfd43b66cfc0ee49cad2763fdbeca67af8ef40479624716ea8948",
+            to_txid_string(view.get_txid()));
+    EXPECT_EQ(view.get_txid(), view.get_wtxid());
+    EXPECT_EQ(260, view.get_size());
+    EXPECT_EQ(260, view.get_virtual_size());
+}
+
+GTEST_TEST(BitcoinTransactionViewTest, SegWit)
+{
+    const bytes data = from_hex(SEGWIT_TX);
+    const BitcoinTransactionView view(as_binary_data(data));
+
+    EXPECT_EQ(1, view.get_version());
+    EXPECT_EQ(0, view.get_lock_time());
+    EXPECT_TRUE(view.is_segwit());
+
+    ASSERT_EQ(2, view.get_inputs().size());
+    const auto& segwit_input = view.get_inputs()[0];
+    EXPECT_EQ(0, segwit_input.prev_transaction_out_index);
+    EXPECT_EQ(as_binary_data(from_hex(
+            "160014b57593a5a0e96bcd52fc2f7a325fb913916db674")),
+            segwit_input.script_signature);
+    ASSERT_EQ(2, segwit_input.witness_items_count);
+    EXPECT_EQ(as_binary_data(from_hex(
+            "304402205ffcf48738622c228cf7b0f9f397b91c9626263163ed0769546e509827f90229"
+            "022033c90e4717ec56213fb82681170af304cd18ea99fbac7c1bab775fa3ca21cdd901")),
+            view.get_witness_item(0, 0));
+    EXPECT_EQ(as_binary_data(from_hex(
+            "03295d829f209b8b1e7c56029f20f8440382be6e43c7b03ae637ad4327f36fb2ab")),
+            view.get_witness_item(0, 1));
+    EXPECT_THROW(view.get_witness_item(0, 2), Exception);
+
+    const auto& p2pkh_input = view.get_inputs()[1];
+    EXPECT_EQ(0x6b, p2pkh_input.script_signature.len);
+    EXPECT_EQ(0, p2pkh_input.witness_items_count);
+    EXPECT_EQ(as_binary_data(from_hex("00")), p2pkh_input.witness);
+    EXPECT_THROW(view.get_witness_item(1, 0), Exception);
+    EXPECT_THROW(view.get_witness_item(2, 0), Exception);
+
+    ASSERT_EQ(2, view.get_outputs().size());
+    EXPECT_EQ(130000000, view.get_outputs()[0].amount);
+    EXPECT_EQ(BITCOIN_ADDRESS_P2SH, get_address_type(view.get_outputs()[0].script_pubkey));
+    EXPECT_EQ(2047209, view.get_outputs()[1].amount);
+    EXPECT_EQ(BITCOIN_ADDRESS_P2PKH, get_address_type(view.get_outputs()[1].script_pubkey));
+
+    EXPECT_EQ("251106e060c9f65659c0943521c26bec8d4fc34ede57ca4b92db33fc02858215",
+            to_txid_string(view.get_txid()));
+    EXPECT_EQ("1782b185ea5a54f8e021e6fd3697e6498fefe704d8cd3cdbd8bb4c4176497b23",
+            to_txid_string(view.get_wtxid()));
+    EXPECT_EQ(398, view.get_size());
+    EXPECT_EQ(316, view.get_virtual_size());
+}
+
+GTEST_TEST(BitcoinTransactionViewTest, C_API)
+{
+    const bytes data = from_hex(SEGWIT_TX);
+    const BinaryData serialized = as_binary_data(data);
+    const BitcoinTransactionView view(serialized);
+
+    BitcoinTransactionInfo info;
+    HANDLE_ERROR(bitcoin_parse_transaction(&serialized, &info, nullptr, 0));
+    EXPECT_EQ(1, info.version);
+    EXPECT_EQ(0, info.lock_time);
+    EXPECT_TRUE(info.is_segwit);
+    EXPECT_EQ(2, info.inputs_count);
+    EXPECT_EQ(2, info.outputs_count);
+    EXPECT_EQ(398, info.size);
+    EXPECT_EQ(316, info.virtual_size);
+    EXPECT_EQ(as_binary_data(view.get_txid()), as_binary_data(info.txid));
+    EXPECT_EQ(as_binary_data(view.get_wtxid()), as_binary_data(info.wtxid));
+
+    // Only as many outputs as there is room for.
+    BitcoinTransactionOutputInfo outputs[3] = {};
+    HANDLE_ERROR(bitcoin_parse_transaction(&serialized, &info, outputs, 1));
+    EXPECT_EQ(130000000, outputs[0].amount);
+    EXPECT_EQ(view.get_outputs()[0].script_pubkey, outputs[0].script_pubkey);
+    EXPECT_EQ(0, outputs[1].amount);
+
+    HANDLE_ERROR(bitcoin_parse_transaction(&serialized, &info, outputs, 3));
+    EXPECT_EQ(2047209, outputs[1].amount);
+    EXPECT_EQ(view.get_outputs()[1].script_pubkey, outputs[1].script_pubkey);
+    EXPECT_EQ(0, outputs[2].amount);
+
+    EXPECT_ERROR(bitcoin_parse_transaction(nullptr, &info, nullptr, 0));
+    EXPECT_ERROR(bitcoin_parse_transaction(&serialized, nullptr, nullptr, 0));
+    EXPECT_ERROR(bitcoin_parse_transaction(&serialized, &info, nullptr, 1));
+
+    const BinaryData truncated{data.data(), data.size() - 1};
+    EXPECT_ERROR(bitcoin_parse_transaction(&truncated, &info, nullptr, 0));
+}
+
+GTEST_TEST(BitcoinTransactionViewTest, invalid_data)
+{
+    for (const char* tx : {P2PKH_TX, SEGWIT_TX})
+    {
+        SCOPED_TRACE(tx);
+
+        // Truncated at various points, including right before the end.
+        const bytes data = from_hex(tx);
+        for (size_t cut = 1; cut <= data.size(); cut += 7)
+        {
+            const size_t len = data.size() - cut;
+            SCOPED_TRACE(len);
+            EXPECT_THROW(BitcoinTransactionView(BinaryData{data.data(), len}),
+                    Exception);
+        }
+
+        bytes extra_data = data;
+        extra_data.push_back(0);
+        EXPECT_THROW(BitcoinTransactionView(as_binary_data(extra_data)),
+                Exception);
+    }
+
+    const std::string version = "01000000";
+    const std::string lock_time = "00000000";
+    // prev tx hash, prev tx out index, empty script and sequence.
+    const std::string input = std::string(2 * (32 + 4), '0') + "00" + "ffffffff";
+
+    // Segwit marker, but all witnesses are empty.
+    EXPECT_THROW(BitcoinTransactionView(as_binary_data(from_hex(
+            (version + "0001" + "01" + input + "00" + "00" + lock_time).c_str()))),
+            Exception);
+
+    // Invalid segwit flag.
+    EXPECT_THROW(BitcoinTransactionView(as_binary_data(from_hex(
+            (version + "0002" + "01" + input + "00" + "00" + lock_time).c_str()))),
+            Exception);
+
+    // Non-canonical compact size of the outputs count.
+    EXPECT_THROW(BitcoinTransactionView(as_binary_data(from_hex(
+            (version + "01" + input + "fd0000" + lock_time).c_str()))),
+            Exception);
+
+    // Inputs count is way bigger than the data.
+    EXPECT_THROW(BitcoinTransactionView(as_binary_data(from_hex(
+            (version + "ffffffffffffffffff" + "00" + lock_time).c_str()))),
+            Exception);
+
+    // Valid transaction with single input and no outputs.
+    const bytes no_outputs = from_hex((version + "01" + input + "00" + lock_time).c_str());
+    EXPECT_EQ(1, BitcoinTransactionView(as_binary_data(no_outputs)).get_inputs().size());
+
+    // Valid transaction with no inputs and outputs.
+    const bytes empty = from_hex("01000000" "00" "00" "00000000");
+    const BitcoinTransactionView empty_view(as_binary_data(empty));
+    EXPECT_EQ(0, empty_view.get_inputs().size());
+    EXPECT_EQ(0, empty_view.get_outputs().size());
+}
+
+GTEST_TEST(BitcoinTransactionViewTest, script_pubkey_address_type)
+{
+    BitcoinAddressType address_type;
+    EXPECT_FALSE(get_bitcoin_script_pubkey_address_type(
+            BinaryData{nullptr, 0}, &address_type));
+    // OP_RETURN
+    EXPECT_FALSE(get_bitcoin_script_pubkey_address_type(
+            as_binary_data(from_hex("6a0461626364")), &address_type));
+    // P2WPKH
+    EXPECT_FALSE(get_bitcoin_script_pubkey_address_type(
+            as_binary_data(from_hex("0014b57593a5a0e96bcd52fc2f7a325fb913916db674")),
+            &address_type));
+}
@@ -116,6 +116,13 @@ GTEST_TEST(VersionTest, make_version_string)
     std::cerr << "Library version:" << version_string.get() << std::endl;
 }
 
+GTEST_TEST(InitTest, multy_core_init)
+{
+    // Can be called any number of times.
+    HANDLE_ERROR(multy_core_init());
+    HANDLE_ERROR(multy_core_init());
+}
+
 GTEST_TEST(VersionTestInvalidArgs, get_version)
 {
     EXPECT_ERROR(get_version(nullptr));
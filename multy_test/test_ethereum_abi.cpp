@@ -0,0 +1,364 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_abi.h"
+
+#include "multy_core/ethereum.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/ethereum/ethereum_rlp.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+typedef EthereumAbiValue Value;
+
+Value make_uint(int32_t value)
+{
+    return Value::make_int(BigInt(value));
+}
+
+Value make_uint_list(std::initializer_list<int32_t> values)
+{
+    std::vector<Value> items;
+    for (int32_t value : values)
+    {
+        items.push_back(make_uint(value));
+    }
+    return Value::make_list(std::move(items));
+}
+
+std::string encode_call(const char* signature, const std::vector<Value>& arguments)
+{
+    const EthereumAbiFunction function(signature);
+    const BinaryDataPtr encoded = function.encode_call(arguments);
+    EXPECT_EQ(function.get_call_size(arguments), encoded->len);
+    return to_hex(*encoded);
+}
+
+} // namespace
+
+GTEST_TEST(EthereumAbiTest, selector)
+{
+    EXPECT_EQ("a9059cbb", to_hex(as_binary_data(
+            ethereum_abi_selector("transfer(address,uint256)"))));
+    EXPECT_EQ("095ea7b3", to_hex(as_binary_data(
+            ethereum_abi_selector("approve(address,uint256)"))));
+
+    // Signature is normalized before hashing.
+    const EthereumAbiFunction function("transfer( address, uint )");
+    EXPECT_EQ("transfer(address,uint256)", function.get_signature());
+    EXPECT_EQ(ethereum_abi_selector("transfer(address,uint256)"), function.get_selector());
+
+    EXPECT_EQ("g(uint256[][],(int8,bytes32)[2],string)",
+            EthereumAbiFunction("g(uint[][],(int8,bytes32)[2],string)").get_signature());
+    EXPECT_EQ("f()", EthereumAbiFunction("f()").get_signature());
+}
+
+// Examples from https://solidity.readthedocs.io/en/develop/abi-spec.html
+GTEST_TEST(EthereumAbiTest, static_arguments)
+{
+    EXPECT_EQ("cdcd77c0"
+            "0000000000000000000000000000000000000000000000000000000000000045"
+            "0000000000000000000000000000000000000000000000000000000000000001",
+            encode_call("baz(uint32,bool)", {make_uint(69), Value::make_bool(true)}));
+
+    EXPECT_EQ("fce353f6"
+            "6162630000000000000000000000000000000000000000000000000000000000"
+            "6465660000000000000000000000000000000000000000000000000000000000",
+            encode_call("bar(bytes3[2])", {Value::make_list({
+                    Value::make_fixed_bytes(as_binary_data("abc")),
+                    Value::make_fixed_bytes(as_binary_data("def"))})}));
+
+    EXPECT_EQ("a9059cbb"
+            "000000000000000000000000fdf88a23d6058789c6a37bd997d3ed4760feb3b2"
+            "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+            encode_call("transfer(address,uint256)", {
+                    Value::make_address(as_binary_data(from_hex(
+                            "fdf88a23d6058789c6a37bd997d3ed4760feb3b2"))),
+                    Value::make_int(BigInt("115792089237316195423570985008687907853269984665640564039457584007913129639935"))}));
+
+    EXPECT_EQ(to_hex(as_binary_data(ethereum_abi_selector("h(int8,int16,int256)")))
+            + "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+            "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff80"
+            "8000000000000000000000000000000000000000000000000000000000000000",
+            encode_call("h(int8,int16,int256)", {make_uint(-1), make_uint(-128),
+                    Value::make_int(BigInt("-57896044618658097711785492504343953926634992332820282019728792003956564819968"))}));
+}
+
+GTEST_TEST(EthereumAbiTest, dynamic_arguments)
+{
+    EXPECT_EQ("a5643bf2"
+            "0000000000000000000000000000000000000000000000000000000000000060"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "00000000000000000000000000000000000000000000000000000000000000a0"
+            "0000000000000000000000000000000000000000000000000000000000000004"
+            "6461766500000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000003",
+            encode_call("sam(bytes,bool,uint[])", {
+                    Value::make_bytes(as_binary_data("dave")),
+                    Value::make_bool(true),
+                    make_uint_list({1, 2, 3})}));
+
+    EXPECT_EQ("8be65246"
+            "0000000000000000000000000000000000000000000000000000000000000123"
+            "0000000000000000000000000000000000000000000000000000000000000080"
+            "3132333435363738393000000000000000000000000000000000000000000000"
+            "00000000000000000000000000000000000000000000000000000000000000e0"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000456"
+            "0000000000000000000000000000000000000000000000000000000000000789"
+            "000000000000000000000000000000000000000000000000000000000000000d"
+            "48656c6c6f2c20776f726c642100000000000000000000000000000000000000",
+            encode_call("f(uint,uint32[],bytes10,bytes)", {
+                    make_uint(0x123),
+                    make_uint_list({0x456, 0x789}),
+                    Value::make_fixed_bytes(as_binary_data("1234567890")),
+                    Value::make_bytes(as_binary_data("Hello, world!"))}));
+
+    EXPECT_EQ("2289b18c"
+            "0000000000000000000000000000000000000000000000000000000000000040"
+            "0000000000000000000000000000000000000000000000000000000000000140"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000040"
+            "00000000000000000000000000000000000000000000000000000000000000a0"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "0000000000000000000000000000000000000000000000000000000000000060"
+            "00000000000000000000000000000000000000000000000000000000000000a0"
+            "00000000000000000000000000000000000000000000000000000000000000e0"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "6f6e650000000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "74776f0000000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000005"
+            "7468726565000000000000000000000000000000000000000000000000000000",
+            encode_call("g(uint[][],string[])", {
+                    Value::make_list({make_uint_list({1, 2}), make_uint_list({3})}),
+                    Value::make_list({Value::make_string("one"),
+                            Value::make_string("two"),
+                            Value::make_string("three")})}));
+
+    // Dynamic tuple: static component inline, dynamic one by offset.
+    EXPECT_EQ(to_hex(as_binary_data(ethereum_abi_selector("t((uint256,string),uint256)")))
+            + "0000000000000000000000000000000000000000000000000000000000000040"
+            "0000000000000000000000000000000000000000000000000000000000000007"
+            "0000000000000000000000000000000000000000000000000000000000000005"
+            "0000000000000000000000000000000000000000000000000000000000000040"
+            "0000000000000000000000000000000000000000000000000000000000000000",
+            encode_call("t((uint,string),uint)", {
+                    Value::make_list({make_uint(5), Value::make_string("")}),
+                    make_uint(7)}));
+}
+
+GTEST_TEST(EthereumAbiTest, text_arguments)
+{
+    struct TestCase
+    {
+        const char* signature;
+        std::vector<std::string> text_arguments;
+        std::vector<Value> arguments;
+    };
+
+    const bytes address = from_hex("6b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b");
+    const TestCase TEST_CASES[] = {
+        {"sam(bytes,bool,uint[])",
+                {"0x64617665", "true", "[1, 2, 3]"},
+                {Value::make_bytes(as_binary_data("dave")), Value::make_bool(true),
+                        make_uint_list({1, 2, 3})}},
+        {"f(uint,uint32[],bytes10,bytes)",
+                {"291", "[1110,1929]", "31323334353637383930", ""},
+                {make_uint(0x123), make_uint_list({0x456, 0x789}),
+                        Value::make_fixed_bytes(as_binary_data("1234567890")),
+                        Value::make_bytes(BinaryData{nullptr, 0})}},
+        {"g(uint[][],string[])",
+                {"[[1,2],[3]]", "[one, two, three]"},
+                {Value::make_list({make_uint_list({1, 2}), make_uint_list({3})}),
+                        Value::make_list({Value::make_string("one"),
+                                Value::make_string("two"),
+                                Value::make_string("three")})}},
+        {"t((int,address,string),uint[2])",
+                {"(-5, 0x6b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b, )", "[7,8]"},
+                {Value::make_list({Value::make_int(BigInt(-5)),
+                        Value::make_address(as_binary_data(address)),
+                        Value::make_string("")}),
+                        make_uint_list({7, 8})}},
+        {"s(string)",
+                {" Hello, [world]! "},
+                {Value::make_string(" Hello, [world]! ")}},
+    };
+
+    for (const TestCase& test_case : TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.signature);
+        const EthereumAbiFunction function(test_case.signature);
+        EXPECT_EQ(*function.encode_call(test_case.arguments),
+                *function.encode_call_from_text(test_case.text_arguments));
+    }
+
+    const std::pair<const char*, std::vector<std::string>> INVALID_CASES[] = {
+        {"f(uint)", {}},
+        {"f(uint)", {"1", "2"}},
+        {"f(uint)", {"0x01"}},
+        {"f(uint8)", {"256"}},
+        {"f(bool)", {"1"}},
+        {"f(address)", {"0x0011"}},
+        {"f(bytes2)", {"0x001"}},
+        {"f(bytes2)", {"0x001122"}},
+        {"f(uint[])", {"1,2"}},
+        {"f(uint[])", {"[1,2"}},
+        {"f(uint[])", {"[1,[2]]"}},
+        {"f(uint[2])", {"[1]"}},
+        {"f((uint,bool))", {"(1,true,2)"}},
+        {"f((uint,bool))", {"[1,true]"}},
+    };
+    for (const auto& test_case : INVALID_CASES)
+    {
+        SCOPED_TRACE(test_case.first);
+        const EthereumAbiFunction function(test_case.first);
+        EXPECT_THROW(function.encode_call_from_text(test_case.second), Exception);
+    }
+}
+
+GTEST_TEST(EthereumAbiTest, encode_contract_call)
+{
+    const char* arguments[] = {
+        "0x6b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b",
+        "1000"
+    };
+
+    BinaryDataPtr call;
+    HANDLE_ERROR(ethereum_encode_contract_call(
+            "transfer(address, uint)", arguments, 2, reset_sp(call)));
+    EXPECT_EQ("a9059cbb"
+            "0000000000000000000000006b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b"
+            "00000000000000000000000000000000000000000000000000000000000003e8",
+            to_hex(*call));
+
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            nullptr, arguments, 2, reset_sp(call)));
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            "transfer(address,uint)", nullptr, 2, reset_sp(call)));
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            "transfer(address,uint)", arguments, 2, nullptr));
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            "transfer(address,uint)", arguments, 1, reset_sp(call)));
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            "transfer(address", arguments, 2, reset_sp(call)));
+
+    const char* null_argument[] = {nullptr};
+    EXPECT_ERROR(ethereum_encode_contract_call(
+            "f(string)", null_argument, 1, reset_sp(call)));
+}
+
+GTEST_TEST(EthereumAbiTest, writes_into_rlp)
+{
+    const EthereumAbiFunction function("sam(bytes,bool,uint[])");
+    const std::vector<Value> arguments = {
+        Value::make_bytes(as_binary_data("dave")),
+        Value::make_bool(true),
+        make_uint_list({1, 2, 3})
+    };
+
+    const BinaryDataPtr expected_data = function.encode_call(arguments);
+    const BinaryDataPtr expected = encode_rlp([&](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_uint(1);
+        encoder->write_bytes(*expected_data);
+        encoder->end_list();
+    });
+
+    EXPECT_EQ(*expected, *encode_rlp([&](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_uint(1);
+        encoder->write_bytes(function.get_call_size(arguments),
+                [&](FixedSizeBinaryDataWriter* writer)
+                {
+                    function.write_call(arguments, writer);
+                });
+        encoder->end_list();
+    }));
+}
+
+GTEST_TEST(EthereumAbiTest, invalid_signature)
+{
+    for (const char* signature : {"", "()", "f", "f(", "f)", "f(uint", "f(uint,)",
+            "f(,uint)", "f(uint7)", "f(uint512)", "f(int0)", "f(bytes0)", "f(bytes33)",
+            "f(address20)", "f(fixed)", "f(function)", "f(uint[0])", "f(uint[)",
+            "f(uint[1x])", "f(uint)[]", "f(uint) x", "f-g(uint)", "f((uint)",
+            "f(uint[9999999999])"})
+    {
+        SCOPED_TRACE(signature);
+        EXPECT_THROW(EthereumAbiFunction{signature}, Exception);
+    }
+}
+
+GTEST_TEST(EthereumAbiTest, invalid_arguments)
+{
+    struct TestCase
+    {
+        const char* signature;
+        std::vector<Value> arguments;
+    };
+
+    const TestCase TEST_CASES[] = {
+        {"f(uint)", {}},
+        {"f(uint)", {make_uint(1), make_uint(1)}},
+        {"f(uint)", {Value::make_bool(true)}},
+        {"f(uint)", {make_uint(-1)}},
+        {"f(uint8)", {make_uint(256)}},
+        {"f(int8)", {make_uint(128)}},
+        {"f(int8)", {make_uint(-129)}},
+        {"f(bool)", {make_uint(1)}},
+        {"f(address)", {make_uint(1)}},
+        {"f(bytes3)", {Value::make_fixed_bytes(as_binary_data("ab"))}},
+        {"f(bytes)", {Value::make_string("ab")}},
+        {"f(string)", {Value::make_bytes(as_binary_data("ab"))}},
+        {"f(uint[])", {make_uint(1)}},
+        {"f(uint[2])", {make_uint_list({1})}},
+        {"f(uint[])", {Value::make_list({Value::make_bool(false)})}},
+        {"f((uint,bool))", {make_uint_list({1, 2})}},
+    };
+
+    for (const TestCase& test_case : TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.signature);
+        const EthereumAbiFunction function(test_case.signature);
+        EXPECT_THROW(function.get_call_size(test_case.arguments), Exception);
+        EXPECT_THROW(function.encode_call(test_case.arguments), Exception);
+    }
+
+    EXPECT_THROW(Value::make_int(BigInt(
+            "115792089237316195423570985008687907853269984665640564039457584007913129639936")),
+            Exception);
+    EXPECT_THROW(Value::make_int(BigInt(
+            "-57896044618658097711785492504343953926634992332820282019728792003956564819969")),
+            Exception);
+    EXPECT_THROW(Value::make_address(as_binary_data(from_hex("0011"))), Exception);
+    EXPECT_THROW(Value::make_fixed_bytes(as_binary_data(
+            "123456789012345678901234567890123")), Exception);
+}
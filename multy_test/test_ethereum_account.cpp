@@ -7,10 +7,14 @@
 #include "multy_core/account.h"
 #include "multy_core/src/ethereum/ethereum_account.h"
 
+#include "multy_core/bitcoin.h"
+#include "multy_core/blockchain.h"
 #include "multy_core/ethereum.h"
+#include "multy_core/mnemonic.h"
 #include "multy_core/src/api/account_impl.h"
 #include "multy_core/src/api/key_impl.h"
 #include "multy_core/src/api/sha3_impl.h"
+#include "multy_core/src/exception.h"
 #include "multy_core/src/utility.h"
 
 #include "multy_test/serialized_keys_test_base.h"
@@ -19,103 +23,110 @@
 
 #include "gtest/gtest.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ctype.h>
+
 namespace
 {
 using namespace multy_core::internal;
+using namespace test_utility;
 
 const char* TEST_CASES_ADDRESS[] = {
-    "0x54f46318d8f83c28b719ccf01ab4628e1e8f65fa",
-    "0x256c6f6e7ccb5a6c2d7328a8ab9b79333beba1e1",
-    "0x841d6a3c7854d3250433b4fddd6ce8b4093e7172",
-    "0x23d0033fb9717563cb6d8b1e257a9d6027b48953",
-    "0x2f87c0482c8d8490b3afb68cfe48bea81510a195",
-    "0x6ef90e7dfec25f5b74a2c40eb05fce94cefe52a1",
-    "0x390c61b3bee479ba9db509fb2277c16458553299",
-    "0x60898387644b70c3d74999b30766947c09b2a9c6",
-    "0x7a965b0a45a786ce9249e92ac1746053aa84a690",
-    "0x8405b8c046b94deb5ca5adf81660164b853bbda4",
-    "0x7b098532d8bffb846357e209094d122da98c5ad1",
-    "0xb01f82aabacaa0ed45d041c227b55f0e2f78e897",
-    "0x3f135cb1f425aed875b29e94153c0ccf9cec9f3f",
-    "0x1d90a440b8faff514cfb8b0143df13ccd5b8a7e1",
-    "0x01c7189e7580a75f07fdc4dbf3fee09a85cd9373"
+    "0x54F46318d8F83C28B719ccf01aB4628e1e8F65Fa",
+    "0x256c6F6e7Ccb5A6C2d7328a8ab9B79333bEbA1E1",
+    "0x841D6A3c7854d3250433b4fDDd6CE8b4093e7172",
+    "0x23D0033fb9717563CB6D8B1e257A9d6027B48953",
+    "0x2F87c0482C8D8490b3aFB68cFe48BEa81510a195",
+    "0x6Ef90e7DFEc25F5B74a2c40eB05FCe94cefE52A1",
+    "0x390C61B3BEe479bA9db509fB2277c16458553299",
+    "0x60898387644B70C3d74999B30766947C09b2a9C6",
+    "0x7A965b0a45a786CE9249E92ac1746053AA84a690",
+    "0x8405b8c046B94Deb5ca5adf81660164B853BbDa4",
+    "0x7b098532D8BfFB846357e209094D122da98C5aD1",
+    "0xb01F82aABaCaa0ed45D041C227b55F0E2f78e897",
+    "0x3f135cB1f425aed875B29E94153c0CCF9CEc9F3f",
+    "0x1D90A440B8fafF514cfB8B0143df13CCd5b8a7e1",
+    "0x01c7189E7580a75f07fdc4dBF3FEe09A85cd9373"
 };
 
 SerializedKeyTestCase TEST_CASES[] = {
     {
         "6bd05118bf92e4236232db724a64abbf709f01b4f37041c88ae3ebf3eeed5596",
         "a7f74edbea542dc33840173d5b31486ba60e7e4e52e9fde4595c347ec55a3b6546601019888199d2f4c64132725c8194594ac63a0f29096701d1c9707febda09",
-        "0x54f46318d8f83c28b719ccf01ab4628e1e8f65fa"
+        "0x54F46318d8F83C28B719ccf01aB4628e1e8F65Fa"
     },
     {
         "adff71bae77a106b790ce91e123f15ae003b8fa6295676d9948cb0c8a5b2828a",
         "7928abc8c77f618b7e9d1ee415bb3219976be7643757552b1aad7c790d9af262166cc0315c8e19cb28711e1a7349b4181f30554ce1c7de9adaad82bfe552af9c",
-        "0x256c6f6e7ccb5a6c2d7328a8ab9b79333beba1e1"
+        "0x256c6F6e7Ccb5A6C2d7328a8ab9B79333bEbA1E1"
     },
     {
         "4b337635ae3e3a206b975e09e3049c5e72655f4eed2821d3ac7ff1043f3f89c5",
         "2c062a116a3f93b75902270d14c407b0d2aede7dc8ce2e205f78703f80dc7def0abfd18fdf616d54f4ecb9b8dfb18666dcff2f0792d096f434b16ffc161ee019",
-        "0x841d6a3c7854d3250433b4fddd6ce8b4093e7172"
+        "0x841D6A3c7854d3250433b4fDDd6CE8b4093e7172"
     },
     {
         "dfdecaa72b39c7ac70303a8e7ecea6300e83c58b195ecd52d5c2d21e3460e343",
         "3256d4728477fed4bf2b61d0e97bd79afb15f3863edd2cff04b39e44fdd07e17e5674ea1192e832d666ae951ae5901a77a32af421c37731da6e1b418d3fb74ae",
-        "0x23d0033fb9717563cb6d8b1e257a9d6027b48953"
+        "0x23D0033fb9717563CB6D8B1e257A9d6027B48953"
     },
     {
         "6f7c00b940ef1fba31dafb1fcf4c2f0c5bf5e71948e8ea92094e0701cf425ab8",
         "ad9cee319424a5b0af8f6beeeee58e9775257f583c3bb3d88c320bdc920d46eb538399021e8004d68e9b27c4bfa1b5c1f95e394e7939b86886c84765fb6acf83",
-        "0x2f87c0482c8d8490b3afb68cfe48bea81510a195"
+        "0x2F87c0482C8D8490b3aFB68cFe48BEa81510a195"
     },
     {
         "772655d6fa88f78362fc7489ea4c643d5edcbd052af13e2c37c9de2cf20fbe77",
         "3118f1d006b6dfbf71ca4e6d2951cc7fd74909edd148df9d29625782e0fbf37c47c522ad053b0862c7a78b9058fe968d84fd012c2037ba7938b1cef1ca05ef71",
-        "0x6ef90e7dfec25f5b74a2c40eb05fce94cefe52a1"
+        "0x6Ef90e7DFEc25F5B74a2c40eB05FCe94cefE52A1"
     },
     {
         "a104292f5fb5e49af675ea90748ec6e114c9b4035f77782f4503a6e3059b6dd0",
         "98f86eb3c1768ec59d67cbe0c06335fbb82e4a783d860e5a30a628c671f10797390142b5e4d6a8c2730160edf633003a827b597da2d2d7a61e034575c995e5b2",
-        "0x390c61b3bee479ba9db509fb2277c16458553299"
+        "0x390C61B3BEe479bA9db509fB2277c16458553299"
     },
     {
         "3bddb9373d912591548fedabba36209bf9f7800f0290ac71eeb5f83866f1d691",
         "d6ea90f9e28c6228da2bcef04816189244a5593fde9665d56059d90bd131502c7d7f8f54c05ba74996a16d4aac263826644b2987648306cdb51919bda4718b3c",
-        "0x60898387644b70c3d74999b30766947c09b2a9c6"
+        "0x60898387644B70C3d74999B30766947C09b2a9C6"
     },
     {
         "3a21f6f305f67625706c18f872bfaf58f655e8b3b570332d6af38af4535d0081",
         "8be23baec7804621fd3a2b58b155198f5e79a9f2eeaa3817e944be60c4e1bce8119391bb3b5afa9d674c03b18b90d5acfe8305d65a33181cd15aca438e121ce5",
-        "0x7a965b0a45a786ce9249e92ac1746053aa84a690"
+        "0x7A965b0a45a786CE9249E92ac1746053AA84a690"
     },
     {
         "71dc93df5433faa33f97e65d2cc03ef7c0e04ce59576f0b77192d47f5fdeab3e",
         "419aa97f8da6b71ee75acc8b21dc9a851ec120334f4b7fd62b6d833c58afa49f487bd6424b6629844666af06d0a597a90b0fb6365dbb1e7d96fb9da9637c8ff5",
-        "0x8405b8c046b94deb5ca5adf81660164b853bbda4"
+        "0x8405b8c046B94Deb5ca5adf81660164B853BbDa4"
     },
     {
         "ccd6653148ff43a8a96ac417a6392777c3d6a9fecd78fa02438692e948dcc9cd",
         "dcc583096c0127a5193e9979fb3e0a5a928c960b8056b64c626ccaf3ae960cd5cfa1599b137d9457e2f21e04bc479a74f99fa66a46aa9dbec5804f31da0b5da0",
-        "0x7b098532d8bffb846357e209094d122da98c5ad1"
+        "0x7b098532D8BfFB846357e209094D122da98C5aD1"
     },
     {
         "f32293168da86e1ac2a334e3bf5dd24b0e30a0a7fecf5459db8fa63c870469f8",
         "7e18b8fb656297dec98762a20a34e585cf43b4f367ef5c2eb919357a5213052baf61e0ea2b433f5d3b84021a62fc01457229bc6f92c719976bd7870a5dd9908b",
-        "0xb01f82aabacaa0ed45d041c227b55f0e2f78e897"
+        "0xb01F82aABaCaa0ed45D041C227b55F0E2f78e897"
     },
     {
         "6bc155d11a983461fcc6d3d7f33ea2e504203b95b2f70c133ca81caf22e74b01",
         "5abab429b25536984a89977d5632ec66287f748f3d14b74871423124bb43ba330e62b1d7bedf814f37d7ecf2311651c3727e298715ce3ff49179fe326dd3d707",
-        "0x3f135cb1f425aed875b29e94153c0ccf9cec9f3f"
+        "0x3f135cB1f425aed875B29E94153c0CCF9CEc9F3f"
     },
     {
         "9e8dfca420f547598d0dcef7ee05d8923381e33634577cb06767e57215a66a75",
         "5d05b6b7617be5680f9bb4e368a370fa84396c608941a654892bf682eec50ca9809488701c1ad189a056fabe48e719188bfcab31e5fb4550bc38ce60766af425",
-        "0x1d90a440b8faff514cfb8b0143df13ccd5b8a7e1"
+        "0x1D90A440B8fafF514cfB8B0143df13CCd5b8a7e1"
     },
     {
         "40a0efc4a15e884874c919546b8031393733b9f19578264ded581a7ee1b2d91f",
         "54bacad7b4205095b64ad84450a2c8add9e439a64cfcf107f387fc47b494986d3bde54b751eee7ead26411ff5b90c4f10b2a8f51e11994ad7a0b058b6965eb4b",
-        "0x01c7189e7580a75f07fdc4dbf3fee09a85cd9373"
+        "0x01c7189E7580a75f07fdc4dBF3FEe09A85cd9373"
     }
 };
 
@@ -191,4 +202,175 @@ GTEST_TEST(EthereumBlockchainTest, validate_address)
     EXPECT_ERROR(validate_address(ETH_MAINNET, "0xb826808a8c41e00b7c5d71f211f005a84a7b97949d5e765831e1da4e34c9b8295d2a622eee50f25af78241c1cb7cfff11bcf2a13fe65dee1e3b86fd79a4e3ed000"));
 }
 
+// From https://github.com/ethereum/EIPs/blob/master/EIPS/eip-55.md
+const char* EIP55_ADDRESSES[] = {
+    "0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed",
+    "0xfB6916095ca1df60bB79Ce92cE3Ea74c37c5d359",
+    "0xdbF03B407c01E7cD3CBea99509d93f8DDDC8C6FB",
+    "0xD1220A0cf47c7B9Be7A2E6BA89F429762e7b9aDb",
+    // all-caps and all-lowercase
+    "0x52908400098527886E0F7030069857D2E4169EE7",
+    "0xde709f2102306220921060314715629080e2fb77",
+};
+
+std::string to_lower(std::string address)
+{
+    for (char& c : address)
+    {
+        c = static_cast<char>(tolower(c));
+    }
+    return address;
+}
+
+std::string flip_case(std::string address, size_t i)
+{
+    char& c = address[i];
+    c = static_cast<char>(isupper(c) ? tolower(c) : toupper(c));
+    return address;
+}
+
+GTEST_TEST(EthereumAddressTest, EIP55_checksum)
+{
+    const BlockchainType ETH_MAINNET{BLOCKCHAIN_ETHEREUM, ETHEREUM_CHAIN_ID_MAINNET};
+
+    for (const char* address : EIP55_ADDRESSES)
+    {
+        SCOPED_TRACE(address);
+        HANDLE_ERROR(validate_address(ETH_MAINNET, address));
+
+        const BinaryDataPtr binary_address = ethereum_parse_address(address);
+        const std::string checksummed = ethereum_format_address(*binary_address);
+        EXPECT_EQ(to_lower(address), to_lower(checksummed));
+        EXPECT_EQ(*binary_address, *ethereum_parse_address(checksummed.c_str()));
+        HANDLE_ERROR(validate_address(ETH_MAINNET, checksummed.c_str()));
+
+        // Prefix is optional.
+        HANDLE_ERROR(validate_address(ETH_MAINNET, address + 2));
+
+        // Lowercase address has no checksum to verify.
+        HANDLE_ERROR(validate_address(ETH_MAINNET, to_lower(address).c_str()));
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const std::string address = EIP55_ADDRESSES[i];
+        SCOPED_TRACE(address);
+        EXPECT_EQ(address, ethereum_format_address(
+                *ethereum_parse_address(address.c_str())));
+
+        // Any letter with wrong case breaks the checksum.
+        for (size_t j = 2; j < address.size(); ++j)
+        {
+            if (isalpha(address[j]))
+            {
+                SCOPED_TRACE(j);
+                EXPECT_ERROR(validate_address(ETH_MAINNET,
+                        flip_case(address, j).c_str()));
+            }
+        }
+    }
+
+    EXPECT_THROW(ethereum_format_address(as_binary_data(from_hex("0011"))),
+            Exception);
+}
+
+GTEST_TEST(EthereumAddressTest, validate_addresses)
+{
+    const BlockchainType ETH_MAINNET{BLOCKCHAIN_ETHEREUM, ETHEREUM_CHAIN_ID_MAINNET};
+
+    std::vector<std::string> addresses;
+    for (const char* address : EIP55_ADDRESSES)
+    {
+        addresses.push_back(address);
+        addresses.push_back(to_lower(address));
+    }
+    // Checksummed addresses with wrong case of the first letter.
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const std::string address = EIP55_ADDRESSES[i];
+        addresses.push_back(flip_case(address,
+                address.find_first_not_of("0123456789", 2)));
+    }
+    for (const char* address : TEST_CASES_ADDRESS)
+    {
+        addresses.push_back(address);
+        addresses.push_back(address + 2);
+        addresses.push_back(std::string(address) + "0");
+    }
+    addresses.push_back("");
+    addresses.push_back("0x");
+    addresses.push_back("0xZZ74679d2a190fd679a85ce7767c05605237f030");
+
+    std::vector<const char*> address_ptrs;
+    for (const std::string& address : addresses)
+    {
+        address_ptrs.push_back(address.c_str());
+    }
+    address_ptrs.push_back(nullptr);
+
+    std::unique_ptr<bool[]> is_valid(new bool[address_ptrs.size()]);
+    HANDLE_ERROR(validate_addresses(ETH_MAINNET,
+            address_ptrs.data(), address_ptrs.size(), is_valid.get()));
+
+    size_t valid_count = 0;
+    for (size_t i = 0; i < addresses.size(); ++i)
+    {
+        SCOPED_TRACE(addresses[i]);
+        ErrorPtr error(validate_address(ETH_MAINNET, addresses[i].c_str()));
+        EXPECT_EQ(error == nullptr, is_valid[i]);
+        valid_count += is_valid[i];
+    }
+    EXPECT_FALSE(is_valid[address_ptrs.size() - 1]);
+    EXPECT_EQ(2 * array_size(EIP55_ADDRESSES) + 2 * array_size(TEST_CASES_ADDRESS),
+            valid_count);
+
+    // Generic implementation for other blockchains.
+    const char* bitcoin_addresses[] = {
+        "mzqiDnETWkunRDZxjUQ34JzN1LDevh5DpU",
+        "mzqiDnETWkunRDZxjUQ34JzN1LDevh5Dp",
+        nullptr
+    };
+    bool bitcoin_is_valid[3] = {false, true, true};
+    HANDLE_ERROR(validate_addresses(BlockchainType{BLOCKCHAIN_BITCOIN, BITCOIN_NET_TYPE_TESTNET},
+            bitcoin_addresses, 3, bitcoin_is_valid));
+    EXPECT_TRUE(bitcoin_is_valid[0]);
+    EXPECT_FALSE(bitcoin_is_valid[1]);
+    EXPECT_FALSE(bitcoin_is_valid[2]);
+
+    HANDLE_ERROR(validate_addresses(ETH_MAINNET, nullptr, 0, nullptr));
+    EXPECT_ERROR(validate_addresses(ETH_MAINNET, nullptr, 1, is_valid.get()));
+    EXPECT_ERROR(validate_addresses(ETH_MAINNET, address_ptrs.data(), 1, nullptr));
+}
+
+GTEST_TEST(EthereumHDAccountTest, BIP44_known_address)
+{
+    // m/44'/60'/0'/0/0 of well-known BIP39 test mnemonic, as in MetaMask
+    // and other wallets. Also checks that all 32 bytes of leaf private key
+    // are used.
+    BinaryDataPtr seed;
+    HANDLE_ERROR(make_seed(
+            "abandon abandon abandon abandon abandon abandon "
+            "abandon abandon abandon abandon abandon about",
+            "",
+            reset_sp(seed)));
+
+    ExtendedKeyPtr master_key;
+    HANDLE_ERROR(make_master_key(seed.get(), reset_sp(master_key)));
+
+    HDAccountPtr root_account;
+    HANDLE_ERROR(make_hd_account(
+            master_key.get(),
+            BlockchainType{BLOCKCHAIN_ETHEREUM, ETHEREUM_CHAIN_ID_MAINNET},
+            ACCOUNT_TYPE_DEFAULT,
+            0,
+            reset_sp(root_account)));
+
+    AccountPtr account;
+    HANDLE_ERROR(make_hd_leaf_account(
+            root_account.get(), ADDRESS_EXTERNAL, 0, reset_sp(account)));
+
+    EXPECT_EQ("0x9858EfFD232B4033E47d90003D41EC34EcaEda94",
+            account->get_address());
+}
+
 } // namespace
@@ -0,0 +1,204 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/ethereum_batch.h"
+
+#include "multy_core/account.h"
+#include "multy_core/binary_data.h"
+#include "multy_core/transaction.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/api/properties_impl.h"
+#include "multy_core/src/api/transaction_impl.h"
+#include "multy_core/src/ethereum/ethereum_transaction_view.h"
+#include "multy_core/src/u_ptr.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/supported_blockchains.h"
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+const char* PRIVATE_KEY = "c8aea1b4d991e2bb7c17b1cb8b8dbda9fb59717df552e98ec3aca80410565a9f";
+const char* TOKEN_TRANSFER = "ERC20:0xfdf88a23d6058789c6a37bd997d3ed4760feb3b2:transfer";
+
+// Same transfer, but made with regular transaction API.
+BinaryDataPtr make_single_transaction(const Account& account,
+        const BigInt& nonce, const BigInt& gas_price, const BigInt& gas_limit,
+        const EthereumTransfer& transfer)
+{
+    TransactionPtr transaction;
+    throw_if_error(make_transaction(&account, reset_sp(transaction)));
+
+    Properties& properties = transaction->get_transaction_properties();
+    properties.set_property_value("nonce", nonce);
+    if (transfer.token_transfer)
+    {
+        properties.set_property_value("token_transfer", transfer.token_transfer);
+    }
+    transaction->add_source().set_property_value("amount", BigInt("100000000000000000000"));
+
+    Properties& destination = transaction->add_destination();
+    destination.set_property_value("address", transfer.address);
+    destination.set_property_value("amount", *transfer.amount);
+
+    Properties& fee = transaction->get_fee();
+    fee.set_property_value("gas_price", gas_price);
+    fee.set_property_value("gas_limit", gas_limit);
+
+    return transaction->serialize();
+}
+
+std::vector<BinaryDataPtr> make_transactions(const Account& account,
+        const BigInt& first_nonce, const BigInt& gas_price, const BigInt& gas_limit,
+        const std::vector<EthereumTransfer>& transfers, size_t threads_count)
+{
+    std::vector<BinaryData*> transactions(transfers.size(), nullptr);
+    throw_if_error(ethereum_make_signed_transactions(&account, &first_nonce,
+            &gas_price, &gas_limit, transfers.data(), transfers.size(),
+            threads_count, transactions.data()));
+
+    std::vector<BinaryDataPtr> result;
+    for (BinaryData* transaction : transactions)
+    {
+        result.emplace_back(transaction);
+    }
+    return result;
+}
+
+} // namespace
+
+GTEST_TEST(EthereumBatchTest, same_as_single_transactions)
+{
+    AccountPtr account;
+    HANDLE_ERROR(make_account(ETHEREUM_TEST_NET, ACCOUNT_TYPE_DEFAULT,
+            PRIVATE_KEY, reset_sp(account)));
+
+    const BigInt first_nonce(11);
+    const BigInt gas_price(1.0_GWEI);
+    const BigInt gas_limit(153327);
+
+    std::vector<std::string> addresses;
+    std::vector<BigInt> amounts;
+    for (int i = 0; i < 17; ++i)
+    {
+        addresses.push_back("0x2b74679d2a190fd679a85ce7767c05605237f0"
+                + std::to_string(30 + i));
+        amounts.push_back(BigInt("1000000000000000000") * (i + 1));
+    }
+
+    std::vector<EthereumTransfer> transfers;
+    for (size_t i = 0; i < addresses.size(); ++i)
+    {
+        transfers.push_back(EthereumTransfer{addresses[i].c_str(), &amounts[i],
+                i % 3 == 0 ? TOKEN_TRANSFER : nullptr});
+    }
+
+    const std::vector<BinaryDataPtr> transactions = make_transactions(*account,
+            first_nonce, gas_price, gas_limit, transfers, 1);
+    ASSERT_EQ(transfers.size(), transactions.size());
+
+    // Same as EthereumTransactionTest.SmokeTest_testnet_ERC20_transfer
+    EXPECT_EQ(as_binary_data(from_hex(
+            "f8a90b843b9aca00830256ef94fdf88a23d6058789c6a37bd997d3ed4760feb3b280b844a9059cbb000000"
+            "0000000000000000002b74679d2a190fd679a85ce7767c05605237f0300000000000000000000000000000"
+            "000000000000000000000de0b6b3a76400002ba02e8d834c6b53c91aa6c69d9f1d4ffff761adc3f7d60df0"
+            "ddcfdf2b6990b5f7f5a01efc5f0c3c6fc3863adef7f2bd2c4affaf4f138f77fbbd3e348fc674e8d070a9")),
+            *transactions[0]);
+
+    for (size_t i = 0; i < transfers.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        const BigInt nonce = first_nonce + static_cast<int32_t>(i);
+        EXPECT_EQ(*make_single_transaction(*account, nonce, gas_price, gas_limit,
+                transfers[i]), *transactions[i]);
+        EXPECT_EQ(nonce, EthereumTransactionView(*transactions[i]).get_nonce());
+    }
+
+    for (size_t threads_count : {0, 2, 5, 100})
+    {
+        SCOPED_TRACE(threads_count);
+        const std::vector<BinaryDataPtr> parallel = make_transactions(*account,
+                first_nonce, gas_price, gas_limit, transfers, threads_count);
+        ASSERT_EQ(transactions.size(), parallel.size());
+        for (size_t i = 0; i < transactions.size(); ++i)
+        {
+            EXPECT_EQ(*transactions[i], *parallel[i]);
+        }
+    }
+
+    // Nothing to sign.
+    EXPECT_EQ(0, make_transactions(*account, first_nonce, gas_price, gas_limit,
+            std::vector<EthereumTransfer>(), 0).size());
+}
+
+GTEST_TEST(EthereumBatchTest, invalid_args)
+{
+    AccountPtr account;
+    HANDLE_ERROR(make_account(ETHEREUM_TEST_NET, ACCOUNT_TYPE_DEFAULT,
+            PRIVATE_KEY, reset_sp(account)));
+
+    const BigInt nonce(0);
+    const BigInt gas_price(1.0_GWEI);
+    const BigInt gas_limit(21000);
+    const BigInt amount(1);
+    const BigInt negative(-1);
+    const EthereumTransfer valid{"0x2b74679d2a190fd679a85ce7767c05605237f030", &amount, nullptr};
+
+    BinaryData* transactions[2] = {nullptr, nullptr};
+    EXPECT_ERROR(ethereum_make_signed_transactions(nullptr, &nonce, &gas_price,
+            &gas_limit, &valid, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), nullptr, &gas_price,
+            &gas_limit, &valid, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce, nullptr,
+            &gas_limit, &valid, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce, &gas_price,
+            nullptr, &valid, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce, &gas_price,
+            &gas_limit, nullptr, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce, &gas_price,
+            &gas_limit, &valid, 1, 1, nullptr));
+
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &negative, &gas_price,
+            &gas_limit, &valid, 1, 1, transactions));
+    EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce, &negative,
+            &gas_limit, &valid, 1, 1, transactions));
+
+    const EthereumTransfer invalid_transfers[] = {
+        {nullptr, &amount, nullptr},
+        {"0x2b74679d2a190fd679a85ce7767c05605237f030", nullptr, nullptr},
+        {"0x2b74679d2a190fd679a85ce7767c05605237f0", &amount, nullptr},
+        {"0x2b74679d2a190fd679a85ce7767c05605237f030", &negative, nullptr},
+        {"0x2b74679d2a190fd679a85ce7767c05605237f030", &amount, "ERC20:0x00:transfer"},
+        {"0x2b74679d2a190fd679a85ce7767c05605237f030", &amount, "ERC721"},
+    };
+    for (const EthereumTransfer& invalid : invalid_transfers)
+    {
+        // Valid transfer is not signed either.
+        const EthereumTransfer transfers[] = {valid, invalid};
+        EXPECT_ERROR(ethereum_make_signed_transactions(account.get(), &nonce,
+                &gas_price, &gas_limit, transfers, 2, 1, transactions));
+        EXPECT_EQ(nullptr, transactions[0]);
+        EXPECT_EQ(nullptr, transactions[1]);
+    }
+
+    AccountPtr bitcoin_account;
+    HANDLE_ERROR(make_account(BITCOIN_TEST_NET, ACCOUNT_TYPE_DEFAULT,
+            "cQeGKosJjWPn9GkB7QmvmotmBbVg1hm8UjdN6yLXEWZ5HAcRwam7",
+            reset_sp(bitcoin_account)));
+    EXPECT_ERROR(ethereum_make_signed_transactions(bitcoin_account.get(), &nonce,
+            &gas_price, &gas_limit, &valid, 1, 1, transactions));
+}
@@ -0,0 +1,306 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_rlp.h"
+
+#include "multy_core/src/api/big_int_impl.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+const char* LOREM_IPSUM = "Lorem ipsum dolor sit amet, consectetur adipisicing elit";
+
+std::string encode_to_hex(void (*write_items)(EthereumRlpEncoder*))
+{
+    return to_hex(*encode_rlp(write_items));
+}
+
+} // namespace
+
+// Test vectors from https://github.com/ethereum/wiki/wiki/RLP
+GTEST_TEST(EthereumRlpEncoderTest, strings)
+{
+    EXPECT_EQ("83646f67", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(as_binary_data("dog"));
+    }));
+
+    EXPECT_EQ("80", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(BinaryData{nullptr, 0});
+    }));
+
+    EXPECT_EQ("00", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(as_binary_data(from_hex("00")));
+    }));
+
+    EXPECT_EQ("8180", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(as_binary_data(from_hex("80")));
+    }));
+
+    EXPECT_EQ("b838" + to_hex(as_binary_data(LOREM_IPSUM)),
+            encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(as_binary_data(LOREM_IPSUM));
+    }));
+
+    // Length that takes more than one byte is big-endian.
+    const bytes long_string(1024, 0xAB);
+    const BinaryDataPtr encoded = encode_rlp([&long_string](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_bytes(as_binary_data(long_string));
+    });
+    ASSERT_EQ(3 + long_string.size(), encoded->len);
+    EXPECT_EQ("b90400", to_hex(slice(*encoded, 0, 3)));
+    EXPECT_EQ(as_binary_data(long_string), slice(*encoded, 3, long_string.size()));
+}
+
+GTEST_TEST(EthereumRlpEncoderTest, integers)
+{
+    EXPECT_EQ("80", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_uint(0);
+    }));
+
+    EXPECT_EQ("0f", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_uint(15);
+    }));
+
+    EXPECT_EQ("820400", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_uint(1024);
+    }));
+
+    EXPECT_EQ("88ffffffffffffffff", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_uint(0xFFFFFFFFFFFFFFFF);
+    }));
+
+    EXPECT_EQ("80" "0f" "820400" "89010000000000000000",
+            encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_big_int(BigInt(0));
+        encoder->write_big_int(BigInt(15));
+        encoder->write_big_int(BigInt(1024));
+        encoder->write_big_int(BigInt("18446744073709551616"));
+    }));
+
+    EXPECT_EQ("80" "0f" "820400", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_big_endian_uint(as_binary_data(from_hex("0000")));
+        encoder->write_big_endian_uint(as_binary_data(from_hex("000f")));
+        encoder->write_big_endian_uint(as_binary_data(from_hex("00000400")));
+    }));
+
+    // Bigger than uint256.
+    const BigInt huge(("1" + std::string(100, '0')).c_str());
+    const BinaryDataPtr exported = huge.export_as_binary_data(BigInt::EXPORT_BIG_ENDIAN);
+    EXPECT_EQ("aa" + to_hex(*exported), to_hex(*encode_rlp([&huge](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_big_int(huge);
+    })));
+
+    EXPECT_THROW(encode_rlp([](EthereumRlpEncoder* encoder)
+    {
+        encoder->write_big_int(BigInt(-1));
+    }), Exception);
+}
+
+GTEST_TEST(EthereumRlpEncoderTest, lists)
+{
+    EXPECT_EQ("c0", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->end_list();
+    }));
+
+    EXPECT_EQ("c88363617483646f67", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_bytes(as_binary_data("cat"));
+        encoder->write_bytes(as_binary_data("dog"));
+        encoder->end_list();
+    }));
+
+    // Set theoretical representation of three: [ [], [[]], [ [], [[]] ] ]
+    EXPECT_EQ("c7c0c1c0c3c0c1c0", encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+            encoder->begin_list();
+            encoder->end_list();
+
+            encoder->begin_list();
+                encoder->begin_list();
+                encoder->end_list();
+            encoder->end_list();
+
+            encoder->begin_list();
+                encoder->begin_list();
+                encoder->end_list();
+                encoder->begin_list();
+                    encoder->begin_list();
+                    encoder->end_list();
+                encoder->end_list();
+            encoder->end_list();
+        encoder->end_list();
+    }));
+
+    // Pre-encoded items and a long list.
+    EXPECT_EQ("f83e" "83636174" "b838" + to_hex(as_binary_data(LOREM_IPSUM)),
+            encode_to_hex([](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_encoded(as_binary_data(from_hex("83636174")));
+        encoder->write_bytes(as_binary_data(LOREM_IPSUM));
+        encoder->end_list();
+    }));
+
+    const bytes long_string(1024, 0xAB);
+    const BinaryDataPtr encoded = encode_rlp([&long_string](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_bytes(as_binary_data(long_string));
+        encoder->end_list();
+    });
+    EXPECT_EQ("f90403b90400", to_hex(slice(*encoded, 0, 6)));
+}
+
+GTEST_TEST(EthereumRlpEncoderTest, different_passes)
+{
+    // Writing pass produces more data than was computed by sizing pass.
+    EthereumRlpEncoder encoder;
+    encoder.write_uint(1);
+    encoder.start_writing();
+    EXPECT_THROW(encoder.write_uint(1024), Exception);
+}
+
+GTEST_TEST(EthereumRlpReaderTest, strings_and_integers)
+{
+    const bytes long_string(1024, 0xAB);
+    const bytes data = from_hex(("83646f67" "80" "00" "8180" "820400" "88ffffffffffffffff"
+            "b838" + to_hex(as_binary_data(LOREM_IPSUM))
+            + "b90400" + to_hex(as_binary_data(long_string))).c_str());
+
+    EthereumRlpReader reader(as_binary_data(data));
+    EXPECT_EQ(as_binary_data("dog"), reader.read_bytes());
+    EXPECT_EQ(0, reader.read_uint64());
+    EXPECT_EQ(as_binary_data(from_hex("00")), reader.read_bytes());
+    EXPECT_EQ(BigInt(128), reader.read_big_int());
+    EXPECT_EQ(1024, reader.read_uint64());
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFF, reader.read_uint64());
+    const BinaryData lorem_ipsum = reader.read_bytes();
+    EXPECT_EQ(as_binary_data(LOREM_IPSUM), lorem_ipsum);
+    // Points inside the original buffer.
+    EXPECT_EQ(data.data() + 4 + 1 + 1 + 2 + 3 + 9 + 2, lorem_ipsum.data);
+    EXPECT_EQ(as_binary_data(long_string), reader.read_bytes());
+    EXPECT_FALSE(reader.has_more());
+    EXPECT_THROW(reader.read_item(), Exception);
+}
+
+GTEST_TEST(EthereumRlpReaderTest, lists)
+{
+    const bytes data = from_hex("c7c0c1c0c3c0c1c0" "c88363617483646f67");
+    EthereumRlpReader reader(as_binary_data(data));
+
+    // [ [], [[]], [ [], [[]] ] ]
+    const EthereumRlpItem item = reader.read_item();
+    EXPECT_TRUE(item.is_list);
+    EXPECT_EQ(as_binary_data(from_hex("c7c0c1c0c3c0c1c0")), item.encoded);
+    {
+        EthereumRlpReader three(item.payload);
+        EXPECT_FALSE(three.read_list().has_more());
+        EthereumRlpReader one = three.read_list();
+        EXPECT_FALSE(one.read_list().has_more());
+        EXPECT_FALSE(one.has_more());
+        EXPECT_EQ(as_binary_data(from_hex("c0c1c0")), three.read_item().payload);
+        EXPECT_FALSE(three.has_more());
+    }
+
+    EthereumRlpReader cat_dog = reader.read_list();
+    EXPECT_THROW(cat_dog.read_list(), Exception);
+    EXPECT_EQ(as_binary_data("dog"), cat_dog.read_bytes());
+    EXPECT_FALSE(cat_dog.has_more());
+    EXPECT_FALSE(reader.has_more());
+
+    EXPECT_THROW(EthereumRlpReader(as_binary_data(from_hex("c0"))).read_bytes(),
+            Exception);
+}
+
+GTEST_TEST(EthereumRlpReaderTest, round_trip)
+{
+    const bytes long_string(300, 0xAB);
+    const BigInt huge(("1" + std::string(70, '0')).c_str());
+    const BinaryDataPtr encoded = encode_rlp(
+            [&long_string, &huge](EthereumRlpEncoder* encoder)
+    {
+        encoder->begin_list();
+        encoder->write_uint(1000000);
+        encoder->write_big_int(huge);
+        encoder->begin_list();
+        encoder->write_bytes(as_binary_data(long_string));
+        encoder->end_list();
+        encoder->end_list();
+    });
+
+    EthereumRlpReader reader(*encoded);
+    EthereumRlpReader list = reader.read_list();
+    EXPECT_EQ(1000000, list.read_uint64());
+    EXPECT_EQ(huge, list.read_big_int());
+    EXPECT_EQ(as_binary_data(long_string), list.read_list().read_bytes());
+    EXPECT_FALSE(list.has_more());
+    EXPECT_FALSE(reader.has_more());
+}
+
+GTEST_TEST(EthereumRlpReaderTest, invalid_data)
+{
+    const char* INVALID_ITEMS[] = {
+        // Truncated.
+        "83646f",
+        "b838" "00",
+        "b904",
+        "c883636174",
+        // Single byte below 0x80 with a header.
+        "8100",
+        "817f",
+        // Long form for short length.
+        "b80100",
+        "f800",
+        // Leading zero in the length.
+        "b9000100",
+        // Length does not fit into size_t.
+        "bfffffffffffffffffff",
+    };
+
+    for (const char* item : INVALID_ITEMS)
+    {
+        SCOPED_TRACE(item);
+        const bytes data = from_hex(item);
+        EthereumRlpReader reader(as_binary_data(data));
+        EXPECT_THROW(reader.read_item(), Exception);
+    }
+
+    // Integers with leading zeroes or too big.
+    EXPECT_THROW(EthereumRlpReader(as_binary_data(from_hex("820001"))).read_uint_bytes(),
+            Exception);
+    EXPECT_THROW(EthereumRlpReader(as_binary_data(from_hex("00"))).read_big_int(),
+            Exception);
+    EXPECT_THROW(EthereumRlpReader(as_binary_data(from_hex("89010000000000000000"))).read_uint64(),
+            Exception);
+}
@@ -6,6 +6,8 @@
 
 #include "multy_core/ethereum.h"
 #include "multy_core/src/ethereum/ethereum_transaction.h"
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/exception.h"
 
 #include "multy_core/src/api/properties_impl.h"
 
@@ -518,7 +520,7 @@ GTEST_TEST(EthereumTransactionTest, SmokeTest_testnet_ERC20_transfer_2)
             "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00",
             reset_sp(account)));
     ASSERT_NE(nullptr, account);
-    ASSERT_EQ("0x2b74679d2a190fd679a85ce7767c05605237f030", account->get_address());
+    ASSERT_EQ("0x2B74679D2a190Fd679a85cE7767c05605237f030", account->get_address());
 
     TransactionPtr transaction;
     HANDLE_ERROR(make_transaction(account.get(), reset_sp(transaction)));
@@ -562,6 +564,44 @@ GTEST_TEST(EthereumTransactionTest, SmokeTest_testnet_ERC20_transfer_2)
             "c8c05da800011a963860a027e9189fdee28faac1092441903d59371c84a0cd5cacea0410bcc2ab000646d0")), *serialied);
 }
 
+GTEST_TEST(EthereumTransactionTest, ERC20_transfer_amount_too_big)
+{
+    const AccountPtr account = make_ethereum_account(ETHEREUM_TEST_NET,
+            "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00");
+
+    TransactionPtr transaction;
+    HANDLE_ERROR(make_transaction(account.get(), reset_sp(transaction)));
+
+    {
+        Properties& properties = transaction->get_transaction_properties();
+        properties.set_property_value("nonce", BigInt(0));
+        properties.set_property_value("token_transfer", "ERC20:0xfdf88a23d6058789c6a37bd997d3ed4760feb3b2:transfer");
+    }
+    transaction->add_source().set_property_value("amount", BigInt(0.1_ETH));
+    {
+        Properties& destination = transaction->add_destination();
+        destination.set_property_value("address", "0x6b4be1fc5fa05c5d959d27155694643b8af72fd8");
+        // 2^256
+        destination.set_property_value("amount", BigInt(
+                "115792089237316195423570985008687907853269984665640564039457584007913129639936"));
+    }
+    {
+        Properties& fee = transaction->get_fee();
+        fee.set_property_value("gas_price", BigInt(1.0_GWEI));
+        fee.set_property_value("gas_limit", BigInt(153327));
+    }
+
+    try
+    {
+        transaction->serialize();
+        ADD_FAILURE() << "Exception expected.";
+    }
+    catch (const Exception& e)
+    {
+        EXPECT_EQ(ERROR_TRANSACTION_SPECIFIC_ERROR_BASE, e.get_error_code());
+    }
+}
+
 GTEST_TEST(EthereumTransactionTest, token_transfer_API)
 {
     AccountPtr account;
@@ -628,7 +668,7 @@ GTEST_TEST(EthereumTransactionTest, DISABLED_SmokeTest_mainnet_ERC20_transfer_wi
             "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00",
             reset_sp(account)));
     ASSERT_NE(nullptr, account);
-    ASSERT_EQ("0x2b74679d2a190fd679a85ce7767c05605237f030", account->get_address());
+    ASSERT_EQ("0x2B74679D2a190Fd679a85cE7767c05605237f030", account->get_address());
 
     TransactionPtr transaction;
     HANDLE_ERROR(make_transaction(account.get(), reset_sp(transaction)));
@@ -686,7 +726,7 @@ GTEST_TEST(EthereumTransactionTest, SmokeTest_mainnet_ERC20_transfer)
             "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00",
             reset_sp(account)));
     ASSERT_NE(nullptr, account);
-    ASSERT_EQ("0x2b74679d2a190fd679a85ce7767c05605237f030", account->get_address());
+    ASSERT_EQ("0x2B74679D2a190Fd679a85cE7767c05605237f030", account->get_address());
 
     TransactionPtr transaction;
     HANDLE_ERROR(make_transaction(account.get(), reset_sp(transaction)));
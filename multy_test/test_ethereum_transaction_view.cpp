@@ -0,0 +1,259 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/ethereum/ethereum_transaction_view.h"
+
+#include "multy_core/big_int.h"
+#include "multy_core/ethereum.h"
+#include "multy_core/transaction.h"
+
+#include "multy_core/src/api/account_impl.h"
+#include "multy_core/src/api/properties_impl.h"
+#include "multy_core/src/api/transaction_impl.h"
+#include "multy_core/src/ethereum/ethereum_account.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/supported_blockchains.h"
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+// Example from https://github.com/ethereum/EIPs/blob/master/EIPS/eip-155.md
+const char* EIP155_TX =
+        "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028"
+        "ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b38"
+        "00ccf555c9f3dc64214b297fb1966a3b6d83";
+
+// Signed by EthereumTransactionTest.SmokeTest_testnet_withdata
+const char* TESTNET_TX =
+        "f86a038602ba7def30008301d8a894d1b48a11e2251555c3c6d8b93e13f9aa2f51ea198203e882ffff2ca0122bf1"
+        "a37f949f0fc34354ca737eec7fd654e2172ecf893497d6e8356217512da05f01213f5d1c25d4b55e8c7219e572f9"
+        "2b00ec74a2662ae93c45928eb5133942";
+
+} // namespace
+
+GTEST_TEST(EthereumTransactionViewTest, EIP155_example)
+{
+    const bytes data = from_hex(EIP155_TX);
+    const EthereumTransactionView view(as_binary_data(data));
+
+    EXPECT_EQ(BigInt(9), view.get_nonce());
+    EXPECT_EQ(BigInt("20000000000"), view.get_gas_price());
+    EXPECT_EQ(BigInt(21000), view.get_gas_limit());
+    EXPECT_EQ(as_binary_data(from_hex("3535353535353535353535353535353535353535")),
+            view.get_destination());
+    // Points inside the original buffer.
+    EXPECT_EQ(data.data() + 2 + 1 + 1 + 5 + 1 + 2 + 1, view.get_destination().data);
+    EXPECT_EQ(BigInt("1000000000000000000"), view.get_value());
+    EXPECT_EQ(0, view.get_data().len);
+
+    EXPECT_EQ(37, view.get_v());
+    EXPECT_EQ(1, view.get_chain_id());
+    EXPECT_EQ(0, view.get_recovery_id());
+    EXPECT_EQ(as_binary_data(from_hex(
+            "28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276")),
+            view.get_r());
+
+    EXPECT_EQ("daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53",
+            to_hex(as_binary_data(view.get_signing_hash())));
+    EXPECT_EQ("33469b22e9f636356c4160a87eb19df52b7412e8eac32a4a55ffe88ea8350788",
+            to_hex(as_binary_data(view.get_hash())));
+    EXPECT_EQ(as_binary_data(from_hex("9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f")),
+            *view.recover_sender_address());
+}
+
+GTEST_TEST(EthereumTransactionViewTest, signed_transaction)
+{
+    const bytes data = from_hex(TESTNET_TX);
+    const EthereumTransactionView view(as_binary_data(data));
+
+    EXPECT_EQ(BigInt(3), view.get_nonce());
+    EXPECT_EQ(3000.0_GWEI, view.get_gas_price());
+    EXPECT_EQ(BigInt(121000), view.get_gas_limit());
+    EXPECT_EQ(as_binary_data(from_hex("d1b48a11e2251555c3c6d8b93e13f9aa2f51ea19")),
+            view.get_destination());
+    EXPECT_EQ(1000_WEI, view.get_value());
+    EXPECT_EQ(as_binary_data(from_hex("ffff")), view.get_data());
+    EXPECT_EQ(ETHEREUM_CHAIN_ID_RINKEBY, view.get_chain_id());
+
+    const AccountPtr account = make_ethereum_account(ETHEREUM_TEST_NET,
+            "5a37680b86fabdec299fa02bdfba8c9dfad08d796dc58c1d07527a751905bf71");
+    EXPECT_EQ(*ethereum_parse_address(account->get_address().c_str()),
+            *view.recover_sender_address());
+}
+
+GTEST_TEST(EthereumTransactionViewTest, round_trip)
+{
+    const AccountPtr account = make_ethereum_account(ETHEREUM_MAIN_NET,
+            "b81b3c491e397cbb4939787a81bd049d7a8c5ee819fd4e03afdab94813b06a00");
+
+    TransactionPtr transaction;
+    HANDLE_ERROR(make_transaction(account.get(), reset_sp(transaction)));
+
+    transaction->get_transaction_properties().set_property_value("nonce", BigInt(1000000));
+    transaction->add_source().set_property_value("amount", BigInt(10.0_ETH));
+    {
+        Properties& destination = transaction->add_destination();
+        destination.set_property_value("address", "0x6b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b");
+        destination.set_property_value("amount", BigInt(1.0_ETH));
+    }
+    {
+        Properties& fee = transaction->get_fee();
+        fee.set_property_value("gas_price", BigInt(1.0_GWEI));
+        fee.set_property_value("gas_limit", BigInt(100000));
+    }
+
+    // Long enough to have multi-byte RLP length of both the payload and the list.
+    const bytes payload(300, 0xab);
+    transaction->set_message(as_binary_data(payload));
+
+    const BinaryDataPtr serialized = transaction->serialize();
+    const EthereumTransactionView view(*serialized);
+
+    EXPECT_EQ(BigInt(1000000), view.get_nonce());
+    EXPECT_EQ(BigInt(1.0_GWEI), view.get_gas_price());
+    EXPECT_EQ(BigInt(100000), view.get_gas_limit());
+    EXPECT_EQ(as_binary_data(from_hex("6b4be1fa5332a9a4e8e5bd8a5f8bcbfe7d2a2e3b")),
+            view.get_destination());
+    EXPECT_EQ(BigInt(1.0_ETH), view.get_value());
+    EXPECT_EQ(as_binary_data(payload), view.get_data());
+    EXPECT_EQ(ETHEREUM_CHAIN_ID_MAINNET, view.get_chain_id());
+
+    EXPECT_EQ(*ethereum_parse_address(account->get_address().c_str()),
+            *view.recover_sender_address());
+}
+
+GTEST_TEST(EthereumTransactionViewTest, invalid_data)
+{
+    for (const char* tx : {EIP155_TX, TESTNET_TX})
+    {
+        SCOPED_TRACE(tx);
+
+        // Truncated at various points, including right before the end.
+        const bytes data = from_hex(tx);
+        for (size_t cut = 1; cut <= data.size(); cut += 5)
+        {
+            const size_t len = data.size() - cut;
+            SCOPED_TRACE(len);
+            EXPECT_THROW(EthereumTransactionView(BinaryData{data.data(), len}),
+                    Exception);
+        }
+
+        bytes extra_data = data;
+        extra_data.push_back(0);
+        EXPECT_THROW(EthereumTransactionView(as_binary_data(extra_data)),
+                Exception);
+    }
+
+    const std::string address = "94" + std::string(40, '1');
+    const std::string signature = "25" "a0" + std::string(64, '2') + "a0" + std::string(64, '3');
+
+    // Valid transaction, with empty destination and with address.
+    EXPECT_NO_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" + signature).c_str()))));
+    EXPECT_NO_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f85d" "01" "01" "01" + address + "01" "80" + signature).c_str()))));
+
+    // Not a list.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            "8401020304"))), Exception);
+
+    // Too few and too many fields.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f848" "01" "01" "80" "01" "80" + signature).c_str()))), Exception);
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f84a" "01" "01" "01" "80" "01" "80" + signature + "01").c_str()))),
+            Exception);
+
+    // Invalid destination size.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f84b" "01" "01" "01" "821111" "01" "80" + signature).c_str()))),
+            Exception);
+
+    // Leading zeroes in the nonce.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f84b" "820001" "01" "01" "80" "01" "80" + signature).c_str()))),
+            Exception);
+
+    // Invalid v.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" "1a" + signature.substr(2)).c_str()))),
+            Exception);
+
+    // Chain id 0 in EIP-155 v: 35 and 36.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" "23" + signature.substr(2)).c_str()))),
+            Exception);
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" "24" + signature.substr(2)).c_str()))),
+            Exception);
+
+    // High s (EIP-2): half of the curve order is valid, anything above is not.
+    const std::string half_order = "7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0";
+    const std::string above_half_order = "7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a1";
+    EXPECT_NO_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" + signature.substr(0, 70) + half_order).c_str()))));
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f849" "01" "01" "01" "80" "01" "80" + signature.substr(0, 70) + above_half_order).c_str()))),
+            Exception);
+
+    // Empty r.
+    EXPECT_THROW(EthereumTransactionView(as_binary_data(from_hex(
+            ("f829" "01" "01" "01" "80" "01" "80" "25" "80" "a0" + std::string(64, '3')).c_str()))),
+            Exception);
+}
+
+GTEST_TEST(EthereumTransactionViewTest, C_API)
+{
+    const bytes data = from_hex(EIP155_TX);
+    const BinaryData serialized = as_binary_data(data);
+
+    BigIntPtr nonce, gas_price, gas_limit, value;
+    HANDLE_ERROR(make_big_int("0", reset_sp(nonce)));
+    HANDLE_ERROR(make_big_int("0", reset_sp(gas_price)));
+    HANDLE_ERROR(make_big_int("0", reset_sp(gas_limit)));
+    HANDLE_ERROR(make_big_int("0", reset_sp(value)));
+
+    EthereumTransactionInfo info{};
+    info.nonce = nonce.get();
+    info.gas_price = gas_price.get();
+    info.gas_limit = gas_limit.get();
+    info.value = value.get();
+    HANDLE_ERROR(ethereum_parse_signed_transaction(&serialized, &info));
+
+    EXPECT_EQ(BigInt(9), *nonce);
+    EXPECT_EQ(BigInt("20000000000"), *gas_price);
+    EXPECT_EQ(BigInt(21000), *gas_limit);
+    EXPECT_EQ(BigInt("1000000000000000000"), *value);
+    EXPECT_EQ(as_binary_data(from_hex("3535353535353535353535353535353535353535")),
+            info.destination);
+    EXPECT_EQ(0, info.data.len);
+    EXPECT_EQ(1, info.chain_id);
+    EXPECT_EQ(as_binary_data(from_hex("9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f")),
+            as_binary_data(info.sender));
+    EXPECT_EQ("33469b22e9f636356c4160a87eb19df52b7412e8eac32a4a55ffe88ea8350788",
+            to_hex(as_binary_data(info.hash)));
+
+    // BigInt values are optional.
+    EthereumTransactionInfo sender_only{};
+    HANDLE_ERROR(ethereum_parse_signed_transaction(&serialized, &sender_only));
+    EXPECT_EQ(as_binary_data(info.sender), as_binary_data(sender_only.sender));
+
+    EXPECT_ERROR(ethereum_parse_signed_transaction(nullptr, &info));
+    EXPECT_ERROR(ethereum_parse_signed_transaction(&serialized, nullptr));
+
+    const BinaryData truncated{data.data(), data.size() - 1};
+    EXPECT_ERROR(ethereum_parse_signed_transaction(&truncated, &info));
+}
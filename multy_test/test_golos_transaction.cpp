@@ -30,8 +30,103 @@ namespace
 {
 using namespace multy_core::internal;
 using namespace test_utility;
+
+const char* TEST_PRIVATE_KEY = "5JpDgood17pE47zB6pDJixg9Sw47QiHcQ9qCc3MeKYoYzRiMcnF";
+
+std::string serialize_transfer(BlockchainType blockchain_type,
+        const char* to, const char* amount, const char* memo)
+{
+    AccountPtr account;
+    throw_if_error(make_account(
+            blockchain_type,
+            ACCOUNT_TYPE_DEFAULT,
+            TEST_PRIVATE_KEY,
+            reset_sp(account)));
+
+    TransactionPtr transaction;
+    throw_if_error(make_transaction(account.get(), reset_sp(transaction)));
+
+    {
+        const bytes ref_block_hash = from_hex("00e3a4a84407f2df4953c35614248b433e6db43e");
+        const BinaryData ref_block_hash_data = as_binary_data(ref_block_hash);
+
+        Properties* properties = nullptr;
+        throw_if_error(transaction_get_properties(transaction.get(), &properties));
+        throw_if_error(properties_set_int32_value(properties, "ref_block_num", 14918824));
+        throw_if_error(properties_set_binary_data_value(properties, "ref_block_hash",
+                &ref_block_hash_data));
+        throw_if_error(properties_set_string_value(properties, "expiration",
+                "2018-03-22T14:42:00"));
+    }
+
+    {
+        Properties* source = nullptr;
+        throw_if_error(transaction_add_source(transaction.get(), &source));
+        throw_if_error(properties_set_string_value(source, "address", "multytest"));
+    }
+
+    {
+        Properties* destination = nullptr;
+        throw_if_error(transaction_add_destination(transaction.get(), &destination));
+
+        BigIntPtr value;
+        throw_if_error(make_big_int(amount, reset_sp(value)));
+        throw_if_error(properties_set_big_int_value(destination, "amount", value.get()));
+        throw_if_error(properties_set_string_value(destination, "address", to));
+    }
+
+    if (memo)
+    {
+        const BinaryData message = as_binary_data(memo);
+        throw_if_error(transaction_set_message(transaction.get(), &message));
+    }
+
+    BinaryDataPtr serialized;
+    throw_if_error(transaction_serialize(transaction.get(), reset_sp(serialized)));
+
+    return std::string(reinterpret_cast<const char*>(serialized->data), serialized->len);
+}
+
 } // namespace
 
+GTEST_TEST(GolosTransactionTest, signature)
+{
+    // Signatures were verified by recovering public key of the
+    // TEST_PRIVATE_KEY from sha256(chain_id + binary-serialized transaction).
+    // Signing is deterministic, hence the values are stable.
+    const std::string transfer = serialize_transfer(
+            GOLOS_MAIN_NET, "multy", "5", nullptr);
+    EXPECT_EQ(minify_json(R"({
+            "expiration":"2018-03-22T14:42:00",
+            "extensions":[],
+            "operations":[
+              [
+                 "transfer",
+                 {
+                    "amount":"0.005 GOLOS",
+                    "from":"multytest",
+                    "memo":"",
+                    "to":"multy"
+                 }
+              ]
+            ],
+            "ref_block_num":42152,
+            "ref_block_prefix":3757180740,
+            "signatures":[
+                "204d95f535a9109bebc83c8c5b552f2f372f1c15a25b69eeaa3552042a1d6042f76de111df6c615b548b7ad6e7adee348545580d12c67062e5d7739b36a589261c"
+            ]
+            })"),
+            transfer);
+
+    // Same transaction is signed identically.
+    EXPECT_EQ(transfer, serialize_transfer(GOLOS_MAIN_NET, "multy", "5", nullptr));
+
+    // Any change to operation or chain id results in different signature.
+    EXPECT_NE(transfer, serialize_transfer(GOLOS_MAIN_NET, "multy", "6", nullptr));
+    EXPECT_NE(transfer, serialize_transfer(GOLOS_MAIN_NET, "multy", "5", "memo"));
+    EXPECT_NE(transfer, serialize_transfer(GOLOS_TEST_NET, "multy", "5", nullptr));
+}
+
 GTEST_TEST(GolosTransactionTest, DISABLED_SmokeTest_public_api)
 {
     AccountPtr account;
@@ -0,0 +1,203 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/hash.h"
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+// Long enough to span several blocks of any of the hashers.
+std::vector<uint8_t> make_test_data()
+{
+    std::vector<uint8_t> result(1000);
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        result[i] = static_cast<uint8_t>(i % 251);
+    }
+    return result;
+}
+
+template <HasherType HasherT, size_t N>
+void test_hasher(const char* expected_abc_hash)
+{
+    SCOPED_TRACE(HasherT);
+    SCOPED_TRACE(N);
+
+    {
+        IncrementalHasher<HasherT, N> hasher;
+        hasher.update(as_binary_data("a"));
+        hasher.update(as_binary_data(""));
+        hasher.update(as_binary_data("bc"));
+        EXPECT_EQ(to_hex(from_hex(expected_abc_hash)),
+                to_hex(as_binary_data(hasher.finalize())));
+
+        // finalize() resets hasher to initial state.
+        hasher.update(as_binary_data("abc"));
+        EXPECT_EQ(to_hex(from_hex(expected_abc_hash)),
+                to_hex(as_binary_data(hasher.finalize())));
+
+        // clear() drops data hashed so far.
+        hasher.update(as_binary_data("xyz"));
+        hasher.clear();
+        hasher.update(as_binary_data("abc"));
+        EXPECT_EQ(to_hex(from_hex(expected_abc_hash)),
+                to_hex(as_binary_data(hasher.finalize())));
+    }
+
+    const std::vector<uint8_t> data = make_test_data();
+    const hash<N> expected = do_hash<HasherT, N>(data);
+    for (size_t chunk_size : {1, 7, 64, 71, 128, 136, 999, 1000})
+    {
+        SCOPED_TRACE(chunk_size);
+
+        IncrementalHasher<HasherT, N> hasher;
+        for (size_t i = 0; i < data.size(); i += chunk_size)
+        {
+            const size_t len = std::min(chunk_size, data.size() - i);
+            hasher.update(BinaryData{data.data() + i, len});
+        }
+        EXPECT_EQ(expected, hasher.finalize());
+    }
+
+    // Copy carries over hashing state.
+    IncrementalHasher<HasherT, N> prefix_hasher;
+    prefix_hasher.update(BinaryData{data.data(), 500});
+    IncrementalHasher<HasherT, N> hasher(prefix_hasher);
+    hasher.update(BinaryData{data.data() + 500, data.size() - 500});
+    EXPECT_EQ(expected, hasher.finalize());
+
+    prefix_hasher.update(BinaryData{data.data() + 500, data.size() - 500});
+    EXPECT_EQ(expected, prefix_hasher.finalize());
+}
+
+} // namespace
+
+GTEST_TEST(IncrementalHasherTest, SHA2)
+{
+    test_hasher<SHA2, 256>(
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    test_hasher<SHA2, 512>(
+            "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+            "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+}
+
+GTEST_TEST(IncrementalHasherTest, SHA2_DOUBLE)
+{
+    test_hasher<SHA2_DOUBLE, 256>(
+            "4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358");
+}
+
+GTEST_TEST(IncrementalHasherTest, SHA3)
+{
+    test_hasher<SHA3, 224>(
+            "e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf");
+    test_hasher<SHA3, 256>(
+            "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532");
+    test_hasher<SHA3, 384>(
+            "ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c2596da7cf0e49be4b2"
+            "98d88cea927ac7f539f1edf228376d25");
+    test_hasher<SHA3, 512>(
+            "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+            "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0");
+}
+
+GTEST_TEST(IncrementalHasherTest, KECCAK)
+{
+    test_hasher<KECCAK, 256>(
+            "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+}
+
+GTEST_TEST(HashTest, keccak_256_many)
+{
+    const std::vector<uint8_t> data = make_test_data();
+
+    // Runs of same-sized inputs (some of those span several blocks)
+    // interleaved with odd-sized ones.
+    std::vector<BinaryData> inputs;
+    for (size_t size : {64, 64, 64, 64, 64, 0, 135, 136, 137, 200,
+            64, 64, 64, 64, 999, 272, 300, 280, 271, 1, 64, 64})
+    {
+        inputs.push_back(BinaryData{data.data() + inputs.size(), size});
+    }
+
+    const std::vector<hash<256>> hashes = keccak_256_many(inputs.data(), inputs.size());
+    ASSERT_EQ(inputs.size(), hashes.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        EXPECT_EQ((do_hash<KECCAK, 256>(inputs[i])), hashes[i]);
+    }
+
+    EXPECT_EQ(0, keccak_256_many(nullptr, 0).size());
+}
+
+GTEST_TEST(IncrementalHasherTest, RIPEMD)
+{
+    test_hasher<RIPEMD, 160>("8eb208f7e05d987a9b044a8e98c6b087f15a0bfc");
+}
+
+GTEST_TEST(HashTest, pbkdf2_hmac_sha512)
+{
+    struct Pbkdf2TestCase
+    {
+        std::string password;
+        std::string salt;
+        uint32_t iterations;
+        const char* expected;
+    };
+
+    const Pbkdf2TestCase TEST_CASES[] =
+    {
+        {"password", "salt", 1,
+                "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252"
+                "c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce"},
+        {"password", "salt", 2,
+                "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+                "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e"},
+        {"password", "salt", 4096,
+                "d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5"
+                "143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5"},
+        {"passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+                "8c0511f4c6e597c6ac6315d8f0362e225f3c501495ba23b868c005174dc4ee71"
+                "115b59f9e60cd9532fa33e0f75aefe30225c583a186cd82bd4daea9724a3d3b8"},
+        // Password longer than the block is hashed, output spans several blocks.
+        {std::string(200, 'p'), "salt", 3,
+                "0499d2f52a54272883fc04786c49cbfe54771bb53aa16a2f8d3fdad6a6ef15fa"
+                "d0133b49b8e08dc4bbd208c754356edd34d0e5e2516c4975f9150c616cc96d35"
+                "6e8358be8ec6f4dd31f51d5bef0bb3cbf08428868645ac607227262ee9ca9bcd"
+                "67d6eaf6"},
+        {"", "", 1, "6d2ecbbbfb2e6dcd7056"},
+    };
+
+    for (const auto& test_case : TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.password);
+        SCOPED_TRACE(test_case.iterations);
+
+        const bytes expected = from_hex(test_case.expected);
+        bytes derived(expected.size());
+        pbkdf2_hmac_sha512(as_binary_data(test_case.password),
+                as_binary_data(test_case.salt), test_case.iterations,
+                derived.data(), derived.size());
+        EXPECT_EQ(expected, derived);
+    }
+
+    unsigned char out[64];
+    EXPECT_THROW(pbkdf2_hmac_sha512(as_binary_data("password"),
+            as_binary_data("salt"), 0, out, sizeof(out)), Exception);
+}
@@ -0,0 +1,193 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/json_writer.h"
+
+#include "multy_core/src/exception.h"
+#include "multy_core/src/utility.h"
+
+#include "multy_test/utility.h"
+#include "multy_test/value_printers.h"
+
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <string>
+
+namespace
+{
+using namespace multy_core::internal;
+using namespace test_utility;
+
+std::string write_json(void (*write_value)(JsonWriter*))
+{
+    JsonWriter writer;
+    write_value(&writer);
+    return writer.get_content();
+}
+
+} // namespace
+
+GTEST_TEST(JsonWriterTest, values)
+{
+    EXPECT_EQ("null", write_json([](JsonWriter* writer)
+    {
+        writer->write_null();
+    }));
+
+    EXPECT_EQ("[true,false]", write_json([](JsonWriter* writer)
+    {
+        writer->begin_array();
+        writer->write_bool(true);
+        writer->write_bool(false);
+        writer->end_array();
+    }));
+
+    EXPECT_EQ("[0,18446744073709551615,-9223372036854775808,9223372036854775807]",
+            write_json([](JsonWriter* writer)
+    {
+        writer->begin_array();
+        writer->write_uint(0);
+        writer->write_uint(std::numeric_limits<uint64_t>::max());
+        writer->write_int(std::numeric_limits<int64_t>::min());
+        writer->write_int(std::numeric_limits<int64_t>::max());
+        writer->end_array();
+    }));
+
+    EXPECT_EQ(R"(["0.005 GOLOS","-1.000","12","0.000000001"])",
+            write_json([](JsonWriter* writer)
+    {
+        writer->begin_array();
+        writer->write_fixed_point(5, 3, "GOLOS");
+        writer->write_fixed_point(-1000, 3);
+        writer->write_fixed_point(12, 0);
+        writer->write_fixed_point(1, 9);
+        writer->end_array();
+    }));
+
+    EXPECT_EQ(R"(["","00ff10"])", write_json([](JsonWriter* writer)
+    {
+        writer->begin_array();
+        writer->write_hex(BinaryData{nullptr, 0});
+        writer->write_hex(as_binary_data(from_hex("00FF10")));
+        writer->end_array();
+    }));
+}
+
+GTEST_TEST(JsonWriterTest, string_escaping)
+{
+    EXPECT_EQ(R"("")", write_json([](JsonWriter* writer)
+    {
+        writer->write_string("");
+    }));
+
+    EXPECT_EQ(R"("quote \" backslash \\ slash / unicode \u0001\u001f \b\f\n\r\t ÿ")",
+            write_json([](JsonWriter* writer)
+    {
+        writer->write_string("quote \" backslash \\ slash / unicode \x01\x1f \b\f\n\r\t ÿ");
+    }));
+
+    EXPECT_EQ(R"("\u0000a")", write_json([](JsonWriter* writer)
+    {
+        writer->write_string(std::string("\0a", 2));
+    }));
+}
+
+GTEST_TEST(JsonWriterTest, timestamp)
+{
+    EXPECT_EQ(R"(["1970-01-01T00:00:00","2018-03-22T14:42:00","2000-02-29T23:59:59","1969-12-31T23:59:59"])",
+            write_json([](JsonWriter* writer)
+    {
+        writer->begin_array();
+        writer->write_timestamp(0);
+        writer->write_timestamp(1521729720);
+        writer->write_timestamp(951868799);
+        writer->write_timestamp(-1);
+        writer->end_array();
+    }));
+}
+
+GTEST_TEST(JsonWriterTest, nesting)
+{
+    EXPECT_EQ(R"({"a":[],"b":{},"c":[[1,{"d":null}],2]})", write_json([](JsonWriter* writer)
+    {
+        writer->begin_object();
+        writer->write_key("a");
+        writer->begin_array();
+        writer->end_array();
+        writer->write_key("b");
+        writer->begin_object();
+        writer->end_object();
+        writer->write_key("c");
+        writer->begin_array();
+        writer->begin_array();
+        writer->write_uint(1);
+        writer->begin_object();
+        writer->write_key("d");
+        writer->write_null();
+        writer->end_object();
+        writer->end_array();
+        writer->write_uint(2);
+        writer->end_array();
+        writer->end_object();
+    }));
+}
+
+GTEST_TEST(JsonWriterTest, invalid)
+{
+    {
+        // Value of object member without a key.
+        JsonWriter writer;
+        writer.begin_object();
+        EXPECT_THROW(writer.write_uint(1), Exception);
+    }
+
+    {
+        // Key outside of an object.
+        JsonWriter writer;
+        writer.begin_array();
+        EXPECT_THROW(writer.write_key("a"), Exception);
+    }
+
+    {
+        // Key without a value.
+        JsonWriter writer;
+        writer.begin_object();
+        writer.write_key("a");
+        EXPECT_THROW(writer.write_key("b"), Exception);
+        EXPECT_THROW(writer.end_object(), Exception);
+    }
+
+    {
+        // Mismatched brackets.
+        JsonWriter writer;
+        writer.begin_array();
+        EXPECT_THROW(writer.end_object(), Exception);
+    }
+
+    {
+        // Unclosed array.
+        JsonWriter writer;
+        writer.begin_array();
+        EXPECT_THROW(writer.get_content(), Exception);
+    }
+
+    {
+        // Second top-level value.
+        JsonWriter writer;
+        writer.write_null();
+        EXPECT_THROW(writer.write_null(), Exception);
+    }
+
+    {
+        JsonWriter writer;
+        for (size_t i = 0; i < JsonWriter::MAX_DEPTH; ++i)
+        {
+            writer.begin_array();
+        }
+        EXPECT_THROW(writer.begin_array(), Exception);
+    }
+}
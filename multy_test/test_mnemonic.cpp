@@ -117,6 +117,51 @@ GTEST_TEST(MnemonicTest, empty_null_password)
     ASSERT_EQ(*null_pass_seed, *empty_pass_seed);
 }
 
+GTEST_TEST(MnemonicTest, make_seeds)
+{
+    // Same as make_seed() for each of mnemonics, with and without passwords.
+    std::vector<const char*> mnemonics;
+    std::vector<const char*> passwords;
+    for (const BIP39TestCase& test_case : BIP39_DEFAULT_TEST_CASES)
+    {
+        mnemonics.push_back(test_case.mnemonic);
+        passwords.push_back(mnemonics.size() % 3 == 0 ? nullptr : "TREZOR");
+    }
+    const size_t count = mnemonics.size();
+
+    std::vector<BinaryData*> seeds(count, nullptr);
+    HANDLE_ERROR(make_seeds(mnemonics.data(), passwords.data(), count, seeds.data()));
+    std::vector<BinaryDataPtr> seeds_guard(seeds.begin(), seeds.end());
+
+    std::vector<BinaryData*> no_password_seeds(count, nullptr);
+    HANDLE_ERROR(make_seeds(mnemonics.data(), nullptr, count,
+            no_password_seeds.data()));
+    std::vector<BinaryDataPtr> no_password_seeds_guard(
+            no_password_seeds.begin(), no_password_seeds.end());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        SCOPED_TRACE(mnemonics[i]);
+
+        BinaryDataPtr expected_seed;
+        HANDLE_ERROR(make_seed(mnemonics[i], passwords[i], reset_sp(expected_seed)));
+        ASSERT_NE(nullptr, seeds[i]);
+        EXPECT_EQ(*expected_seed, *seeds[i]);
+
+        if (passwords[i])
+        {
+            EXPECT_EQ(as_binary_data(from_hex(BIP39_DEFAULT_TEST_CASES[i].seed)),
+                    *seeds[i]);
+        }
+
+        HANDLE_ERROR(make_seed(mnemonics[i], nullptr, reset_sp(expected_seed)));
+        ASSERT_NE(nullptr, no_password_seeds[i]);
+        EXPECT_EQ(*expected_seed, *no_password_seeds[i]);
+    }
+
+    HANDLE_ERROR(make_seeds(nullptr, nullptr, 0, nullptr));
+}
+
 GTEST_TEST(MnemonicTest, mnemonic_get_dictionary)
 {
     ConstCharPtr dictionary;
@@ -157,6 +202,25 @@ GTEST_TEST(MnemonicTestInvalidArgs, make_seed)
     EXPECT_EQ(nullptr, binary_data);
 }
 
+GTEST_TEST(MnemonicTestInvalidArgs, make_seeds)
+{
+    const char* mnemonics[] = {BIP39_DEFAULT_TEST_CASES[0].mnemonic, "mnemonic"};
+    const char* null_mnemonics[] = {BIP39_DEFAULT_TEST_CASES[0].mnemonic, nullptr};
+    BinaryData* seeds[] = {nullptr, nullptr};
+
+    EXPECT_ERROR(make_seeds(nullptr, nullptr, 1, seeds));
+    EXPECT_ERROR(make_seeds(mnemonics, nullptr, 1, nullptr));
+
+    // Any invalid mnemonic fails the whole batch.
+    EXPECT_ERROR(make_seeds(mnemonics, nullptr, 2, seeds));
+    EXPECT_EQ(nullptr, seeds[0]);
+    EXPECT_EQ(nullptr, seeds[1]);
+
+    EXPECT_ERROR(make_seeds(null_mnemonics, nullptr, 2, seeds));
+    EXPECT_EQ(nullptr, seeds[0]);
+    EXPECT_EQ(nullptr, seeds[1]);
+}
+
 GTEST_TEST(MnemonicTestInvalidArgs, seed_to_string)
 {
     unsigned char data_vals[] = {1U, 2U, 3U, 4U};
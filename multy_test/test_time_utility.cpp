@@ -0,0 +1,133 @@
+/* Copyright 2018 by Multy.io
+ * Licensed under Multy.io license.
+ *
+ * See LICENSE for details
+ */
+
+#include "multy_core/src/time_utility.h"
+
+#include "multy_core/src/exception.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+namespace
+{
+using namespace multy_core::internal;
+
+struct TimeTestCase
+{
+    const char* formatted;
+    std::time_t time;
+};
+
+const TimeTestCase TIME_TEST_CASES[] =
+{
+    {"1970-01-01T00:00:00", 0},
+    {"1969-12-31T23:59:59", -1},
+    {"2018-03-22T14:42:00", 1521729720},
+    {"2000-02-29T23:59:59", 951868799},
+    {"2000-03-01T00:00:00", 951868800},
+    {"2100-03-01T00:00:00", 4107542400},
+    {"2038-01-19T03:14:08", 2147483648},
+    {"1900-01-01T00:00:00", -2208988800},
+};
+
+} // namespace
+
+GTEST_TEST(TimeUtilityTest, format)
+{
+    for (const auto& test_case : TIME_TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.formatted);
+        EXPECT_EQ(test_case.formatted, format_iso8601_time(test_case.time));
+    }
+
+    EXPECT_THROW(format_iso8601_time(-62167219201), Exception); // year -1
+    EXPECT_THROW(format_iso8601_time(253402300800), Exception); // year 10000
+}
+
+GTEST_TEST(TimeUtilityTest, parse)
+{
+    for (const auto& test_case : TIME_TEST_CASES)
+    {
+        SCOPED_TRACE(test_case.formatted);
+        EXPECT_EQ(test_case.time, parse_iso8601_time(test_case.formatted));
+        EXPECT_EQ(test_case.time,
+                parse_iso8601_time(std::string(test_case.formatted) + "Z"));
+    }
+
+    // UTC offsets.
+    EXPECT_EQ(1521729720, parse_iso8601_time("2018-03-22T17:42:00+03:00"));
+    EXPECT_EQ(1521729720, parse_iso8601_time("2018-03-22T17:42:00+0300"));
+    EXPECT_EQ(1521729720, parse_iso8601_time("2018-03-22T13:12:00-01:30"));
+    EXPECT_EQ(1521729720, parse_iso8601_time("2018-03-22T14:42:00+00:00"));
+
+    // Only the given length is parsed.
+    EXPECT_EQ(1521729720, parse_iso8601_time("2018-03-22T14:42:00 trailing garbage",
+            ISO8601_TIME_LENGTH));
+}
+
+GTEST_TEST(TimeUtilityTest, parse_invalid)
+{
+    const char* INVALID_VALUES[] =
+    {
+        "",
+        "2018-03-22",
+        "2018-03-22T14:42",
+        "2018-03-22 14:42:00",
+        "2018/03/22T14:42:00",
+        "2018-3-22T14:42:00",
+        "2018-03-22T14:42:0a",
+        "2018-00-22T14:42:00",
+        "2018-13-22T14:42:00",
+        "2018-03-00T14:42:00",
+        "2018-03-32T14:42:00",
+        "2018-02-29T14:42:00",
+        "1900-02-29T14:42:00",
+        "2018-04-31T14:42:00",
+        "2018-03-22T24:00:00",
+        "2018-03-22T14:60:00",
+        "2018-03-22T14:42:60",
+        "2018-03-22T14:42:00z",
+        "2018-03-22T14:42:00ZZ",
+        "2018-03-22T14:42:00+03",
+        "2018-03-22T14:42:00+03:0",
+        "2018-03-22T14:42:00+03-00",
+        "2018-03-22T14:42:00+24:00",
+        "2018-03-22T14:42:00 ",
+        "-018-03-22T14:42:00",
+        "+2018-03-22T14:42:00",
+    };
+
+    for (const char* value : INVALID_VALUES)
+    {
+        SCOPED_TRACE(value);
+        EXPECT_THROW(parse_iso8601_time(value), Exception);
+    }
+}
+
+GTEST_TEST(TimeUtilityTest, round_trip)
+{
+    // Every day from 0000-01-01 to 9999-12-31, at various times of day.
+    const std::time_t FIRST_DAY = -719528;
+    const std::time_t LAST_DAY = 2932896;
+    const std::time_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+    char buffer[ISO8601_TIME_LENGTH];
+    for (std::time_t day = FIRST_DAY; day <= LAST_DAY; ++day)
+    {
+        const std::time_t time = day * SECONDS_PER_DAY
+                + ((day - FIRST_DAY) * 7919) % SECONDS_PER_DAY;
+        format_iso8601_time(time, buffer);
+        ASSERT_EQ(time, parse_iso8601_time(buffer, sizeof(buffer)))
+                << std::string(buffer, sizeof(buffer));
+    }
+
+    format_iso8601_time(FIRST_DAY * SECONDS_PER_DAY, buffer);
+    EXPECT_EQ("0000-01-01T00:00:00", std::string(buffer, sizeof(buffer)));
+
+    format_iso8601_time((LAST_DAY + 1) * SECONDS_PER_DAY - 1, buffer);
+    EXPECT_EQ("9999-12-31T23:59:59", std::string(buffer, sizeof(buffer)));
+}
@@ -4,6 +4,7 @@
  * See LICENSE for details
  */
 
+#include "multy_core/src/cached_value.h"
 #include "multy_core/src/utility.h"
 #include "multy_core/src/exception.h"
 
@@ -12,7 +13,10 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace
 {
@@ -125,9 +129,92 @@ GTEST_TEST(UtilityInvalidArgsTest, power_slice)
     EXPECT_THROW(power_slice(data, TOO_SMALL, TOO_SMALL), Exception);
 }
 
+GTEST_TEST(UtilityTest, FixedSizeBinaryDataWriter)
+{
+    const BinaryData data = as_binary_data("Sample BinaryData");
+
+    FixedSizeBinaryDataWriter writer(data.len);
+    writer.write_data(data.data, 6);
+    writer.write_data(nullptr, 0);
+    writer.write_data(data.data + 6, data.len - 6);
+    EXPECT_EQ(data, *writer.release());
+
+    FixedSizeBinaryDataWriter empty_writer(0);
+    EXPECT_EQ(0, empty_writer.release()->len);
+}
+
+GTEST_TEST(UtilityInvalidArgsTest, FixedSizeBinaryDataWriter)
+{
+    const BinaryData data = as_binary_data("Sample BinaryData");
+
+    FixedSizeBinaryDataWriter writer(data.len);
+    EXPECT_THROW(writer.write_data(data.data, data.len + 1), Exception);
+
+    writer.write_data(data.data, data.len - 1);
+    // Not all data is written yet.
+    EXPECT_THROW(writer.release(), Exception);
+    EXPECT_THROW(writer.write_data(data.data, 2), Exception);
+}
+
 GTEST_TEST(UtilityTest, minify_json)
 {
     ASSERT_EQ(minify_json("\t\n\v\f\r a"), "a");
     ASSERT_EQ(minify_json(R"( " \" " )"), R"(" \" ")");
     ASSERT_EQ(minify_json(R"( " a \\ a" \\ )"), R"(" a \\ a"\\)");
 }
+
+GTEST_TEST(UtilityTest, CachedValue)
+{
+    int calls_count = 0;
+    auto make_value = [&calls_count]() -> std::string
+    {
+        ++calls_count;
+        return TEST_VALUE1;
+    };
+
+    CachedValue<std::string> value;
+    EXPECT_EQ(TEST_VALUE1, value.get(make_value));
+    EXPECT_EQ(TEST_VALUE1, value.get(make_value));
+    EXPECT_EQ(&value.get(make_value), &value.get(make_value));
+    EXPECT_EQ(1, calls_count);
+
+    // Copy gets already computed value.
+    CachedValue<std::string> value_copy(value);
+    EXPECT_EQ(TEST_VALUE1, value_copy.get(make_value));
+    EXPECT_EQ(1, calls_count);
+
+    // Nothing is cached if make_value throws.
+    CachedValue<std::string> throwing_value;
+    EXPECT_THROW(throwing_value.get([]() -> std::string
+            {
+                throw_exception(TEST_VALUE2);
+                return TEST_VALUE2;
+            }), std::exception);
+    EXPECT_EQ(TEST_VALUE1, throwing_value.get(make_value));
+    EXPECT_EQ(2, calls_count);
+}
+
+GTEST_TEST(UtilityTest, CachedValue_multithreaded)
+{
+    std::atomic<int> calls_count(0);
+    CachedValue<std::string> value;
+
+    std::vector<std::future<std::string>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+        results.push_back(std::async(std::launch::async, [&]()
+        {
+            return value.get([&calls_count]() -> std::string
+            {
+                ++calls_count;
+                return TEST_VALUE1;
+            });
+        }));
+    }
+
+    for (auto& result : results)
+    {
+        EXPECT_EQ(TEST_VALUE1, result.get());
+    }
+    EXPECT_EQ(1, calls_count);
+}
@@ -32,7 +32,10 @@
 #define WINDOW_A 5
 /** larger numbers may result in slightly better performance, at the cost of
     exponentially larger precomputed tables. */
-#ifdef USE_ENDOMORPHISM
+#if defined(ECMULT_WINDOW_SIZE)
+/** Set by the build: smaller tables are faster to build, but verification is slower. */
+#define WINDOW_G ECMULT_WINDOW_SIZE
+#elif defined(USE_ENDOMORPHISM)
 /** Two tables for window size 15: 1.375 MiB. */
 #define WINDOW_G 15
 #else